@@ -0,0 +1,257 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace midnight {
+
+// Times a benchmark body over repeated runs after a few untimed warmups.
+// Timed runs continue until `max_runs` or until `time_budget` is spent with
+// at least `min_runs` recorded. Bodies return a checksum of their output so
+// the work cannot be optimized away.
+class BenchmarkHarness final {
+public:
+    struct CreateInfo final {
+        std::size_t warmup_runs = 2;
+        std::size_t min_runs = 5;
+        std::size_t max_runs = 100;
+        std::chrono::milliseconds time_budget{1000};
+        std::string filter;
+        std::string json_path;
+    };
+
+    struct Result final {
+        std::string name;
+        std::string size;
+        std::uint64_t items = 0;
+        std::size_t runs = 0;
+        double mean_ns = 0.0;
+        double min_ns = 0.0;
+        double p50_ns = 0.0;
+        double p90_ns = 0.0;
+        double p99_ns = 0.0;
+        double max_ns = 0.0;
+    };
+
+    explicit BenchmarkHarness(CreateInfo create_info)
+        : create_info_(std::move(create_info))
+    {
+    }
+
+    // Applies the options every benchmark takes: --json FILE, --filter NAME
+    // and --runs N. Returns false for any other argument.
+    static bool apply_option(
+        CreateInfo& create_info,
+        const std::string_view argument,
+        const std::string& value
+    )
+    {
+        if (argument == "--json") {
+            create_info.json_path = value;
+        } else if (argument == "--filter") {
+            create_info.filter = value;
+        } else if (argument == "--runs") {
+            create_info.max_runs = std::max<std::size_t>(std::stoul(value), 1);
+            create_info.min_runs =
+                std::min(create_info.min_runs, create_info.max_runs);
+        } else {
+            return false;
+        }
+
+        return true;
+    }
+
+    BenchmarkHarness(const BenchmarkHarness&) = delete;
+    BenchmarkHarness& operator=(const BenchmarkHarness&) = delete;
+
+    BenchmarkHarness(BenchmarkHarness&&) = delete;
+    BenchmarkHarness& operator=(BenchmarkHarness&&) = delete;
+
+    [[nodiscard]] bool selected(const std::string_view name) const
+    {
+        return create_info_.filter.empty() ||
+            name.find(create_info_.filter) != std::string_view::npos;
+    }
+
+    // `setup` runs untimed before every run, warmups included; `items` is
+    // the work one run does, for the throughput column.
+    template <typename Setup, typename Body>
+    void run(
+        const std::string_view name,
+        const std::string_view size,
+        const std::uint64_t items,
+        Setup&& setup,
+        Body&& body
+    )
+    {
+        if (!selected(name)) {
+            return;
+        }
+
+        for (std::size_t run = 0; run < create_info_.warmup_runs; ++run) {
+            setup();
+            checksum_ += body();
+        }
+
+        std::vector<double> samples;
+        Clock::duration spent{};
+
+        while (samples.size() < create_info_.max_runs &&
+               (samples.size() < create_info_.min_runs ||
+                spent < create_info_.time_budget)) {
+            setup();
+
+            const Clock::time_point start = Clock::now();
+            checksum_ += body();
+            const Clock::duration elapsed = Clock::now() - start;
+
+            spent += elapsed;
+            samples.push_back(
+                std::chrono::duration<double, std::nano>(elapsed).count()
+            );
+        }
+
+        std::ranges::sort(samples);
+
+        double total = 0.0;
+
+        for (const double sample : samples) {
+            total += sample;
+        }
+
+        const Result& result = results_.emplace_back(Result{
+            .name = std::string(name),
+            .size = std::string(size),
+            .items = items,
+            .runs = samples.size(),
+            .mean_ns = total / static_cast<double>(samples.size()),
+            .min_ns = samples.front(),
+            .p50_ns = percentile(samples, 0.50),
+            .p90_ns = percentile(samples, 0.90),
+            .p99_ns = percentile(samples, 0.99),
+            .max_ns = samples.back()
+        });
+
+        std::cout << "[Midnight] "
+                  << result.name
+                  << " "
+                  << result.size
+                  << ": p50 "
+                  << result.p50_ns / 1'000'000.0
+                  << " ms, p90 "
+                  << result.p90_ns / 1'000'000.0
+                  << " ms, p99 "
+                  << result.p99_ns / 1'000'000.0
+                  << " ms ("
+                  << result.runs
+                  << " runs, "
+                  << static_cast<double>(result.items) * 1'000.0 /
+                         result.p50_ns
+                  << " M items/s)\n";
+    }
+
+    [[nodiscard]] const std::vector<Result>& results() const noexcept
+    {
+        return results_;
+    }
+
+    [[nodiscard]] std::uint64_t checksum() const noexcept
+    {
+        return checksum_;
+    }
+
+    void write_json(std::ostream& output) const
+    {
+        output << "{\n  \"benchmarks\": [";
+
+        for (std::size_t index = 0; index < results_.size(); ++index) {
+            const Result& result = results_[index];
+
+            output << (index == 0 ? "\n" : ",\n")
+                   << "    {\"name\": \"" << escaped(result.name)
+                   << "\", \"size\": \"" << escaped(result.size)
+                   << "\", \"items\": " << result.items
+                   << ", \"runs\": " << result.runs
+                   << ", \"mean_ns\": " << result.mean_ns
+                   << ", \"min_ns\": " << result.min_ns
+                   << ", \"p50_ns\": " << result.p50_ns
+                   << ", \"p90_ns\": " << result.p90_ns
+                   << ", \"p99_ns\": " << result.p99_ns
+                   << ", \"max_ns\": " << result.max_ns
+                   << "}";
+        }
+
+        output << "\n  ]\n}\n";
+    }
+
+    // Writes the JSON report when --json was given and prints the checksum.
+    void finish() const
+    {
+        if (!create_info_.json_path.empty()) {
+            std::ofstream output(create_info_.json_path);
+            write_json(output);
+
+            if (!output) {
+                throw std::runtime_error(
+                    "Failed to write " + create_info_.json_path
+                );
+            }
+
+            std::cout << "[Midnight] Wrote "
+                      << results_.size()
+                      << " results to "
+                      << create_info_.json_path
+                      << '\n';
+        }
+
+        std::cout << "[Midnight] Checksum " << checksum_ << '\n';
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Nearest rank over sorted samples.
+    [[nodiscard]] static double percentile(
+        const std::vector<double>& sorted,
+        const double fraction
+    )
+    {
+        const std::size_t rank = static_cast<std::size_t>(
+            std::ceil(fraction * static_cast<double>(sorted.size()))
+        );
+
+        return sorted[rank > 0 ? rank - 1 : 0];
+    }
+
+    [[nodiscard]] static std::string escaped(const std::string_view text)
+    {
+        std::string result;
+
+        for (const char character : text) {
+            if (character == '"' || character == '\\') {
+                result.push_back('\\');
+            }
+
+            result.push_back(character);
+        }
+
+        return result;
+    }
+
+    CreateInfo create_info_;
+    std::vector<Result> results_;
+    std::uint64_t checksum_ = 0;
+};
+
+}
@@ -0,0 +1,211 @@
+#include "BenchmarkHarness.hpp"
+
+#include "midnight/core/JobSystem.hpp"
+#include "midnight/core/Simulation.hpp"
+#include "midnight/ecs/SpriteComponents.hpp"
+#include "midnight/ecs/SpriteSystems.hpp"
+#include "midnight/ecs/World.hpp"
+#include "midnight/renderer/Vertex2D.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kEntityCount = 100'000;
+constexpr float kBoundsWidth = 256.0f;
+constexpr float kBoundsHeight = 256.0f;
+constexpr std::string_view kSizeLabel = "100000 entities";
+
+constexpr midnight::SimulationStep kStep{
+    .tick = 0,
+    .duration = std::chrono::nanoseconds{16'666'667},
+    .seconds = 1.0 / 60.0
+};
+
+constexpr midnight::SpriteMotionBounds kBounds{
+    .width = kBoundsWidth,
+    .height = kBoundsHeight
+};
+
+constexpr midnight::SpriteRenderLayout kRenderLayout{
+    .left = -1.0f,
+    .top = -1.0f,
+    .cell_width = 2.0f / kBoundsWidth,
+    .cell_height = 2.0f / kBoundsHeight,
+    .atlas_columns = 12,
+    .atlas_rows = 8
+};
+
+void create_sprites(midnight::World& world, std::span<midnight::Entity> entities)
+{
+    using namespace midnight;
+
+    world.create_entities(
+        entities,
+        Position2D{},
+        PreviousPosition2D{},
+        Velocity2D{},
+        Sprite{}
+    );
+}
+
+void scatter_sprites(midnight::World& world)
+{
+    using namespace midnight;
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> position_x(0.0f, kBoundsWidth - 1.0f);
+    std::uniform_real_distribution<float> position_y(0.0f, kBoundsHeight - 1.0f);
+    std::uniform_real_distribution<float> velocity(-4.0f, 4.0f);
+
+    world.each<Position2D, PreviousPosition2D, Velocity2D>(
+        [&](
+            Position2D& position,
+            PreviousPosition2D& previous_position,
+            Velocity2D& entity_velocity
+        ) {
+            position = Position2D{.x = position_x(random), .y = position_y(random)};
+            previous_position = PreviousPosition2D{.x = position.x, .y = position.y};
+            entity_velocity = Velocity2D{.x = velocity(random), .y = velocity(random)};
+        }
+    );
+}
+
+}
+
+// midnight_bench [--json FILE] [--filter NAME] [--runs N]
+int main(const int argc, char** argv)
+{
+    using namespace midnight;
+
+    try {
+        BenchmarkHarness::CreateInfo create_info{};
+
+        for (int index = 1; index < argc; ++index) {
+            const std::string_view argument = argv[index];
+
+            if (index + 1 >= argc ||
+                !BenchmarkHarness::apply_option(
+                    create_info,
+                    argument,
+                    argv[index + 1]
+                )) {
+                throw std::runtime_error(
+                    "Unknown or incomplete argument: " + std::string(argument)
+                );
+            }
+
+            ++index;
+        }
+
+        BenchmarkHarness harness(create_info);
+        JobSystem jobs(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+        World world;
+        std::vector<Entity> entities(kEntityCount);
+        std::vector<Vertex2D> vertices(kEntityCount * 4);
+        SpriteRenderSnapshot snapshot;
+
+        harness.run(
+            "ecs_create",
+            kSizeLabel,
+            kEntityCount,
+            [&] {
+                world.clear();
+            },
+            [&] {
+                create_sprites(world, entities);
+                return world.entity_count();
+            }
+        );
+
+        harness.run(
+            "ecs_destroy",
+            kSizeLabel,
+            kEntityCount,
+            [&] {
+                if (world.entity_count() == 0) {
+                    create_sprites(world, entities);
+                }
+            },
+            [&] {
+                world.destroy_entities(entities);
+                return world.entity_count();
+            }
+        );
+
+        create_sprites(world, entities);
+        scatter_sprites(world);
+
+        harness.run(
+            "sprite_motion",
+            kSizeLabel,
+            kEntityCount,
+            [] {},
+            [&] {
+                update_sprite_motion(world, kStep, kBounds);
+                return world.entity_count();
+            }
+        );
+
+        harness.run(
+            "sprite_motion_jobs",
+            kSizeLabel,
+            kEntityCount,
+            [] {},
+            [&] {
+                update_sprite_motion(world, kStep, kBounds, &jobs);
+                return world.entity_count();
+            }
+        );
+
+        harness.run(
+            "sprite_vertices",
+            kSizeLabel,
+            kEntityCount,
+            [] {},
+            [&] {
+                return build_sprite_vertices(world, kRenderLayout, 0.5, vertices);
+            }
+        );
+
+        harness.run(
+            "sprite_snapshot",
+            kSizeLabel,
+            kEntityCount,
+            [] {},
+            [&] {
+                capture_sprite_render_snapshot(world, snapshot);
+                return build_sprite_vertices(
+                    snapshot,
+                    kRenderLayout,
+                    0.5,
+                    vertices
+                );
+            }
+        );
+
+        std::cout << "[Midnight] Job system: "
+                  << jobs.concurrency()
+                  << " threads\n";
+        harness.finish();
+    } catch (const std::exception& error) {
+        std::cerr << "[Midnight] ECS benchmark failed: "
+                  << error.what()
+                  << '\n';
+        return 1;
+    }
+
+    return 0;
+}
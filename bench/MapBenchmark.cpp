@@ -0,0 +1,925 @@
+#include "BenchmarkHarness.hpp"
+
+#include "midnight/core/JobSystem.hpp"
+#include "midnight/map/MapAutoTiler.hpp"
+#include "midnight/map/MapEditing.hpp"
+#include "midnight/map/MapEditor.hpp"
+#include "midnight/map/MapGenerator.hpp"
+#include "midnight/map/MapMesh.hpp"
+#include "midnight/map/MapMinimap.hpp"
+#include "midnight/map/MapTileIndex.hpp"
+#include "midnight/map/MapTileSpans.hpp"
+#include "midnight/map/TileMap.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <initializer_list>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct MapSize final {
+    std::uint32_t columns = 0;
+    std::uint32_t rows = 0;
+};
+
+// The editor's canvas first, then square maps up to the size the map
+// format is meant to handle.
+constexpr MapSize kMapSizes[] = {
+    {16, 12},
+    {64, 64},
+    {256, 256},
+    {1024, 1024},
+    {4096, 4096}
+};
+
+constexpr std::size_t kLayerCount = 2;
+constexpr std::uint32_t kChunkSize = 8;
+constexpr std::uint32_t kMaxQuadsPerIndexBatch = 0x1'0000 / 4;
+constexpr std::size_t kEditorBatchSize = 4096;
+constexpr midnight::MapCellRect kPatternA{
+    .left = 0,
+    .top = 0,
+    .right = 2,
+    .bottom = 1
+};
+constexpr midnight::MapCellRect kPatternB{
+    .left = 3,
+    .top = 2,
+    .right = 5,
+    .bottom = 3
+};
+constexpr midnight::PackedMapTile kWallTile =
+    midnight::pack_map_tile(7, 1, true);
+constexpr midnight::PackedMapTile kFillTile =
+    midnight::pack_map_tile(1, 0, true);
+
+constexpr midnight::MapGeneratorSettings kGeneratorSettings{
+    .kind = midnight::MapGeneratorKind::Caves,
+    .seed = 13,
+    .ground_layer = 0,
+    .wall_layer = 1,
+    .ground_tile = kFillTile,
+    .water_tile = midnight::pack_map_tile(8, 4, true),
+    .wall_tile = kWallTile
+};
+
+constexpr std::pair<std::string_view, midnight::MapGeneratorKind>
+    kGeneratorKinds[] = {
+        {"generate_noise", midnight::MapGeneratorKind::Noise},
+        {"generate_caves", midnight::MapGeneratorKind::Caves},
+        {"generate_rooms", midnight::MapGeneratorKind::Rooms}
+    };
+
+// Matches the editor's 16x12 canvas scale; only the arithmetic matters.
+constexpr midnight::MapMeshLayout kMeshLayout{
+    .left = -0.4f,
+    .top = -0.6f,
+    .cell_width = 0.075f,
+    .cell_height = 0.1f,
+    .tile_width = 16,
+    .tile_height = 16,
+    .atlas_width = 384,
+    .atlas_height = 256,
+    .atlas_tile_padding = 8
+};
+
+// Sections whose benchmarks share setup run it when any of them passes the
+// filter; a filter naming one of them need not match the others.
+bool any_selected(
+    const midnight::BenchmarkHarness& harness,
+    const std::initializer_list<std::string_view> names
+)
+{
+    return std::ranges::any_of(names, [&harness](const std::string_view name) {
+        return harness.selected(name);
+    });
+}
+
+void use_span_kernels(const std::string_view name)
+{
+    using namespace midnight;
+
+    for (const MapTileSpanKernels kernels : {
+             MapTileSpanKernels::Scalar,
+             MapTileSpanKernels::Sse41,
+             MapTileSpanKernels::Avx2,
+             MapTileSpanKernels::Neon
+         }) {
+        if (map_tile_span_kernels_name(kernels) != name) {
+            continue;
+        }
+
+        if (!use_map_tile_span_kernels(kernels)) {
+            throw std::runtime_error(
+                "This CPU cannot run the " + std::string(name) + " span kernels"
+            );
+        }
+
+        return;
+    }
+
+    throw std::runtime_error("Unknown span kernels: " + std::string(name));
+}
+
+midnight::MapCellRect whole_map(const midnight::TileMap& map)
+{
+    return midnight::MapCellRect{
+        .left = 0,
+        .top = 0,
+        .right = map.columns() - 1,
+        .bottom = map.rows() - 1
+    };
+}
+
+// Stand-in average colours for the 12x8 outdoor tileset, so the minimap
+// benchmarks need no assets.
+midnight::RgbaImage make_tile_colors()
+{
+    midnight::RgbaImage colors{
+        .width = 12,
+        .height = 8,
+        .pixels = std::vector<std::uint8_t>(
+            12 * 8 * midnight::RgbaImage::bytes_per_pixel
+        )
+    };
+
+    for (std::size_t index = 0; index < colors.pixels.size(); ++index) {
+        colors.pixels[index] = static_cast<std::uint8_t>(
+            index % 4 == 3 ? 255 : index * 37
+        );
+    }
+
+    return colors;
+}
+
+// Broken walls on every other row, so the flood fill winds through gaps
+// instead of sweeping straight rows, while every open cell stays reachable
+// through the clear rows between them.
+void scatter_walls(midnight::TileMap& map)
+{
+    std::mt19937 random(7);
+    const std::span<midnight::PackedMapTile> tiles = map.layer(0);
+
+    for (std::size_t cell = 0; cell < tiles.size(); ++cell) {
+        const bool wall_row = (cell / map.columns()) % 2 == 1;
+        tiles[cell] = wall_row && random() % 2 == 0 ? kWallTile : 0;
+    }
+}
+
+// Small edits scattered over the map, cycling through the command kinds
+// the way a script or tool would issue them.
+std::vector<midnight::MapEditCommand> make_edit_batch(
+    const midnight::TileMap& map
+)
+{
+    using namespace midnight;
+
+    std::mt19937 random(11);
+    std::vector<MapEditCommand> commands;
+    commands.reserve(kEditorBatchSize);
+
+    for (std::size_t index = 0; index < kEditorBatchSize; ++index) {
+        const std::uint32_t column =
+            random() % std::max(map.columns() - 4, 1u);
+        const std::uint32_t row = random() % std::max(map.rows() - 4, 1u);
+        const MapCellRect area{
+            .left = column,
+            .top = row,
+            .right = std::min(column + 3, map.columns() - 1),
+            .bottom = std::min(row + 3, map.rows() - 1)
+        };
+
+        switch (index % 4) {
+            case 0:
+                commands.push_back(MapSetTileCommand{
+                    .layer = 0,
+                    .column = column,
+                    .row = row,
+                    .tile = kWallTile
+                });
+                break;
+
+            case 1:
+                commands.push_back(MapPaintStampCommand{
+                    .layer = 0,
+                    .area = area,
+                    .pattern = kPatternA
+                });
+                break;
+
+            case 2:
+                commands.push_back(MapFillRectCommand{
+                    .layer = 1,
+                    .area = area,
+                    .tile = kFillTile
+                });
+                break;
+
+            default:
+                commands.push_back(MapEraseCommand{
+                    .layer = 1,
+                    .area = MapCellRect{
+                        .left = column,
+                        .top = row,
+                        .right = std::min(column + 1, map.columns() - 1),
+                        .bottom = std::min(row + 1, map.rows() - 1)
+                    }
+                });
+                break;
+        }
+    }
+
+    return commands;
+}
+
+void benchmark_map_size(
+    midnight::BenchmarkHarness& harness,
+    midnight::JobSystem& jobs,
+    const MapSize size
+)
+{
+    using namespace midnight;
+
+    const std::string label =
+        std::to_string(size.columns) + "x" + std::to_string(size.rows);
+    const std::uint64_t cell_count =
+        static_cast<std::uint64_t>(size.columns) * size.rows;
+    TileMap map(size.columns, size.rows, kLayerCount);
+    std::vector<MapCellChange> changes;
+
+    if (harness.selected("flood_fill")) {
+        scatter_walls(map);
+
+        harness.run(
+            "flood_fill",
+            label,
+            cell_count,
+            [&] {
+                revert_map_changes(map, changes);
+                changes.clear();
+            },
+            [&] {
+                return flood_fill_map_tiles(map, 0, 0, 0, kFillTile, changes);
+            }
+        );
+
+        map.clear();
+        changes = {};
+    }
+
+    if (harness.selected("rectangle_paint")) {
+        bool pattern_a = false;
+
+        harness.run(
+            "rectangle_paint",
+            label,
+            cell_count,
+            [&] {
+                changes.clear();
+                pattern_a = !pattern_a;
+            },
+            [&] {
+                return paint_map_tile_pattern(
+                    map,
+                    0,
+                    whole_map(map),
+                    pattern_a ? kPatternA : kPatternB,
+                    changes
+                );
+            }
+        );
+
+        map.clear();
+        changes = {};
+    }
+
+    if (harness.selected("move_region")) {
+        (void)paint_map_tile_pattern(map, 0, whole_map(map), kPatternA, changes);
+        changes.clear();
+
+        // Half the map in each direction, moved one cell right and back
+        // again by the setup, like a held Ctrl+Arrow.
+        const MapCellRect area{
+            .left = size.columns / 4,
+            .top = size.rows / 4,
+            .right = size.columns / 4 + std::max(size.columns / 2, 1u) - 1,
+            .bottom = size.rows / 4 + std::max(size.rows / 2, 1u) - 1
+        };
+
+        harness.run(
+            "move_region",
+            label,
+            static_cast<std::uint64_t>(area.columns()) * area.rows(),
+            [&] {
+                revert_map_changes(map, changes);
+                changes.clear();
+            },
+            [&] {
+                return static_cast<std::uint64_t>(
+                    move_map_tiles(map, 0, area, 1, 0, changes)
+                ) + changes.size();
+            }
+        );
+
+        map.clear();
+        changes = {};
+    }
+
+    if (any_selected(harness, {"paste_region", "paste_transparent"})) {
+        (void)paint_map_tile_pattern(map, 0, whole_map(map), kPatternA, changes);
+        (void)paint_map_tile_pattern(map, 1, whole_map(map), kPatternB, changes);
+        changes.clear();
+
+        // A quarter of the map on both layers, pasted back one cell down
+        // and right of where it was copied from.
+        const TileMap region = copy_map_region(
+            map,
+            MapCellRect{
+                .left = 0,
+                .top = 0,
+                .right = std::max(size.columns / 2, 1u) - 1,
+                .bottom = std::max(size.rows / 2, 1u) - 1
+            }
+        );
+
+        harness.run(
+            "paste_region",
+            label,
+            static_cast<std::uint64_t>(region.cell_count()) * kLayerCount,
+            [&] {
+                revert_map_changes(map, changes);
+                changes.clear();
+            },
+            [&] {
+                return paste_map_region(
+                    map,
+                    region,
+                    std::min(1u, size.columns - 1),
+                    std::min(1u, size.rows - 1),
+                    changes
+                );
+            }
+        );
+
+        // The same region with every third cell empty, like a stamp cut
+        // around irregular art.
+        TileMap stamp = copy_map_region(map, whole_map(region));
+
+        for (std::size_t layer = 0; layer < kLayerCount; ++layer) {
+            const std::span<PackedMapTile> tiles = stamp.layer(layer);
+
+            for (std::size_t cell = 0; cell < tiles.size(); cell += 3) {
+                tiles[cell] = 0;
+            }
+        }
+
+        harness.run(
+            "paste_transparent",
+            label,
+            static_cast<std::uint64_t>(stamp.cell_count()) * kLayerCount,
+            [&] {
+                revert_map_changes(map, changes);
+                changes.clear();
+            },
+            [&] {
+                return paste_map_region(
+                    map,
+                    stamp,
+                    std::min(1u, size.columns - 1),
+                    std::min(1u, size.rows - 1),
+                    changes,
+                    true
+                );
+            }
+        );
+
+        map.clear();
+        changes = {};
+    }
+
+    if (harness.selected("erase_area")) {
+        (void)paint_map_tile_pattern(map, 0, whole_map(map), kPatternA, changes);
+        changes.clear();
+
+        harness.run(
+            "erase_area",
+            label,
+            cell_count,
+            [&] {
+                revert_map_changes(map, changes);
+                changes.clear();
+            },
+            [&] {
+                return clear_map_tiles(map, 0, whole_map(map), changes);
+            }
+        );
+
+        map.clear();
+        changes = {};
+    }
+
+    // Diffing a loaded or generated map against the current one into an
+    // undo step.
+    if (harness.selected("map_diff")) {
+        (void)paint_map_tile_pattern(map, 0, whole_map(map), kPatternA, changes);
+        changes.clear();
+
+        TileMap source(size.columns, size.rows, kLayerCount);
+        (void)paint_map_tile_pattern(source, 0, whole_map(source), kPatternA, changes);
+        (void)fill_map_tiles(
+            source,
+            1,
+            MapCellRect{
+                .left = 0,
+                .top = 0,
+                .right = size.columns - 1,
+                .bottom = std::max(size.rows / 8, 1u) - 1
+            },
+            kFillTile,
+            changes
+        );
+        changes.clear();
+
+        harness.run(
+            "map_diff",
+            label,
+            cell_count * kLayerCount,
+            [&] {
+                revert_map_changes(map, changes);
+                changes.clear();
+            },
+            [&] {
+                return replace_map_tiles(map, source, changes);
+            }
+        );
+
+        map.clear();
+        changes = {};
+    }
+
+    if (any_selected(harness, {"span_fill", "span_compare", "span_blend"})) {
+        // Whole layers as single spans, so the kernels' loops dominate.
+        std::vector<PackedMapTile> tiles(cell_count, kFillTile);
+        const std::vector<PackedMapTile> same(cell_count, kFillTile);
+        std::vector<PackedMapTile> holes(cell_count, kWallTile);
+        bool wall = false;
+
+        for (std::size_t cell = 0; cell < holes.size(); cell += 3) {
+            holes[cell] = 0;
+        }
+
+        harness.run(
+            "span_fill",
+            label,
+            cell_count,
+            [&] {
+                wall = !wall;
+            },
+            [&] {
+                fill_map_tile_span(tiles, wall ? kWallTile : kFillTile);
+                return static_cast<std::uint64_t>(tiles.back());
+            }
+        );
+
+        std::ranges::fill(tiles, kFillTile);
+
+        harness.run(
+            "span_compare",
+            label,
+            cell_count,
+            [] {},
+            [&] {
+                return find_map_tile_span_difference(tiles, same) +
+                    find_map_tile_span_difference(tiles, kFillTile);
+            }
+        );
+
+        harness.run(
+            "span_blend",
+            label,
+            cell_count,
+            [&] {
+                std::ranges::fill(tiles, kFillTile);
+            },
+            [&] {
+                blend_map_tile_span(tiles, holes);
+                return static_cast<std::uint64_t>(tiles.back());
+            }
+        );
+    }
+
+    if (harness.selected("undo_redo")) {
+        (void)paint_map_tile_pattern(map, 0, whole_map(map), kPatternA, changes);
+        (void)paint_map_tile_pattern(map, 1, whole_map(map), kPatternB, changes);
+        coalesce_map_changes(changes);
+
+        harness.run(
+            "undo_redo",
+            label,
+            changes.size(),
+            [] {},
+            [&] {
+                revert_map_changes(map, changes);
+                apply_map_changes(map, changes);
+                return static_cast<std::uint64_t>(map.layer(0).front());
+            }
+        );
+
+        map.clear();
+        changes = {};
+    }
+
+    if (harness.selected("editor_batch")) {
+        MapEditor editor(size.columns, size.rows, kLayerCount);
+        const std::vector<MapEditCommand> commands =
+            make_edit_batch(editor.map());
+
+        // Each run executes the batch as one undo step; the setup undoes
+        // the previous run's step so every run edits the same map.
+        harness.run(
+            "editor_batch",
+            label,
+            commands.size(),
+            [&] {
+                (void)editor.undo();
+            },
+            [&] {
+                const MapEditStep* const step = editor.execute(commands);
+                return step != nullptr ? step->changes.size() : 0;
+            }
+        );
+    }
+
+    if (any_selected(harness, {"tile_index_build", "tile_find", "tile_replace"})) {
+        TileMap generated(size.columns, size.rows, kLayerCount);
+        generate_map(generated, kGeneratorSettings, &jobs);
+
+        if (harness.selected("tile_index_build")) {
+            MapTileIndex index(generated);
+
+            harness.run(
+                "tile_index_build",
+                label,
+                cell_count * kLayerCount,
+                [] {},
+                [&] {
+                    index.rebuild(generated, &jobs);
+                    return index.count(kFillTile);
+                }
+            );
+        }
+
+        MapEditor editor(size.columns, size.rows, kLayerCount);
+        editor.set_job_system(&jobs);
+        editor.restore(std::move(generated), {}, {});
+
+        std::vector<std::uint32_t> cells;
+
+        harness.run(
+            "tile_find",
+            label,
+            cell_count,
+            [&] {
+                cells.clear();
+            },
+            [&] {
+                return editor.tile_index().find(kWallTile, 1, cells);
+            }
+        );
+
+        // Every wall becomes ground as one undo step; the setup undoes the
+        // previous run's step so every run replaces the same walls.
+        const std::array<MapEditCommand, 1> replace_walls{
+            MapReplaceTileCommand{
+                .layer = 1,
+                .tile = kWallTile,
+                .replacement = kFillTile
+            }
+        };
+
+        harness.run(
+            "tile_replace",
+            label,
+            editor.tile_index().count(kWallTile),
+            [&] {
+                (void)editor.undo();
+            },
+            [&] {
+                const MapEditStep* const step = editor.execute(replace_walls);
+                return step != nullptr ? step->changes.size() : 0;
+            }
+        );
+    }
+
+    if (any_selected(harness, {"terrain_fill", "terrain_brush"})) {
+        const MapAutoTiler tiler(std::vector<MapTerrain>{
+            make_map_terrain_from_block("dirt", 3, 0),
+            make_map_terrain_from_block("water", 7, 3)
+        });
+        std::uint8_t terrain = 1;
+
+        // The whole map switching between two terrains, resolved by chunk
+        // on the job system.
+        harness.run(
+            "terrain_fill",
+            label,
+            cell_count,
+            [&] {
+                changes.clear();
+                terrain = terrain == 1 ? 2 : 1;
+            },
+            [&] {
+                return tiler.paint(map, 0, whole_map(map), terrain, changes, &jobs);
+            }
+        );
+
+        // A diagonal drag with a one-cell brush, each cell re-resolving its
+        // neighbourhood.
+        const std::uint32_t stroke_length = std::min(size.columns, size.rows);
+
+        harness.run(
+            "terrain_brush",
+            label,
+            stroke_length,
+            [&] {
+                changes.clear();
+                terrain = terrain == 1 ? 2 : 1;
+            },
+            [&] {
+                std::size_t changed_count = 0;
+
+                for (std::uint32_t cell = 0; cell < stroke_length; ++cell) {
+                    changed_count += tiler.paint(
+                        map,
+                        0,
+                        MapCellRect{
+                            .left = cell,
+                            .top = cell,
+                            .right = cell,
+                            .bottom = cell
+                        },
+                        terrain,
+                        changes,
+                        &jobs
+                    );
+                }
+
+                return changed_count;
+            }
+        );
+
+        map.clear();
+        changes = {};
+    }
+
+    if (any_selected(
+            harness,
+            {kGeneratorKinds[0].first,
+             kGeneratorKinds[1].first,
+             kGeneratorKinds[2].first}
+        )) {
+        for (const auto& [name, kind] : kGeneratorKinds) {
+            if (!harness.selected(name)) {
+                continue;
+            }
+
+            MapGeneratorSettings settings = kGeneratorSettings;
+            settings.kind = kind;
+
+            // Bands only split the work, so the serial and parallel runs
+            // have to agree tile for tile.
+            TileMap serial_map(size.columns, size.rows, kLayerCount);
+            generate_map(serial_map, settings);
+            generate_map(map, settings, &jobs);
+
+            if (map != serial_map) {
+                throw std::runtime_error(
+                    std::string(name) + " differs between serial and "
+                    "parallel runs at " + label
+                );
+            }
+
+            harness.run(
+                name,
+                label,
+                cell_count,
+                [&] {
+                    ++settings.seed;
+                },
+                [&] {
+                    generate_map(map, settings, &jobs);
+                    return map.layer(1)[map.cell_count() / 2];
+                }
+            );
+        }
+
+        map.clear();
+    }
+
+    if (any_selected(harness, {"minimap_full", "minimap_edit"})) {
+        generate_map(map, kGeneratorSettings, &jobs);
+
+        MapMinimap minimap(MapMinimap::CreateInfo{
+            .columns = size.columns,
+            .rows = size.rows
+        });
+        minimap.set_tile_colors(make_tile_colors());
+
+        harness.run(
+            "minimap_full",
+            label,
+            cell_count,
+            [&] {
+                minimap.mark_all_dirty();
+            },
+            [&] {
+                (void)minimap.refresh(map, &jobs);
+                return minimap.pixels()[minimap.pixels().size() / 2];
+            }
+        );
+
+        // A one-cell edit, as each brush stroke step makes, and the texel
+        // rectangle the editor would upload for it.
+        std::uint32_t edit = 0;
+
+        harness.run(
+            "minimap_edit",
+            label,
+            1,
+            [&] {
+                const std::uint32_t column = (edit * 7919) % size.columns;
+                const std::uint32_t row = (edit * 104'729) % size.rows;
+
+                map.layer(1)[map.cell_index(column, row)] =
+                    edit % 2 == 0 ? kWallTile : 0;
+                minimap.mark_cell_dirty(column, row);
+                ++edit;
+            },
+            [&] {
+                const std::optional<MapCellRect> texels =
+                    minimap.refresh(map, &jobs);
+                return texels ? texels->left + texels->top : 0u;
+            }
+        );
+
+        map.clear();
+    }
+
+    if (harness.selected("tile_vertices")) {
+        (void)paint_map_tile_pattern(map, 0, whole_map(map), kPatternA, changes);
+        changes = {};
+
+        // Every chunk of the map, copied out and meshed one at a time the
+        // way the editor's mesh jobs do.
+        std::vector<PackedMapTile> block(kChunkSize * kChunkSize);
+        std::vector<Vertex2D> vertices;
+        vertices.reserve(block.size() * 4);
+
+        harness.run(
+            "tile_vertices",
+            label,
+            cell_count,
+            [] {},
+            [&] {
+                std::uint64_t vertex_count = 0;
+
+                for (std::uint32_t row = 0; row < map.rows(); row += kChunkSize) {
+                    for (std::uint32_t column = 0;
+                         column < map.columns();
+                         column += kChunkSize) {
+                        map.copy_block(0, column, row, kChunkSize, kChunkSize, block);
+                        vertices.clear();
+                        append_map_chunk_vertices(
+                            kMeshLayout,
+                            block,
+                            kChunkSize,
+                            column,
+                            row,
+                            vertices
+                        );
+                        vertex_count += vertices.size();
+                    }
+                }
+
+                return vertex_count;
+            }
+        );
+
+        map.clear();
+    }
+
+    if (harness.selected("quad_indices")) {
+        // One quad per cell, in batches that fit 16-bit indices.
+        std::vector<std::uint16_t> indices(
+            static_cast<std::size_t>(kMaxQuadsPerIndexBatch) * 6
+        );
+
+        harness.run(
+            "quad_indices",
+            label,
+            cell_count,
+            [] {},
+            [&] {
+                std::uint64_t index_sum = 0;
+
+                for (std::uint64_t first_quad = 0;
+                     first_quad < cell_count;
+                     first_quad += kMaxQuadsPerIndexBatch) {
+                    const std::uint32_t quad_count =
+                        static_cast<std::uint32_t>(std::min<std::uint64_t>(
+                            kMaxQuadsPerIndexBatch,
+                            cell_count - first_quad
+                        ));
+                    std::size_t next_index = 0;
+
+                    for (std::uint32_t quad = 0; quad < quad_count; ++quad) {
+                        append_quad_indices(
+                            indices,
+                            next_index,
+                            static_cast<std::uint16_t>(quad * 4)
+                        );
+                    }
+
+                    index_sum += indices[next_index - 1];
+                }
+
+                return index_sum;
+            }
+        );
+    }
+}
+
+}
+
+// midnight_map_bench [--json FILE] [--filter NAME] [--max-size N]
+// [--runs N]. Map sizes above --max-size (the larger side) are skipped.
+int main(const int argc, char** argv)
+{
+    using namespace midnight;
+
+    try {
+        BenchmarkHarness::CreateInfo create_info{};
+        std::uint32_t max_size = 4096;
+
+        for (int index = 1; index < argc; ++index) {
+            const std::string_view argument = argv[index];
+
+            if (index + 1 >= argc) {
+                throw std::runtime_error(
+                    "Unknown or incomplete argument: " + std::string(argument)
+                );
+            }
+
+            const std::string value = argv[++index];
+
+            if (BenchmarkHarness::apply_option(create_info, argument, value)) {
+                continue;
+            }
+
+            if (argument == "--kernels") {
+                use_span_kernels(value);
+            } else if (argument == "--max-size") {
+                max_size = static_cast<std::uint32_t>(std::stoul(value));
+            } else {
+                throw std::runtime_error(
+                    "Unknown argument: " + std::string(argument)
+                );
+            }
+        }
+
+        std::cout << "[Midnight] Span kernels: "
+                  << map_tile_span_kernels_name(active_map_tile_span_kernels())
+                  << '\n';
+
+        BenchmarkHarness harness(create_info);
+        JobSystem jobs(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+
+        for (const MapSize size : kMapSizes) {
+            if (std::max(size.columns, size.rows) <= max_size) {
+                benchmark_map_size(harness, jobs, size);
+            }
+        }
+
+        harness.finish();
+    } catch (const std::exception& error) {
+        std::cerr << "[Midnight] Map benchmark failed: "
+                  << error.what()
+                  << '\n';
+        return 1;
+    }
+
+    return 0;
+}
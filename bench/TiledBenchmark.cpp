@@ -0,0 +1,339 @@
+#include "BenchmarkHarness.hpp"
+
+#include "midnight/core/Base64.hpp"
+#include "midnight/core/JobSystem.hpp"
+#include "midnight/map/TiledMap.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::uint32_t kMapWidth = 10'000;
+constexpr std::uint32_t kMapHeight = 10'000;
+constexpr std::uint32_t kLayerCount = 2;
+constexpr std::uint32_t kTilesetColumns = 12;
+constexpr std::uint32_t kTilesetTileCount = 96;
+
+midnight::TiledMap make_reference_map()
+{
+    midnight::TiledMap map{
+        .width = kMapWidth,
+        .height = kMapHeight,
+        .tile_width = 16,
+        .tile_height = 16,
+        .tilesets = {},
+        .layers = {}
+    };
+
+    midnight::TiledTileset& tileset = map.tilesets.emplace_back();
+    tileset.name = "outdoor_tileset";
+    tileset.tile_width = 16;
+    tileset.tile_height = 16;
+    tileset.tile_count = kTilesetTileCount;
+    tileset.columns = kTilesetColumns;
+    tileset.image_source = "outdoor_tileset.png";
+    tileset.image_width = 192;
+    tileset.image_height = 128;
+
+    std::mt19937 random(7);
+    std::uniform_int_distribution<std::uint32_t> gid(1, kTilesetTileCount);
+    std::uniform_int_distribution<std::uint32_t> run_length(1, 24);
+
+    for (std::uint32_t layer = 0; layer < kLayerCount; ++layer) {
+        midnight::TiledTileLayer& tile_layer = map.layers.emplace_back();
+        tile_layer.name = "Layer " + std::to_string(layer + 1);
+        tile_layer.gids.resize(static_cast<std::size_t>(kMapWidth) * kMapHeight);
+
+        // Runs of repeated tiles with sparse upper layers, roughly like
+        // painted terrain, so zlib sees realistic redundancy.
+        for (std::size_t index = 0; index < tile_layer.gids.size();) {
+            const std::size_t run_end = std::min(
+                index + run_length(random),
+                tile_layer.gids.size()
+            );
+            const std::uint32_t run_gid =
+                layer == 0 || random() % 4 == 0 ? gid(random) : 0;
+
+            std::fill(
+                tile_layer.gids.begin() + static_cast<std::ptrdiff_t>(index),
+                tile_layer.gids.begin() + static_cast<std::ptrdiff_t>(run_end),
+                run_gid
+            );
+            index = run_end;
+        }
+    }
+
+    return map;
+}
+
+void use_decode_kernels(const std::string_view name)
+{
+    using namespace midnight;
+
+    for (const Base64Kernels kernels : {
+             Base64Kernels::Scalar,
+             Base64Kernels::Sse41,
+             Base64Kernels::Avx2,
+             Base64Kernels::Neon
+         }) {
+        if (base64_kernels_name(kernels) != name) {
+            continue;
+        }
+
+        if (!use_base64_kernels(kernels)) {
+            throw std::runtime_error(
+                "This CPU cannot run the " + std::string(name) + " base64 kernels"
+            );
+        }
+
+        return;
+    }
+
+    throw std::runtime_error("Unknown base64 kernels: " + std::string(name));
+}
+
+// Decodes one reference layer, as a base64 Tiled layer stores it, with
+// every kernel set the CPU can run, then restores the active one.
+void benchmark_base64_decode(
+    midnight::BenchmarkHarness& harness,
+    const midnight::TiledMap& reference
+)
+{
+    using namespace midnight;
+
+    if (!harness.selected("base64_decode")) {
+        return;
+    }
+
+    const std::vector<std::uint32_t>& gids = reference.layers.front().gids;
+    const std::string text = encode_base64(std::as_bytes(std::span(gids)));
+    const std::string size =
+        std::to_string(reference.width) + "x" + std::to_string(reference.height);
+    std::vector<std::byte> decoded(gids.size() * sizeof(std::uint32_t));
+    const Base64Kernels active = active_base64_kernels();
+
+    for (const Base64Kernels kernels : {
+             Base64Kernels::Scalar,
+             Base64Kernels::Sse41,
+             Base64Kernels::Avx2,
+             Base64Kernels::Neon
+         }) {
+        if (!use_base64_kernels(kernels)) {
+            continue;
+        }
+
+        harness.run(
+            "base64_decode",
+            size + " " + std::string(base64_kernels_name(kernels)),
+            gids.size(),
+            [] {},
+            [&] {
+                return decode_base64(text, decoded);
+            }
+        );
+
+        if (std::memcmp(decoded.data(), gids.data(), decoded.size()) != 0) {
+            throw std::runtime_error(
+                std::string(base64_kernels_name(kernels)) +
+                " base64 kernels decoded a different layer"
+            );
+        }
+    }
+
+    use_base64_kernels(active);
+}
+
+// Times a serial and a job-system import of `path`, then checks the last
+// import of each against `expected` when there is one.
+void benchmark_import(
+    midnight::BenchmarkHarness& harness,
+    const std::filesystem::path& path,
+    midnight::JobSystem& jobs,
+    const midnight::TiledMap* expected
+)
+{
+    using namespace midnight;
+
+    const std::string label = path.filename().string();
+    TiledMap imported;
+
+    const auto import_with = [&](JobSystem* import_jobs) {
+        return [&, import_jobs] {
+            imported = import_tiled_map(path, import_jobs);
+
+            std::uint64_t gid_count = 0;
+
+            for (const TiledTileLayer& layer : imported.layers) {
+                gid_count += layer.gids.size();
+            }
+
+            return gid_count;
+        };
+    };
+
+    const auto check_import = [&] {
+        if (expected == nullptr) {
+            return;
+        }
+
+        bool matches = imported.layers.size() == expected->layers.size();
+
+        for (std::size_t layer = 0; matches && layer < expected->layers.size(); ++layer) {
+            matches = imported.layers[layer].gids == expected->layers[layer].gids;
+        }
+
+        if (!matches) {
+            throw std::runtime_error(label + " imported a different map");
+        }
+    };
+
+    // Files given on the command line are imported once untimed to learn
+    // how many tiles they hold.
+    const std::uint64_t tile_count = expected != nullptr
+        ? static_cast<std::uint64_t>(expected->width) * expected->height *
+              expected->layers.size()
+        : import_with(nullptr)();
+
+    if (harness.selected("tiled_import_serial")) {
+        harness.run("tiled_import_serial", label, tile_count, [] {}, import_with(nullptr));
+        check_import();
+    }
+
+    if (harness.selected("tiled_import_jobs")) {
+        harness.run("tiled_import_jobs", label, tile_count, [] {}, import_with(&jobs));
+        check_import();
+    }
+}
+
+}
+
+// midnight_tiled_bench [--json FILE] [--filter NAME] [--runs N]
+//                      [--base64-kernels scalar|sse4.1|avx2|neon] [FILE...]
+// Decodes a generated 10k x 10k reference layer with every base64 kernel,
+// exports and imports the map in every supported encoding, then imports any
+// Tiled files given. Imports use the --base64-kernels set, or the best one.
+int main(const int argc, char** argv)
+{
+    using namespace midnight;
+
+    try {
+        // Each run moves hundreds of megabytes, so a few runs are enough.
+        BenchmarkHarness::CreateInfo create_info{
+            .warmup_runs = 1,
+            .min_runs = 3,
+            .max_runs = 10,
+            .time_budget = std::chrono::milliseconds{5000},
+            .filter = {},
+            .json_path = {}
+        };
+        std::vector<std::filesystem::path> paths;
+
+        for (int index = 1; index < argc; ++index) {
+            const std::string_view argument = argv[index];
+
+            if (!argument.starts_with("--")) {
+                paths.emplace_back(argument);
+                continue;
+            }
+
+            if (index + 1 >= argc) {
+                throw std::runtime_error(
+                    "Unknown or incomplete argument: " + std::string(argument)
+                );
+            }
+
+            const std::string value = argv[++index];
+
+            if (BenchmarkHarness::apply_option(create_info, argument, value)) {
+                continue;
+            }
+
+            if (argument == "--base64-kernels") {
+                use_decode_kernels(value);
+            } else {
+                throw std::runtime_error(
+                    "Unknown argument: " + std::string(argument)
+                );
+            }
+        }
+
+        std::cout << "[Midnight] Base64 kernels: "
+                  << base64_kernels_name(active_base64_kernels())
+                  << '\n';
+
+        BenchmarkHarness harness(create_info);
+        JobSystem jobs(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+        const std::filesystem::path directory =
+            std::filesystem::temp_directory_path() / "midnight_tiled_bench";
+        std::filesystem::create_directories(directory);
+
+        const TiledMap reference = make_reference_map();
+        const std::uint64_t reference_tile_count =
+            static_cast<std::uint64_t>(kMapWidth) * kMapHeight * kLayerCount;
+
+        benchmark_base64_decode(harness, reference);
+
+        struct ReferenceFile final {
+            const char* name;
+            TiledDataEncoding encoding;
+        };
+
+        constexpr ReferenceFile kReferenceFiles[] = {
+            {"reference_csv.tmx", TiledDataEncoding::Csv},
+            {"reference_base64.tmx", TiledDataEncoding::Base64},
+            {"reference_zlib.tmx", TiledDataEncoding::Base64Zlib},
+            {"reference_csv.tmj", TiledDataEncoding::Csv},
+            {"reference_base64.tmj", TiledDataEncoding::Base64},
+            {"reference_zlib.tmj", TiledDataEncoding::Base64Zlib}
+        };
+
+        for (const ReferenceFile& file : kReferenceFiles) {
+            const std::filesystem::path path = directory / file.name;
+
+            harness.run(
+                "tiled_export",
+                file.name,
+                reference_tile_count,
+                [] {},
+                [&] {
+                    export_tiled_map(path, reference, file.encoding);
+                    return std::filesystem::file_size(path);
+                }
+            );
+
+            if (!std::filesystem::exists(path)) {
+                export_tiled_map(path, reference, file.encoding);
+            }
+
+            benchmark_import(harness, path, jobs, &reference);
+            std::filesystem::remove(path);
+        }
+
+        for (const std::filesystem::path& path : paths) {
+            benchmark_import(harness, path, jobs, nullptr);
+        }
+
+        harness.finish();
+    } catch (const std::exception& error) {
+        std::cerr << "[Midnight] Tiled benchmark failed: "
+                  << error.what()
+                  << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,15 +1,75 @@
 #include "midnight/core/Application.hpp"
+#include "midnight/core/Log.hpp"
 
 #include <exception>
-#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 
-int main()
+namespace {
+
+// midnight [--record FILE | --replay FILE [--max-speed] [--bench]]
+//          [--threaded-simulation]
+midnight::Application::CreateInfo parse_arguments(
+    const int argc,
+    char** argv
+)
+{
+    midnight::Application::CreateInfo create_info{};
+
+    for (int index = 1; index < argc; ++index) {
+        const std::string_view argument = argv[index];
+
+        const auto path_argument = [&]() -> std::string {
+            if (index + 1 >= argc) {
+                throw std::runtime_error(
+                    std::string(argument) + " needs a file path"
+                );
+            }
+
+            return argv[++index];
+        };
+
+        if (argument == "--record") {
+            create_info.record_input_path = path_argument();
+        } else if (argument == "--replay") {
+            create_info.replay_input_path = path_argument();
+        } else if (argument == "--max-speed") {
+            create_info.replay_at_max_speed = true;
+        } else if (argument == "--bench") {
+            create_info.benchmark = true;
+        } else if (argument == "--threaded-simulation") {
+            create_info.threaded_simulation = true;
+        } else {
+            throw std::runtime_error(
+                "Unknown argument: " + std::string(argument)
+            );
+        }
+    }
+
+    if (!create_info.record_input_path.empty() &&
+        !create_info.replay_input_path.empty()) {
+        throw std::runtime_error("--record and --replay cannot be combined");
+    }
+
+    if (create_info.replay_input_path.empty() &&
+        (create_info.replay_at_max_speed || create_info.benchmark)) {
+        throw std::runtime_error("--max-speed and --bench need --replay");
+    }
+
+    return create_info;
+}
+
+}
+
+int main(int argc, char** argv)
 {
     try {
-        midnight::Application app;
+        midnight::Application app(parse_arguments(argc, argv));
         return app.run();
     } catch (const std::exception& error) {
-        std::cerr << "[Midnight] Fatal error: " << error.what() << '\n';
+        MIDNIGHT_LOG_ERROR(Core, "Fatal error: {}", error.what());
+        midnight::Logger::instance().flush();
         return 1;
     }
 }
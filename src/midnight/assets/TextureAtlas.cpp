@@ -0,0 +1,258 @@
+#include "midnight/assets/TextureAtlas.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+namespace midnight {
+namespace {
+
+constexpr std::size_t kBytesPerPixel = RgbaImage::bytes_per_pixel;
+
+float srgb_to_linear(const float value) noexcept
+{
+    return value <= 0.04045f
+        ? value / 12.92f
+        : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+std::uint8_t linear_to_srgb_byte(const float value) noexcept
+{
+    const float clamped = std::clamp(value, 0.0f, 1.0f);
+    const float encoded = clamped <= 0.0031308f
+        ? clamped * 12.92f
+        : 1.055f * std::pow(clamped, 1.0f / 2.4f) - 0.055f;
+
+    return static_cast<std::uint8_t>(std::lround(encoded * 255.0f));
+}
+
+const std::array<float, 256>& srgb_to_linear_table()
+{
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> values{};
+
+        for (std::size_t index = 0; index < values.size(); ++index) {
+            values[index] =
+                srgb_to_linear(static_cast<float>(index) / 255.0f);
+        }
+
+        return values;
+    }();
+
+    return table;
+}
+
+std::size_t pixel_offset(
+    const std::uint32_t width,
+    const std::uint32_t x,
+    const std::uint32_t y
+) noexcept
+{
+    return (static_cast<std::size_t>(y) * width + x) * kBytesPerPixel;
+}
+
+// Averages the width x height block at (left, top) in linear light,
+// weighted by alpha, into `destination`.
+void average_block(
+    const RgbaImage& source,
+    const std::uint32_t left,
+    const std::uint32_t top,
+    const std::uint32_t width,
+    const std::uint32_t height,
+    std::uint8_t* const destination
+)
+{
+    const std::array<float, 256>& to_linear = srgb_to_linear_table();
+    const float texel_count = static_cast<float>(width * height);
+
+    std::array<float, 3> weighted{};
+    std::array<float, 3> unweighted{};
+    float alpha_sum = 0.0f;
+
+    for (std::uint32_t y = top; y < top + height; ++y) {
+        for (std::uint32_t x = left; x < left + width; ++x) {
+            const std::uint8_t* texel =
+                source.pixels.data() + pixel_offset(source.width, x, y);
+            const float alpha = static_cast<float>(texel[3]) / 255.0f;
+
+            for (std::size_t channel = 0; channel < 3; ++channel) {
+                const float linear = to_linear[texel[channel]];
+                weighted[channel] += linear * alpha;
+                unweighted[channel] += linear;
+            }
+
+            alpha_sum += alpha;
+        }
+    }
+
+    for (std::size_t channel = 0; channel < 3; ++channel) {
+        // Fully transparent blocks keep their plain average so a later mip
+        // that mixes them in still has a sensible colour.
+        destination[channel] = linear_to_srgb_byte(
+            alpha_sum > 0.0f
+                ? weighted[channel] / alpha_sum
+                : unweighted[channel] / texel_count
+        );
+    }
+
+    destination[3] = static_cast<std::uint8_t>(
+        std::lround(alpha_sum / texel_count * 255.0f)
+    );
+}
+
+RgbaImage halve(const RgbaImage& source)
+{
+    RgbaImage result{};
+    result.width = source.width / 2;
+    result.height = source.height / 2;
+    result.pixels.resize(
+        static_cast<std::size_t>(result.width) * result.height * kBytesPerPixel
+    );
+
+    for (std::uint32_t y = 0; y < result.height; ++y) {
+        for (std::uint32_t x = 0; x < result.width; ++x) {
+            average_block(
+                source,
+                x * 2,
+                y * 2,
+                2,
+                2,
+                result.pixels.data() + pixel_offset(result.width, x, y)
+            );
+        }
+    }
+
+    return result;
+}
+
+}
+
+RgbaImage extrude_atlas_tiles(
+    const RgbaImage& atlas,
+    const std::uint32_t tile_width,
+    const std::uint32_t tile_height,
+    const std::uint32_t padding
+)
+{
+    if (tile_width == 0 || tile_height == 0 ||
+        atlas.width % tile_width != 0 ||
+        atlas.height % tile_height != 0) {
+        throw std::runtime_error("Atlas dimensions must be a multiple of the tile size");
+    }
+
+    if (atlas.pixels.size() !=
+        static_cast<std::size_t>(atlas.width) * atlas.height * kBytesPerPixel) {
+        throw std::runtime_error("Atlas pixel data does not match its dimensions");
+    }
+
+    const std::uint32_t columns = atlas.width / tile_width;
+    const std::uint32_t rows = atlas.height / tile_height;
+    const std::uint32_t cell_width = tile_width + padding * 2;
+    const std::uint32_t cell_height = tile_height + padding * 2;
+
+    RgbaImage result{};
+    result.width = columns * cell_width;
+    result.height = rows * cell_height;
+    result.pixels.resize(
+        static_cast<std::size_t>(result.width) * result.height * kBytesPerPixel
+    );
+
+    for (std::uint32_t y = 0; y < result.height; ++y) {
+        const std::uint32_t row = y / cell_height;
+        const std::uint32_t cell_y = y % cell_height;
+        const std::uint32_t source_y = row * tile_height + std::min(
+            cell_y > padding ? cell_y - padding : 0,
+            tile_height - 1
+        );
+
+        for (std::uint32_t x = 0; x < result.width; ++x) {
+            const std::uint32_t column = x / cell_width;
+            const std::uint32_t cell_x = x % cell_width;
+            const std::uint32_t source_x = column * tile_width + std::min(
+                cell_x > padding ? cell_x - padding : 0,
+                tile_width - 1
+            );
+
+            std::memcpy(
+                result.pixels.data() + pixel_offset(result.width, x, y),
+                atlas.pixels.data() + pixel_offset(atlas.width, source_x, source_y),
+                kBytesPerPixel
+            );
+        }
+    }
+
+    return result;
+}
+
+RgbaImage average_atlas_tile_colors(
+    const RgbaImage& atlas,
+    const std::uint32_t tile_width,
+    const std::uint32_t tile_height
+)
+{
+    if (tile_width == 0 || tile_height == 0 ||
+        atlas.width % tile_width != 0 ||
+        atlas.height % tile_height != 0) {
+        throw std::runtime_error("Atlas dimensions must be a multiple of the tile size");
+    }
+
+    if (atlas.pixels.size() !=
+        static_cast<std::size_t>(atlas.width) * atlas.height * kBytesPerPixel) {
+        throw std::runtime_error("Atlas pixel data does not match its dimensions");
+    }
+
+    RgbaImage result{};
+    result.width = atlas.width / tile_width;
+    result.height = atlas.height / tile_height;
+    result.pixels.resize(
+        static_cast<std::size_t>(result.width) * result.height * kBytesPerPixel
+    );
+
+    for (std::uint32_t row = 0; row < result.height; ++row) {
+        for (std::uint32_t column = 0; column < result.width; ++column) {
+            average_block(
+                atlas,
+                column * tile_width,
+                row * tile_height,
+                tile_width,
+                tile_height,
+                result.pixels.data() + pixel_offset(result.width, column, row)
+            );
+        }
+    }
+
+    return result;
+}
+
+std::vector<RgbaImage> build_srgb_mip_chain(
+    const RgbaImage& base,
+    const std::uint32_t level_count
+)
+{
+    if (level_count == 0 || level_count > 32) {
+        throw std::runtime_error("Mip chain needs between 1 and 32 levels");
+    }
+
+    const std::uint32_t divisor = 1u << (level_count - 1);
+
+    if (base.width == 0 || base.height == 0 ||
+        base.width % divisor != 0 ||
+        base.height % divisor != 0) {
+        throw std::runtime_error("Image dimensions cannot be halved for every mip level");
+    }
+
+    std::vector<RgbaImage> levels;
+    levels.reserve(level_count);
+    levels.push_back(base);
+
+    while (levels.size() < level_count) {
+        levels.push_back(halve(levels.back()));
+    }
+
+    return levels;
+}
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "midnight/assets/RgbaImage.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace midnight {
+
+// Copies every tile of a tightly packed atlas into its own cell with
+// `padding` pixels of extruded edge on each side, so filtering and smaller
+// mips never reach into a neighbouring tile.
+[[nodiscard]] RgbaImage extrude_atlas_tiles(
+    const RgbaImage& atlas,
+    std::uint32_t tile_width,
+    std::uint32_t tile_height,
+    std::uint32_t padding
+);
+
+// Number of mips, base included, that keep every cell of the given size
+// in its own texels.
+[[nodiscard]] constexpr std::uint32_t isolated_mip_level_count(
+    const std::uint32_t cell_width,
+    const std::uint32_t cell_height
+) noexcept
+{
+    if (cell_width == 0 || cell_height == 0) {
+        return 1;
+    }
+
+    return static_cast<std::uint32_t>(
+        std::min(std::countr_zero(cell_width), std::countr_zero(cell_height))
+    ) + 1;
+}
+
+// One texel per tile of a tightly packed atlas, holding the tile's average
+// colour, blended the same way as the mips below.
+[[nodiscard]] RgbaImage average_atlas_tile_colors(
+    const RgbaImage& atlas,
+    std::uint32_t tile_width,
+    std::uint32_t tile_height
+);
+
+// Halves `base` level_count - 1 times with a 2x2 box filter. Colour is
+// averaged in linear light and weighted by alpha so transparent texels do
+// not darken edges. Both dimensions must be divisible by
+// 2^(level_count - 1).
+[[nodiscard]] std::vector<RgbaImage> build_srgb_mip_chain(
+    const RgbaImage& base,
+    std::uint32_t level_count
+);
+
+}
@@ -1,18 +1,31 @@
 #include "midnight/core/Application.hpp"
 
 #include "midnight/assets/Png.hpp"
+#include "midnight/assets/TextureAtlas.hpp"
+#include "midnight/core/Log.hpp"
+#include "midnight/ecs/SpriteComponents.hpp"
+#include "midnight/ecs/SpriteSystems.hpp"
+#include "midnight/map/MapMesh.hpp"
+#include "midnight/map/MapTileSpans.hpp"
+#include "midnight/map/TiledMap.hpp"
 #include "midnight/renderer/Vertex2D.hpp"
 
 #include <SDL3/SDL.h>
 
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
-#include <iostream>
 #include <limits>
+#include <memory_resource>
+#include <numbers>
+#include <optional>
+#include <span>
 #include <stdexcept>
+#include <thread>
 #include <utility>
 
 namespace midnight {
@@ -29,6 +42,7 @@ constexpr std::uint32_t kOutdoorTilesetColumns =
 constexpr std::uint32_t kOutdoorTilesetRows =
     kOutdoorTilesetHeight / kTilesetTileHeight;
 constexpr std::uint32_t kTilesetPreviewScale = 2;
+constexpr std::uint32_t kMapAtlasTilePadding = 8;
 constexpr std::uint32_t kInitialSelectedTileColumn = 1;
 constexpr std::uint32_t kInitialSelectedTileRow = 0;
 constexpr std::uint32_t kSelectedRegionPreviewMaxScale = 3;
@@ -37,28 +51,129 @@ constexpr std::uint32_t kSelectedRegionPreviewMaxHeight = 256;
 constexpr std::uint32_t kMapCanvasColumns = 16;
 constexpr std::uint32_t kMapCanvasRows = 12;
 constexpr std::uint32_t kMapCanvasScale = 2;
+constexpr std::uint32_t kMapNavigationChunkSize = 8;
+constexpr std::size_t kMapFlowFieldCacheCapacity = 8;
+constexpr std::size_t kMaxMapSpriteCount = 512;
+constexpr std::size_t kMapSpriteSpawnCount = 32;
+constexpr float kMapSpriteMinSpeed = 1.0f;
+constexpr float kMapSpriteMaxSpeed = 4.0f;
+constexpr std::uint32_t kMapSpriteGridBucketSize = 1;
+constexpr float kMapSpriteOverlapDistance = 1.0f;
+
+constexpr std::uint32_t kMapFileChunkSize = 8;
+constexpr std::uint32_t kMapRenderChunkSize = 8;
+constexpr std::size_t kMapChunkMeshSlotsPerMesh = 3;
+constexpr const char* kMapFileName = "map.mdmap";
+constexpr const char* kTiledMapFileName = "map.tmx";
+constexpr const char* kMapJournalFileName = "map.journal";
+constexpr const char* kMapSnapshotFileName = "map.autosave";
+constexpr std::size_t kMapJournalCompactionInterval = 128;
+constexpr std::size_t kMapStampSlotCount = 4;
+// Grass, the centre of the pond block and the cobbled stone wall.
+constexpr PackedMapTile kGeneratedGroundTile = pack_map_tile(1, 0, true);
+constexpr PackedMapTile kGeneratedWaterTile = pack_map_tile(8, 4, true);
+constexpr PackedMapTile kGeneratedWallTile = pack_map_tile(1, 5, true);
+// Leads the autosave snapshot; format 1 stored whole-map undo snapshots
+// and began directly with the canvas width.
+constexpr std::uint32_t kMapHistoryFormat = 2;
+
+constexpr std::size_t kFrameArenaBlockSize = 256 * 1024;
+
+constexpr std::uint32_t kSimulationTicksPerSecond = 60;
+constexpr std::uint32_t kSimulationMaxStepsPerUpdate = 5;
 constexpr std::uint64_t kSwapchainResizeSettleMilliseconds = 250;
 constexpr std::size_t kMapCanvasCellCount =
     static_cast<std::size_t>(kMapCanvasColumns) *
     static_cast<std::size_t>(kMapCanvasRows);
+constexpr std::uint32_t kMapFileChunkColumns =
+    (kMapCanvasColumns + kMapFileChunkSize - 1) / kMapFileChunkSize;
+constexpr std::uint32_t kMapFileChunkRows =
+    (kMapCanvasRows + kMapFileChunkSize - 1) / kMapFileChunkSize;
+constexpr std::size_t kMapFileChunkCount =
+    static_cast<std::size_t>(kMapFileChunkColumns) *
+    static_cast<std::size_t>(kMapFileChunkRows);
+constexpr std::uint32_t kMapRenderChunkColumns =
+    (kMapCanvasColumns + kMapRenderChunkSize - 1) / kMapRenderChunkSize;
+constexpr std::uint32_t kMapRenderChunkRows =
+    (kMapCanvasRows + kMapRenderChunkSize - 1) / kMapRenderChunkSize;
+constexpr std::size_t kMapRenderChunkCount =
+    static_cast<std::size_t>(kMapRenderChunkColumns) *
+    static_cast<std::size_t>(kMapRenderChunkRows);
+constexpr std::size_t kMapRenderChunkCellCount =
+    static_cast<std::size_t>(kMapRenderChunkSize) * kMapRenderChunkSize;
+constexpr std::size_t kMapChunkMeshCount =
+    kMapLayerCount * kMapRenderChunkCount;
 constexpr std::size_t kOutdoorTilesetByteSize =
     static_cast<std::size_t>(kOutdoorTilesetWidth) *
     static_cast<std::size_t>(kOutdoorTilesetHeight) *
     RgbaImage::bytes_per_pixel;
 
+constexpr std::uint32_t kMapAtlasCellWidth =
+    kTilesetTileWidth + kMapAtlasTilePadding * 2;
+constexpr std::uint32_t kMapAtlasCellHeight =
+    kTilesetTileHeight + kMapAtlasTilePadding * 2;
+constexpr std::uint32_t kMapAtlasWidth =
+    kOutdoorTilesetColumns * kMapAtlasCellWidth;
+constexpr std::uint32_t kMapAtlasHeight =
+    kOutdoorTilesetRows * kMapAtlasCellHeight;
+constexpr std::uint32_t kMapAtlasMipLevels =
+    isolated_mip_level_count(kMapAtlasCellWidth, kMapAtlasCellHeight);
+
+constexpr std::uint32_t kMapMinimapMaxExtent = 256;
+constexpr std::uint32_t kMapMinimapCellsPerTexel =
+    MapMinimap::cells_per_texel(
+        kMapCanvasColumns,
+        kMapCanvasRows,
+        kMapMinimapMaxExtent
+    );
+constexpr std::uint32_t kMapMinimapWidth =
+    (kMapCanvasColumns + kMapMinimapCellsPerTexel - 1) /
+    kMapMinimapCellsPerTexel;
+constexpr std::uint32_t kMapMinimapHeight =
+    (kMapCanvasRows + kMapMinimapCellsPerTexel - 1) /
+    kMapMinimapCellsPerTexel;
+
 static_assert(kOutdoorTilesetWidth % kTilesetTileWidth == 0);
 static_assert(kOutdoorTilesetHeight % kTilesetTileHeight == 0);
+static_assert(kMapAtlasMipLevels > 1);
 static_assert(kMapLayerCount == 2);
 static_assert(kInitialSelectedTileColumn < kOutdoorTilesetColumns);
 static_assert(kInitialSelectedTileRow < kOutdoorTilesetRows);
 static_assert(kSelectedRegionPreviewMaxWidth >= kOutdoorTilesetWidth);
 static_assert(kSelectedRegionPreviewMaxHeight >= kOutdoorTilesetHeight);
+static_assert(kMapMinimapWidth <= kMapMinimapMaxExtent);
+static_assert(kMapMinimapHeight <= kMapMinimapMaxExtent);
+
+enum class MapJournalRecord : std::uint8_t {
+    Edit,
+    Undo,
+    Redo
+};
 
 constexpr std::size_t map_layer_index(const MapLayer layer)
 {
     return static_cast<std::size_t>(layer);
 }
 
+// Unoccupied tiles read back as 0, the only form TileMap stores them in.
+PackedMapTile read_map_history_tile(ByteReader& reader)
+{
+    const PackedMapTile tile = reader.read_u32();
+
+    if (!packed_map_tile_occupied(tile)) {
+        return 0;
+    }
+
+    if (packed_map_tile_column(tile) >= kOutdoorTilesetColumns ||
+        packed_map_tile_row(tile) >= kOutdoorTilesetRows) {
+        throw std::runtime_error(
+            "Map history references a tile outside the tileset"
+        );
+    }
+
+    return tile;
+}
+
 struct TextureRegion final {
     float left = 0.0f;
     float top = 0.0f;
@@ -148,6 +263,45 @@ constexpr float kMapCanvasCellHeight =
     (2.0f * kMapCanvasHalfHeight) /
     static_cast<float>(kMapCanvasRows);
 
+// The minimap sits in the top right corner at a whole number of pixels per
+// texel, its longer side at most kMapMinimapMaxPixels.
+constexpr std::uint32_t kMapMinimapMaxPixels = 128;
+constexpr std::uint32_t kMapMinimapScale =
+    kMapMinimapMaxPixels / std::max(kMapMinimapWidth, kMapMinimapHeight);
+constexpr float kMapMinimapRight = 0.98f;
+constexpr float kMapMinimapTop = -0.95f;
+constexpr float kMapMinimapLeft =
+    kMapMinimapRight -
+    static_cast<float>(2 * kMapMinimapWidth * kMapMinimapScale) /
+        static_cast<float>(kInitialWindowWidth);
+constexpr float kMapMinimapBottom =
+    kMapMinimapTop +
+    static_cast<float>(2 * kMapMinimapHeight * kMapMinimapScale) /
+        static_cast<float>(kInitialWindowHeight);
+
+constexpr SpriteRenderLayout kMapSpriteRenderLayout{
+    .left = kMapCanvasLeft,
+    .top = kMapCanvasTop,
+    .cell_width = kMapCanvasCellWidth,
+    .cell_height = kMapCanvasCellHeight,
+    .atlas_columns = kOutdoorTilesetColumns,
+    .atlas_rows = kOutdoorTilesetRows
+};
+
+// The map draws from the padded atlas, whose cells carry extruded tile
+// edges so linear filtering and the smaller mips stay inside the tile.
+constexpr MapMeshLayout kMapMeshLayout{
+    .left = kMapCanvasLeft,
+    .top = kMapCanvasTop,
+    .cell_width = kMapCanvasCellWidth,
+    .cell_height = kMapCanvasCellHeight,
+    .tile_width = kTilesetTileWidth,
+    .tile_height = kTilesetTileHeight,
+    .atlas_width = kMapAtlasWidth,
+    .atlas_height = kMapAtlasHeight,
+    .atlas_tile_padding = kMapAtlasTilePadding
+};
+
 static_assert(kTilesetPreviewLeft >= -1.0f);
 static_assert(kTilesetPreviewTop >= -1.0f);
 static_assert(kTilesetPreviewRight <= 1.0f);
@@ -173,6 +327,9 @@ static_assert(
         kSelectedRegionPreviewMaxHalfHeight <= 1.0f
 );
 static_assert(kTilesetPreviewRight < kMapCanvasLeft);
+static_assert(kMapMinimapScale >= 1);
+static_assert(kMapMinimapBottom <= 1.0f);
+static_assert(kMapCanvasRight < kMapMinimapLeft);
 static_assert(
     kTilesetPreviewBottom <
         kSelectedRegionPreviewCenterY -
@@ -207,6 +364,8 @@ constexpr float kTilesetGridBlue = 0.32f;
 constexpr float kMapCanvasRed = 0.06f;
 constexpr float kMapCanvasGreen = 0.075f;
 constexpr float kMapCanvasBlue = 0.12f;
+// The canvas colour above, sRGB-encoded like the minimap texture.
+constexpr std::array<std::uint8_t, 4> kMapMinimapBackground{69, 77, 97, 255};
 constexpr float kMapGridRed = 0.24f;
 constexpr float kMapGridGreen = 0.27f;
 constexpr float kMapGridBlue = 0.38f;
@@ -555,72 +714,6 @@ static_assert(
     kMapCanvasBackgroundVertexCount + kMapGridVertexCount
 );
 
-using MapTileCellVertices = std::array<Vertex2D, 4>;
-
-constexpr MapTileCellVertices make_map_tile_vertices(
-    const std::uint32_t map_column,
-    const std::uint32_t map_row,
-    const std::uint32_t tileset_column,
-    const std::uint32_t tileset_row
-)
-{
-    const float left =
-        kMapCanvasLeft +
-        static_cast<float>(map_column) * kMapCanvasCellWidth;
-    const float top =
-        kMapCanvasTop +
-        static_cast<float>(map_row) * kMapCanvasCellHeight;
-    const float right = left + kMapCanvasCellWidth;
-    const float bottom = top + kMapCanvasCellHeight;
-    const TextureRegion texture_region =
-        tile_texture_region(
-            tileset_column,
-            tileset_row,
-            tileset_column,
-            tileset_row
-        );
-
-    return {{
-        Vertex2D{
-            left, top,
-            1.0f, 1.0f, 1.0f,
-            texture_region.left,
-            texture_region.top
-        },
-        Vertex2D{
-            right, top,
-            1.0f, 1.0f, 1.0f,
-            texture_region.right,
-            texture_region.top
-        },
-        Vertex2D{
-            right, bottom,
-            1.0f, 1.0f, 1.0f,
-            texture_region.right,
-            texture_region.bottom
-        },
-        Vertex2D{
-            left, bottom,
-            1.0f, 1.0f, 1.0f,
-            texture_region.left,
-            texture_region.bottom
-        }
-    }};
-}
-
-constexpr MapTileCellVertices kEmptyMapTileCellVertices{};
-
-constexpr std::size_t kMapTileLayerVertexCount =
-    kMapCanvasCellCount * MapTileCellVertices{}.size();
-
-constexpr std::size_t kMapTileVertexCount =
-    kMapLayerCount * kMapTileLayerVertexCount;
-
-using MapTileVertices =
-    std::array<Vertex2D, kMapTileVertexCount>;
-
-constexpr MapTileVertices kEmptyMapTileVertices{};
-
 constexpr std::size_t kMapHoverVertexCount = 8;
 
 using MapHoverVertices =
@@ -841,14 +934,28 @@ make_tile_selection_vertices(
     }};
 }
 
+constexpr std::size_t kMapSpriteVertexCount = kMaxMapSpriteCount * 4;
+
+// Each frame in flight keeps its own copy of the sprite vertices.
+constexpr std::size_t kMapSpriteVertexRegionCount =
+    VulkanFrameRenderer::kSpriteVertexRegionCount;
+
+constexpr std::array<Vertex2D, 4> kMapMinimapVertices{{
+    Vertex2D{kMapMinimapLeft,  kMapMinimapTop,    1.0f, 1.0f, 1.0f, 0.0f, 0.0f},
+    Vertex2D{kMapMinimapRight, kMapMinimapTop,    1.0f, 1.0f, 1.0f, 1.0f, 0.0f},
+    Vertex2D{kMapMinimapRight, kMapMinimapBottom, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f},
+    Vertex2D{kMapMinimapLeft,  kMapMinimapBottom, 1.0f, 1.0f, 1.0f, 0.0f, 1.0f}
+}};
+
 constexpr std::size_t kQuadVertexCount =
     kTilesetPreviewVertices.size() +
     kTilesetGridVertices.size() +
     kMapCanvasVertices.size() +
     kTileSelectionVertexCount +
     kMapHoverVertexCount +
-    kMapTileVertexCount +
-    kMapAreaSelectionVertexCount;
+    kMapAreaSelectionVertexCount +
+    kMapSpriteVertexCount * kMapSpriteVertexRegionCount +
+    kMapMinimapVertices.size();
 
 static_assert(
     kQuadVertexCount <=
@@ -877,78 +984,49 @@ constexpr std::size_t kMapHoverVertexByteOffset =
     kTileSelectionVertexByteOffset +
     sizeof(Vertex2D) * kTileSelectionVertexCount;
 
-constexpr std::size_t kMapTileVertexByteOffset =
+constexpr std::size_t kMapAreaSelectionVertexByteOffset =
     kMapHoverVertexByteOffset +
     sizeof(Vertex2D) * kMapHoverVertexCount;
 
-constexpr std::size_t kMapAreaSelectionVertexByteOffset =
-    kMapTileVertexByteOffset +
-    sizeof(Vertex2D) * kMapTileVertexCount;
+constexpr std::size_t kMapSpriteVertexByteOffset =
+    kMapAreaSelectionVertexByteOffset +
+    sizeof(Vertex2D) * kMapAreaSelectionVertexCount;
+
+constexpr std::size_t kMapSpriteVertexRegionByteSize =
+    sizeof(Vertex2D) * kMapSpriteVertexCount;
+
+constexpr std::size_t kMapMinimapVertexByteOffset =
+    kMapSpriteVertexByteOffset +
+    kMapSpriteVertexRegionByteSize * kMapSpriteVertexRegionCount;
 
 constexpr std::size_t kQuadIndexCount =
     (
         1 +
         kTilesetGridLineCount +
         kMapCanvasQuadCount +
-        kMapLayerCount * kMapCanvasCellCount +
+        kMaxMapSpriteCount +
         1 +
         4 +
         4 +
-        4
+        4 +
+        1
     ) * 6;
 
-using QuadIndices = std::array<std::uint16_t, kQuadIndexCount>;
+// Map tiles are drawn from chunk meshes spliced into the index stream
+// right after the tileset preview, its grid and the canvas background.
+constexpr std::size_t kMapChunkMeshFirstIndex =
+    (1 + kTilesetGridLineCount + 1) * 6;
 
-constexpr void append_quad_indices(
-    QuadIndices& indices,
-    std::size_t& next_index,
-    const std::uint16_t first_vertex
-)
-{
-    indices[next_index++] = first_vertex;
-    indices[next_index++] = first_vertex + 1;
-    indices[next_index++] = first_vertex + 2;
-    indices[next_index++] = first_vertex + 2;
-    indices[next_index++] = first_vertex + 3;
-    indices[next_index++] = first_vertex;
-}
+// Sprite quads follow the canvas quads and index the first sprite region.
+constexpr std::size_t kMapSpriteFirstIndex =
+    (1 + kTilesetGridLineCount + kMapCanvasQuadCount) * 6;
 
-constexpr void append_outline_indices(
-    QuadIndices& indices,
-    std::size_t& next_index,
-    const std::uint16_t outer
-)
-{
-    const std::uint16_t inner = outer + 4;
-
-    indices[next_index++] = outer;
-    indices[next_index++] = outer + 1;
-    indices[next_index++] = inner + 1;
-    indices[next_index++] = inner + 1;
-    indices[next_index++] = inner;
-    indices[next_index++] = outer;
-
-    indices[next_index++] = outer + 1;
-    indices[next_index++] = outer + 2;
-    indices[next_index++] = inner + 2;
-    indices[next_index++] = inner + 2;
-    indices[next_index++] = inner + 1;
-    indices[next_index++] = outer + 1;
-
-    indices[next_index++] = outer + 2;
-    indices[next_index++] = outer + 3;
-    indices[next_index++] = inner + 3;
-    indices[next_index++] = inner + 3;
-    indices[next_index++] = inner + 2;
-    indices[next_index++] = outer + 2;
-
-    indices[next_index++] = outer + 3;
-    indices[next_index++] = outer;
-    indices[next_index++] = inner;
-    indices[next_index++] = inner;
-    indices[next_index++] = inner + 3;
-    indices[next_index++] = outer + 3;
-}
+constexpr std::size_t kMapSpriteIndexCount = kMaxMapSpriteCount * 6;
+
+// The minimap quad ends the index stream and samples its own texture.
+constexpr std::size_t kMapMinimapFirstIndex = kQuadIndexCount - 6;
+
+using QuadIndices = std::array<std::uint16_t, kQuadIndexCount>;
 
 constexpr QuadIndices make_quad_indices()
 {
@@ -984,7 +1062,7 @@ constexpr QuadIndices make_quad_indices()
         map_canvas_first_vertex
     );
 
-    const std::uint16_t map_tile_first_vertex =
+    const std::uint16_t map_area_selection_first_vertex =
         map_canvas_first_vertex +
         static_cast<std::uint16_t>(
             kMapCanvasVertices.size() +
@@ -992,26 +1070,6 @@ constexpr QuadIndices make_quad_indices()
             kMapHoverVertexCount
         );
 
-    for (std::size_t layer = 0;
-         layer < kMapLayerCount;
-         ++layer) {
-        for (std::size_t cell = 0;
-             cell < kMapCanvasCellCount;
-             ++cell) {
-            append_quad_indices(
-                indices,
-                next_index,
-                static_cast<std::uint16_t>(
-                    map_tile_first_vertex +
-                    (
-                        layer * kMapCanvasCellCount +
-                        cell
-                    ) * 4
-                )
-            );
-        }
-    }
-
     for (std::size_t quad = 1;
          quad < kMapCanvasQuadCount;
          ++quad) {
@@ -1024,6 +1082,22 @@ constexpr QuadIndices make_quad_indices()
         );
     }
 
+    const std::uint16_t map_sprite_first_vertex =
+        map_area_selection_first_vertex +
+        static_cast<std::uint16_t>(kMapAreaSelectionVertexCount);
+
+    for (std::size_t sprite = 0;
+         sprite < kMaxMapSpriteCount;
+         ++sprite) {
+        append_quad_indices(
+            indices,
+            next_index,
+            static_cast<std::uint16_t>(
+                map_sprite_first_vertex + sprite * 4
+            )
+        );
+    }
+
     const std::uint16_t selection_first_vertex =
         static_cast<std::uint16_t>(
             kTilesetPreviewVertices.size() +
@@ -1043,10 +1117,6 @@ constexpr QuadIndices make_quad_indices()
         selection_first_vertex + 4
     );
 
-    const std::uint16_t map_area_selection_first_vertex =
-        map_tile_first_vertex +
-        static_cast<std::uint16_t>(kMapTileVertexCount);
-
     append_outline_indices(
         indices,
         next_index,
@@ -1063,6 +1133,12 @@ constexpr QuadIndices make_quad_indices()
         map_hover_first_vertex
     );
 
+    append_quad_indices(
+        indices,
+        next_index,
+        static_cast<std::uint16_t>(kQuadVertexCount - 4)
+    );
+
     return indices;
 }
 
@@ -1076,7 +1152,7 @@ constexpr VkDeviceSize kQuadIndexBufferSize =
 
 }
 
-Application::Application()
+Application::Application(const CreateInfo& create_info)
     : sdl_(),
       window_(Window::CreateInfo{
           .title = "Midnight",
@@ -1091,17 +1167,27 @@ Application::Application()
       vulkan_transfer_context_(vulkan_device_),
       quad_vertex_buffer_(
           vulkan_device_,
+          vulkan_transfer_context_,
           kQuadVertexBufferSize,
-          VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-              VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+          VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
       ),
       quad_index_buffer_(
           vulkan_device_,
           kQuadIndexBufferSize,
-          VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-              VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+          VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+              VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+      ),
+      map_chunk_meshes_(
+          vulkan_device_,
+          vulkan_transfer_context_,
+          VulkanChunkMeshPool::CreateInfo{
+              .mesh_count = kMapChunkMeshCount,
+              .slot_count =
+                  kMapChunkMeshCount * kMapChunkMeshSlotsPerMesh,
+              .max_quads_per_mesh =
+                  static_cast<std::uint32_t>(kMapRenderChunkCellCount)
+          }
       ),
       texture_image_(
           vulkan_device_,
@@ -1120,15 +1206,93 @@ Application::Application()
           vulkan_device_,
           VulkanSampler::CreateInfo{}
       ),
-      map_tile_layers_{
-          MapTileLayer(kMapCanvasCellCount),
-          MapTileLayer(kMapCanvasCellCount)
-      },
+      map_texture_image_(
+          vulkan_device_,
+          VulkanImage::CreateInfo{
+              .extent = VkExtent2D{
+                  .width = kMapAtlasWidth,
+                  .height = kMapAtlasHeight
+              },
+              .format = VK_FORMAT_R8G8B8A8_SRGB,
+              .usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                  VK_IMAGE_USAGE_SAMPLED_BIT,
+              .aspect_mask = VK_IMAGE_ASPECT_COLOR_BIT,
+              .mip_levels = kMapAtlasMipLevels
+          }
+      ),
+      map_texture_sampler_(
+          vulkan_device_,
+          VulkanSampler::CreateInfo{
+              .min_filter = VK_FILTER_LINEAR,
+              .mag_filter = VK_FILTER_NEAREST,
+              .mipmap_mode = VK_SAMPLER_MIPMAP_MODE_LINEAR,
+              .max_lod = static_cast<float>(kMapAtlasMipLevels - 1)
+          }
+      ),
+      map_minimap_image_(
+          vulkan_device_,
+          VulkanImage::CreateInfo{
+              .extent = VkExtent2D{
+                  .width = kMapMinimapWidth,
+                  .height = kMapMinimapHeight
+              },
+              .format = VK_FORMAT_R8G8B8A8_SRGB,
+              .usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                  VK_IMAGE_USAGE_SAMPLED_BIT,
+              .aspect_mask = VK_IMAGE_ASPECT_COLOR_BIT
+          }
+      ),
+      map_auto_tiler_(std::vector<MapTerrain>{
+          make_map_terrain_from_block("dirt", 3, 0),
+          make_map_terrain_from_block("water", 7, 3)
+      }),
+      map_editor_(kMapCanvasColumns, kMapCanvasRows, kMapLayerCount),
+      map_chunk_mesh_dirty_(kMapChunkMeshCount, 1),
+      map_minimap_(MapMinimap::CreateInfo{
+          .columns = kMapCanvasColumns,
+          .rows = kMapCanvasRows,
+          .max_extent = kMapMinimapMaxExtent,
+          .background = kMapMinimapBackground
+      }),
+      map_file_dirty_chunks_(kMapLayerCount * kMapFileChunkCount, 1),
+      map_stamps_(kMapStampSlotCount),
+      frame_arena_(kFrameArenaBlockSize),
+      jobs_(std::max(std::thread::hardware_concurrency(), 2u) - 1),
+      map_collision_grid_(
+          kMapCanvasColumns,
+          kMapCanvasRows,
+          kMapNavigationChunkSize
+      ),
+      map_pathfinder_(map_collision_grid_),
+      map_flow_fields_(
+          map_collision_grid_,
+          kMapFlowFieldCacheCapacity,
+          &jobs_
+      ),
+      map_sprite_grid_(
+          kMapCanvasColumns,
+          kMapCanvasRows,
+          kMapSpriteGridBucketSize,
+          &jobs_
+      ),
+      map_sprite_vertices_(kMapSpriteVertexCount),
+      map_sprite_random_(std::random_device{}()),
+      simulation_(Simulation::CreateInfo{
+          .step = std::chrono::nanoseconds{std::chrono::seconds{1}} /
+              kSimulationTicksPerSecond,
+          .max_steps_per_update = kSimulationMaxStepsPerUpdate,
+          .threaded = create_info.threaded_simulation
+      }),
+      input_replay_by_frame_(create_info.replay_at_max_speed),
+      benchmark_(create_info.benchmark),
       selected_tile_left_(kInitialSelectedTileColumn),
       selected_tile_top_(kInitialSelectedTileRow),
       selected_tile_right_(kInitialSelectedTileColumn),
       selected_tile_bottom_(kInitialSelectedTileRow)
 {
+    map_editor_.set_scratch_resource(&frame_arena_);
+    map_editor_.set_auto_tiler(&map_auto_tiler_);
+    map_editor_.set_job_system(&jobs_);
     swapchain_resources_ = create_swapchain_resources();
     swapchain_window_pixel_width_ = window_.pixel_width();
     swapchain_window_pixel_height_ = window_.pixel_height();
@@ -1149,15 +1313,27 @@ Application::Application()
     upload_tile_selection_vertices();
     upload_map_hover_vertices();
 
+    upload_map_area_selection_vertices();
+
+    for (std::size_t region = 0;
+         region < kMapSpriteVertexRegionCount;
+         ++region) {
+        quad_vertex_buffer_.upload(
+            map_sprite_vertices_.data(),
+            kMapSpriteVertexRegionByteSize,
+            kMapSpriteVertexByteOffset +
+                kMapSpriteVertexRegionByteSize * region
+        );
+    }
+
     quad_vertex_buffer_.upload(
-        kEmptyMapTileVertices.data(),
-        sizeof(kEmptyMapTileVertices),
-        kMapTileVertexByteOffset
+        kMapMinimapVertices.data(),
+        sizeof(kMapMinimapVertices),
+        kMapMinimapVertexByteOffset
     );
 
-    upload_map_area_selection_vertices();
-
-    quad_index_buffer_.upload(
+    vulkan_transfer_context_.upload_to_buffer(
+        quad_index_buffer_,
         kQuadIndices.data(),
         kQuadIndexBufferSize
     );
@@ -1192,46 +1368,218 @@ Application::Application()
         );
     }
 
-    std::cout << "[Midnight] Decoded PNG: "
-              << outdoor_tileset_path.lexically_normal().string()
-              << " "
-              << outdoor_tileset.width
-              << "x"
-              << outdoor_tileset.height
-              << " RGBA8 ("
-              << outdoor_tileset.byte_size()
-              << " bytes)"
-              << '\n';
+    MIDNIGHT_LOG_INFO(
+        Assets,
+        "Decoded PNG: {} {}x{} RGBA8 ({} bytes)",
+        outdoor_tileset_path.lexically_normal().string(),
+        outdoor_tileset.width,
+        outdoor_tileset.height,
+        outdoor_tileset.byte_size()
+    );
 
     vulkan_transfer_context_.upload_to_new_sampled_image(
         texture_image_,
         outdoor_tileset.pixels.data(),
         static_cast<VkDeviceSize>(outdoor_tileset.byte_size())
     );
+
+    const std::vector<RgbaImage> map_atlas_levels = build_srgb_mip_chain(
+        extrude_atlas_tiles(
+            outdoor_tileset,
+            kTilesetTileWidth,
+            kTilesetTileHeight,
+            kMapAtlasTilePadding
+        ),
+        kMapAtlasMipLevels
+    );
+
+    std::vector<std::uint8_t> map_atlas_pixels;
+
+    for (const RgbaImage& level : map_atlas_levels) {
+        map_atlas_pixels.insert(
+            map_atlas_pixels.end(),
+            level.pixels.begin(),
+            level.pixels.end()
+        );
+    }
+
+    MIDNIGHT_LOG_INFO(
+        Assets,
+        "Built map atlas: {}x{}, {} px tile padding, {} mips ({} bytes)",
+        kMapAtlasWidth,
+        kMapAtlasHeight,
+        kMapAtlasTilePadding,
+        map_atlas_levels.size(),
+        map_atlas_pixels.size()
+    );
+
+    vulkan_transfer_context_.upload_to_new_sampled_image(
+        map_texture_image_,
+        map_atlas_pixels.data(),
+        static_cast<VkDeviceSize>(map_atlas_pixels.size())
+    );
+
+    // Tile colours are averaged once here; after this the minimap only
+    // recomputes and uploads the texels that edits touch.
+    map_minimap_.set_tile_colors(average_atlas_tile_colors(
+        outdoor_tileset,
+        kTilesetTileWidth,
+        kTilesetTileHeight
+    ));
+    (void)map_minimap_.refresh(map_editor_.map(), &jobs_);
+
+    vulkan_transfer_context_.upload_to_new_sampled_image(
+        map_minimap_image_,
+        map_minimap_.pixels().data(),
+        static_cast<VkDeviceSize>(map_minimap_.pixels().size())
+    );
+
+    MIDNIGHT_LOG_INFO(
+        Assets,
+        "Built map minimap: {}x{}, {} cells per texel",
+        map_minimap_.width(),
+        map_minimap_.height(),
+        map_minimap_.cells_per_texel()
+    );
+
+    if (!create_info.replay_input_path.empty()) {
+        input_replay_ =
+            std::make_unique<InputReplay>(create_info.replay_input_path);
+
+        const InputRecordingHeader& header = input_replay_->header();
+
+        map_sprite_random_.seed(
+            static_cast<std::minstd_rand::result_type>(header.random_seed)
+        );
+
+        if (header.window_width != window_.width() ||
+            header.window_height != window_.height()) {
+            (void)SDL_SetWindowSize(
+                window_.sdl_handle(),
+                header.window_width,
+                header.window_height
+            );
+        }
+
+        input_replay_start_ticks_ns_ = SDL_GetTicksNS();
+
+        MIDNIGHT_LOG_INFO(
+            Core,
+            "Replaying {} input events over {} frames from {}{}",
+            input_replay_->event_count(),
+            input_replay_->frame_count(),
+            create_info.replay_input_path.string(),
+            input_replay_by_frame_ ? " at maximum speed" : ""
+        );
+    } else if (!create_info.record_input_path.empty()) {
+        const std::uint64_t seed = std::random_device{}();
+
+        map_sprite_random_.seed(
+            static_cast<std::minstd_rand::result_type>(seed)
+        );
+        input_recorder_ = std::make_unique<InputRecorder>(
+            create_info.record_input_path,
+            InputRecordingHeader{
+                .random_seed = seed,
+                .window_width = window_.width(),
+                .window_height = window_.height()
+            }
+        );
+
+        MIDNIGHT_LOG_INFO(
+            Core,
+            "Recording input to {}",
+            create_info.record_input_path.string()
+        );
+    }
+
+    if (input_recorder_ == nullptr && input_replay_ == nullptr) {
+        recover_map_autosave();
+    }
+
+    simulation_.add_system([this](const SimulationStep& step) {
+        update_sprite_motion(
+            map_entities_,
+            step,
+            SpriteMotionBounds{
+                .width = static_cast<float>(kMapCanvasColumns),
+                .height = static_cast<float>(kMapCanvasRows)
+            },
+            &jobs_
+        );
+        rebuild_sprite_spatial_grid(
+            map_entities_,
+            map_sprite_grid_,
+            map_sprite_grid_items_
+        );
+        publish_map_sprite_snapshot();
+    });
 }
 
 Application::~Application() noexcept
 {
+    simulation_.stop();
+
+    if (map_chunk_mesh_build_ != nullptr) {
+        try {
+            jobs_.wait(map_chunk_mesh_build_->counter);
+        } catch (const std::exception& error) {
+            MIDNIGHT_LOG_ERROR(
+                Renderer,
+                "Map chunk mesh build failed: {}",
+                error.what()
+            );
+        }
+    }
+
+    if (map_journal_ != nullptr) {
+        try {
+            map_journal_->write_snapshot(encode_map_history());
+            map_journal_->flush();
+        } catch (const std::exception& error) {
+            MIDNIGHT_LOG_WARNING(
+                Map,
+                "Autosave snapshot failed: {}",
+                error.what()
+            );
+        }
+    }
+
     try {
         vulkan_device_.wait_idle();
     } catch (const std::exception& error) {
-        std::cerr << "[Midnight] Vulkan shutdown wait failed: "
-                  << error.what()
-                  << '\n';
+        MIDNIGHT_LOG_ERROR(
+            Renderer,
+            "Vulkan shutdown wait failed: {}",
+            error.what()
+        );
     }
 }
 
 int Application::run()
 {
     print_startup_info();
+    simulation_.start();
 
     while (running_) {
+        const std::chrono::steady_clock::time_point frame_start =
+            std::chrono::steady_clock::now();
+
+        report_frame_arena_usage();
+        frame_arena_.reset();
         poll_events();
+        ++input_frame_;
+
+        if (input_replay_ != nullptr && input_replay_->finished()) {
+            finish_input_replay();
+        }
 
         if (!running_) {
             break;
         }
 
+        simulation_.update();
+
         window_.refresh_size();
 
         if (window_.pixel_width() !=
@@ -1254,11 +1602,34 @@ int Application::run()
             }
         }
 
-        const bool swapchain_ready =
-            swapchain_resources_.frame_renderer->draw_frame();
+        upload_map_sprite_vertices();
+        update_map_chunk_meshes();
+        update_map_minimap();
+        quad_vertex_buffer_.flush();
+
+        VulkanFrameRenderer& frame_renderer =
+            *swapchain_resources_.frame_renderer;
+        const std::uint64_t submitted_frame_count =
+            frame_renderer.submitted_frame_count();
+
+        const bool swapchain_ready = frame_renderer.draw_frame();
+
+        if (benchmark_) {
+            if (frame_renderer.submitted_frame_count() !=
+                submitted_frame_count) {
+                benchmark_cpu_frame_times_.add(
+                    std::chrono::steady_clock::now() - frame_start -
+                        frame_renderer.last_frame_wait()
+                );
+            }
+
+            if (const std::optional<std::chrono::nanoseconds> gpu_time =
+                    frame_renderer.consume_gpu_frame_time()) {
+                benchmark_gpu_frame_times_.add(*gpu_time);
+            }
+        }
 
-        if (swapchain_resources_.frame_renderer
-                ->consume_present_completion_observed()) {
+        if (frame_renderer.consume_present_completion_observed()) {
             release_retired_swapchain_resources();
         }
 
@@ -1300,17 +1671,44 @@ Application::create_swapchain_resources(
             texture_image_,
             texture_sampler_
         );
+    resources.map_texture_descriptor =
+        std::make_unique<VulkanTextureDescriptor>(
+            vulkan_device_,
+            resources.graphics_pipeline->descriptor_set_layout(),
+            map_texture_image_,
+            map_texture_sampler_
+        );
+    resources.minimap_texture_descriptor =
+        std::make_unique<VulkanTextureDescriptor>(
+            vulkan_device_,
+            resources.graphics_pipeline->descriptor_set_layout(),
+            map_minimap_image_,
+            texture_sampler_
+        );
     resources.frame_renderer =
         std::make_unique<VulkanFrameRenderer>(
             vulkan_device_,
+            vulkan_transfer_context_,
             *resources.swapchain,
             *resources.render_pass,
             *resources.graphics_pipeline,
             *resources.texture_descriptor,
-            quad_vertex_buffer_,
+            *resources.map_texture_descriptor,
+            *resources.minimap_texture_descriptor,
+            quad_vertex_buffer_.buffer(),
             quad_index_buffer_,
             static_cast<std::uint32_t>(kQuadIndices.size()),
-            VK_INDEX_TYPE_UINT16
+            VK_INDEX_TYPE_UINT16,
+            map_chunk_meshes_,
+            static_cast<std::uint32_t>(kMapChunkMeshFirstIndex),
+            static_cast<std::uint32_t>(kMapSpriteFirstIndex),
+            static_cast<std::uint32_t>(kMapSpriteIndexCount),
+            static_cast<std::uint32_t>(kMapSpriteVertexCount),
+            static_cast<std::uint32_t>(kMapMinimapFirstIndex),
+            swapchain_resources_.frame_renderer != nullptr
+                ? swapchain_resources_.frame_renderer
+                      ->submitted_frame_count()
+                : 0
         );
 
     return resources;
@@ -1346,7 +1744,7 @@ bool Application::recreate_swapchain_resources()
     swapchain_window_pixel_height_ = window_.pixel_height();
     swapchain_recreation_pending_ = false;
 
-    std::cout << "[Midnight] Vulkan swapchain resources recreated\n";
+    MIDNIGHT_LOG_INFO(Renderer, "Vulkan swapchain resources recreated");
 
     return true;
 }
@@ -1391,9 +1789,28 @@ void Application::release_retired_swapchain_resources()
         retired_swapchain_resources_.size();
     retired_swapchain_resources_.clear();
 
-    std::cout << "[Midnight] Retired Vulkan swapchain resources released: "
-              << released_count
-              << '\n';
+    MIDNIGHT_LOG_INFO(
+        Renderer,
+        "Retired Vulkan swapchain resources released: {}",
+        released_count
+    );
+}
+
+void Application::report_frame_arena_usage()
+{
+    if (frame_arena_.used_bytes() <= reported_frame_arena_bytes_) {
+        return;
+    }
+
+    reported_frame_arena_bytes_ = frame_arena_.used_bytes();
+
+    MIDNIGHT_LOG_INFO(
+        Core,
+        "Frame arena high-water mark: {} bytes ({} reserved in {} blocks)",
+        reported_frame_arena_bytes_,
+        frame_arena_.reserved_bytes(),
+        frame_arena_.block_allocation_count()
+    );
 }
 
 void Application::wait_for_rendering_resources()
@@ -1409,6 +1826,8 @@ void Application::wait_for_rendering_resources()
             ->consume_present_completion_observed()) {
         release_retired_swapchain_resources();
     }
+
+    map_chunk_meshes_.reclaim_all();
 }
 
 const char* Application::map_layer_name(
@@ -1436,20 +1855,9 @@ bool Application::map_layer_blocks_movement(
     return layer == MapLayer::AboveGround;
 }
 
-Application::MapTileLayer&
-Application::active_map_tiles() noexcept
-{
-    return map_tile_layers_[
-        map_layer_index(active_map_layer_)
-    ];
-}
-
-const Application::MapTileLayer&
-Application::active_map_tiles() const noexcept
+std::size_t Application::active_map_layer_index() const noexcept
 {
-    return map_tile_layers_[
-        map_layer_index(active_map_layer_)
-    ];
+    return map_layer_index(active_map_layer_);
 }
 
 void Application::set_active_map_layer(
@@ -1461,99 +1869,130 @@ void Application::set_active_map_layer(
         map_rectangle_dragging_ ||
         map_area_selection_dragging_ ||
         map_erase_dragging_ ||
-        map_edit_active_) {
-        std::cout << "[Midnight] Finish the current drag or edit before switching layers\n";
+        map_editor_.editing()) {
+        MIDNIGHT_LOG_INFO(Editor, "Finish the current drag or edit before switching layers");
         return;
     }
 
     active_map_layer_ = layer;
 
-    std::cout << "[Midnight] Active map layer: "
-              << map_layer_name(active_map_layer_)
-              << " ("
-              << (
-                    map_layer_blocks_movement(active_map_layer_)
-                        ? "collidable when occupied"
-                        : "walkable"
-                 )
-              << ")\n";
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Active map layer: {} ({})",
+        map_layer_name(active_map_layer_),
+        map_layer_blocks_movement(active_map_layer_)
+            ? "collidable when occupied"
+            : "walkable"
+    );
 }
 
 void Application::print_startup_info() const
 {
-    std::cout << "[Midnight] Application started\n";
-    std::cout << "[Midnight] Window size: "
-              << window_.width()
-              << "x"
-              << window_.height()
-              << '\n';
-    std::cout << "[Midnight] Window pixel size: "
-              << window_.pixel_width()
-              << "x"
-              << window_.pixel_height()
-              << '\n';
-    std::cout << "[Midnight] Outdoor tileset grid: "
-              << kOutdoorTilesetColumns
-              << "x"
-              << kOutdoorTilesetRows
-              << " tiles at "
-              << kTilesetTileWidth
-              << "x"
-              << kTilesetTileHeight
-              << " pixels\n";
-    std::cout << "[Midnight] Blank map canvas: "
-              << kMapCanvasColumns
-              << "x"
-              << kMapCanvasRows
-              << " tiles at "
-              << kMapCanvasScale
-              << "x\n";
-    std::cout << "[Midnight] Map layers: "
-              << map_layer_name(MapLayer::Ground)
-              << " ("
-              << (
-                    map_layer_blocks_movement(MapLayer::Ground)
-                        ? "collidable when occupied"
-                        : "walkable"
-                 )
-              << "), "
-              << map_layer_name(MapLayer::AboveGround)
-              << " ("
-              << (
-                    map_layer_blocks_movement(
-                        MapLayer::AboveGround
-                    )
-                        ? "collidable when occupied"
-                        : "walkable"
-                 )
-              << ")\n";
-    std::cout << "[Midnight] Active map layer: "
-              << map_layer_name(active_map_layer_)
-              << '\n';
-    std::cout << "[Midnight] Rendering the outdoor tileset at "
-              << kTilesetPreviewScale
-              << "x\n";
+    MIDNIGHT_LOG_INFO(Core, "Application started");
+    MIDNIGHT_LOG_INFO(
+        Core,
+        "Window size: {}x{}",
+        window_.width(),
+        window_.height()
+    );
+    MIDNIGHT_LOG_INFO(
+        Core,
+        "Window pixel size: {}x{}",
+        window_.pixel_width(),
+        window_.pixel_height()
+    );
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Outdoor tileset grid: {}x{} tiles at {}x{} pixels",
+        kOutdoorTilesetColumns,
+        kOutdoorTilesetRows,
+        kTilesetTileWidth,
+        kTilesetTileHeight
+    );
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Blank map canvas: {}x{} tiles at {}x",
+        kMapCanvasColumns,
+        kMapCanvasRows,
+        kMapCanvasScale
+    );
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Map layers: {} ({}), {} ({})",
+        map_layer_name(MapLayer::Ground),
+        map_layer_blocks_movement(MapLayer::Ground)
+            ? "collidable when occupied"
+            : "walkable",
+        map_layer_name(MapLayer::AboveGround),
+        map_layer_blocks_movement(MapLayer::AboveGround)
+            ? "collidable when occupied"
+            : "walkable"
+    );
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Active map layer: {}",
+        map_layer_name(active_map_layer_)
+    );
+    MIDNIGHT_LOG_INFO(
+        Core,
+        "Job system: {} workers",
+        jobs_.worker_count()
+    );
+    MIDNIGHT_LOG_INFO(
+        Simulation,
+        "Simulation: {} Hz fixed step{}",
+        kSimulationTicksPerSecond,
+        simulation_.threaded() ? " on a worker thread" : ""
+    );
+    vulkan_device_.memory_allocator().print_stats();
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Rendering the outdoor tileset at {}x",
+        kTilesetPreviewScale
+    );
     print_tile_selection();
-    std::cout << "[Midnight] Use the arrow keys, click, or drag across the atlas to select tiles\n";
-    std::cout << "[Midnight] Move the cursor across the map to highlight cells\n";
-    std::cout << "[Midnight] Left-click or drag across the map to paint the selected region\n";
-    std::cout << "[Midnight] Hold Shift and left-drag to paint a filled rectangle\n";
-    std::cout << "[Midnight] Hold Ctrl and left-drag to select a rectangular map area\n";
-    std::cout << "[Midnight] Press Delete to clear the selected map area\n";
-    std::cout << "[Midnight] Press Ctrl+Arrow to move the selected map area one cell\n";
-    std::cout << "[Midnight] Right-click or drag across the map to erase tiles\n";
-    std::cout << "[Midnight] Middle-click a painted map tile to select it\n";
-    std::cout << "[Midnight] Press F over the map to flood-fill with a 1x1 selection\n";
-    std::cout << "[Midnight] Press Ctrl+Z to undo and Ctrl+Shift+Z to redo map edits\n";
-    std::cout << "[Midnight] Press 1 for Ground or 2 for Above Ground\n";
-    std::cout << "[Midnight] Press G to toggle the atlas grid\n";
-    std::cout << "[Midnight] Press M to toggle the map grid\n";
-    std::cout << "[Midnight] Press Escape or close the window to quit\n";
+    MIDNIGHT_LOG_INFO(Editor, "Use the arrow keys, click, or drag across the atlas to select tiles");
+    MIDNIGHT_LOG_INFO(Editor, "Move the cursor across the map to highlight cells");
+    MIDNIGHT_LOG_INFO(Editor, "Left-click or drag across the map to paint the selected region");
+    MIDNIGHT_LOG_INFO(Editor, "Hold Shift and left-drag to paint a filled rectangle");
+    MIDNIGHT_LOG_INFO(Editor, "Hold Ctrl and left-drag to select a rectangular map area");
+    MIDNIGHT_LOG_INFO(Editor, "Press Delete to clear the selected map area");
+    MIDNIGHT_LOG_INFO(Editor, "Press Ctrl+Arrow to move the selected map area one cell");
+    MIDNIGHT_LOG_INFO(Editor, "Right-click or drag across the map to erase tiles");
+    MIDNIGHT_LOG_INFO(Editor, "Middle-click a painted map tile to select it");
+    MIDNIGHT_LOG_INFO(Editor, "Press F over the map to flood-fill with a 1x1 selection");
+    MIDNIGHT_LOG_INFO(Editor, "Press Ctrl+F to find the selected tile on the active layer and Ctrl+Shift+F to list tile usage");
+    MIDNIGHT_LOG_INFO(Editor, "Press Ctrl+R over the map to replace every copy of the hovered tile with the selected one");
+    MIDNIGHT_LOG_INFO(Editor, "Press P over the map to mark a path start, then P again to find a path");
+    MIDNIGHT_LOG_INFO(Editor, "Press Shift+P over the map to build a flow field toward that cell");
+    MIDNIGHT_LOG_INFO(Editor, "Press E over the map to spawn moving sprites and Shift+E to clear them");
+    MIDNIGHT_LOG_INFO(Editor, "Press I over the map to list nearby sprites");
+    MIDNIGHT_LOG_INFO(Editor, "Press Ctrl+Z to undo and Ctrl+Shift+Z to redo map edits");
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Map edits are journaled to {} and restored on the next start",
+        kMapJournalFileName
+    );
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Press Ctrl+S to save the map to {} and Ctrl+O to load it",
+        kMapFileName
+    );
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Press Ctrl+Shift+S to export {} for Tiled and Ctrl+Shift+O to import it",
+        kTiledMapFileName
+    );
+    MIDNIGHT_LOG_INFO(Editor, "Press 1 for Ground or 2 for Above Ground");
+    MIDNIGHT_LOG_INFO(Editor, "Press G to toggle the atlas grid");
+    MIDNIGHT_LOG_INFO(Editor, "Press M to toggle the map grid");
+    MIDNIGHT_LOG_INFO(Editor, "Press Escape or close the window to quit");
 }
 
 void Application::poll_events()
 {
-    SDL_Event event{};
+    InputEvent input{};
+    const SDL_Event& event = input.event;
     bool tile_selection_drag_update_pending = false;
     float pending_tile_selection_drag_x = 0.0f;
     float pending_tile_selection_drag_y = 0.0f;
@@ -1587,16 +2026,14 @@ void Application::poll_events()
     };
 
     const auto queue_current_map_hover = [&]() {
-        if (SDL_GetMouseFocus() != window_.sdl_handle()) {
+        if (!input.mouse_focused) {
             map_hover_update_pending = false;
             clear_map_hover();
             return;
         }
 
-        (void)SDL_GetMouseState(
-            &pending_map_hover_x,
-            &pending_map_hover_y
-        );
+        pending_map_hover_x = input.mouse_x;
+        pending_map_hover_y = input.mouse_y;
         map_hover_update_pending = true;
     };
 
@@ -1615,7 +2052,7 @@ void Application::poll_events()
         tile_selection_drag_update_pending = false;
     };
 
-    while (SDL_PollEvent(&event)) {
+    while (next_input_event(input)) {
         switch (event.type) {
             case SDL_EVENT_QUIT:
             case SDL_EVENT_WINDOW_CLOSE_REQUESTED:
@@ -1632,16 +2069,41 @@ void Application::poll_events()
 
                     case SDLK_1:
                         if (!event.key.repeat) {
-                            set_active_map_layer(
-                                MapLayer::Ground
-                            );
+                            if ((event.key.mod & SDL_KMOD_CTRL) != 0) {
+                                select_map_stamp(
+                                    0,
+                                    (event.key.mod & SDL_KMOD_SHIFT) != 0
+                                );
+                            } else {
+                                set_active_map_layer(
+                                    MapLayer::Ground
+                                );
+                            }
                         }
                         break;
 
                     case SDLK_2:
                         if (!event.key.repeat) {
-                            set_active_map_layer(
-                                MapLayer::AboveGround
+                            if ((event.key.mod & SDL_KMOD_CTRL) != 0) {
+                                select_map_stamp(
+                                    1,
+                                    (event.key.mod & SDL_KMOD_SHIFT) != 0
+                                );
+                            } else {
+                                set_active_map_layer(
+                                    MapLayer::AboveGround
+                                );
+                            }
+                        }
+                        break;
+
+                    case SDLK_3:
+                    case SDLK_4:
+                        if (!event.key.repeat &&
+                            (event.key.mod & SDL_KMOD_CTRL) != 0) {
+                            select_map_stamp(
+                                event.key.key == SDLK_3 ? 2 : 3,
+                                (event.key.mod & SDL_KMOD_SHIFT) != 0
                             );
                         }
                         break;
@@ -1688,7 +2150,19 @@ void Application::poll_events()
 
                     case SDLK_G:
                         if (!event.key.repeat) {
-                            toggle_tileset_grid();
+                            if ((event.key.mod & SDL_KMOD_CTRL) != 0) {
+                                generate_map_canvas(
+                                    (event.key.mod & SDL_KMOD_SHIFT) != 0
+                                );
+                            } else {
+                                toggle_tileset_grid();
+                            }
+                        }
+                        break;
+
+                    case SDLK_T:
+                        if (!event.key.repeat) {
+                            cycle_map_terrain_brush();
                         }
                         break;
 
@@ -1700,14 +2174,101 @@ void Application::poll_events()
 
                     case SDLK_F:
                         if (!event.key.repeat) {
-                            flush_pending_map_hover();
-                            flood_fill_map();
+                            if ((event.key.mod & SDL_KMOD_CTRL) != 0) {
+                                if ((event.key.mod & SDL_KMOD_SHIFT) != 0) {
+                                    log_map_tile_usage();
+                                } else {
+                                    find_map_tile();
+                                }
+                            } else {
+                                flush_pending_map_hover();
+                                flood_fill_map();
+                            }
                         }
                         break;
 
-                    case SDLK_DELETE:
-                        if (!event.key.repeat) {
-                            delete_selected_map_area();
+                    case SDLK_R:
+                        if (!event.key.repeat &&
+                            (event.key.mod & SDL_KMOD_CTRL) != 0) {
+                            flush_pending_map_hover();
+                            replace_map_tile();
+                        }
+                        break;
+
+                    case SDLK_P:
+                        if (!event.key.repeat) {
+                            flush_pending_map_hover();
+
+                            if ((event.key.mod & SDL_KMOD_SHIFT) != 0) {
+                                query_map_flow_field();
+                            } else {
+                                query_map_path();
+                            }
+                        }
+                        break;
+
+                    case SDLK_E:
+                        if (!event.key.repeat) {
+                            flush_pending_map_hover();
+
+                            if ((event.key.mod & SDL_KMOD_SHIFT) != 0) {
+                                clear_map_sprites();
+                            } else {
+                                spawn_map_sprites();
+                            }
+                        }
+                        break;
+
+                    case SDLK_I:
+                        if (!event.key.repeat) {
+                            flush_pending_map_hover();
+                            inspect_map_sprites();
+                        }
+                        break;
+
+                    case SDLK_DELETE:
+                        if (!event.key.repeat) {
+                            delete_selected_map_area();
+                        }
+                        break;
+
+                    case SDLK_C:
+                    case SDLK_X:
+                        if (!event.key.repeat &&
+                            (event.key.mod & SDL_KMOD_CTRL) != 0) {
+                            copy_selected_map_area(event.key.key == SDLK_X);
+                        }
+                        break;
+
+                    case SDLK_V:
+                        if (!event.key.repeat &&
+                            (event.key.mod & SDL_KMOD_CTRL) != 0) {
+                            flush_pending_map_hover();
+                            paste_map_clipboard(
+                                (event.key.mod & SDL_KMOD_SHIFT) != 0
+                            );
+                        }
+                        break;
+
+                    case SDLK_S:
+                        if (!event.key.repeat &&
+                            (event.key.mod & SDL_KMOD_CTRL) != 0) {
+                            if ((event.key.mod & SDL_KMOD_SHIFT) != 0) {
+                                export_tiled_map_file();
+                            } else {
+                                save_map();
+                            }
+                        }
+                        break;
+
+                    case SDLK_O:
+                        if (!event.key.repeat &&
+                            (event.key.mod & SDL_KMOD_CTRL) != 0) {
+                            if ((event.key.mod & SDL_KMOD_SHIFT) != 0) {
+                                import_tiled_map_file();
+                            } else {
+                                load_map();
+                            }
                         }
                         break;
 
@@ -1738,8 +2299,7 @@ void Application::poll_events()
                     map_paint_dragging_ = false;
                     map_rectangle_dragging_ = false;
                     map_area_selection_dragging_ = false;
-                    const SDL_Keymod modifiers =
-                        SDL_GetModState();
+                    const SDL_Keymod modifiers = input.modifiers;
                     const bool area_selection_requested =
                         (modifiers & SDL_KMOD_CTRL) != 0;
                     const bool rectangle_requested =
@@ -1984,16 +2544,14 @@ void Application::poll_events()
                     old_height != window_.height() ||
                     old_pixel_width != window_.pixel_width() ||
                     old_pixel_height != window_.pixel_height()) {
-                    std::cout << "[Midnight] Window resized: "
-                              << window_.width()
-                              << "x"
-                              << window_.height()
-                              << " logical, "
-                              << window_.pixel_width()
-                              << "x"
-                              << window_.pixel_height()
-                              << " pixels"
-                              << '\n';
+                    MIDNIGHT_LOG_INFO(
+                        Core,
+                        "Window resized: {}x{} logical, {}x{} pixels",
+                        window_.width(),
+                        window_.height(),
+                        window_.pixel_width(),
+                        window_.pixel_height()
+                    );
                 }
 
                 queue_current_map_hover();
@@ -2032,56 +2590,142 @@ void Application::poll_events()
 
     flush_pending_tile_selection_drag();
     flush_pending_map_hover();
+
+    if (input_recorder_ != nullptr) {
+        input_recorder_->flush();
+    }
+}
+
+// Live events carry the keyboard and pointer state sampled as they are
+// polled. During a replay, live input is dropped and recorded events are
+// handed out instead; quitting and window changes still come through.
+bool Application::next_input_event(InputEvent& input)
+{
+    SDL_Event& event = input.event;
+
+    if (input_replay_ == nullptr) {
+        if (!SDL_PollEvent(&event)) {
+            return false;
+        }
+
+        input.modifiers = SDL_GetModState();
+        input.mouse_focused = SDL_GetMouseFocus() == window_.sdl_handle();
+        (void)SDL_GetMouseState(&input.mouse_x, &input.mouse_y);
+
+        if (input_recorder_ != nullptr) {
+            input_recorder_->record(input_frame_, input);
+        }
+
+        return true;
+    }
+
+    while (SDL_PollEvent(&event)) {
+        if (is_recorded_input_event(event) &&
+            event.type != SDL_EVENT_WINDOW_RESIZED) {
+            continue;
+        }
+
+        input_replay_->apply_ambient(input);
+        return true;
+    }
+
+    const std::chrono::microseconds elapsed{
+        (SDL_GetTicksNS() - input_replay_start_ticks_ns_) / 1000
+    };
+
+    while (input_replay_->next(
+        input_frame_,
+        elapsed,
+        input_replay_by_frame_,
+        input
+    )) {
+        // Recorded resizes are reapplied to the window; the events SDL
+        // raises for them arrive live on a later poll.
+        if (event.type == SDL_EVENT_WINDOW_RESIZED) {
+            (void)SDL_SetWindowSize(
+                window_.sdl_handle(),
+                event.window.data1,
+                event.window.data2
+            );
+            continue;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+void Application::finish_input_replay()
+{
+    MIDNIGHT_LOG_INFO(
+        Core,
+        "Input replay finished after {} frames",
+        input_frame_
+    );
+    input_replay_.reset();
+
+    if (!benchmark_) {
+        return;
+    }
+
+    benchmark_cpu_frame_times_.log_report("CPU frame time");
+    benchmark_gpu_frame_times_.log_report("GPU frame time");
+    running_ = false;
 }
 
 void Application::begin_map_edit(
     const bool include_area_selection
 )
 {
-    if (map_edit_active_) {
+    if (map_editor_.editing()) {
         return;
     }
 
-    active_map_edit_before_ = map_tile_layers_;
-    active_map_area_selection_before_ =
+    map_editor_.begin(
         include_area_selection
-            ? std::optional<MapAreaSelectionState>{
-                  capture_map_area_selection_state()
-              }
-            : std::nullopt;
-    map_edit_active_ = true;
+            ? std::optional<MapSelection>{capture_map_area_selection_state()}
+            : std::nullopt
+    );
 }
 
 void Application::finish_map_edit()
 {
-    if (!map_edit_active_) {
+    if (!map_editor_.editing()) {
         return;
     }
 
-    const bool area_selection_changed =
-        active_map_area_selection_before_.has_value() &&
-        active_map_area_selection_before_.value() !=
-            capture_map_area_selection_state();
+    const MapEditStep* const step =
+        map_editor_.commit(capture_map_area_selection_state());
 
-    if (active_map_edit_before_ != map_tile_layers_ ||
-        area_selection_changed) {
-        map_undo_stack_.push_back(MapEditSnapshot{
-            .layers = std::move(active_map_edit_before_),
-            .area_selection =
-                std::move(active_map_area_selection_before_)
-        });
-        map_redo_stack_.clear();
+    if (step == nullptr || map_journal_ == nullptr) {
+        return;
+    }
+
+    ByteWriter record;
+    record.write_u8(static_cast<std::uint8_t>(MapJournalRecord::Edit));
+    record.write_u8(step->selection_after.has_value() ? 1 : 0);
+
+    if (step->selection_after.has_value()) {
+        write_map_area_selection(record, step->selection_before.value());
+        write_map_area_selection(record, step->selection_after.value());
+    }
+
+    record.write_u32(static_cast<std::uint32_t>(step->changes.size()));
+
+    for (const MapCellChange& change : step->changes) {
+        record.write_u8(static_cast<std::uint8_t>(change.layer));
+        record.write_u32(change.cell);
+        record.write_u32(change.after);
     }
 
-    active_map_edit_before_ = MapTileLayers{};
-    active_map_area_selection_before_.reset();
-    map_edit_active_ = false;
+    record_map_journal(record.take());
 }
 
-Application::MapAreaSelectionState
+MapSelection
 Application::capture_map_area_selection_state() const
 {
-    return MapAreaSelectionState{
+    return MapSelection{
         .left = map_area_selection_left_,
         .top = map_area_selection_top_,
         .right = map_area_selection_right_,
@@ -2091,7 +2735,7 @@ Application::capture_map_area_selection_state() const
 }
 
 void Application::apply_map_area_selection_state(
-    const MapAreaSelectionState& state
+    const MapSelection& state
 )
 {
     map_area_selection_left_ = state.left;
@@ -2105,455 +2749,1682 @@ void Application::apply_map_area_selection_state(
     upload_map_area_selection_vertices();
 }
 
+void Application::apply_map_edit_step(
+    const MapEditStep& step,
+    const bool undo
+)
+{
+    const std::optional<MapSelection>& selection =
+        undo ? step.selection_before : step.selection_after;
+
+    if (selection.has_value()) {
+        apply_map_area_selection_state(selection.value());
+    }
+}
+
 void Application::undo_map_edit()
 {
-    if (map_edit_active_ ||
+    if (map_editor_.editing() ||
         map_area_selection_dragging_) {
         return;
     }
 
-    if (map_undo_stack_.empty()) {
-        std::cout << "[Midnight] Nothing to undo\n";
+    if (map_editor_.undo_steps().empty()) {
+        MIDNIGHT_LOG_INFO(Editor, "Nothing to undo");
         return;
     }
 
     wait_for_rendering_resources();
 
-    MapEditSnapshot previous =
-        std::move(map_undo_stack_.back());
-    map_undo_stack_.pop_back();
+    const MapEditStep& step = *map_editor_.undo();
+    apply_map_edit_step(step, true);
+    sync_map_changes(step.changes);
+    record_map_journal({
+        static_cast<std::byte>(MapJournalRecord::Undo)
+    });
 
-    MapEditSnapshot current{
-        .layers = std::move(map_tile_layers_),
-        .area_selection = std::nullopt
-    };
+    MIDNIGHT_LOG_INFO(Editor, "Undid map edit");
+}
 
-    if (previous.area_selection.has_value()) {
-        current.area_selection =
-            capture_map_area_selection_state();
+void Application::redo_map_edit()
+{
+    if (map_editor_.editing() ||
+        map_area_selection_dragging_) {
+        return;
     }
 
-    map_tile_layers_ = std::move(previous.layers);
-
-    if (previous.area_selection.has_value()) {
-        apply_map_area_selection_state(
-            previous.area_selection.value()
-        );
+    if (map_editor_.redo_steps().empty()) {
+        MIDNIGHT_LOG_INFO(Editor, "Nothing to redo");
+        return;
     }
 
-    map_redo_stack_.push_back(std::move(current));
+    wait_for_rendering_resources();
 
-    upload_all_map_tile_vertices();
+    const MapEditStep& step = *map_editor_.redo();
+    apply_map_edit_step(step, false);
+    sync_map_changes(step.changes);
+    record_map_journal({
+        static_cast<std::byte>(MapJournalRecord::Redo)
+    });
 
-    std::cout << "[Midnight] Undid map edit\n";
+    MIDNIGHT_LOG_INFO(Editor, "Redid map edit");
 }
 
-void Application::redo_map_edit()
+void Application::write_map_tiles(
+    ByteWriter& writer,
+    const TileMap& map_tiles
+)
 {
-    if (map_edit_active_ ||
-        map_area_selection_dragging_) {
-        return;
+    for (std::size_t layer = 0; layer < map_tiles.layer_count(); ++layer) {
+        for (const PackedMapTile tile : map_tiles.layer(layer)) {
+            writer.write_u32(tile);
+        }
     }
+}
 
-    if (map_redo_stack_.empty()) {
-        std::cout << "[Midnight] Nothing to redo\n";
-        return;
+TileMap Application::read_map_tiles(ByteReader& reader)
+{
+    TileMap map_tiles(kMapCanvasColumns, kMapCanvasRows, kMapLayerCount);
+
+    for (std::size_t layer = 0; layer < kMapLayerCount; ++layer) {
+        for (PackedMapTile& tile : map_tiles.layer(layer)) {
+            tile = read_map_history_tile(reader);
+        }
     }
 
-    wait_for_rendering_resources();
+    return map_tiles;
+}
 
-    MapEditSnapshot next =
-        std::move(map_redo_stack_.back());
-    map_redo_stack_.pop_back();
+void Application::write_map_changes(
+    ByteWriter& writer,
+    const std::span<const MapCellChange> changes
+)
+{
+    writer.write_u32(static_cast<std::uint32_t>(changes.size()));
 
-    MapEditSnapshot current{
-        .layers = std::move(map_tile_layers_),
-        .area_selection = std::nullopt
-    };
+    for (const MapCellChange& change : changes) {
+        writer.write_u8(static_cast<std::uint8_t>(change.layer));
+        writer.write_u32(change.cell);
+        writer.write_u32(change.before);
+        writer.write_u32(change.after);
+    }
+}
 
-    if (next.area_selection.has_value()) {
-        current.area_selection =
-            capture_map_area_selection_state();
+std::vector<MapCellChange> Application::read_map_changes(
+    ByteReader& reader
+)
+{
+    const std::uint32_t change_count = reader.read_u32();
+    std::vector<MapCellChange> changes;
+
+    for (std::uint32_t change = 0; change < change_count; ++change) {
+        MapCellChange& entry = changes.emplace_back();
+        entry.layer = reader.read_u8();
+        entry.cell = reader.read_u32();
+        entry.before = read_map_history_tile(reader);
+        entry.after = read_map_history_tile(reader);
+
+        if (entry.layer >= kMapLayerCount ||
+            entry.cell >= kMapCanvasCellCount) {
+            throw std::runtime_error(
+                "Map history change is outside the map canvas"
+            );
+        }
     }
 
-    map_tile_layers_ = std::move(next.layers);
+    return changes;
+}
+
+void Application::write_map_area_selection(
+    ByteWriter& writer,
+    const MapSelection& state
+)
+{
+    writer.write_u32(state.left);
+    writer.write_u32(state.top);
+    writer.write_u32(state.right);
+    writer.write_u32(state.bottom);
+    writer.write_u8(state.visible ? 1 : 0);
+}
 
-    if (next.area_selection.has_value()) {
-        apply_map_area_selection_state(
-            next.area_selection.value()
+MapSelection Application::read_map_area_selection(
+    ByteReader& reader
+)
+{
+    MapSelection state{};
+    state.left = reader.read_u32();
+    state.top = reader.read_u32();
+    state.right = reader.read_u32();
+    state.bottom = reader.read_u32();
+    state.visible = reader.read_u8() != 0;
+
+    if (state.left > state.right ||
+        state.top > state.bottom ||
+        state.right >= kMapCanvasColumns ||
+        state.bottom >= kMapCanvasRows) {
+        throw std::runtime_error(
+            "Map history selection is outside the map canvas"
         );
     }
 
-    map_undo_stack_.push_back(std::move(current));
+    return state;
+}
+
+std::vector<std::byte> Application::encode_map_history() const
+{
+    ByteWriter writer;
+    writer.write_u32(kMapHistoryFormat);
+    writer.write_u32(kMapCanvasColumns);
+    writer.write_u32(kMapCanvasRows);
+    writer.write_u32(static_cast<std::uint32_t>(kMapLayerCount));
+    write_map_tiles(writer, map_editor_.map());
+    write_map_area_selection(writer, capture_map_area_selection_state());
+
+    for (const std::span<const MapEditStep> steps :
+         {map_editor_.undo_steps(), map_editor_.redo_steps()}) {
+        writer.write_u32(static_cast<std::uint32_t>(steps.size()));
+
+        for (const MapEditStep& step : steps) {
+            writer.write_u8(step.selection_before.has_value() ? 1 : 0);
+
+            if (step.selection_before.has_value()) {
+                write_map_area_selection(writer, step.selection_before.value());
+                write_map_area_selection(writer, step.selection_after.value());
+            }
 
-    upload_all_map_tile_vertices();
+            write_map_changes(writer, step.changes);
+        }
+    }
 
-    std::cout << "[Midnight] Redid map edit\n";
+    return writer.take();
 }
 
-void Application::flood_fill_map()
+void Application::restore_map_history(
+    const std::span<const std::byte> snapshot
+)
 {
-    if (!map_hover_visible_ ||
-        tile_selection_dragging_ ||
-        map_paint_dragging_ ||
-        map_rectangle_dragging_ ||
-        map_area_selection_dragging_ ||
-        map_erase_dragging_ ||
-        map_edit_active_) {
-        return;
+    ByteReader reader(snapshot);
+
+    if (reader.read_u32() != kMapHistoryFormat) {
+        throw std::runtime_error("Unsupported map autosave format");
     }
 
-    if (selected_tile_left_ != selected_tile_right_ ||
-        selected_tile_top_ != selected_tile_bottom_) {
-        std::cout << "[Midnight] Flood fill requires a 1x1 atlas selection\n";
-        return;
+    if (reader.read_u32() != kMapCanvasColumns ||
+        reader.read_u32() != kMapCanvasRows ||
+        reader.read_u32() != kMapLayerCount) {
+        throw std::runtime_error(
+            "Map autosave dimensions do not match the map canvas"
+        );
     }
 
-    const MapTile replacement{
-        .tileset_column = selected_tile_left_,
-        .tileset_row = selected_tile_top_,
-        .occupied = true
-    };
-    const std::size_t start_index =
-        static_cast<std::size_t>(hovered_map_row_) *
-            kMapCanvasColumns +
-        hovered_map_column_;
-    MapTileLayer& map_tiles = active_map_tiles();
-    const MapTile target = map_tiles.at(start_index);
+    TileMap map_tiles = read_map_tiles(reader);
+    const MapSelection area_selection =
+        read_map_area_selection(reader);
+    std::array<std::vector<MapEditStep>, 2> stacks;
 
-    if (target == replacement) {
-        return;
-    }
+    for (std::vector<MapEditStep>& stack : stacks) {
+        const std::uint32_t entry_count = reader.read_u32();
 
-    const auto matches_target = [&target](
-        const MapTile& map_tile
-    ) {
-        if (!target.occupied) {
-            return !map_tile.occupied;
-        }
+        for (std::uint32_t entry_index = 0;
+             entry_index < entry_count;
+             ++entry_index) {
+            MapEditStep& step = stack.emplace_back();
 
-        return map_tile == target;
-    };
+            if (reader.read_u8() != 0) {
+                step.selection_before = read_map_area_selection(reader);
+                step.selection_after = read_map_area_selection(reader);
+            }
 
-    std::array<bool, kMapCanvasCellCount> queued{};
-    std::vector<std::size_t> pending_cells;
-    std::vector<std::size_t> filled_cells;
-    pending_cells.reserve(kMapCanvasCellCount);
-    filled_cells.reserve(kMapCanvasCellCount);
-
-    const auto queue_cell = [&](
-        const std::size_t cell_index
-    ) {
-        if (queued.at(cell_index) ||
-            !matches_target(map_tiles.at(cell_index))) {
-            return;
+            step.changes = read_map_changes(reader);
         }
+    }
 
-        queued.at(cell_index) = true;
-        pending_cells.push_back(cell_index);
-    };
+    if (reader.remaining() != 0) {
+        throw std::runtime_error("Map autosave has trailing data");
+    }
 
-    queue_cell(start_index);
+    map_editor_.restore(
+        std::move(map_tiles),
+        std::move(stacks[0]),
+        std::move(stacks[1])
+    );
+    apply_map_area_selection_state(area_selection);
+}
 
-    while (!pending_cells.empty()) {
-        const std::size_t cell_index = pending_cells.back();
-        pending_cells.pop_back();
-        filled_cells.push_back(cell_index);
+void Application::replay_map_journal_record(
+    const std::span<const std::byte> record
+)
+{
+    ByteReader reader(record);
 
-        const std::uint32_t column =
-            static_cast<std::uint32_t>(
-                cell_index % kMapCanvasColumns
-            );
-        const std::uint32_t row =
-            static_cast<std::uint32_t>(
-                cell_index / kMapCanvasColumns
-            );
+    switch (static_cast<MapJournalRecord>(reader.read_u8())) {
+        case MapJournalRecord::Edit: {
+            std::optional<MapSelection> selection_before;
+            std::optional<MapSelection> selection_after;
 
-        if (column > 0) {
-            queue_cell(cell_index - 1);
-        }
+            if (reader.read_u8() != 0) {
+                selection_before = read_map_area_selection(reader);
+                selection_after = read_map_area_selection(reader);
+            }
+
+            const std::uint32_t change_count = reader.read_u32();
+            std::vector<MapEditCommand> commands;
+            commands.reserve(change_count);
+
+            for (std::uint32_t change = 0; change < change_count; ++change) {
+                const std::uint8_t layer_index = reader.read_u8();
+                const std::uint32_t cell_index = reader.read_u32();
+                const PackedMapTile tile = read_map_history_tile(reader);
+
+                if (layer_index >= kMapLayerCount ||
+                    cell_index >= kMapCanvasCellCount) {
+                    throw std::runtime_error("Invalid map journal edit");
+                }
+
+                commands.push_back(MapSetTileCommand{
+                    .layer = layer_index,
+                    .column = cell_index % kMapCanvasColumns,
+                    .row = cell_index / kMapCanvasColumns,
+                    .tile = tile
+                });
+            }
 
-        if (column + 1 < kMapCanvasColumns) {
-            queue_cell(cell_index + 1);
+            map_editor_.begin(selection_before);
+            (void)map_editor_.apply(commands);
+            (void)map_editor_.commit(selection_after);
+
+            if (selection_after.has_value()) {
+                apply_map_area_selection_state(selection_after.value());
+            }
+            break;
         }
 
-        if (row > 0) {
-            queue_cell(cell_index - kMapCanvasColumns);
+        case MapJournalRecord::Undo: {
+            const MapEditStep* const step = map_editor_.undo();
+
+            if (step == nullptr) {
+                throw std::runtime_error("Map journal undo has no edit to undo");
+            }
+
+            apply_map_edit_step(*step, true);
+            break;
         }
 
-        if (row + 1 < kMapCanvasRows) {
-            queue_cell(cell_index + kMapCanvasColumns);
+        case MapJournalRecord::Redo: {
+            const MapEditStep* const step = map_editor_.redo();
+
+            if (step == nullptr) {
+                throw std::runtime_error("Map journal redo has no edit to redo");
+            }
+
+            apply_map_edit_step(*step, false);
+            break;
         }
-    }
 
-    begin_map_edit();
-    wait_for_rendering_resources();
+        default:
+            throw std::runtime_error("Unknown map journal record");
+    }
 
-    for (const std::size_t cell_index : filled_cells) {
-        const std::uint32_t column =
-            static_cast<std::uint32_t>(
-                cell_index % kMapCanvasColumns
-            );
-        const std::uint32_t row =
-            static_cast<std::uint32_t>(
-                cell_index / kMapCanvasColumns
-            );
+    if (reader.remaining() != 0) {
+        throw std::runtime_error("Map journal record has trailing data");
+    }
+}
 
-        map_tiles.at(cell_index) = replacement;
-        upload_map_tile_vertices(column, row);
+void Application::record_map_journal(std::vector<std::byte> record)
+{
+    if (map_journal_ == nullptr) {
+        return;
     }
 
-    finish_map_edit();
+    try {
+        map_journal_->append(std::move(record));
 
-    std::cout << "[Midnight] Flood-filled "
-              << filled_cells.size()
-              << " connected map cells with atlas tile ("
-              << replacement.tileset_column
-              << ", "
-              << replacement.tileset_row
-              << ")\n";
+        if (map_journal_->records_since_snapshot() >=
+            kMapJournalCompactionInterval) {
+            map_journal_->write_snapshot(encode_map_history());
+        }
+    } catch (const std::exception& error) {
+        MIDNIGHT_LOG_WARNING(
+            Map,
+            "Autosave disabled: {}",
+            error.what()
+        );
+        map_journal_.reset();
+    }
 }
 
-void Application::delete_selected_map_area()
+void Application::recover_map_autosave()
 {
-    if (!map_area_selection_visible_) {
-        std::cout << "[Midnight] No map area selected\n";
-        return;
+    const auto recovery_start = std::chrono::steady_clock::now();
+    MapEditJournal::Recovery recovery{};
+    bool recovered = false;
+
+    try {
+        recovery = MapEditJournal::recover(
+            kMapJournalFileName,
+            kMapSnapshotFileName
+        );
+
+        if (!recovery.snapshot.empty()) {
+            restore_map_history(recovery.snapshot);
+            recovered = true;
+        }
+
+        for (const std::vector<std::byte>& record : recovery.records) {
+            replay_map_journal_record(record);
+            recovered = true;
+        }
+    } catch (const std::exception& error) {
+        MIDNIGHT_LOG_WARNING(
+            Map,
+            "Discarding unreadable autosave: {}",
+            error.what()
+        );
+
+        recovery = MapEditJournal::Recovery{};
+        recovered = false;
+        map_editor_.reset();
+        apply_map_area_selection_state(MapSelection{});
     }
 
-    if (tile_selection_dragging_ ||
-        map_paint_dragging_ ||
-        map_rectangle_dragging_ ||
-        map_area_selection_dragging_ ||
-        map_erase_dragging_ ||
-        map_edit_active_) {
-        return;
+    if (recovered) {
+        sync_all_map_tiles();
+
+        const auto recovery_time =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - recovery_start
+            );
+
+        const double recovery_milliseconds =
+            static_cast<double>(recovery_time.count()) / 1000.0;
+
+        if (recovery.discarded_bytes > 0) {
+            MIDNIGHT_LOG_INFO(
+                Map,
+                "Recovered map autosave: {} journal records replayed in {} ms "
+                "({} torn bytes dropped)",
+                recovery.records.size(),
+                recovery_milliseconds,
+                recovery.discarded_bytes
+            );
+        } else {
+            MIDNIGHT_LOG_INFO(
+                Map,
+                "Recovered map autosave: {} journal records replayed in {} ms",
+                recovery.records.size(),
+                recovery_milliseconds
+            );
+        }
     }
 
-    MapTileLayer& map_tiles = active_map_tiles();
-    std::size_t deleted_cell_count = 0;
+    try {
+        map_journal_ = std::make_unique<MapEditJournal>(
+            kMapJournalFileName,
+            kMapSnapshotFileName,
+            recovery
+        );
 
-    for (std::uint32_t row = map_area_selection_top_;
-         row <= map_area_selection_bottom_;
-         ++row) {
-        for (std::uint32_t column = map_area_selection_left_;
-             column <= map_area_selection_right_;
-             ++column) {
-            const std::size_t cell_index =
-                static_cast<std::size_t>(row) *
-                    kMapCanvasColumns +
-                column;
-
-            if (map_tiles.at(cell_index).occupied) {
-                ++deleted_cell_count;
-            }
+        if (recovery.snapshot.empty() && recovery.records.empty()) {
+            map_journal_->write_snapshot(encode_map_history());
+        }
+    } catch (const std::exception& error) {
+        MIDNIGHT_LOG_WARNING(
+            Map,
+            "Autosave disabled: {}",
+            error.what()
+        );
+        map_journal_.reset();
+    }
+}
+
+MapFileLayout Application::map_file_layout() const
+{
+    MapFileLayout layout{
+        .columns = kMapCanvasColumns,
+        .rows = kMapCanvasRows,
+        .chunk_size = kMapFileChunkSize,
+        .layer_flags = std::vector<std::uint32_t>(kMapLayerCount, 0)
+    };
+
+    for (std::size_t layer_index = 0;
+         layer_index < kMapLayerCount;
+         ++layer_index) {
+        if (map_layer_blocks_movement(static_cast<MapLayer>(layer_index))) {
+            layout.layer_flags[layer_index] =
+                MapFileLayout::kLayerBlocksMovement;
+        }
+    }
+
+    return layout;
+}
+
+void Application::save_map()
+{
+    if (map_editor_.editing() ||
+        map_area_selection_dragging_) {
+        return;
+    }
+
+    const std::filesystem::path path = kMapFileName;
+
+    try {
+        const MapFileSaveStats stats = save_map_file(
+            path,
+            map_file_layout(),
+            [this](
+                const std::uint32_t layer,
+                const std::size_t chunk_index,
+                const std::span<PackedMapTile> tiles
+            ) {
+                map_editor_.map().copy_block(
+                    layer,
+                    static_cast<std::uint32_t>(
+                        chunk_index % kMapFileChunkColumns
+                    ) * kMapFileChunkSize,
+                    static_cast<std::uint32_t>(
+                        chunk_index / kMapFileChunkColumns
+                    ) * kMapFileChunkSize,
+                    kMapFileChunkSize,
+                    kMapFileChunkSize,
+                    tiles
+                );
+            },
+            map_file_dirty_chunks_,
+            map_file_.get()
+        );
+
+        map_file_ = std::make_unique<MapFile>(path);
+        std::ranges::fill(map_file_dirty_chunks_, std::uint8_t{0});
+
+        MIDNIGHT_LOG_INFO(
+            Map,
+            "Saved map to {} ({} chunks encoded, {} unchanged, {} bytes)",
+            path.string(),
+            stats.encoded_chunk_count,
+            stats.copied_chunk_count,
+            stats.file_bytes
+        );
+    } catch (const std::exception& error) {
+        MIDNIGHT_LOG_WARNING(
+            Map,
+            "Failed to save map: {}",
+            error.what()
+        );
+    }
+}
+
+void Application::load_map()
+{
+    if (map_editor_.editing() ||
+        map_area_selection_dragging_) {
+        return;
+    }
+
+    const std::filesystem::path path = kMapFileName;
+
+    if (!std::filesystem::exists(path)) {
+        MIDNIGHT_LOG_INFO(
+            Map,
+            "No saved map at {}",
+            path.string()
+        );
+        return;
+    }
+
+    std::unique_ptr<MapFile> map_file;
+    TileMap loaded_tiles(kMapCanvasColumns, kMapCanvasRows, kMapLayerCount);
+
+    try {
+        map_file = std::make_unique<MapFile>(path);
+
+        const MapFileLayout& layout = map_file->layout();
+
+        if (layout.columns != kMapCanvasColumns ||
+            layout.rows != kMapCanvasRows ||
+            layout.layer_count() != kMapLayerCount) {
+            throw std::runtime_error(
+                "Map file dimensions do not match the map canvas"
+            );
+        }
+
+        // Empty chunks are already zero in `loaded_tiles`, so they are never
+        // decoded; every other chunk is checked and copied a row at a time.
+        for (std::uint32_t layer = 0; layer < kMapLayerCount; ++layer) {
+            const std::span<PackedMapTile> loaded_layer =
+                loaded_tiles.layer(layer);
+
+            for (std::size_t chunk_index = 0;
+                 chunk_index < layout.chunk_count();
+                 ++chunk_index) {
+                if (map_file->chunk_encoding(layer, chunk_index) ==
+                    MapChunkEncoding::Empty) {
+                    continue;
+                }
+
+                const std::span<const PackedMapTile> chunk_tiles =
+                    map_file->chunk_tiles(layer, chunk_index);
+
+                for (const PackedMapTile tile : chunk_tiles) {
+                    if (packed_map_tile_occupied(tile) &&
+                        (packed_map_tile_column(tile) >= kOutdoorTilesetColumns ||
+                         packed_map_tile_row(tile) >= kOutdoorTilesetRows)) {
+                        throw std::runtime_error(
+                            "Map file references a tile outside the tileset"
+                        );
+                    }
+                }
+
+                const std::uint32_t first_column =
+                    static_cast<std::uint32_t>(
+                        chunk_index % kMapFileChunkColumns
+                    ) * kMapFileChunkSize;
+                const std::uint32_t first_row =
+                    static_cast<std::uint32_t>(
+                        chunk_index / kMapFileChunkColumns
+                    ) * kMapFileChunkSize;
+                const std::uint32_t chunk_columns = std::min(
+                    kMapFileChunkSize,
+                    kMapCanvasColumns - first_column
+                );
+                const std::uint32_t chunk_rows = std::min(
+                    kMapFileChunkSize,
+                    kMapCanvasRows - first_row
+                );
+
+                for (std::uint32_t row = 0; row < chunk_rows; ++row) {
+                    copy_map_tile_span(
+                        loaded_layer.subspan(
+                            loaded_tiles.cell_index(
+                                first_column,
+                                first_row + row
+                            ),
+                            chunk_columns
+                        ),
+                        chunk_tiles.subspan(
+                            static_cast<std::size_t>(row) * kMapFileChunkSize,
+                            chunk_columns
+                        )
+                    );
+                }
+            }
+        }
+    } catch (const std::exception& error) {
+        MIDNIGHT_LOG_WARNING(
+            Map,
+            "Failed to load map: {}",
+            error.what()
+        );
+        return;
+    }
+
+    begin_map_edit();
+    sync_map_changes(map_editor_.replace(loaded_tiles));
+    finish_map_edit();
+
+    map_file_ = std::move(map_file);
+    std::ranges::fill(map_file_dirty_chunks_, std::uint8_t{0});
+
+    MIDNIGHT_LOG_INFO(
+        Map,
+        "Loaded map from {} ({} chunks decoded)",
+        path.string(),
+        map_file_->decoded_chunk_count()
+    );
+}
+
+void Application::export_tiled_map_file()
+{
+    if (map_editor_.editing() ||
+        map_area_selection_dragging_) {
+        return;
+    }
+
+    TiledMap tiled_map{
+        .width = kMapCanvasColumns,
+        .height = kMapCanvasRows,
+        .tile_width = kTilesetTileWidth,
+        .tile_height = kTilesetTileHeight,
+        .tilesets = {},
+        .layers = {}
+    };
+
+    TiledTileset& tileset = tiled_map.tilesets.emplace_back();
+    tileset.name = "outdoor_tileset";
+    tileset.tile_width = kTilesetTileWidth;
+    tileset.tile_height = kTilesetTileHeight;
+    tileset.tile_count = kOutdoorTilesetColumns * kOutdoorTilesetRows;
+    tileset.columns = kOutdoorTilesetColumns;
+    tileset.image_source = (
+        std::filesystem::path(MIDNIGHT_ASSET_DIR) /
+        "tilesets/basic_village/outdoor_tileset.png"
+    ).string();
+    tileset.image_width = kOutdoorTilesetWidth;
+    tileset.image_height = kOutdoorTilesetHeight;
+
+    for (std::size_t layer_index = 0;
+         layer_index < kMapLayerCount;
+         ++layer_index) {
+        TiledTileLayer& layer = tiled_map.layers.emplace_back();
+        layer.name = map_layer_name(static_cast<MapLayer>(layer_index));
+        layer.gids.reserve(kMapCanvasCellCount);
+
+        for (const PackedMapTile tile : map_editor_.map().layer(layer_index)) {
+            layer.gids.push_back(
+                packed_map_tile_occupied(tile)
+                    ? tileset.first_gid +
+                          packed_map_tile_row(tile) * kOutdoorTilesetColumns +
+                          packed_map_tile_column(tile)
+                    : 0
+            );
+        }
+    }
+
+    try {
+        export_tiled_map(
+            kTiledMapFileName,
+            tiled_map,
+            TiledDataEncoding::Csv
+        );
+    } catch (const std::exception& error) {
+        MIDNIGHT_LOG_WARNING(
+            Map,
+            "Failed to export Tiled map: {}",
+            error.what()
+        );
+        return;
+    }
+
+    MIDNIGHT_LOG_INFO(
+        Map,
+        "Exported map to {}",
+        kTiledMapFileName
+    );
+}
+
+void Application::import_tiled_map_file()
+{
+    if (map_editor_.editing() ||
+        map_area_selection_dragging_) {
+        return;
+    }
+
+    if (!std::filesystem::exists(kTiledMapFileName)) {
+        MIDNIGHT_LOG_INFO(
+            Map,
+            "No Tiled map at {}",
+            kTiledMapFileName
+        );
+        return;
+    }
+
+    TiledMap tiled_map;
+
+    try {
+        tiled_map = import_tiled_map(kTiledMapFileName, &jobs_);
+    } catch (const std::exception& error) {
+        MIDNIGHT_LOG_WARNING(
+            Map,
+            "Failed to import Tiled map: {}",
+            error.what()
+        );
+        return;
+    }
+
+    // Tile layers fill Midnight's layers in document order; everything past
+    // the canvas, past the last layer, or outside the atlas is skipped.
+    TileMap imported_tiles(kMapCanvasColumns, kMapCanvasRows, kMapLayerCount);
+    std::size_t skipped_tile_count = 0;
+    const std::uint32_t copy_columns =
+        std::min(tiled_map.width, kMapCanvasColumns);
+    const std::uint32_t copy_rows =
+        std::min(tiled_map.height, kMapCanvasRows);
+
+    for (std::size_t layer_index = 0;
+         layer_index < std::min(tiled_map.layers.size(), kMapLayerCount);
+         ++layer_index) {
+        const TiledTileLayer& layer = tiled_map.layers[layer_index];
+
+        for (std::uint32_t row = 0; row < copy_rows; ++row) {
+            for (std::uint32_t column = 0; column < copy_columns; ++column) {
+                const std::uint32_t gid =
+                    layer.gids[
+                        static_cast<std::size_t>(row) * tiled_map.width +
+                        column
+                    ] & kTiledGidMask;
+
+                if (gid == 0) {
+                    continue;
+                }
+
+                const TiledTileset* tileset = nullptr;
+
+                for (const TiledTileset& candidate : tiled_map.tilesets) {
+                    if (candidate.first_gid <= gid &&
+                        (tileset == nullptr ||
+                         candidate.first_gid > tileset->first_gid)) {
+                        tileset = &candidate;
+                    }
+                }
+
+                const std::uint32_t tileset_columns =
+                    tileset != nullptr && tileset->columns != 0
+                        ? tileset->columns
+                        : kOutdoorTilesetColumns;
+                const std::uint32_t local_id =
+                    gid - (tileset != nullptr ? tileset->first_gid : 1);
+                const std::uint32_t tileset_column = local_id % tileset_columns;
+                const std::uint32_t tileset_row = local_id / tileset_columns;
+
+                if (tileset_column >= kOutdoorTilesetColumns ||
+                    tileset_row >= kOutdoorTilesetRows) {
+                    ++skipped_tile_count;
+                    continue;
+                }
+
+                imported_tiles.layer(layer_index)[
+                    imported_tiles.cell_index(column, row)
+                ] = pack_map_tile(tileset_column, tileset_row, true);
+            }
+        }
+    }
+
+    begin_map_edit();
+    sync_map_changes(map_editor_.replace(imported_tiles));
+    finish_map_edit();
+
+    if (skipped_tile_count > 0) {
+        MIDNIGHT_LOG_INFO(
+            Map,
+            "Imported {}x{} Tiled map with {} tile layers from {} "
+            "({} tiles outside the atlas skipped)",
+            tiled_map.width,
+            tiled_map.height,
+            tiled_map.layers.size(),
+            kTiledMapFileName,
+            skipped_tile_count
+        );
+    } else {
+        MIDNIGHT_LOG_INFO(
+            Map,
+            "Imported {}x{} Tiled map with {} tile layers from {}",
+            tiled_map.width,
+            tiled_map.height,
+            tiled_map.layers.size(),
+            kTiledMapFileName
+        );
+    }
+}
+
+void Application::flood_fill_map()
+{
+    if (!map_hover_visible_ ||
+        tile_selection_dragging_ ||
+        map_paint_dragging_ ||
+        map_rectangle_dragging_ ||
+        map_area_selection_dragging_ ||
+        map_erase_dragging_ ||
+        map_editor_.editing()) {
+        return;
+    }
+
+    if (selected_tile_left_ != selected_tile_right_ ||
+        selected_tile_top_ != selected_tile_bottom_) {
+        MIDNIGHT_LOG_INFO(Editor, "Flood fill requires a 1x1 atlas selection");
+        return;
+    }
+
+    begin_map_edit();
+
+    const std::span<const MapCellChange> filled_cells = map_editor_.apply(
+        MapFloodFillCommand{
+            .layer = active_map_layer_index(),
+            .column = hovered_map_column_,
+            .row = hovered_map_row_,
+            .tile = pack_map_tile(selected_tile_left_, selected_tile_top_, true)
+        }
+    );
+    const std::size_t filled_count = filled_cells.size();
+
+    sync_map_changes(filled_cells);
+    finish_map_edit();
+
+    if (filled_count == 0) {
+        return;
+    }
+
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Flood-filled {} connected map cells with atlas tile ({}, {})",
+        filled_count,
+        selected_tile_left_,
+        selected_tile_top_
+    );
+}
+
+// Selects the area spanning every cell of the active layer that holds the
+// selected atlas tile.
+void Application::find_map_tile()
+{
+    if (tile_selection_dragging_ ||
+        map_paint_dragging_ ||
+        map_rectangle_dragging_ ||
+        map_area_selection_dragging_ ||
+        map_erase_dragging_ ||
+        map_editor_.editing()) {
+        return;
+    }
+
+    if (selected_tile_left_ != selected_tile_right_ ||
+        selected_tile_top_ != selected_tile_bottom_) {
+        MIDNIGHT_LOG_INFO(Editor, "Finding a tile requires a 1x1 atlas selection");
+        return;
+    }
+
+    const PackedMapTile tile =
+        pack_map_tile(selected_tile_left_, selected_tile_top_, true);
+    std::vector<std::uint32_t> cells;
+
+    (void)map_editor_.tile_index().find(tile, active_map_layer_index(), cells);
+
+    if (cells.empty()) {
+        MIDNIGHT_LOG_INFO(
+            Editor,
+            "Atlas tile ({}, {}) is not on the active layer ({} cells on all layers)",
+            selected_tile_left_,
+            selected_tile_top_,
+            map_editor_.tile_index().count(tile)
+        );
+        return;
+    }
+
+    MapSelection found{
+        .left = kMapCanvasColumns - 1,
+        .top = kMapCanvasRows - 1,
+        .right = 0,
+        .bottom = 0,
+        .visible = true
+    };
+
+    for (const std::uint32_t cell : cells) {
+        const std::uint32_t column = cell % kMapCanvasColumns;
+        const std::uint32_t row = cell / kMapCanvasColumns;
+
+        found.left = std::min(found.left, column);
+        found.top = std::min(found.top, row);
+        found.right = std::max(found.right, column);
+        found.bottom = std::max(found.bottom, row);
+    }
+
+    apply_map_area_selection_state(found);
+
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Found atlas tile ({}, {}) in {} cells of the active layer ({} on all layers)",
+        selected_tile_left_,
+        selected_tile_top_,
+        cells.size(),
+        map_editor_.tile_index().count(tile)
+    );
+}
+
+void Application::log_map_tile_usage() const
+{
+    const MapTileIndex& index = map_editor_.tile_index();
+    const std::vector<MapTileUsage> usage = index.usage();
+    std::uint64_t cell_count = 0;
+    MapTileUsage most_used{};
+
+    for (const MapTileUsage& tile : usage) {
+        cell_count += tile.count;
+
+        if (tile.count > most_used.count) {
+            most_used = tile;
+        }
+    }
+
+    std::string unused;
+    std::size_t unused_count = 0;
+
+    for (std::uint32_t row = 0; row < kOutdoorTilesetRows; ++row) {
+        for (std::uint32_t column = 0; column < kOutdoorTilesetColumns; ++column) {
+            if (index.count(pack_map_tile(column, row, true)) == 0) {
+                unused += " (" + std::to_string(column) + ", " +
+                    std::to_string(row) + ")";
+                ++unused_count;
+            }
+        }
+    }
+
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Map uses {} distinct tiles in {} cells; {} of {} atlas tiles are unused",
+        usage.size(),
+        cell_count,
+        unused_count,
+        kOutdoorTilesetColumns * kOutdoorTilesetRows
+    );
+
+    if (most_used.count != 0) {
+        MIDNIGHT_LOG_INFO(
+            Editor,
+            "Most used atlas tile: ({}, {}) in {} cells",
+            packed_map_tile_column(most_used.tile),
+            packed_map_tile_row(most_used.tile),
+            most_used.count
+        );
+    }
+
+    if (unused_count != 0) {
+        MIDNIGHT_LOG_INFO(Editor, "Unused atlas tiles:{}", unused);
+    }
+}
+
+// Replace-all on the active layer: every copy of the hovered tile becomes
+// the selected atlas tile, as one undo step.
+void Application::replace_map_tile()
+{
+    if (!map_hover_visible_ ||
+        tile_selection_dragging_ ||
+        map_paint_dragging_ ||
+        map_rectangle_dragging_ ||
+        map_area_selection_dragging_ ||
+        map_erase_dragging_ ||
+        map_editor_.editing()) {
+        return;
+    }
+
+    if (selected_tile_left_ != selected_tile_right_ ||
+        selected_tile_top_ != selected_tile_bottom_) {
+        MIDNIGHT_LOG_INFO(Editor, "Replacing a tile requires a 1x1 atlas selection");
+        return;
+    }
+
+    const MapTile hovered_tile = map_editor_.map().tile(
+        active_map_layer_index(),
+        hovered_map_column_,
+        hovered_map_row_
+    );
+
+    if (!hovered_tile.occupied) {
+        return;
+    }
+
+    begin_map_edit();
+
+    const std::span<const MapCellChange> replaced_cells = map_editor_.apply(
+        MapReplaceTileCommand{
+            .layer = active_map_layer_index(),
+            .tile = pack_map_tile(hovered_tile),
+            .replacement =
+                pack_map_tile(selected_tile_left_, selected_tile_top_, true)
+        }
+    );
+    const std::size_t replaced_count = replaced_cells.size();
+
+    sync_map_changes(replaced_cells);
+    finish_map_edit();
+
+    if (replaced_count == 0) {
+        return;
+    }
+
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Replaced atlas tile ({}, {}) with ({}, {}) in {} map cells",
+        hovered_tile.tileset_column,
+        hovered_tile.tileset_row,
+        selected_tile_left_,
+        selected_tile_top_,
+        replaced_count
+    );
+}
+
+void Application::query_map_path()
+{
+    if (!map_hover_visible_) {
+        return;
+    }
+
+    if (!map_path_start_marked_) {
+        map_path_start_column_ = hovered_map_column_;
+        map_path_start_row_ = hovered_map_row_;
+        map_path_start_marked_ = true;
+
+        MIDNIGHT_LOG_INFO(
+            Navigation,
+            "Path start marked at map cell ({}, {})",
+            map_path_start_column_,
+            map_path_start_row_
+        );
+        return;
+    }
+
+    map_path_start_marked_ = false;
+
+    const auto query_start = std::chrono::steady_clock::now();
+    const std::size_t rebuilt_chunk_count = map_pathfinder_.refresh();
+    const std::optional<HierarchicalPathfinder::Path> path =
+        map_pathfinder_.find_path(
+            map_path_start_column_,
+            map_path_start_row_,
+            hovered_map_column_,
+            hovered_map_row_
+        );
+    const auto query_microseconds =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - query_start
+        ).count();
+
+    if (path.has_value()) {
+        MIDNIGHT_LOG_INFO(
+            Navigation,
+            "Path from map cell ({}, {}) to ({}, {}): {} steps in {} us "
+            "({} navigation chunks rebuilt, {} abstract nodes)",
+            map_path_start_column_,
+            map_path_start_row_,
+            hovered_map_column_,
+            hovered_map_row_,
+            path->cost,
+            query_microseconds,
+            rebuilt_chunk_count,
+            map_pathfinder_.abstract_node_count()
+        );
+    } else {
+        MIDNIGHT_LOG_INFO(
+            Navigation,
+            "Path from map cell ({}, {}) to ({}, {}): blocked in {} us "
+            "({} navigation chunks rebuilt, {} abstract nodes)",
+            map_path_start_column_,
+            map_path_start_row_,
+            hovered_map_column_,
+            hovered_map_row_,
+            query_microseconds,
+            rebuilt_chunk_count,
+            map_pathfinder_.abstract_node_count()
+        );
+    }
+}
+
+void Application::query_map_flow_field()
+{
+    if (!map_hover_visible_) {
+        return;
+    }
+
+    const std::size_t previous_misses = map_flow_fields_.stats().misses;
+    const auto query_start = std::chrono::steady_clock::now();
+    const std::shared_ptr<const FlowField> flow_field =
+        map_flow_fields_.field_to(hovered_map_column_, hovered_map_row_);
+    const auto query_microseconds =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - query_start
+        ).count();
+
+    MIDNIGHT_LOG_INFO(
+        Navigation,
+        "Flow field toward map cell ({}, {}): {} reachable cells, {} in {} us "
+        "({}/{} fields cached)",
+        hovered_map_column_,
+        hovered_map_row_,
+        flow_field->reachable_cell_count(),
+        map_flow_fields_.stats().misses == previous_misses ? "cached" : "built",
+        query_microseconds,
+        map_flow_fields_.size(),
+        map_flow_fields_.capacity()
+    );
+}
+
+void Application::spawn_map_sprites()
+{
+    if (!map_hover_visible_) {
+        return;
+    }
+
+    const std::unique_lock state_lock = simulation_.lock_state();
+    const std::size_t spawn_count = std::min(
+        kMapSpriteSpawnCount,
+        kMaxMapSpriteCount - map_entities_.entity_count()
+    );
+
+    if (spawn_count == 0) {
+        MIDNIGHT_LOG_INFO(
+            Simulation,
+            "Sprite limit of {} reached",
+            kMaxMapSpriteCount
+        );
+        return;
+    }
+
+    const auto column = static_cast<float>(hovered_map_column_);
+    const auto row = static_cast<float>(hovered_map_row_);
+    std::array<Entity, kMapSpriteSpawnCount> entities{};
+    const std::span<Entity> spawned_entities(entities.data(), spawn_count);
+
+    map_entities_.create_entities(
+        spawned_entities,
+        Position2D{.x = column, .y = row},
+        PreviousPosition2D{.x = column, .y = row},
+        Velocity2D{},
+        Sprite{
+            .tileset_column = selected_tile_left_,
+            .tileset_row = selected_tile_top_
+        }
+    );
+
+    std::uniform_real_distribution<float> angle(
+        0.0f,
+        2.0f * std::numbers::pi_v<float>
+    );
+    std::uniform_real_distribution<float> speed(
+        kMapSpriteMinSpeed,
+        kMapSpriteMaxSpeed
+    );
+
+    for (const Entity entity : spawned_entities) {
+        const float direction = angle(map_sprite_random_);
+        const float entity_speed = speed(map_sprite_random_);
+
+        *map_entities_.try_get<Velocity2D>(entity) = Velocity2D{
+            .x = std::cos(direction) * entity_speed,
+            .y = std::sin(direction) * entity_speed
+        };
+    }
+
+    MIDNIGHT_LOG_INFO(
+        Simulation,
+        "Spawned {} sprites at map cell ({}, {}), {} total",
+        spawn_count,
+        hovered_map_column_,
+        hovered_map_row_,
+        map_entities_.entity_count()
+    );
+
+    rebuild_sprite_spatial_grid(
+        map_entities_,
+        map_sprite_grid_,
+        map_sprite_grid_items_
+    );
+    publish_map_sprite_snapshot();
+}
+
+void Application::clear_map_sprites()
+{
+    const std::unique_lock state_lock = simulation_.lock_state();
+
+    if (map_entities_.entity_count() == 0) {
+        return;
+    }
+
+    map_entities_.clear();
+    rebuild_sprite_spatial_grid(
+        map_entities_,
+        map_sprite_grid_,
+        map_sprite_grid_items_
+    );
+    publish_map_sprite_snapshot();
+
+    MIDNIGHT_LOG_INFO(Simulation, "Cleared all sprites");
+}
+
+void Application::inspect_map_sprites()
+{
+    if (!map_hover_visible_) {
+        return;
+    }
+
+    std::vector<SpatialGrid::Item> cell_sprites;
+    std::vector<SpatialGrid::Item> nearest_sprites;
+    std::vector<std::pair<Entity, Entity>> overlapping_sprites;
+    const std::unique_lock state_lock = simulation_.lock_state();
+
+    map_sprite_grid_.query_cell(
+        hovered_map_column_,
+        hovered_map_row_,
+        cell_sprites
+    );
+    map_sprite_grid_.query_nearest(
+        static_cast<float>(hovered_map_column_) + 0.5f,
+        static_cast<float>(hovered_map_row_) + 0.5f,
+        1,
+        nearest_sprites
+    );
+    map_sprite_grid_.query_overlapping_pairs(
+        kMapSpriteOverlapDistance,
+        overlapping_sprites
+    );
+
+    if (!nearest_sprites.empty()) {
+        MIDNIGHT_LOG_INFO(
+            Simulation,
+            "Map cell ({}, {}): {} sprites, nearest sprite at ({}, {}), "
+            "{} overlapping sprite pairs on the map",
+            hovered_map_column_,
+            hovered_map_row_,
+            cell_sprites.size(),
+            nearest_sprites.front().x,
+            nearest_sprites.front().y,
+            overlapping_sprites.size()
+        );
+    } else {
+        MIDNIGHT_LOG_INFO(
+            Simulation,
+            "Map cell ({}, {}): {} sprites, {} overlapping sprite pairs on the map",
+            hovered_map_column_,
+            hovered_map_row_,
+            cell_sprites.size(),
+            overlapping_sprites.size()
+        );
+    }
+}
+
+void Application::publish_map_sprite_snapshot()
+{
+    capture_sprite_render_snapshot(map_entities_, map_sprite_back_snapshot_);
+
+    const std::lock_guard snapshot_lock(map_sprite_snapshot_mutex_);
+    std::swap(map_sprite_snapshot_, map_sprite_back_snapshot_);
+}
+
+void Application::upload_map_sprite_vertices()
+{
+    const VulkanFrameRenderer& frame_renderer =
+        *swapchain_resources_.frame_renderer;
+    const std::size_t region = frame_renderer.sprite_vertex_region();
+    std::size_t& uploaded_sprite_count = uploaded_map_sprite_counts_[region];
+
+    std::size_t sprite_count = 0;
+
+    {
+        // The snapshot is published before the step's time, so an alpha
+        // read now is never older than the positions it blends.
+        const std::lock_guard snapshot_lock(map_sprite_snapshot_mutex_);
+
+        if (map_sprite_snapshot_.sprites.empty() &&
+            uploaded_sprite_count == 0) {
+            return;
+        }
+
+        sprite_count = build_sprite_vertices(
+            map_sprite_snapshot_,
+            kMapSpriteRenderLayout,
+            simulation_.frame().interpolation_alpha,
+            map_sprite_vertices_
+        );
+    }
+
+    const std::size_t upload_count =
+        std::max(sprite_count, uploaded_sprite_count);
+
+    std::fill(
+        map_sprite_vertices_.begin() +
+            static_cast<std::ptrdiff_t>(sprite_count * 4),
+        map_sprite_vertices_.begin() +
+            static_cast<std::ptrdiff_t>(upload_count * 4),
+        Vertex2D{}
+    );
+
+    // The last frame to draw from this region has passed its fence wait
+    // unless retired swapchains still own frames the count cannot see.
+    if (!retired_swapchain_resources_.empty() ||
+        frame_renderer.completed_frame_count() <
+            frame_renderer.sprite_vertex_region_released_frame()) {
+        wait_for_rendering_resources();
+    }
+
+    quad_vertex_buffer_.upload(
+        map_sprite_vertices_.data(),
+        sizeof(Vertex2D) * upload_count * 4,
+        kMapSpriteVertexByteOffset + kMapSpriteVertexRegionByteSize * region
+    );
+
+    uploaded_sprite_count = sprite_count;
+}
+
+void Application::delete_selected_map_area()
+{
+    if (!map_area_selection_visible_) {
+        MIDNIGHT_LOG_INFO(Editor, "No map area selected");
+        return;
+    }
+
+    if (tile_selection_dragging_ ||
+        map_paint_dragging_ ||
+        map_rectangle_dragging_ ||
+        map_area_selection_dragging_ ||
+        map_erase_dragging_ ||
+        map_editor_.editing()) {
+        return;
+    }
+
+    begin_map_edit();
+
+    const std::span<const MapCellChange> deleted_cells = map_editor_.apply(
+        MapEraseCommand{
+            .layer = active_map_layer_index(),
+            .area = capture_map_area_selection_state().area()
+        }
+    );
+    const std::size_t deleted_cell_count = deleted_cells.size();
+
+    sync_map_changes(deleted_cells);
+    finish_map_edit();
+
+    if (deleted_cell_count == 0) {
+        MIDNIGHT_LOG_INFO(Editor, "Selected map area is already empty");
+        return;
+    }
+
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Deleted {} painted map cells from selected area ({}, {}) to ({}, {})",
+        deleted_cell_count,
+        map_area_selection_left_,
+        map_area_selection_top_,
+        map_area_selection_right_,
+        map_area_selection_bottom_
+    );
+}
+
+void Application::move_selected_map_area(
+    const int column_delta,
+    const int row_delta
+)
+{
+    if (!map_area_selection_visible_) {
+        MIDNIGHT_LOG_INFO(Editor, "No map area selected");
+        return;
+    }
+
+    if (tile_selection_dragging_ ||
+        map_paint_dragging_ ||
+        map_rectangle_dragging_ ||
+        map_area_selection_dragging_ ||
+        map_erase_dragging_ ||
+        map_editor_.editing()) {
+        return;
+    }
+
+    const int next_left =
+        static_cast<int>(map_area_selection_left_) +
+        column_delta;
+    const int next_top =
+        static_cast<int>(map_area_selection_top_) +
+        row_delta;
+    const int next_right =
+        static_cast<int>(map_area_selection_right_) +
+        column_delta;
+    const int next_bottom =
+        static_cast<int>(map_area_selection_bottom_) +
+        row_delta;
+
+    if (next_left < 0 ||
+        next_top < 0 ||
+        next_right >= static_cast<int>(kMapCanvasColumns) ||
+        next_bottom >= static_cast<int>(kMapCanvasRows)) {
+        MIDNIGHT_LOG_INFO(Editor, "Selected map area cannot move outside the map");
+        return;
+    }
+
+    begin_map_edit(true);
+    wait_for_rendering_resources();
+
+    sync_map_changes(map_editor_.apply(MapMoveRegionCommand{
+        .layer = active_map_layer_index(),
+        .area = capture_map_area_selection_state().area(),
+        .column_delta = column_delta,
+        .row_delta = row_delta
+    }));
+
+    apply_map_area_selection_state(MapSelection{
+        .left = static_cast<std::uint32_t>(next_left),
+        .top = static_cast<std::uint32_t>(next_top),
+        .right = static_cast<std::uint32_t>(next_right),
+        .bottom = static_cast<std::uint32_t>(next_bottom),
+        .visible = true
+    });
+    finish_map_edit();
+
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Moved selected map area to cells ({}, {}) to ({}, {})",
+        map_area_selection_left_,
+        map_area_selection_top_,
+        map_area_selection_right_,
+        map_area_selection_bottom_
+    );
+}
+
+void Application::copy_selected_map_area(const bool cut)
+{
+    if (!map_area_selection_visible_) {
+        MIDNIGHT_LOG_INFO(Editor, "No map area selected");
+        return;
+    }
+
+    if (tile_selection_dragging_ ||
+        map_paint_dragging_ ||
+        map_rectangle_dragging_ ||
+        map_area_selection_dragging_ ||
+        map_erase_dragging_ ||
+        map_editor_.editing()) {
+        return;
+    }
+
+    const MapCellRect area = capture_map_area_selection_state().area();
+    map_clipboard_ = std::make_shared<const TileMap>(
+        copy_map_region(map_editor_.map(), area)
+    );
+
+    if (cut) {
+        begin_map_edit();
+
+        for (std::size_t layer = 0; layer < kMapLayerCount; ++layer) {
+            sync_map_changes(map_editor_.apply(MapEraseCommand{
+                .layer = layer,
+                .area = area
+            }));
+        }
+
+        finish_map_edit();
+    }
+
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "{} {}x{} map area from cell ({}, {}) on every layer",
+        cut ? "Cut" : "Copied",
+        area.columns(),
+        area.rows(),
+        area.left,
+        area.top
+    );
+}
+
+// Pastes at the hovered cell and selects what was pasted, so Ctrl+Arrow
+// can nudge it into place. Ctrl+Shift+V pastes transparently, keeping the
+// tiles under the clipboard's empty cells.
+void Application::paste_map_clipboard(const bool transparent)
+{
+    if (!map_hover_visible_ ||
+        tile_selection_dragging_ ||
+        map_paint_dragging_ ||
+        map_rectangle_dragging_ ||
+        map_area_selection_dragging_ ||
+        map_erase_dragging_ ||
+        map_editor_.editing()) {
+        return;
+    }
+
+    if (map_clipboard_ == nullptr) {
+        MIDNIGHT_LOG_INFO(Editor, "Map clipboard is empty");
+        return;
+    }
+
+    const std::uint32_t column = hovered_map_column_;
+    const std::uint32_t row = hovered_map_row_;
+    const std::uint32_t right = std::min(
+        column + map_clipboard_->columns() - 1,
+        kMapCanvasColumns - 1
+    );
+    const std::uint32_t bottom = std::min(
+        row + map_clipboard_->rows() - 1,
+        kMapCanvasRows - 1
+    );
+
+    begin_map_edit(true);
+    sync_map_changes(map_editor_.apply(MapPasteCommand{
+        .region = map_clipboard_,
+        .column = column,
+        .row = row,
+        .transparent = transparent
+    }));
+    apply_map_area_selection_state(MapSelection{
+        .left = column,
+        .top = row,
+        .right = right,
+        .bottom = bottom,
+        .visible = true
+    });
+    finish_map_edit();
+
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Pasted {}x{} map area{} at cells ({}, {}) to ({}, {})",
+        map_clipboard_->columns(),
+        map_clipboard_->rows(),
+        transparent ? " transparently" : "",
+        column,
+        row,
+        right,
+        bottom
+    );
+}
+
+// Ctrl+Shift+N saves the clipboard as stamp N; Ctrl+N puts stamp N back
+// on the clipboard for pasting.
+void Application::select_map_stamp(
+    const std::size_t slot,
+    const bool save
+)
+{
+    if (save) {
+        if (map_clipboard_ == nullptr) {
+            MIDNIGHT_LOG_INFO(Editor, "Map clipboard is empty");
+            return;
         }
-    }
 
-    if (deleted_cell_count == 0) {
-        std::cout << "[Midnight] Selected map area is already empty\n";
+        map_stamps_[slot] = map_clipboard_;
+
+        MIDNIGHT_LOG_INFO(
+            Editor,
+            "Saved {}x{} clipboard as stamp {}",
+            map_clipboard_->columns(),
+            map_clipboard_->rows(),
+            slot + 1
+        );
         return;
     }
 
-    begin_map_edit();
-    wait_for_rendering_resources();
-
-    for (std::uint32_t row = map_area_selection_top_;
-         row <= map_area_selection_bottom_;
-         ++row) {
-        for (std::uint32_t column = map_area_selection_left_;
-             column <= map_area_selection_right_;
-             ++column) {
-            const std::size_t cell_index =
-                static_cast<std::size_t>(row) *
-                    kMapCanvasColumns +
-                column;
-            MapTile& map_tile = map_tiles.at(cell_index);
-
-            if (!map_tile.occupied) {
-                continue;
-            }
-
-            map_tile = MapTile{};
-            upload_map_tile_vertices(column, row);
-        }
+    if (map_stamps_[slot] == nullptr) {
+        MIDNIGHT_LOG_INFO(Editor, "Stamp {} is empty", slot + 1);
+        return;
     }
 
-    finish_map_edit();
+    map_clipboard_ = map_stamps_[slot];
 
-    std::cout << "[Midnight] Deleted "
-              << deleted_cell_count
-              << " painted map cells from selected area ("
-              << map_area_selection_left_
-              << ", "
-              << map_area_selection_top_
-              << ") to ("
-              << map_area_selection_right_
-              << ", "
-              << map_area_selection_bottom_
-              << ")\n";
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Loaded {}x{} stamp {} into the clipboard",
+        map_clipboard_->columns(),
+        map_clipboard_->rows(),
+        slot + 1
+    );
 }
 
-void Application::move_selected_map_area(
-    const int column_delta,
-    const int row_delta
-)
+// T steps through the terrains and back to painting atlas selections.
+void Application::cycle_map_terrain_brush()
 {
-    if (!map_area_selection_visible_) {
-        std::cout << "[Midnight] No map area selected\n";
-        return;
-    }
-
     if (tile_selection_dragging_ ||
         map_paint_dragging_ ||
         map_rectangle_dragging_ ||
         map_area_selection_dragging_ ||
         map_erase_dragging_ ||
-        map_edit_active_) {
+        map_editor_.editing()) {
         return;
     }
 
-    MapTileLayer& map_tiles = active_map_tiles();
-    const int next_left =
-        static_cast<int>(map_area_selection_left_) +
-        column_delta;
-    const int next_top =
-        static_cast<int>(map_area_selection_top_) +
-        row_delta;
-    const int next_right =
-        static_cast<int>(map_area_selection_right_) +
-        column_delta;
-    const int next_bottom =
-        static_cast<int>(map_area_selection_bottom_) +
-        row_delta;
+    map_terrain_brush_ =
+        map_terrain_brush_ < map_auto_tiler_.terrains().size()
+            ? static_cast<std::uint8_t>(map_terrain_brush_ + 1)
+            : MapAutoTiler::kNoTerrain;
 
-    if (next_left < 0 ||
-        next_top < 0 ||
-        next_right >= static_cast<int>(kMapCanvasColumns) ||
-        next_bottom >= static_cast<int>(kMapCanvasRows)) {
-        std::cout << "[Midnight] Selected map area cannot move outside the map\n";
+    if (map_terrain_brush_ == MapAutoTiler::kNoTerrain) {
+        MIDNIGHT_LOG_INFO(Editor, "Terrain brush off; painting atlas selections");
         return;
     }
 
-    const std::uint32_t selected_column_count =
-        map_area_selection_right_ -
-        map_area_selection_left_ +
-        1;
-    const std::uint32_t selected_row_count =
-        map_area_selection_bottom_ -
-        map_area_selection_top_ +
-        1;
-    std::vector<MapTile> selected_tiles;
-    selected_tiles.reserve(
-        static_cast<std::size_t>(selected_column_count) *
-        selected_row_count
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Terrain brush: {}",
+        map_auto_tiler_.terrains()[map_terrain_brush_ - 1].name
     );
+}
 
-    for (std::uint32_t row_offset = 0;
-         row_offset < selected_row_count;
-         ++row_offset) {
-        for (std::uint32_t column_offset = 0;
-             column_offset < selected_column_count;
-             ++column_offset) {
-            const std::uint32_t column =
-                map_area_selection_left_ + column_offset;
-            const std::uint32_t row =
-                map_area_selection_top_ + row_offset;
-            const std::size_t cell_index =
-                static_cast<std::size_t>(row) *
-                    kMapCanvasColumns +
-                column;
-
-            selected_tiles.push_back(
-                map_tiles.at(cell_index)
-            );
-        }
-    }
-
-    std::vector<MapTile> moved_tiles = map_tiles;
-
-    for (std::uint32_t row = map_area_selection_top_;
-         row <= map_area_selection_bottom_;
-         ++row) {
-        for (std::uint32_t column = map_area_selection_left_;
-             column <= map_area_selection_right_;
-             ++column) {
-            const std::size_t cell_index =
-                static_cast<std::size_t>(row) *
-                    kMapCanvasColumns +
-                column;
-            moved_tiles.at(cell_index) = MapTile{};
-        }
+void Application::generate_map_canvas(const bool next_kind)
+{
+    if (tile_selection_dragging_ ||
+        map_paint_dragging_ ||
+        map_rectangle_dragging_ ||
+        map_area_selection_dragging_ ||
+        map_erase_dragging_ ||
+        map_editor_.editing()) {
+        return;
     }
 
-    for (std::uint32_t row_offset = 0;
-         row_offset < selected_row_count;
-         ++row_offset) {
-        for (std::uint32_t column_offset = 0;
-             column_offset < selected_column_count;
-             ++column_offset) {
-            const std::uint32_t column =
-                static_cast<std::uint32_t>(next_left) +
-                column_offset;
-            const std::uint32_t row =
-                static_cast<std::uint32_t>(next_top) +
-                row_offset;
-            const std::size_t destination_index =
-                static_cast<std::size_t>(row) *
-                    kMapCanvasColumns +
-                column;
-            const std::size_t selected_index =
-                static_cast<std::size_t>(row_offset) *
-                    selected_column_count +
-                column_offset;
-
-            moved_tiles.at(destination_index) =
-                selected_tiles.at(selected_index);
-        }
+    if (next_kind) {
+        map_generator_kind_ = map_generator_kind_ == MapGeneratorKind::Rooms
+            ? MapGeneratorKind::Noise
+            : static_cast<MapGeneratorKind>(
+                  static_cast<std::uint8_t>(map_generator_kind_) + 1
+              );
     }
 
-    begin_map_edit(true);
-    wait_for_rendering_resources();
-
-    for (std::size_t cell_index = 0;
-         cell_index < map_tiles.size();
-         ++cell_index) {
-        if (map_tiles.at(cell_index) ==
-            moved_tiles.at(cell_index)) {
-            continue;
-        }
-
-        map_tiles.at(cell_index) =
-            moved_tiles.at(cell_index);
+    // Drawn from the replay-seeded generator so recorded sessions generate
+    // the same maps when played back.
+    const std::uint64_t seed =
+        static_cast<std::uint64_t>(map_sprite_random_()) << 32 |
+        map_sprite_random_();
+
+    // Sized for the canvas; the 4096-cell defaults would give a single
+    // room or one flat stretch of noise.
+    const MapGeneratorSettings settings{
+        .kind = map_generator_kind_,
+        .seed = seed,
+        .ground_layer = map_layer_index(MapLayer::Ground),
+        .wall_layer = map_layer_index(MapLayer::AboveGround),
+        .ground_tile = kGeneratedGroundTile,
+        .water_tile = kGeneratedWaterTile,
+        .wall_tile = kGeneratedWallTile,
+        .noise_scale = 8,
+        .noise_octaves = 3,
+        .room_min_size = 2,
+        .room_max_size = 4
+    };
 
-        upload_map_tile_vertices(
-            static_cast<std::uint32_t>(
-                cell_index % kMapCanvasColumns
-            ),
-            static_cast<std::uint32_t>(
-                cell_index / kMapCanvasColumns
-            )
-        );
-    }
+    TileMap generated = map_editor_.map();
+    generate_map(generated, settings, &jobs_);
 
-    apply_map_area_selection_state(MapAreaSelectionState{
-        .left = static_cast<std::uint32_t>(next_left),
-        .top = static_cast<std::uint32_t>(next_top),
-        .right = static_cast<std::uint32_t>(next_right),
-        .bottom = static_cast<std::uint32_t>(next_bottom),
-        .visible = true
-    });
+    begin_map_edit();
+    sync_map_changes(map_editor_.replace(generated));
     finish_map_edit();
 
-    std::cout << "[Midnight] Moved selected map area to cells ("
-              << map_area_selection_left_
-              << ", "
-              << map_area_selection_top_
-              << ") to ("
-              << map_area_selection_right_
-              << ", "
-              << map_area_selection_bottom_
-              << ")\n";
+    constexpr const char* kGeneratorKindNames[] = {"noise", "caves", "rooms"};
+
+    MIDNIGHT_LOG_INFO(
+        Map,
+        "Generated {} map with seed {}",
+        kGeneratorKindNames[static_cast<std::size_t>(map_generator_kind_)],
+        seed
+    );
 }
 
 bool Application::begin_map_rectangle_paint(
@@ -2623,93 +4494,56 @@ void Application::update_map_rectangle_paint(
 
 void Application::apply_map_rectangle_paint()
 {
-    const MapTileLayer& edit_before_tiles =
-        active_map_edit_before_.at(
-            map_layer_index(active_map_layer_)
-        );
-    MapTileLayer& map_tiles = active_map_tiles();
-
     if (!map_rectangle_dragging_ ||
-        !map_edit_active_ ||
-        edit_before_tiles.size() != map_tiles.size()) {
+        !map_editor_.editing()) {
         return;
     }
 
-    const std::uint32_t left = std::min(
-        map_rectangle_anchor_column_,
-        map_rectangle_end_column_
-    );
-    const std::uint32_t top = std::min(
-        map_rectangle_anchor_row_,
-        map_rectangle_end_row_
-    );
-    const std::uint32_t right = std::max(
-        map_rectangle_anchor_column_,
-        map_rectangle_end_column_
-    );
-    const std::uint32_t bottom = std::max(
-        map_rectangle_anchor_row_,
-        map_rectangle_end_row_
-    );
-    const std::uint32_t selected_column_count =
-        map_rectangle_tileset_right_ -
-        map_rectangle_tileset_left_ +
-        1;
-    const std::uint32_t selected_row_count =
-        map_rectangle_tileset_bottom_ -
-        map_rectangle_tileset_top_ +
-        1;
+    const MapCellRect area{
+        .left = std::min(
+            map_rectangle_anchor_column_,
+            map_rectangle_end_column_
+        ),
+        .top = std::min(
+            map_rectangle_anchor_row_,
+            map_rectangle_end_row_
+        ),
+        .right = std::max(
+            map_rectangle_anchor_column_,
+            map_rectangle_end_column_
+        ),
+        .bottom = std::max(
+            map_rectangle_anchor_row_,
+            map_rectangle_end_row_
+        )
+    };
 
-    std::vector<MapTile> rectangle_tiles =
-        edit_before_tiles;
-
-    for (std::uint32_t row = top; row <= bottom; ++row) {
-        for (std::uint32_t column = left;
-             column <= right;
-             ++column) {
-            const std::size_t cell_index =
-                static_cast<std::size_t>(row) *
-                    kMapCanvasColumns +
-                column;
-
-            rectangle_tiles.at(cell_index) = MapTile{
-                .tileset_column =
-                    map_rectangle_tileset_left_ +
-                    (column - left) % selected_column_count,
-                .tileset_row =
-                    map_rectangle_tileset_top_ +
-                    (row - top) % selected_row_count,
-                .occupied = true
-            };
-        }
-    }
+    // The edit so far is the previous rectangle; its cells go back to how
+    // the drag found them before the new rectangle is painted.
+    const std::vector<MapCellChange> previous_changes =
+        map_editor_.revert_session();
 
-    if (rectangle_tiles == map_tiles) {
+    sync_map_changes(previous_changes);
+
+    if (map_terrain_brush_ != MapAutoTiler::kNoTerrain) {
+        sync_map_changes(map_editor_.apply(MapPaintTerrainCommand{
+            .layer = active_map_layer_index(),
+            .area = area,
+            .terrain = map_terrain_brush_
+        }));
         return;
     }
 
-    wait_for_rendering_resources();
-
-    for (std::size_t cell_index = 0;
-         cell_index < map_tiles.size();
-         ++cell_index) {
-        if (rectangle_tiles.at(cell_index) ==
-            map_tiles.at(cell_index)) {
-            continue;
+    sync_map_changes(map_editor_.apply(MapPaintStampCommand{
+        .layer = active_map_layer_index(),
+        .area = area,
+        .pattern = MapCellRect{
+            .left = map_rectangle_tileset_left_,
+            .top = map_rectangle_tileset_top_,
+            .right = map_rectangle_tileset_right_,
+            .bottom = map_rectangle_tileset_bottom_
         }
-
-        map_tiles.at(cell_index) =
-            rectangle_tiles.at(cell_index);
-
-        upload_map_tile_vertices(
-            static_cast<std::uint32_t>(
-                cell_index % kMapCanvasColumns
-            ),
-            static_cast<std::uint32_t>(
-                cell_index / kMapCanvasColumns
-            )
-        );
-    }
+    }));
 }
 
 void Application::finish_map_rectangle_paint()
@@ -2743,10 +4577,8 @@ void Application::finish_map_rectangle_paint()
         map_rectangle_tileset_top_ +
         1;
     const bool map_changed =
-        map_edit_active_ &&
-        active_map_edit_before_.at(
-            map_layer_index(active_map_layer_)
-        ) != active_map_tiles();
+        map_editor_.editing() &&
+        !map_editor_.session_changes().empty();
 
     map_rectangle_dragging_ = false;
     finish_map_edit();
@@ -2755,19 +4587,30 @@ void Application::finish_map_rectangle_paint()
         return;
     }
 
-    std::cout << "[Midnight] Painted filled rectangle from map cell ("
-              << left
-              << ", "
-              << top
-              << ") to ("
-              << right
-              << ", "
-              << bottom
-              << ") with repeating "
-              << selected_column_count
-              << "x"
-              << selected_row_count
-              << " atlas selection\n";
+    if (map_terrain_brush_ != MapAutoTiler::kNoTerrain) {
+        MIDNIGHT_LOG_INFO(
+            Editor,
+            "Painted {} terrain rectangle from map cell ({}, {}) to ({}, {})",
+            map_auto_tiler_.terrains()[map_terrain_brush_ - 1].name,
+            left,
+            top,
+            right,
+            bottom
+        );
+        return;
+    }
+
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Painted filled rectangle from map cell ({}, {}) to ({}, {}) "
+        "with repeating {}x{} atlas selection",
+        left,
+        top,
+        right,
+        bottom,
+        selected_column_count,
+        selected_row_count
+    );
 }
 
 bool Application::begin_map_area_selection_drag(
@@ -2874,19 +4717,16 @@ void Application::finish_map_area_selection_drag()
         map_area_selection_top_ +
         1;
 
-    std::cout << "[Midnight] Selected map area from cell ("
-              << map_area_selection_left_
-              << ", "
-              << map_area_selection_top_
-              << ") to ("
-              << map_area_selection_right_
-              << ", "
-              << map_area_selection_bottom_
-              << "), "
-              << selected_column_count
-              << "x"
-              << selected_row_count
-              << " cells\n";
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Selected map area from cell ({}, {}) to ({}, {}), {}x{} cells",
+        map_area_selection_left_,
+        map_area_selection_top_,
+        map_area_selection_right_,
+        map_area_selection_bottom_,
+        selected_column_count,
+        selected_row_count
+    );
 }
 
 bool Application::paint_map_selection(
@@ -2915,7 +4755,35 @@ bool Application::paint_map_selection(
     last_map_paint_column_ = column;
     last_map_paint_row_ = row;
 
-    MapTileLayer& map_tiles = active_map_tiles();
+    if (map_terrain_brush_ != MapAutoTiler::kNoTerrain) {
+        const std::span<const MapCellChange> painted_cells = map_editor_.apply(
+            MapPaintTerrainCommand{
+                .layer = active_map_layer_index(),
+                .area = MapCellRect{
+                    .left = column,
+                    .top = row,
+                    .right = column,
+                    .bottom = row
+                },
+                .terrain = map_terrain_brush_
+            }
+        );
+
+        if (!painted_cells.empty()) {
+            sync_map_changes(painted_cells);
+
+            MIDNIGHT_LOG_INFO(
+                Editor,
+                "Painted {} terrain at map cell ({}, {})",
+                map_auto_tiler_.terrains()[map_terrain_brush_ - 1].name,
+                column,
+                row
+            );
+        }
+
+        return true;
+    }
+
     const std::uint32_t selected_column_count =
         selected_tile_right_ - selected_tile_left_ + 1;
     const std::uint32_t selected_row_count =
@@ -2928,109 +4796,53 @@ bool Application::paint_map_selection(
         selected_row_count,
         kMapCanvasRows - row
     );
-
-    const auto tile_matches = [](
-        const MapTile& map_tile,
-        const std::uint32_t tileset_column,
-        const std::uint32_t tileset_row
-    ) {
-        return map_tile.occupied &&
-            map_tile.tileset_column == tileset_column &&
-            map_tile.tileset_row == tileset_row;
-    };
-
-    bool tile_will_change = false;
-
-    for (std::uint32_t row_offset = 0;
-         row_offset < painted_row_count && !tile_will_change;
-         ++row_offset) {
-        for (std::uint32_t column_offset = 0;
-             column_offset < painted_column_count;
-             ++column_offset) {
-            const std::uint32_t map_column =
-                column + column_offset;
-            const std::uint32_t map_row =
-                row + row_offset;
-            const std::size_t cell_index =
-                static_cast<std::size_t>(map_row) *
-                    kMapCanvasColumns +
-                map_column;
-            const MapTile& map_tile =
-                map_tiles.at(cell_index);
-
-            if (!tile_matches(
-                    map_tile,
-                    selected_tile_left_ + column_offset,
-                    selected_tile_top_ + row_offset
-                )) {
-                tile_will_change = true;
-                break;
+    const std::span<const MapCellChange> painted_cells = map_editor_.apply(
+        MapPaintStampCommand{
+            .layer = active_map_layer_index(),
+            .area = MapCellRect{
+                .left = column,
+                .top = row,
+                .right = column + painted_column_count - 1,
+                .bottom = row + painted_row_count - 1
+            },
+            .pattern = MapCellRect{
+                .left = selected_tile_left_,
+                .top = selected_tile_top_,
+                .right = selected_tile_right_,
+                .bottom = selected_tile_bottom_
             }
         }
-    }
+    );
 
-    if (!tile_will_change) {
+    if (painted_cells.empty()) {
         return true;
     }
 
-    wait_for_rendering_resources();
-
-    for (std::uint32_t row_offset = 0;
-         row_offset < painted_row_count;
-         ++row_offset) {
-        for (std::uint32_t column_offset = 0;
-             column_offset < painted_column_count;
-             ++column_offset) {
-            const std::uint32_t map_column =
-                column + column_offset;
-            const std::uint32_t map_row =
-                row + row_offset;
-            const std::uint32_t tileset_column =
-                selected_tile_left_ + column_offset;
-            const std::uint32_t tileset_row =
-                selected_tile_top_ + row_offset;
-            const std::size_t cell_index =
-                static_cast<std::size_t>(map_row) *
-                    kMapCanvasColumns +
-                map_column;
-            MapTile& map_tile = map_tiles.at(cell_index);
-
-            if (tile_matches(
-                    map_tile,
-                    tileset_column,
-                    tileset_row
-                )) {
-                continue;
-            }
-
-            map_tile.tileset_column = tileset_column;
-            map_tile.tileset_row = tileset_row;
-            map_tile.occupied = true;
-
-            upload_map_tile_vertices(map_column, map_row);
-        }
-    }
-
-    std::cout << "[Midnight] Painted "
-              << selected_column_count
-              << "x"
-              << selected_row_count
-              << " atlas region at map cell ("
-              << column
-              << ", "
-              << row
-              << ")";
+    sync_map_changes(painted_cells);
 
     if (painted_column_count != selected_column_count ||
         painted_row_count != selected_row_count) {
-        std::cout << ", clipped to "
-                  << painted_column_count
-                  << "x"
-                  << painted_row_count;
+        MIDNIGHT_LOG_INFO(
+            Editor,
+            "Painted {}x{} atlas region at map cell ({}, {}), clipped to {}x{}",
+            selected_column_count,
+            selected_row_count,
+            column,
+            row,
+            painted_column_count,
+            painted_row_count
+        );
+    } else {
+        MIDNIGHT_LOG_INFO(
+            Editor,
+            "Painted {}x{} atlas region at map cell ({}, {})",
+            selected_column_count,
+            selected_row_count,
+            column,
+            row
+        );
     }
 
-    std::cout << '\n';
-
     return true;
 }
 
@@ -3060,26 +4872,39 @@ bool Application::erase_map_tile(
     last_map_erase_column_ = column;
     last_map_erase_row_ = row;
 
-    MapTileLayer& map_tiles = active_map_tiles();
-    const std::size_t cell_index =
-        static_cast<std::size_t>(row) * kMapCanvasColumns +
-        column;
-    MapTile& map_tile = map_tiles.at(cell_index);
-
-    if (!map_tile.occupied) {
+    // With a terrain brush, erasing also re-resolves the terrain around
+    // the hole.
+    const std::span<const MapCellChange> erased_cells =
+        map_terrain_brush_ != MapAutoTiler::kNoTerrain
+            ? map_editor_.apply(MapPaintTerrainCommand{
+                  .layer = active_map_layer_index(),
+                  .area = MapCellRect{
+                      .left = column,
+                      .top = row,
+                      .right = column,
+                      .bottom = row
+                  },
+                  .terrain = MapAutoTiler::kNoTerrain
+              })
+            : map_editor_.apply(MapSetTileCommand{
+                  .layer = active_map_layer_index(),
+                  .column = column,
+                  .row = row,
+                  .tile = 0
+              });
+
+    if (erased_cells.empty()) {
         return true;
     }
 
-    wait_for_rendering_resources();
-
-    map_tile = MapTile{};
-    upload_map_tile_vertices(column, row);
+    sync_map_changes(erased_cells);
 
-    std::cout << "[Midnight] Erased map cell ("
-              << column
-              << ", "
-              << row
-              << ")\n";
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Erased map cell ({}, {})",
+        column,
+        row
+    );
 
     return true;
 }
@@ -3101,11 +4926,8 @@ void Application::pick_map_tile(
         return;
     }
 
-    const MapTileLayer& map_tiles = active_map_tiles();
-    const std::size_t cell_index =
-        static_cast<std::size_t>(row) * kMapCanvasColumns +
-        column;
-    const MapTile& map_tile = map_tiles.at(cell_index);
+    const MapTile map_tile =
+        map_editor_.map().tile(active_map_layer_index(), column, row);
 
     if (!map_tile.occupied) {
         return;
@@ -3118,64 +4940,76 @@ void Application::pick_map_tile(
         map_tile.tileset_row
     );
 
-    std::cout << "[Midnight] Picked atlas tile ("
-              << map_tile.tileset_column
-              << ", "
-              << map_tile.tileset_row
-              << ") from map cell ("
-              << column
-              << ", "
-              << row
-              << ")\n";
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Picked atlas tile ({}, {}) from map cell ({}, {})",
+        map_tile.tileset_column,
+        map_tile.tileset_row,
+        column,
+        row
+    );
 }
 
-void Application::upload_map_tile_vertices(
+void Application::sync_map_tile(
     const std::uint32_t column,
     const std::uint32_t row
 )
 {
-    upload_map_tile_vertices(
+    sync_map_tile(
         active_map_layer_,
         column,
         row
     );
 }
 
-void Application::upload_map_tile_vertices(
+void Application::sync_map_tile(
     const MapLayer layer,
     const std::uint32_t column,
     const std::uint32_t row
 )
 {
-    const std::size_t cell_index =
-        static_cast<std::size_t>(row) * kMapCanvasColumns +
-        column;
-    const std::size_t layer_cell_index =
-        map_layer_index(layer) * kMapCanvasCellCount +
-        cell_index;
-    const MapTile& map_tile =
-        map_tile_layers_.at(map_layer_index(layer))
-            .at(cell_index);
-    const MapTileCellVertices vertices =
-        map_tile.occupied
-            ? make_map_tile_vertices(
-                  column,
-                  row,
-                  map_tile.tileset_column,
-                  map_tile.tileset_row
-              )
-            : kEmptyMapTileCellVertices;
+    const MapTile map_tile =
+        map_editor_.map().tile(map_layer_index(layer), column, row);
+
+    map_file_dirty_chunks_[
+        map_layer_index(layer) * kMapFileChunkCount +
+        static_cast<std::size_t>(row / kMapFileChunkSize) *
+            kMapFileChunkColumns +
+        column / kMapFileChunkSize
+    ] = 1;
+
+    map_chunk_mesh_dirty_[
+        map_layer_index(layer) * kMapRenderChunkCount +
+        static_cast<std::size_t>(row / kMapRenderChunkSize) *
+            kMapRenderChunkColumns +
+        column / kMapRenderChunkSize
+    ] = 1;
+
+    map_minimap_.mark_cell_dirty(column, row);
+
+    if (map_layer_blocks_movement(layer)) {
+        (void)map_collision_grid_.set_blocked(
+            column,
+            row,
+            map_tile.occupied
+        );
+    }
+}
 
-    quad_vertex_buffer_.upload(
-        vertices.data(),
-        sizeof(vertices),
-        kMapTileVertexByteOffset +
-            static_cast<VkDeviceSize>(layer_cell_index) *
-            sizeof(vertices)
-    );
+void Application::sync_map_changes(
+    const std::span<const MapCellChange> changes
+)
+{
+    for (const MapCellChange& change : changes) {
+        sync_map_tile(
+            static_cast<MapLayer>(change.layer),
+            change.cell % kMapCanvasColumns,
+            change.cell / kMapCanvasColumns
+        );
+    }
 }
 
-void Application::upload_all_map_tile_vertices()
+void Application::sync_all_map_tiles()
 {
     for (std::size_t layer_index = 0;
          layer_index < kMapLayerCount;
@@ -3186,7 +5020,7 @@ void Application::upload_all_map_tile_vertices()
             for (std::uint32_t column = 0;
                  column < kMapCanvasColumns;
                  ++column) {
-                upload_map_tile_vertices(
+                sync_map_tile(
                     static_cast<MapLayer>(layer_index),
                     column,
                     row
@@ -3196,6 +5030,146 @@ void Application::upload_all_map_tile_vertices()
     }
 }
 
+void Application::update_map_chunk_meshes()
+{
+    const VulkanFrameRenderer& frame_renderer =
+        *swapchain_resources_.frame_renderer;
+
+    // The current renderer's completed count says nothing about frames
+    // still owned by retired swapchains, so reclaiming waits for those.
+    if (retired_swapchain_resources_.empty()) {
+        map_chunk_meshes_.reclaim(frame_renderer.completed_frame_count());
+    }
+
+    if (map_chunk_mesh_build_ != nullptr) {
+        if (!map_chunk_mesh_build_->counter.done()) {
+            return;
+        }
+
+        jobs_.wait(map_chunk_mesh_build_->counter);
+
+        std::vector<VulkanChunkMeshPool::MeshUpload> uploads;
+        uploads.reserve(map_chunk_mesh_build_->meshes.size());
+
+        for (std::size_t index = 0;
+             index < map_chunk_mesh_build_->meshes.size();
+             ++index) {
+            uploads.push_back(VulkanChunkMeshPool::MeshUpload{
+                .mesh = map_chunk_mesh_build_->meshes[index],
+                .vertices = map_chunk_mesh_build_->vertices[index]
+            });
+        }
+
+        if (map_chunk_meshes_.free_slot_count() < uploads.size()) {
+            wait_for_rendering_resources();
+        }
+
+        map_chunk_meshes_.upload(
+            uploads,
+            frame_renderer.submitted_frame_count()
+        );
+        map_chunk_mesh_build_.reset();
+    }
+
+    if (std::ranges::find(map_chunk_mesh_dirty_, std::uint8_t{1}) ==
+        map_chunk_mesh_dirty_.end()) {
+        return;
+    }
+
+    // Workers build from a copy of the dirty chunks so edits can keep
+    // landing in the map while the meshes are generated.
+    auto build = std::make_unique<MapChunkMeshBuild>();
+
+    for (std::size_t mesh = 0; mesh < kMapChunkMeshCount; ++mesh) {
+        if (map_chunk_mesh_dirty_[mesh] == 0) {
+            continue;
+        }
+
+        map_chunk_mesh_dirty_[mesh] = 0;
+        build->meshes.push_back(mesh);
+
+        const std::size_t chunk = mesh % kMapRenderChunkCount;
+
+        build->tiles.resize(build->tiles.size() + kMapRenderChunkCellCount);
+        map_editor_.map().copy_block(
+            mesh / kMapRenderChunkCount,
+            static_cast<std::uint32_t>(chunk % kMapRenderChunkColumns) *
+                kMapRenderChunkSize,
+            static_cast<std::uint32_t>(chunk / kMapRenderChunkColumns) *
+                kMapRenderChunkSize,
+            kMapRenderChunkSize,
+            kMapRenderChunkSize,
+            std::span<PackedMapTile>(build->tiles).last(
+                kMapRenderChunkCellCount
+            )
+        );
+    }
+
+    build->vertices.resize(build->meshes.size());
+
+    for (std::size_t index = 0; index < build->meshes.size(); ++index) {
+        jobs_.run(build->counter, [build = build.get(), index] {
+            const std::size_t chunk =
+                build->meshes[index] % kMapRenderChunkCount;
+            const std::uint32_t first_column =
+                static_cast<std::uint32_t>(chunk % kMapRenderChunkColumns) *
+                kMapRenderChunkSize;
+            const std::uint32_t first_row =
+                static_cast<std::uint32_t>(chunk / kMapRenderChunkColumns) *
+                kMapRenderChunkSize;
+            const std::span<const PackedMapTile> tiles(
+                build->tiles.data() + index * kMapRenderChunkCellCount,
+                kMapRenderChunkCellCount
+            );
+
+            append_map_chunk_vertices(
+                kMapMeshLayout,
+                tiles,
+                kMapRenderChunkSize,
+                first_column,
+                first_row,
+                build->vertices[index]
+            );
+        });
+    }
+
+    map_chunk_mesh_build_ = std::move(build);
+}
+
+void Application::update_map_minimap()
+{
+    const std::optional<MapCellRect> texels =
+        map_minimap_.refresh(map_editor_.map(), &jobs_);
+
+    if (!texels) {
+        return;
+    }
+
+    // Whole rows of the minimap's copy are staged and the copy picks the
+    // changed columns out of them, so one edit uploads a few texels.
+    const std::uint32_t row_count = texels->bottom - texels->top + 1;
+    const std::size_t row_bytes =
+        static_cast<std::size_t>(map_minimap_.width()) *
+        RgbaImage::bytes_per_pixel;
+
+    vulkan_transfer_context_.update_sampled_image_region(
+        map_minimap_image_,
+        VkRect2D{
+            .offset = VkOffset2D{
+                .x = static_cast<std::int32_t>(texels->left),
+                .y = static_cast<std::int32_t>(texels->top)
+            },
+            .extent = VkExtent2D{
+                .width = texels->right - texels->left + 1,
+                .height = row_count
+            }
+        },
+        map_minimap_.pixels().data() + texels->top * row_bytes,
+        map_minimap_.width(),
+        static_cast<VkDeviceSize>(row_count * row_bytes)
+    );
+}
+
 void Application::update_map_hover(
     const float x,
     const float y
@@ -3340,9 +5314,11 @@ void Application::toggle_tileset_grid()
     tileset_grid_visible_ = !tileset_grid_visible_;
     upload_tileset_grid_vertices();
 
-    std::cout << "[Midnight] Atlas grid "
-              << (tileset_grid_visible_ ? "shown" : "hidden")
-              << '\n';
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Atlas grid {}",
+        tileset_grid_visible_ ? "shown" : "hidden"
+    );
 }
 
 void Application::upload_tileset_grid_vertices()
@@ -3366,9 +5342,11 @@ void Application::toggle_map_grid()
     map_grid_visible_ = !map_grid_visible_;
     upload_map_grid_vertices();
 
-    std::cout << "[Midnight] Map grid "
-              << (map_grid_visible_ ? "shown" : "hidden")
-              << '\n';
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Map grid {}",
+        map_grid_visible_ ? "shown" : "hidden"
+    );
 }
 
 void Application::upload_map_grid_vertices()
@@ -3589,24 +5567,17 @@ void Application::print_tile_selection() const
     const std::uint32_t selected_row_count =
         selected_tile_bottom_ - selected_tile_top_ + 1;
 
-    std::cout << "[Midnight] Selected region: ("
-              << selected_tile_left_
-              << ", "
-              << selected_tile_top_
-              << ") to ("
-              << selected_tile_right_
-              << ", "
-              << selected_tile_bottom_
-              << "), "
-              << selected_column_count
-              << "x"
-              << selected_row_count
-              << " tiles, preview "
-              << selected_region_preview_scale(
-                     selected_column_count,
-                     selected_row_count
-                 )
-              << "x\n";
+    MIDNIGHT_LOG_INFO(
+        Editor,
+        "Selected region: ({}, {}) to ({}, {}), {}x{} tiles, preview {}x",
+        selected_tile_left_,
+        selected_tile_top_,
+        selected_tile_right_,
+        selected_tile_bottom_,
+        selected_column_count,
+        selected_row_count,
+        selected_region_preview_scale(selected_column_count, selected_row_count)
+    );
 }
 
 void Application::upload_tile_selection_vertices()
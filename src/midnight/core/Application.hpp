@@ -1,9 +1,30 @@
 #pragma once
 
+#include "midnight/core/BinaryStream.hpp"
+#include "midnight/core/DurationHistogram.hpp"
+#include "midnight/core/JobSystem.hpp"
+#include "midnight/core/LinearArena.hpp"
+#include "midnight/core/Simulation.hpp"
+#include "midnight/ecs/SpatialGrid.hpp"
+#include "midnight/ecs/SpriteSystems.hpp"
+#include "midnight/ecs/World.hpp"
+#include "midnight/map/MapEditJournal.hpp"
+#include "midnight/map/MapEditor.hpp"
+#include "midnight/map/MapFile.hpp"
+#include "midnight/map/MapGenerator.hpp"
+#include "midnight/map/MapMinimap.hpp"
+#include "midnight/map/TileMap.hpp"
+#include "midnight/navigation/CollisionGrid.hpp"
+#include "midnight/navigation/FlowFieldCache.hpp"
+#include "midnight/navigation/HierarchicalPathfinder.hpp"
+#include "midnight/platform/InputRecording.hpp"
 #include "midnight/platform/SdlContext.hpp"
 #include "midnight/platform/Window.hpp"
+#include "midnight/renderer/Vertex2D.hpp"
 #include "midnight/renderer/vulkan/VulkanBuffer.hpp"
+#include "midnight/renderer/vulkan/VulkanChunkMeshPool.hpp"
 #include "midnight/renderer/vulkan/VulkanDevice.hpp"
+#include "midnight/renderer/vulkan/VulkanDynamicBuffer.hpp"
 #include "midnight/renderer/vulkan/VulkanFrameRenderer.hpp"
 #include "midnight/renderer/vulkan/VulkanGraphicsPipeline.hpp"
 #include "midnight/renderer/vulkan/VulkanImage.hpp"
@@ -18,8 +39,11 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <filesystem>
 #include <memory>
-#include <optional>
+#include <mutex>
+#include <random>
+#include <span>
 #include <vector>
 
 namespace midnight {
@@ -35,7 +59,17 @@ inline constexpr std::size_t kMapLayerCount =
 
 class Application final {
 public:
-    Application();
+    // Recording and replay both start from an empty map, skipping autosave
+    // recovery, so a replay reproduces the recorded session's edits.
+    struct CreateInfo final {
+        std::filesystem::path record_input_path;
+        std::filesystem::path replay_input_path;
+        bool replay_at_max_speed = false;
+        bool benchmark = false;
+        bool threaded_simulation = false;
+    };
+
+    explicit Application(const CreateInfo& create_info);
     ~Application() noexcept;
 
     Application(const Application&) = delete;
@@ -52,34 +86,18 @@ private:
         std::unique_ptr<VulkanRenderPass> render_pass;
         std::unique_ptr<VulkanGraphicsPipeline> graphics_pipeline;
         std::unique_ptr<VulkanTextureDescriptor> texture_descriptor;
+        std::unique_ptr<VulkanTextureDescriptor> map_texture_descriptor;
+        std::unique_ptr<VulkanTextureDescriptor> minimap_texture_descriptor;
         std::unique_ptr<VulkanFrameRenderer> frame_renderer;
     };
 
-    struct MapTile final {
-        std::uint32_t tileset_column = 0;
-        std::uint32_t tileset_row = 0;
-        bool occupied = false;
-
-        bool operator==(const MapTile&) const = default;
-    };
-
-    struct MapAreaSelectionState final {
-        std::uint32_t left = 0;
-        std::uint32_t top = 0;
-        std::uint32_t right = 0;
-        std::uint32_t bottom = 0;
-        bool visible = false;
-
-        bool operator==(const MapAreaSelectionState&) const = default;
-    };
-
-    using MapTileLayer = std::vector<MapTile>;
-    using MapTileLayers =
-        std::array<MapTileLayer, kMapLayerCount>;
-
-    struct MapEditSnapshot final {
-        MapTileLayers layers;
-        std::optional<MapAreaSelectionState> area_selection;
+    // Dirty chunks copied out for the job system; `tiles` holds one
+    // chunk-sized block per entry of `meshes`.
+    struct MapChunkMeshBuild final {
+        JobCounter counter;
+        std::vector<std::size_t> meshes;
+        std::vector<PackedMapTile> tiles;
+        std::vector<std::vector<Vertex2D>> vertices;
     };
 
     [[nodiscard]] static const char* map_layer_name(
@@ -88,12 +106,12 @@ private:
     [[nodiscard]] static bool map_layer_blocks_movement(
         MapLayer layer
     ) noexcept;
-    [[nodiscard]] MapTileLayer& active_map_tiles() noexcept;
-    [[nodiscard]] const MapTileLayer&
-        active_map_tiles() const noexcept;
+    [[nodiscard]] std::size_t active_map_layer_index() const noexcept;
     void set_active_map_layer(MapLayer layer);
     void print_startup_info() const;
     void poll_events();
+    [[nodiscard]] bool next_input_event(InputEvent& input);
+    void finish_input_replay();
     [[nodiscard]] SwapchainResources create_swapchain_resources(
         VkSwapchainKHR old_swapchain = VK_NULL_HANDLE
     );
@@ -103,19 +121,66 @@ private:
         bool restart_settle_delay = false
     );
     void release_retired_swapchain_resources();
+    void report_frame_arena_usage();
     void wait_for_rendering_resources();
     void begin_map_edit(bool include_area_selection = false);
     void finish_map_edit();
     void undo_map_edit();
     void redo_map_edit();
-    [[nodiscard]] MapAreaSelectionState
+    void apply_map_edit_step(const MapEditStep& step, bool undo);
+    static void write_map_tiles(
+        ByteWriter& writer,
+        const TileMap& map_tiles
+    );
+    [[nodiscard]] static TileMap read_map_tiles(ByteReader& reader);
+    static void write_map_changes(
+        ByteWriter& writer,
+        std::span<const MapCellChange> changes
+    );
+    [[nodiscard]] static std::vector<MapCellChange> read_map_changes(
+        ByteReader& reader
+    );
+    static void write_map_area_selection(
+        ByteWriter& writer,
+        const MapSelection& state
+    );
+    [[nodiscard]] static MapSelection read_map_area_selection(
+        ByteReader& reader
+    );
+    [[nodiscard]] std::vector<std::byte> encode_map_history() const;
+    void restore_map_history(std::span<const std::byte> snapshot);
+    void replay_map_journal_record(std::span<const std::byte> record);
+    void record_map_journal(std::vector<std::byte> record);
+    void recover_map_autosave();
+    [[nodiscard]] MapFileLayout map_file_layout() const;
+    void save_map();
+    void load_map();
+    void export_tiled_map_file();
+    void import_tiled_map_file();
+    [[nodiscard]] MapSelection
         capture_map_area_selection_state() const;
     void apply_map_area_selection_state(
-        const MapAreaSelectionState& state
+        const MapSelection& state
     );
     void flood_fill_map();
+    void find_map_tile();
+    void log_map_tile_usage() const;
+    void replace_map_tile();
+    void query_map_path();
+    void query_map_flow_field();
+    void spawn_map_sprites();
+    void clear_map_sprites();
+    void inspect_map_sprites();
+    // Hands the sprites to rendering; callers hold the simulation state lock.
+    void publish_map_sprite_snapshot();
+    void upload_map_sprite_vertices();
     void delete_selected_map_area();
     void move_selected_map_area(int column_delta, int row_delta);
+    void copy_selected_map_area(bool cut);
+    void paste_map_clipboard(bool transparent);
+    void select_map_stamp(std::size_t slot, bool save);
+    void cycle_map_terrain_brush();
+    void generate_map_canvas(bool next_kind);
     [[nodiscard]] bool begin_map_rectangle_paint(float x, float y);
     void update_map_rectangle_paint(float x, float y);
     void apply_map_rectangle_paint();
@@ -127,16 +192,19 @@ private:
     [[nodiscard]] bool paint_map_selection(float x, float y);
     [[nodiscard]] bool erase_map_tile(float x, float y);
     void pick_map_tile(float x, float y);
-    void upload_map_tile_vertices(
+    void sync_map_tile(
         std::uint32_t column,
         std::uint32_t row
     );
-    void upload_map_tile_vertices(
+    void sync_map_tile(
         MapLayer layer,
         std::uint32_t column,
         std::uint32_t row
     );
-    void upload_all_map_tile_vertices();
+    void sync_map_changes(std::span<const MapCellChange> changes);
+    void sync_all_map_tiles();
+    void update_map_chunk_meshes();
+    void update_map_minimap();
     void update_map_hover(float x, float y);
     void clear_map_hover();
     [[nodiscard]] bool window_position_to_map_cell(
@@ -177,18 +245,51 @@ private:
     VulkanSurface vulkan_surface_;
     VulkanDevice vulkan_device_;
     VulkanTransferContext vulkan_transfer_context_;
-    VulkanBuffer quad_vertex_buffer_;
+    VulkanDynamicBuffer quad_vertex_buffer_;
     VulkanBuffer quad_index_buffer_;
+    VulkanChunkMeshPool map_chunk_meshes_;
     VulkanImage texture_image_;
     VulkanSampler texture_sampler_;
+    VulkanImage map_texture_image_;
+    VulkanSampler map_texture_sampler_;
+    VulkanImage map_minimap_image_;
     SwapchainResources swapchain_resources_;
     std::vector<SwapchainResources> retired_swapchain_resources_;
-    MapTileLayers map_tile_layers_;
-    MapTileLayers active_map_edit_before_;
-    std::optional<MapAreaSelectionState>
-        active_map_area_selection_before_;
-    std::vector<MapEditSnapshot> map_undo_stack_;
-    std::vector<MapEditSnapshot> map_redo_stack_;
+    MapAutoTiler map_auto_tiler_;
+    MapEditor map_editor_;
+    std::vector<std::uint8_t> map_chunk_mesh_dirty_;
+    MapMinimap map_minimap_;
+    std::unique_ptr<MapFile> map_file_;
+    std::vector<std::uint8_t> map_file_dirty_chunks_;
+    std::unique_ptr<MapEditJournal> map_journal_;
+    std::shared_ptr<const TileMap> map_clipboard_;
+    std::vector<std::shared_ptr<const TileMap>> map_stamps_;
+    LinearArena frame_arena_;
+    std::size_t reported_frame_arena_bytes_ = 0;
+    JobSystem jobs_;
+    std::unique_ptr<MapChunkMeshBuild> map_chunk_mesh_build_;
+    CollisionGrid map_collision_grid_;
+    HierarchicalPathfinder map_pathfinder_;
+    FlowFieldCache map_flow_fields_;
+    World map_entities_;
+    SpatialGrid map_sprite_grid_;
+    std::vector<SpatialGrid::Item> map_sprite_grid_items_;
+    SpriteRenderSnapshot map_sprite_snapshot_;
+    SpriteRenderSnapshot map_sprite_back_snapshot_;
+    std::mutex map_sprite_snapshot_mutex_;
+    std::vector<Vertex2D> map_sprite_vertices_;
+    std::array<std::size_t, VulkanFrameRenderer::kSpriteVertexRegionCount>
+        uploaded_map_sprite_counts_{};
+    std::minstd_rand map_sprite_random_;
+    Simulation simulation_;
+    std::unique_ptr<InputRecorder> input_recorder_;
+    std::unique_ptr<InputReplay> input_replay_;
+    std::uint64_t input_frame_ = 0;
+    std::uint64_t input_replay_start_ticks_ns_ = 0;
+    bool input_replay_by_frame_ = false;
+    bool benchmark_ = false;
+    DurationHistogram benchmark_cpu_frame_times_;
+    DurationHistogram benchmark_gpu_frame_times_;
 
     MapLayer active_map_layer_ = MapLayer::Ground;
     std::uint32_t selected_tile_left_ = 0;
@@ -211,12 +312,16 @@ private:
     std::uint32_t map_rectangle_tileset_top_ = 0;
     std::uint32_t map_rectangle_tileset_right_ = 0;
     std::uint32_t map_rectangle_tileset_bottom_ = 0;
+    std::uint8_t map_terrain_brush_ = MapAutoTiler::kNoTerrain;
+    MapGeneratorKind map_generator_kind_ = MapGeneratorKind::Caves;
     std::uint32_t map_area_selection_anchor_column_ = 0;
     std::uint32_t map_area_selection_anchor_row_ = 0;
     std::uint32_t map_area_selection_left_ = 0;
     std::uint32_t map_area_selection_top_ = 0;
     std::uint32_t map_area_selection_right_ = 0;
     std::uint32_t map_area_selection_bottom_ = 0;
+    std::uint32_t map_path_start_column_ = 0;
+    std::uint32_t map_path_start_row_ = 0;
     bool tileset_grid_visible_ = true;
     bool map_grid_visible_ = true;
     bool tile_selection_dragging_ = false;
@@ -224,9 +329,9 @@ private:
     bool map_rectangle_dragging_ = false;
     bool map_area_selection_dragging_ = false;
     bool map_erase_dragging_ = false;
-    bool map_edit_active_ = false;
     bool map_hover_visible_ = false;
     bool map_area_selection_visible_ = false;
+    bool map_path_start_marked_ = false;
     bool swapchain_recreation_pending_ = false;
     std::uint64_t swapchain_recreation_not_before_ticks_ = 0;
     int swapchain_window_pixel_width_ = 0;
@@ -0,0 +1,594 @@
+#include "midnight/core/Base64.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MIDNIGHT_BASE64_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define MIDNIGHT_BASE64_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace midnight {
+namespace {
+
+constexpr std::string_view kBase64Alphabet =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+constexpr std::uint32_t kInvalidSextet = 0xFF;
+constexpr std::uint32_t kInvalidQuad = 0x0100'0000u;
+
+constexpr std::array<std::uint32_t, 256> make_sextet_table()
+{
+    std::array<std::uint32_t, 256> table{};
+    table.fill(kInvalidSextet);
+
+    for (std::size_t index = 0; index < kBase64Alphabet.size(); ++index) {
+        table[static_cast<unsigned char>(kBase64Alphabet[index])] =
+            static_cast<std::uint32_t>(index);
+    }
+
+    return table;
+}
+
+// One table per character position, pre-shifted into its slot of the
+// 24-bit group so a full quad decodes with four loads and three ORs.
+// Any invalid character sets bit 24, which one compare catches.
+constexpr std::array<std::uint32_t, 256> make_quad_table(const unsigned shift)
+{
+    constexpr std::array<std::uint32_t, 256> sextets = make_sextet_table();
+    std::array<std::uint32_t, 256> table{};
+
+    for (std::size_t index = 0; index < table.size(); ++index) {
+        table[index] = sextets[index] == kInvalidSextet
+            ? kInvalidQuad
+            : sextets[index] << shift;
+    }
+
+    return table;
+}
+
+constexpr std::array<std::uint32_t, 256> kSextets = make_sextet_table();
+constexpr std::array<std::uint32_t, 256> kQuad0 = make_quad_table(18);
+constexpr std::array<std::uint32_t, 256> kQuad1 = make_quad_table(12);
+constexpr std::array<std::uint32_t, 256> kQuad2 = make_quad_table(6);
+constexpr std::array<std::uint32_t, 256> kQuad3 = make_quad_table(0);
+
+bool skippable(const char character) noexcept
+{
+    return character == ' ' ||
+           character == '\n' ||
+           character == '\r' ||
+           character == '\t' ||
+           character == '\\';
+}
+
+// Decodes whole quads until the first one holding a character outside the
+// alphabet or until `capacity` bytes cannot take another, and returns the
+// number of characters consumed.
+using DecodeQuads = std::size_t (*)(
+    const char*,
+    std::size_t,
+    std::byte*,
+    std::size_t
+) noexcept;
+
+struct Base64KernelTable final {
+    Base64Kernels kind = Base64Kernels::Scalar;
+    DecodeQuads decode_quads = nullptr;
+};
+
+std::size_t decode_quads_scalar(
+    const char* const text,
+    const std::size_t length,
+    std::byte* const output,
+    const std::size_t capacity
+) noexcept
+{
+    const auto table_index = [text](const std::size_t position) {
+        return static_cast<unsigned char>(text[position]);
+    };
+
+    std::size_t index = 0;
+    std::size_t written = 0;
+
+    for (; index + 4 <= length && written + 3 <= capacity; index += 4) {
+        const std::uint32_t group =
+            kQuad0[table_index(index)] |
+            kQuad1[table_index(index + 1)] |
+            kQuad2[table_index(index + 2)] |
+            kQuad3[table_index(index + 3)];
+
+        if (group >= kInvalidQuad) {
+            break;
+        }
+
+        output[written] = static_cast<std::byte>(group >> 16);
+        output[written + 1] = static_cast<std::byte>(group >> 8);
+        output[written + 2] = static_cast<std::byte>(group);
+        written += 3;
+    }
+
+    return index;
+}
+
+constexpr Base64KernelTable kScalarKernels{
+    .kind = Base64Kernels::Scalar,
+    .decode_quads = decode_quads_scalar
+};
+
+#if defined(MIDNIGHT_BASE64_X86) || defined(MIDNIGHT_BASE64_NEON)
+
+// The vector kernels classify each character by its two nibbles: it lies
+// outside the alphabet when the class bits of its low and high nibble
+// overlap. Adding the offset its high nibble selects turns it into its
+// sextet; '/' shares a high nibble with '+' and borrows the slot below.
+// Each vector of sextets is packed to 24-bit groups in place, and the byte
+// order shuffle leaves the last four lanes zero, so a 16-character block
+// stores 16 bytes of which 12 are kept.
+constexpr std::array<std::uint8_t, 16> kLowNibbleClasses{
+    0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+    0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A
+};
+constexpr std::array<std::uint8_t, 16> kHighNibbleClasses{
+    0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+    0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10
+};
+constexpr std::array<std::uint8_t, 16> kSextetOffsets{
+    0, 16, 19, 4, 0xBF, 0xBF, 0xB9, 0xB9,
+    0, 0, 0, 0, 0, 0, 0, 0
+};
+constexpr std::array<std::uint8_t, 16> kGroupByteOrder{
+    2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, 0x80, 0x80, 0x80, 0x80
+};
+
+#endif
+
+#if defined(MIDNIGHT_BASE64_X86)
+
+__attribute__((target("sse4.1")))
+__m128i load_table_sse41(const std::array<std::uint8_t, 16>& table) noexcept
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(table.data()));
+}
+
+__attribute__((target("avx2")))
+__m256i load_table_avx2(const std::array<std::uint8_t, 16>& table) noexcept
+{
+    return _mm256_broadcastsi128_si256(load_table_sse41(table));
+}
+
+__attribute__((target("sse4.1")))
+std::size_t decode_quads_sse41(
+    const char* const text,
+    const std::size_t length,
+    std::byte* const output,
+    const std::size_t capacity
+) noexcept
+{
+    const __m128i low_classes = load_table_sse41(kLowNibbleClasses);
+    const __m128i high_classes = load_table_sse41(kHighNibbleClasses);
+    const __m128i offsets = load_table_sse41(kSextetOffsets);
+    const __m128i byte_order = load_table_sse41(kGroupByteOrder);
+    const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+    const __m128i slash = _mm_set1_epi8('/');
+    std::size_t index = 0;
+    std::size_t written = 0;
+
+    for (; index + 16 <= length && written + 16 <= capacity;
+         index += 16, written += 12) {
+        const __m128i characters =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + index));
+        const __m128i high =
+            _mm_and_si128(_mm_srli_epi32(characters, 4), nibble_mask);
+        const __m128i low_bits = _mm_shuffle_epi8(
+            low_classes,
+            _mm_and_si128(characters, nibble_mask)
+        );
+
+        if (!_mm_testz_si128(low_bits, _mm_shuffle_epi8(high_classes, high))) {
+            break;
+        }
+
+        const __m128i sextets = _mm_add_epi8(
+            characters,
+            _mm_shuffle_epi8(
+                offsets,
+                _mm_add_epi8(high, _mm_cmpeq_epi8(characters, slash))
+            )
+        );
+        const __m128i pairs =
+            _mm_maddubs_epi16(sextets, _mm_set1_epi32(0x0140'0140));
+        const __m128i groups =
+            _mm_madd_epi16(pairs, _mm_set1_epi32(0x0001'1000));
+
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(output + written),
+            _mm_shuffle_epi8(groups, byte_order)
+        );
+    }
+
+    return index + decode_quads_scalar(
+        text + index,
+        length - index,
+        output + written,
+        capacity - written
+    );
+}
+
+// Same steps as the SSE4.1 kernel on two 16-character lanes, whose 12-byte
+// results are then moved together.
+__attribute__((target("avx2")))
+std::size_t decode_quads_avx2(
+    const char* const text,
+    const std::size_t length,
+    std::byte* const output,
+    const std::size_t capacity
+) noexcept
+{
+    const __m256i low_classes = load_table_avx2(kLowNibbleClasses);
+    const __m256i high_classes = load_table_avx2(kHighNibbleClasses);
+    const __m256i offsets = load_table_avx2(kSextetOffsets);
+    const __m256i byte_order = load_table_avx2(kGroupByteOrder);
+    const __m256i lane_order = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+    const __m256i nibble_mask = _mm256_set1_epi8(0x0F);
+    const __m256i slash = _mm256_set1_epi8('/');
+    std::size_t index = 0;
+    std::size_t written = 0;
+
+    for (; index + 32 <= length && written + 32 <= capacity;
+         index += 32, written += 24) {
+        const __m256i characters =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + index));
+        const __m256i high =
+            _mm256_and_si256(_mm256_srli_epi32(characters, 4), nibble_mask);
+        const __m256i low_bits = _mm256_shuffle_epi8(
+            low_classes,
+            _mm256_and_si256(characters, nibble_mask)
+        );
+
+        if (!_mm256_testz_si256(
+                low_bits,
+                _mm256_shuffle_epi8(high_classes, high)
+            )) {
+            break;
+        }
+
+        const __m256i sextets = _mm256_add_epi8(
+            characters,
+            _mm256_shuffle_epi8(
+                offsets,
+                _mm256_add_epi8(high, _mm256_cmpeq_epi8(characters, slash))
+            )
+        );
+        const __m256i pairs =
+            _mm256_maddubs_epi16(sextets, _mm256_set1_epi32(0x0140'0140));
+        const __m256i groups =
+            _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x0001'1000));
+
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(output + written),
+            _mm256_permutevar8x32_epi32(
+                _mm256_shuffle_epi8(groups, byte_order),
+                lane_order
+            )
+        );
+    }
+
+    return index + decode_quads_sse41(
+        text + index,
+        length - index,
+        output + written,
+        capacity - written
+    );
+}
+
+constexpr Base64KernelTable kSse41Kernels{
+    .kind = Base64Kernels::Sse41,
+    .decode_quads = decode_quads_sse41
+};
+
+constexpr Base64KernelTable kAvx2Kernels{
+    .kind = Base64Kernels::Avx2,
+    .decode_quads = decode_quads_avx2
+};
+
+#elif defined(MIDNIGHT_BASE64_NEON)
+
+std::size_t decode_quads_neon(
+    const char* const text,
+    const std::size_t length,
+    std::byte* const output,
+    const std::size_t capacity
+) noexcept
+{
+    const uint8x16_t low_classes = vld1q_u8(kLowNibbleClasses.data());
+    const uint8x16_t high_classes = vld1q_u8(kHighNibbleClasses.data());
+    const uint8x16_t offsets = vld1q_u8(kSextetOffsets.data());
+    const uint8x16_t byte_order = vld1q_u8(kGroupByteOrder.data());
+    std::size_t index = 0;
+    std::size_t written = 0;
+
+    for (; index + 16 <= length && written + 16 <= capacity;
+         index += 16, written += 12) {
+        const uint8x16_t characters =
+            vld1q_u8(reinterpret_cast<const std::uint8_t*>(text + index));
+        const uint8x16_t high = vshrq_n_u8(characters, 4);
+        const uint8x16_t classes = vandq_u8(
+            vqtbl1q_u8(low_classes, vandq_u8(characters, vdupq_n_u8(0x0F))),
+            vqtbl1q_u8(high_classes, high)
+        );
+
+        if (vmaxvq_u8(classes) != 0) {
+            break;
+        }
+
+        const uint8x16_t sextets = vaddq_u8(
+            characters,
+            vqtbl1q_u8(
+                offsets,
+                vaddq_u8(high, vceqq_u8(characters, vdupq_n_u8('/')))
+            )
+        );
+
+        // NEON has no multiply-add across neighbouring lanes, so the
+        // sextet pairs and then the 12-bit pairs are joined with shifts.
+        const uint16x8_t pairs = vreinterpretq_u16_u8(sextets);
+        const uint32x4_t halves = vreinterpretq_u32_u16(vorrq_u16(
+            vshlq_n_u16(vandq_u16(pairs, vdupq_n_u16(0x00FF)), 6),
+            vshrq_n_u16(pairs, 8)
+        ));
+        const uint32x4_t groups = vorrq_u32(
+            vshlq_n_u32(vandq_u32(halves, vdupq_n_u32(0xFFFF)), 12),
+            vshrq_n_u32(halves, 16)
+        );
+
+        vst1q_u8(
+            reinterpret_cast<std::uint8_t*>(output + written),
+            vqtbl1q_u8(vreinterpretq_u8_u32(groups), byte_order)
+        );
+    }
+
+    return index + decode_quads_scalar(
+        text + index,
+        length - index,
+        output + written,
+        capacity - written
+    );
+}
+
+constexpr Base64KernelTable kNeonKernels{
+    .kind = Base64Kernels::Neon,
+    .decode_quads = decode_quads_neon
+};
+
+#endif
+
+// Null when the CPU cannot run `kernels`.
+const Base64KernelTable* kernels_for(const Base64Kernels kernels) noexcept
+{
+    switch (kernels) {
+        case Base64Kernels::Scalar:
+            return &kScalarKernels;
+
+#if defined(MIDNIGHT_BASE64_X86)
+        case Base64Kernels::Sse41:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse4.1") ? &kSse41Kernels : nullptr;
+
+        case Base64Kernels::Avx2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? &kAvx2Kernels : nullptr;
+
+#elif defined(MIDNIGHT_BASE64_NEON)
+        case Base64Kernels::Neon:
+            return &kNeonKernels;
+
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+constinit std::atomic<const Base64KernelTable*> active_kernels{nullptr};
+
+const Base64KernelTable& kernels() noexcept
+{
+    const Base64KernelTable* table =
+        active_kernels.load(std::memory_order_acquire);
+
+    // Racing first calls all pick the same table.
+    if (table == nullptr) {
+        table = kernels_for(best_base64_kernels());
+        active_kernels.store(table, std::memory_order_release);
+    }
+
+    return *table;
+}
+
+}
+
+Base64Kernels best_base64_kernels() noexcept
+{
+    for (const Base64Kernels kernels : {
+             Base64Kernels::Avx2,
+             Base64Kernels::Sse41,
+             Base64Kernels::Neon
+         }) {
+        if (kernels_for(kernels) != nullptr) {
+            return kernels;
+        }
+    }
+
+    return Base64Kernels::Scalar;
+}
+
+Base64Kernels active_base64_kernels() noexcept
+{
+    return kernels().kind;
+}
+
+std::string_view base64_kernels_name(const Base64Kernels kernels) noexcept
+{
+    switch (kernels) {
+        case Base64Kernels::Sse41:
+            return "sse4.1";
+
+        case Base64Kernels::Avx2:
+            return "avx2";
+
+        case Base64Kernels::Neon:
+            return "neon";
+
+        default:
+            return "scalar";
+    }
+}
+
+bool use_base64_kernels(const Base64Kernels kernels) noexcept
+{
+    const Base64KernelTable* const table = kernels_for(kernels);
+
+    if (table == nullptr) {
+        return false;
+    }
+
+    active_kernels.store(table, std::memory_order_release);
+    return true;
+}
+
+std::string encode_base64(const std::span<const std::byte> bytes)
+{
+    std::string text((bytes.size() + 2) / 3 * 4, '=');
+    char* output = text.data();
+    std::size_t index = 0;
+
+    for (; index + 3 <= bytes.size(); index += 3) {
+        const std::uint32_t group =
+            static_cast<std::uint32_t>(bytes[index]) << 16 |
+            static_cast<std::uint32_t>(bytes[index + 1]) << 8 |
+            static_cast<std::uint32_t>(bytes[index + 2]);
+
+        output[0] = kBase64Alphabet[(group >> 18) & 0x3F];
+        output[1] = kBase64Alphabet[(group >> 12) & 0x3F];
+        output[2] = kBase64Alphabet[(group >> 6) & 0x3F];
+        output[3] = kBase64Alphabet[group & 0x3F];
+        output += 4;
+    }
+
+    const std::size_t remainder = bytes.size() - index;
+
+    if (remainder > 0) {
+        std::uint32_t group = static_cast<std::uint32_t>(bytes[index]) << 16;
+
+        if (remainder == 2) {
+            group |= static_cast<std::uint32_t>(bytes[index + 1]) << 8;
+            output[2] = kBase64Alphabet[(group >> 6) & 0x3F];
+        }
+
+        output[0] = kBase64Alphabet[(group >> 18) & 0x3F];
+        output[1] = kBase64Alphabet[(group >> 12) & 0x3F];
+    }
+
+    return text;
+}
+
+std::vector<std::byte> decode_base64(const std::string_view text)
+{
+    std::vector<std::byte> bytes(text.size() / 4 * 3 + 3);
+    bytes.resize(decode_base64(text, bytes));
+
+    return bytes;
+}
+
+std::size_t decode_base64(
+    std::string_view text,
+    const std::span<std::byte> output_bytes
+)
+{
+    while (!text.empty() && skippable(text.front())) {
+        text.remove_prefix(1);
+    }
+
+    while (!text.empty() && skippable(text.back())) {
+        text.remove_suffix(1);
+    }
+
+    std::byte* output = output_bytes.data();
+    std::byte* const output_end = output + output_bytes.size();
+
+    const auto reserve_output = [&](const std::size_t count) {
+        if (static_cast<std::size_t>(output_end - output) < count) {
+            throw std::runtime_error("Decoded base64 data is larger than expected");
+        }
+    };
+
+    // The quad kernels stop at the first padding, whitespace or escape; the
+    // remainder is finished one character at a time.
+    std::size_t index = kernels().decode_quads(
+        text.data(),
+        text.size(),
+        output,
+        output_bytes.size()
+    );
+    output += index / 4 * 3;
+
+    std::uint32_t group = 0;
+    std::size_t sextet_count = 0;
+    std::size_t padding_count = 0;
+
+    for (; index < text.size(); ++index) {
+        const char character = text[index];
+
+        if (skippable(character)) {
+            continue;
+        }
+
+        if (character == '=') {
+            ++padding_count;
+            continue;
+        }
+
+        const std::uint32_t sextet = kSextets[static_cast<unsigned char>(character)];
+
+        if (sextet == kInvalidSextet || padding_count > 0) {
+            throw std::runtime_error("Invalid base64 data");
+        }
+
+        group = group << 6 | sextet;
+
+        if (++sextet_count == 4) {
+            reserve_output(3);
+            output[0] = static_cast<std::byte>(group >> 16);
+            output[1] = static_cast<std::byte>(group >> 8);
+            output[2] = static_cast<std::byte>(group);
+            output += 3;
+            group = 0;
+            sextet_count = 0;
+        }
+    }
+
+    if (sextet_count == 1 ||
+        padding_count > 2 ||
+        (padding_count > 0 && sextet_count + padding_count != 4)) {
+        throw std::runtime_error("Invalid base64 data");
+    }
+
+    if (sextet_count == 2) {
+        reserve_output(1);
+        *output++ = static_cast<std::byte>(group >> 4);
+    } else if (sextet_count == 3) {
+        reserve_output(2);
+        output[0] = static_cast<std::byte>(group >> 10);
+        output[1] = static_cast<std::byte>(group >> 2);
+        output += 2;
+    }
+
+    return static_cast<std::size_t>(output - output_bytes.data());
+}
+
+}
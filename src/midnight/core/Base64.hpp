@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace midnight {
+
+enum class Base64Kernels : std::uint8_t {
+    Scalar,
+    Sse41,
+    Avx2,
+    Neon
+};
+
+// Decoding runs whole blocks of characters through vector kernels up to the
+// first padding, whitespace or escape. The first call picks the widest
+// instruction set the CPU supports: AVX2 or SSE4.1 on x86-64, NEON on
+// AArch64, table lookups anywhere else.
+
+[[nodiscard]] Base64Kernels best_base64_kernels() noexcept;
+[[nodiscard]] Base64Kernels active_base64_kernels() noexcept;
+[[nodiscard]] std::string_view base64_kernels_name(Base64Kernels kernels) noexcept;
+
+// Returns false, changing nothing, when the CPU cannot run `kernels`.
+bool use_base64_kernels(Base64Kernels kernels) noexcept;
+
+[[nodiscard]] std::string encode_base64(std::span<const std::byte> bytes);
+
+// Accepts standard padded base64. Whitespace and the backslashes left by
+// JSON "\/" escapes are skipped.
+[[nodiscard]] std::vector<std::byte> decode_base64(std::string_view text);
+
+// Decodes into `output` and returns the number of bytes written. Throws if
+// the decoded data does not fit.
+std::size_t decode_base64(std::string_view text, std::span<std::byte> output);
+
+}
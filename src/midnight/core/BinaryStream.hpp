@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace midnight {
+
+// Little-endian encoding helpers for the editor's on-disk records.
+class ByteWriter final {
+public:
+    void write_u8(const std::uint8_t value)
+    {
+        bytes_.push_back(static_cast<std::byte>(value));
+    }
+
+    void write_u32(const std::uint32_t value)
+    {
+        for (std::size_t byte = 0; byte < 4; ++byte) {
+            bytes_.push_back(static_cast<std::byte>(value >> (byte * 8)));
+        }
+    }
+
+    void write_u64(const std::uint64_t value)
+    {
+        write_u32(static_cast<std::uint32_t>(value));
+        write_u32(static_cast<std::uint32_t>(value >> 32));
+    }
+
+    // LEB128: seven bits per byte, low bits first.
+    void write_varint(std::uint64_t value)
+    {
+        while (value >= 0x80) {
+            bytes_.push_back(static_cast<std::byte>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+
+        bytes_.push_back(static_cast<std::byte>(value));
+    }
+
+    void write_bytes(const std::span<const std::byte> bytes)
+    {
+        bytes_.insert(bytes_.end(), bytes.begin(), bytes.end());
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return bytes_.size();
+    }
+
+    [[nodiscard]] std::vector<std::byte> take() noexcept
+    {
+        return std::exchange(bytes_, {});
+    }
+
+private:
+    std::vector<std::byte> bytes_;
+};
+
+class ByteReader final {
+public:
+    explicit ByteReader(const std::span<const std::byte> bytes) noexcept
+        : bytes_(bytes)
+    {
+    }
+
+    [[nodiscard]] std::uint8_t read_u8()
+    {
+        return static_cast<std::uint8_t>(read_bytes(1)[0]);
+    }
+
+    [[nodiscard]] std::uint32_t read_u32()
+    {
+        const std::span<const std::byte> bytes = read_bytes(4);
+        std::uint32_t value = 0;
+
+        for (std::size_t byte = 0; byte < 4; ++byte) {
+            value |= static_cast<std::uint32_t>(bytes[byte]) << (byte * 8);
+        }
+
+        return value;
+    }
+
+    [[nodiscard]] std::uint64_t read_u64()
+    {
+        const std::uint64_t low = read_u32();
+        const std::uint64_t high = read_u32();
+
+        return low | high << 32;
+    }
+
+    [[nodiscard]] std::uint64_t read_varint()
+    {
+        std::uint64_t value = 0;
+
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            const std::uint8_t byte = read_u8();
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+
+        throw std::runtime_error("Variable-length integer is too long");
+    }
+
+    [[nodiscard]] std::span<const std::byte> read_bytes(const std::size_t count)
+    {
+        if (count > remaining()) {
+            throw std::runtime_error("Unexpected end of binary data");
+        }
+
+        const std::span<const std::byte> bytes = bytes_.subspan(offset_, count);
+        offset_ += count;
+
+        return bytes;
+    }
+
+    [[nodiscard]] std::size_t offset() const noexcept
+    {
+        return offset_;
+    }
+
+    [[nodiscard]] std::size_t remaining() const noexcept
+    {
+        return bytes_.size() - offset_;
+    }
+
+private:
+    std::span<const std::byte> bytes_;
+    std::size_t offset_ = 0;
+};
+
+}
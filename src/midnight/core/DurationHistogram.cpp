@@ -0,0 +1,147 @@
+#include "midnight/core/DurationHistogram.hpp"
+
+#include "midnight/core/Log.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace midnight {
+namespace {
+
+constexpr std::int64_t kFirstBucketLimitNanoseconds =
+    std::chrono::nanoseconds{DurationHistogram::kFirstBucketLimit}.count();
+constexpr std::size_t kBarWidth = 40;
+
+double to_milliseconds(const std::int64_t nanoseconds) noexcept
+{
+    return static_cast<double>(nanoseconds) / 1'000'000.0;
+}
+
+std::size_t bucket_index(const std::int64_t nanoseconds) noexcept
+{
+    std::size_t index = 0;
+    std::int64_t limit = kFirstBucketLimitNanoseconds;
+
+    while (index + 1 < DurationHistogram::kBucketCount &&
+           nanoseconds >= limit) {
+        limit *= 2;
+        ++index;
+    }
+
+    return index;
+}
+
+}
+
+void DurationHistogram::add(const std::chrono::nanoseconds duration)
+{
+    const std::int64_t nanoseconds = std::max<std::int64_t>(duration.count(), 0);
+
+    samples_.push_back(nanoseconds);
+    ++buckets_[bucket_index(nanoseconds)];
+    total_ += nanoseconds;
+    max_ = std::max(max_, nanoseconds);
+}
+
+std::size_t DurationHistogram::count() const noexcept
+{
+    return samples_.size();
+}
+
+std::chrono::nanoseconds DurationHistogram::mean() const noexcept
+{
+    return samples_.empty()
+        ? std::chrono::nanoseconds{}
+        : std::chrono::nanoseconds{
+              total_ / static_cast<std::int64_t>(samples_.size())
+          };
+}
+
+std::chrono::nanoseconds DurationHistogram::max() const noexcept
+{
+    return std::chrono::nanoseconds{max_};
+}
+
+std::chrono::nanoseconds DurationHistogram::percentile(const double fraction) const
+{
+    if (fraction < 0.0 || fraction > 1.0) {
+        throw std::runtime_error("Percentile fraction must be between 0 and 1");
+    }
+
+    if (samples_.empty()) {
+        return {};
+    }
+
+    const std::size_t rank = static_cast<std::size_t>(std::ceil(
+        fraction * static_cast<double>(samples_.size())
+    ));
+    const std::size_t index = rank > 0 ? rank - 1 : 0;
+
+    std::vector<std::int64_t> sorted = samples_;
+    std::nth_element(
+        sorted.begin(),
+        sorted.begin() + static_cast<std::ptrdiff_t>(index),
+        sorted.end()
+    );
+
+    return std::chrono::nanoseconds{sorted[index]};
+}
+
+void DurationHistogram::log_report(const std::string_view name) const
+{
+    if (samples_.empty()) {
+        MIDNIGHT_LOG_INFO(Core, "{}: no samples", name);
+        return;
+    }
+
+    MIDNIGHT_LOG_INFO(
+        Core,
+        "{}: {} frames, mean {} ms, p50 {} ms, p90 {} ms, p99 {} ms, max {} ms",
+        name,
+        samples_.size(),
+        to_milliseconds(mean().count()),
+        to_milliseconds(percentile(0.50).count()),
+        to_milliseconds(percentile(0.90).count()),
+        to_milliseconds(percentile(0.99).count()),
+        to_milliseconds(max_)
+    );
+
+    const std::uint64_t largest_bucket =
+        *std::max_element(buckets_.begin(), buckets_.end());
+    std::int64_t lower = 0;
+    std::int64_t upper = kFirstBucketLimitNanoseconds;
+
+    for (std::size_t index = 0; index < kBucketCount; ++index) {
+        const std::uint64_t bucket = buckets_[index];
+        const std::size_t bar_length = static_cast<std::size_t>(
+            (bucket * kBarWidth + largest_bucket - 1) / largest_bucket
+        );
+        const std::string bar(bar_length, '#');
+
+        if (index + 1 < kBucketCount) {
+            MIDNIGHT_LOG_INFO(
+                Core,
+                "  {} - {} ms: {} {}",
+                to_milliseconds(lower),
+                to_milliseconds(upper),
+                bucket,
+                bar
+            );
+        } else {
+            MIDNIGHT_LOG_INFO(
+                Core,
+                "  {}+ ms: {} {}",
+                to_milliseconds(lower),
+                bucket,
+                bar
+            );
+        }
+
+        lower = upper;
+        upper *= 2;
+    }
+}
+
+}
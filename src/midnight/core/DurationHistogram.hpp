@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace midnight {
+
+// Collects durations for a benchmark report. Every sample is kept so the
+// percentiles are exact; the buckets double in width from a quarter
+// millisecond so both fast frames and hitches stay readable.
+class DurationHistogram final {
+public:
+    static constexpr std::size_t kBucketCount = 9;
+    static constexpr std::chrono::microseconds kFirstBucketLimit{250};
+
+    DurationHistogram() = default;
+
+    DurationHistogram(const DurationHistogram&) = delete;
+    DurationHistogram& operator=(const DurationHistogram&) = delete;
+
+    DurationHistogram(DurationHistogram&&) = delete;
+    DurationHistogram& operator=(DurationHistogram&&) = delete;
+
+    void add(std::chrono::nanoseconds duration);
+
+    [[nodiscard]] std::size_t count() const noexcept;
+    [[nodiscard]] std::chrono::nanoseconds mean() const noexcept;
+    [[nodiscard]] std::chrono::nanoseconds max() const noexcept;
+
+    // `fraction` in [0, 1]; nearest-rank over the recorded samples.
+    [[nodiscard]] std::chrono::nanoseconds percentile(double fraction) const;
+
+    void log_report(std::string_view name) const;
+
+private:
+    std::vector<std::int64_t> samples_;
+    std::array<std::uint64_t, kBucketCount> buckets_{};
+    std::int64_t total_ = 0;
+    std::int64_t max_ = 0;
+};
+
+}
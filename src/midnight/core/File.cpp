@@ -5,6 +5,11 @@
 #include <stdexcept>
 #include <string>
 
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace midnight {
 namespace {
 
@@ -66,4 +71,25 @@ std::string read_text_file(const std::filesystem::path& path)
     return stream.str();
 }
 
+void sync_directory(const std::filesystem::path& directory)
+{
+#if !defined(_WIN32)
+    const std::filesystem::path target = directory.empty() ? "." : directory;
+    const int descriptor = ::open(target.c_str(), O_RDONLY | O_DIRECTORY);
+
+    if (descriptor < 0) {
+        throw std::runtime_error("Failed to open directory: " + path_to_string(target));
+    }
+
+    const int result = ::fsync(descriptor);
+    ::close(descriptor);
+
+    if (result != 0) {
+        throw std::runtime_error("Failed to sync directory: " + path_to_string(target));
+    }
+#else
+    (void)directory;
+#endif
+}
+
 }
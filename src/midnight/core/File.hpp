@@ -15,4 +15,9 @@ namespace midnight {
     const std::filesystem::path& path
 );
 
+// Flushes `directory`'s entries, so a file renamed into it or created in it
+// survives a crash. An empty path is the working directory. Does nothing on
+// Windows.
+void sync_directory(const std::filesystem::path& directory);
+
 }
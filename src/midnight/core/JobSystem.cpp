@@ -0,0 +1,303 @@
+#include "midnight/core/JobSystem.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace midnight {
+namespace {
+
+struct WorkerIdentity final {
+    const JobSystem* job_system = nullptr;
+    std::size_t worker_index = 0;
+};
+
+thread_local WorkerIdentity current_worker{};
+
+}
+
+bool JobCounter::done() const noexcept
+{
+    return pending_.load(std::memory_order_acquire) == 0;
+}
+
+JobSystem::JobSystem(const std::size_t worker_count)
+{
+    workers_.reserve(worker_count);
+
+    for (std::size_t worker_index = 0;
+         worker_index < worker_count;
+         ++worker_index) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+
+    for (std::size_t worker_index = 0;
+         worker_index < worker_count;
+         ++worker_index) {
+        workers_[worker_index]->thread = std::jthread([this, worker_index] {
+            run_worker(worker_index);
+        });
+    }
+}
+
+JobSystem::~JobSystem() noexcept
+{
+    {
+        const std::lock_guard lock(sleep_mutex_);
+        stopping_ = true;
+    }
+
+    sleep_condition_.notify_all();
+
+    for (const std::unique_ptr<Worker>& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+
+    for (Job* job : injection_queue_) {
+        delete job;
+    }
+}
+
+void JobSystem::run(JobCounter& counter, Work work)
+{
+    counter.pending_.fetch_add(1, std::memory_order_relaxed);
+    enqueue(new Job{.work = std::move(work), .counter = &counter});
+}
+
+void JobSystem::run_after(
+    JobCounter& dependency,
+    JobCounter& counter,
+    Work work
+)
+{
+    counter.pending_.fetch_add(1, std::memory_order_relaxed);
+
+    {
+        const std::lock_guard lock(dependency.mutex_);
+
+        if (!dependency.done()) {
+            dependency.continuations_.push_back(JobCounter::Continuation{
+                .job_system = this,
+                .counter = &counter,
+                .work = std::move(work)
+            });
+            return;
+        }
+    }
+
+    enqueue(new Job{.work = std::move(work), .counter = &counter});
+}
+
+void JobSystem::wait(JobCounter& counter)
+{
+    while (!counter.done()) {
+        if (!help_one()) {
+            std::this_thread::yield();
+        }
+    }
+
+    std::exception_ptr error;
+
+    {
+        const std::lock_guard lock(counter.mutex_);
+        error = std::exchange(counter.error_, nullptr);
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+bool JobSystem::help_one()
+{
+    Job* job = find_job();
+
+    if (job == nullptr) {
+        return false;
+    }
+
+    execute(job);
+    return true;
+}
+
+void JobSystem::parallel_for(
+    const std::size_t count,
+    const std::size_t grain_size,
+    const RangeWork& work
+)
+{
+    if (count == 0) {
+        return;
+    }
+
+    const std::size_t grain = std::max<std::size_t>(grain_size, 1);
+
+    if (count <= grain || workers_.empty()) {
+        work(0, count);
+        return;
+    }
+
+    JobCounter counter;
+
+    for (std::size_t begin = grain; begin < count; begin += grain) {
+        const std::size_t end = std::min(begin + grain, count);
+
+        run(counter, [&work, begin, end] {
+            work(begin, end);
+        });
+    }
+
+    std::exception_ptr error;
+
+    try {
+        work(0, grain);
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    try {
+        wait(counter);
+    } catch (...) {
+        if (!error) {
+            error = std::current_exception();
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+std::size_t JobSystem::worker_count() const noexcept
+{
+    return workers_.size();
+}
+
+std::size_t JobSystem::concurrency() const noexcept
+{
+    return workers_.size() + 1;
+}
+
+void JobSystem::enqueue(Job* job)
+{
+    if (current_worker.job_system == this) {
+        workers_[current_worker.worker_index]->deque.push(job);
+    } else {
+        const std::lock_guard lock(injection_mutex_);
+        injection_queue_.push_back(job);
+    }
+
+    queued_job_count_.fetch_add(1, std::memory_order_release);
+
+    {
+        const std::lock_guard lock(sleep_mutex_);
+    }
+
+    sleep_condition_.notify_one();
+}
+
+JobSystem::Job* JobSystem::find_job()
+{
+    if (queued_job_count_.load(std::memory_order_acquire) == 0) {
+        return nullptr;
+    }
+
+    Job* job = nullptr;
+    std::size_t first_victim = 0;
+
+    if (current_worker.job_system == this) {
+        job = workers_[current_worker.worker_index]->deque.pop();
+        first_victim = current_worker.worker_index + 1;
+    }
+
+    if (job == nullptr) {
+        const std::lock_guard lock(injection_mutex_);
+
+        if (!injection_queue_.empty()) {
+            job = injection_queue_.front();
+            injection_queue_.pop_front();
+        }
+    }
+
+    for (std::size_t attempt = 0;
+         job == nullptr && attempt < workers_.size();
+         ++attempt) {
+        job = workers_[(first_victim + attempt) % workers_.size()]
+            ->deque.steal();
+    }
+
+    if (job != nullptr) {
+        queued_job_count_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    return job;
+}
+
+void JobSystem::execute(Job* job)
+{
+    const std::unique_ptr<Job> owned_job(job);
+
+    try {
+        owned_job->work();
+    } catch (...) {
+        const std::lock_guard lock(owned_job->counter->mutex_);
+
+        if (!owned_job->counter->error_) {
+            owned_job->counter->error_ = std::current_exception();
+        }
+    }
+
+    complete(*owned_job->counter);
+}
+
+void JobSystem::complete(JobCounter& counter)
+{
+    std::vector<JobCounter::Continuation> continuations;
+
+    {
+        const std::lock_guard lock(counter.mutex_);
+
+        if (counter.pending_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+
+        continuations.swap(counter.continuations_);
+    }
+
+    for (JobCounter::Continuation& continuation : continuations) {
+        continuation.job_system->enqueue(new Job{
+            .work = std::move(continuation.work),
+            .counter = continuation.counter
+        });
+    }
+}
+
+void JobSystem::run_worker(const std::size_t worker_index)
+{
+    current_worker = WorkerIdentity{
+        .job_system = this,
+        .worker_index = worker_index
+    };
+
+    while (true) {
+        if (Job* job = find_job(); job != nullptr) {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock lock(sleep_mutex_);
+
+        sleep_condition_.wait(lock, [this] {
+            return stopping_ ||
+                queued_job_count_.load(std::memory_order_acquire) > 0;
+        });
+
+        if (stopping_ &&
+            queued_job_count_.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+}
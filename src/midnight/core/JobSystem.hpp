@@ -0,0 +1,102 @@
+#pragma once
+
+#include "midnight/core/WorkStealingDeque.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace midnight {
+
+class JobSystem;
+
+class JobCounter final {
+public:
+    JobCounter() = default;
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    JobCounter(JobCounter&&) = delete;
+    JobCounter& operator=(JobCounter&&) = delete;
+
+    [[nodiscard]] bool done() const noexcept;
+
+private:
+    friend class JobSystem;
+
+    struct Continuation final {
+        JobSystem* job_system = nullptr;
+        JobCounter* counter = nullptr;
+        std::function<void()> work;
+    };
+
+    std::atomic<std::uint32_t> pending_ = 0;
+    std::mutex mutex_;
+    std::vector<Continuation> continuations_;
+    std::exception_ptr error_;
+};
+
+class JobSystem final {
+public:
+    using Work = std::function<void()>;
+    using RangeWork = std::function<void(std::size_t, std::size_t)>;
+
+    explicit JobSystem(std::size_t worker_count);
+    ~JobSystem() noexcept;
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    JobSystem(JobSystem&&) = delete;
+    JobSystem& operator=(JobSystem&&) = delete;
+
+    void run(JobCounter& counter, Work work);
+    void run_after(JobCounter& dependency, JobCounter& counter, Work work);
+    void wait(JobCounter& counter);
+    bool help_one();
+
+    void parallel_for(
+        std::size_t count,
+        std::size_t grain_size,
+        const RangeWork& work
+    );
+
+    [[nodiscard]] std::size_t worker_count() const noexcept;
+    [[nodiscard]] std::size_t concurrency() const noexcept;
+
+private:
+    struct Job final {
+        Work work;
+        JobCounter* counter = nullptr;
+    };
+
+    struct Worker final {
+        WorkStealingDeque<Job> deque;
+        std::jthread thread;
+    };
+
+    void enqueue(Job* job);
+    [[nodiscard]] Job* find_job();
+    void execute(Job* job);
+    void complete(JobCounter& counter);
+    void run_worker(std::size_t worker_index);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::mutex injection_mutex_;
+    std::deque<Job*> injection_queue_;
+    std::atomic<std::size_t> queued_job_count_ = 0;
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_condition_;
+    bool stopping_ = false;
+};
+
+}
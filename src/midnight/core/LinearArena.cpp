@@ -0,0 +1,154 @@
+#include "midnight/core/LinearArena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+namespace midnight {
+namespace {
+
+constexpr std::size_t kScratchArenaBlockSize = 64 * 1024;
+
+LinearArena& thread_scratch_arena()
+{
+    thread_local LinearArena arena(kScratchArenaBlockSize);
+    return arena;
+}
+
+}
+
+LinearArena::LinearArena(const std::size_t initial_block_size)
+{
+    if (initial_block_size == 0) {
+        throw std::runtime_error("Linear arena block size must be positive");
+    }
+
+    blocks_.push_back(Block{
+        .bytes = std::make_unique_for_overwrite<std::byte[]>(
+            initial_block_size
+        ),
+        .size = initial_block_size
+    });
+    block_allocation_count_ = 1;
+}
+
+LinearArena::Marker LinearArena::mark() const noexcept
+{
+    return Marker{
+        .block = current_block_,
+        .offset = current_offset_,
+        .used_bytes = used_bytes_
+    };
+}
+
+void LinearArena::rewind(const Marker& marker) noexcept
+{
+    current_block_ = marker.block;
+    current_offset_ = marker.offset;
+    used_bytes_ = marker.used_bytes;
+}
+
+void LinearArena::reset() noexcept
+{
+    rewind(Marker{});
+}
+
+std::size_t LinearArena::used_bytes() const noexcept
+{
+    return used_bytes_;
+}
+
+std::size_t LinearArena::high_water_mark() const noexcept
+{
+    return high_water_mark_;
+}
+
+std::size_t LinearArena::reserved_bytes() const noexcept
+{
+    std::size_t reserved_bytes = 0;
+
+    for (const Block& block : blocks_) {
+        reserved_bytes += block.size;
+    }
+
+    return reserved_bytes;
+}
+
+std::size_t LinearArena::block_allocation_count() const noexcept
+{
+    return block_allocation_count_;
+}
+
+void* LinearArena::do_allocate(
+    const std::size_t bytes,
+    const std::size_t alignment
+)
+{
+    while (true) {
+        Block& block = blocks_[current_block_];
+        const auto base = reinterpret_cast<std::uintptr_t>(block.bytes.get());
+        const std::uintptr_t aligned_address =
+            (base + current_offset_ + alignment - 1) & ~(alignment - 1);
+        const std::size_t aligned_offset = aligned_address - base;
+
+        if (aligned_offset + bytes <= block.size) {
+            used_bytes_ += aligned_offset + bytes - current_offset_;
+            high_water_mark_ = std::max(high_water_mark_, used_bytes_);
+            current_offset_ = aligned_offset + bytes;
+            return block.bytes.get() + aligned_offset;
+        }
+
+        used_bytes_ += block.size - current_offset_;
+
+        if (current_block_ + 1 == blocks_.size()) {
+            const std::size_t block_size = std::max(
+                block.size * 2,
+                bytes + alignment
+            );
+
+            blocks_.push_back(Block{
+                .bytes = std::make_unique_for_overwrite<std::byte[]>(
+                    block_size
+                ),
+                .size = block_size
+            });
+            ++block_allocation_count_;
+        }
+
+        ++current_block_;
+        current_offset_ = 0;
+    }
+}
+
+void LinearArena::do_deallocate(
+    void*,
+    const std::size_t,
+    const std::size_t
+)
+{
+}
+
+bool LinearArena::do_is_equal(
+    const std::pmr::memory_resource& other
+) const noexcept
+{
+    return this == &other;
+}
+
+ScratchArena::ScratchArena()
+    : arena_(thread_scratch_arena()),
+      marker_(arena_.mark())
+{
+}
+
+ScratchArena::~ScratchArena() noexcept
+{
+    arena_.rewind(marker_);
+}
+
+std::pmr::memory_resource* ScratchArena::resource() noexcept
+{
+    return &arena_;
+}
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace midnight {
+
+class LinearArena final : public std::pmr::memory_resource {
+public:
+    struct Marker final {
+        std::size_t block = 0;
+        std::size_t offset = 0;
+        std::size_t used_bytes = 0;
+    };
+
+    explicit LinearArena(std::size_t initial_block_size);
+    ~LinearArena() override = default;
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    LinearArena(LinearArena&&) = delete;
+    LinearArena& operator=(LinearArena&&) = delete;
+
+    [[nodiscard]] Marker mark() const noexcept;
+    void rewind(const Marker& marker) noexcept;
+    void reset() noexcept;
+
+    [[nodiscard]] std::size_t used_bytes() const noexcept;
+    [[nodiscard]] std::size_t high_water_mark() const noexcept;
+    [[nodiscard]] std::size_t reserved_bytes() const noexcept;
+    [[nodiscard]] std::size_t block_allocation_count() const noexcept;
+
+private:
+    struct Block final {
+        std::unique_ptr<std::byte[]> bytes;
+        std::size_t size = 0;
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(
+        void* pointer,
+        std::size_t bytes,
+        std::size_t alignment
+    ) override;
+    [[nodiscard]] bool do_is_equal(
+        const std::pmr::memory_resource& other
+    ) const noexcept override;
+
+    std::vector<Block> blocks_;
+    std::size_t current_block_ = 0;
+    std::size_t current_offset_ = 0;
+    std::size_t used_bytes_ = 0;
+    std::size_t high_water_mark_ = 0;
+    std::size_t block_allocation_count_ = 0;
+};
+
+class ScratchArena final {
+public:
+    ScratchArena();
+    ~ScratchArena() noexcept;
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    ScratchArena(ScratchArena&&) = delete;
+    ScratchArena& operator=(ScratchArena&&) = delete;
+
+    [[nodiscard]] std::pmr::memory_resource* resource() noexcept;
+
+private:
+    LinearArena& arena_;
+    LinearArena::Marker marker_;
+};
+
+}
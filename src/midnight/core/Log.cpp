@@ -0,0 +1,376 @@
+#include "midnight/core/Log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace midnight {
+namespace {
+
+static_assert((Logger::kQueueCapacity & (Logger::kQueueCapacity - 1)) == 0);
+
+std::int64_t steady_nanoseconds() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+const char* category_prefix(const LogCategory category) noexcept
+{
+    switch (category) {
+        case LogCategory::Validation:
+            return "[Vulkan validation] ";
+
+        default:
+            return "[Midnight] ";
+    }
+}
+
+void write_argument(
+    std::ostream& out,
+    const LogRecord& record,
+    const LogArgument& argument
+)
+{
+    switch (argument.type) {
+        case LogArgumentType::Signed:
+            out << argument.signed_value;
+            break;
+
+        case LogArgumentType::Unsigned:
+            out << argument.unsigned_value;
+            break;
+
+        case LogArgumentType::Floating:
+            out << argument.floating_value;
+            break;
+
+        case LogArgumentType::Boolean:
+            out << (argument.unsigned_value != 0);
+            break;
+
+        case LogArgumentType::Character:
+            out << static_cast<char>(argument.signed_value);
+            break;
+
+        case LogArgumentType::Text:
+            out.write(
+                record.text.data() + argument.text_offset,
+                argument.text_length
+            );
+            break;
+
+        case LogArgumentType::Pointer:
+            out << argument.pointer_value;
+            break;
+    }
+}
+
+void write_record(const LogRecord& record)
+{
+    std::ostream& out =
+        record.level >= LogLevel::Warning ? std::cerr : std::cout;
+
+    out << category_prefix(record.category);
+
+    std::size_t next_argument = 0;
+
+    for (const char* cursor = record.format; *cursor != '\0'; ++cursor) {
+        if (cursor[0] == '{' && cursor[1] == '}' &&
+            next_argument < record.argument_count) {
+            write_argument(out, record, record.arguments[next_argument]);
+            ++next_argument;
+            ++cursor;
+            continue;
+        }
+
+        out.put(*cursor);
+    }
+
+    if (record.suppressed > 0) {
+        out << " (" << record.suppressed << " similar messages suppressed)";
+    }
+
+    out.put('\n');
+}
+
+}
+
+bool LogSite::admit(std::uint32_t& suppressed) noexcept
+{
+    const std::int64_t now = steady_nanoseconds();
+    std::int64_t window_start =
+        window_start_.load(std::memory_order_relaxed);
+
+    if (now - window_start >= kWindowNanoseconds &&
+        window_start_.compare_exchange_strong(
+            window_start,
+            now,
+            std::memory_order_relaxed
+        )) {
+        window_count_.store(0, std::memory_order_relaxed);
+    }
+
+    if (window_count_.fetch_add(1, std::memory_order_relaxed) >= kBurst) {
+        suppressed_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+void LogRecord::append_signed(const std::int64_t value) noexcept
+{
+    if (argument_count == kMaxArguments) {
+        return;
+    }
+
+    LogArgument& argument = arguments[argument_count++];
+    argument.type = LogArgumentType::Signed;
+    argument.signed_value = value;
+}
+
+void LogRecord::append_unsigned(const std::uint64_t value) noexcept
+{
+    if (argument_count == kMaxArguments) {
+        return;
+    }
+
+    LogArgument& argument = arguments[argument_count++];
+    argument.type = LogArgumentType::Unsigned;
+    argument.unsigned_value = value;
+}
+
+void LogRecord::append_floating(const double value) noexcept
+{
+    if (argument_count == kMaxArguments) {
+        return;
+    }
+
+    LogArgument& argument = arguments[argument_count++];
+    argument.type = LogArgumentType::Floating;
+    argument.floating_value = value;
+}
+
+void LogRecord::append_boolean(const bool value) noexcept
+{
+    if (argument_count == kMaxArguments) {
+        return;
+    }
+
+    LogArgument& argument = arguments[argument_count++];
+    argument.type = LogArgumentType::Boolean;
+    argument.unsigned_value = value ? 1 : 0;
+}
+
+void LogRecord::append_character(const char value) noexcept
+{
+    if (argument_count == kMaxArguments) {
+        return;
+    }
+
+    LogArgument& argument = arguments[argument_count++];
+    argument.type = LogArgumentType::Character;
+    argument.signed_value = value;
+}
+
+void LogRecord::append_text(const std::string_view value) noexcept
+{
+    if (argument_count == kMaxArguments) {
+        return;
+    }
+
+    // Text that does not fit is cut short rather than spilling into
+    // another slot.
+    const std::size_t length =
+        std::min(value.size(), kTextCapacity - text_used);
+
+    LogArgument& argument = arguments[argument_count++];
+    argument.type = LogArgumentType::Text;
+    argument.text_offset = text_used;
+    argument.text_length = static_cast<std::uint16_t>(length);
+
+    std::memcpy(text.data() + text_used, value.data(), length);
+    text_used = static_cast<std::uint16_t>(text_used + length);
+}
+
+void LogRecord::append_pointer(const void* value) noexcept
+{
+    if (argument_count == kMaxArguments) {
+        return;
+    }
+
+    LogArgument& argument = arguments[argument_count++];
+    argument.type = LogArgumentType::Pointer;
+    argument.pointer_value = value;
+}
+
+Logger& Logger::instance()
+{
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+{
+    for (std::size_t index = 0; index < slots_.size(); ++index) {
+        slots_[index].sequence.store(index, std::memory_order_relaxed);
+    }
+
+    thread_ = std::thread([this] {
+        run();
+    });
+}
+
+Logger::~Logger() noexcept
+{
+    stopping_.store(true, std::memory_order_seq_cst);
+    wake_sequence_.fetch_add(1, std::memory_order_release);
+    wake_sequence_.notify_one();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void Logger::flush() noexcept
+{
+    const std::uint64_t target =
+        enqueue_position_.load(std::memory_order_acquire);
+
+    wake_sequence_.fetch_add(1, std::memory_order_release);
+    wake_sequence_.notify_one();
+
+    std::uint64_t written = written_position_.load(std::memory_order_acquire);
+
+    while (written < target) {
+        written_position_.wait(written, std::memory_order_acquire);
+        written = written_position_.load(std::memory_order_acquire);
+    }
+}
+
+std::uint64_t Logger::dropped_count() const noexcept
+{
+    return dropped_total_.load(std::memory_order_relaxed);
+}
+
+Logger::Slot* Logger::claim_slot(std::uint64_t& position) noexcept
+{
+    position = enqueue_position_.load(std::memory_order_relaxed);
+
+    while (true) {
+        Slot& slot = slots_[position & (kQueueCapacity - 1)];
+        const std::uint64_t sequence =
+            slot.sequence.load(std::memory_order_acquire);
+        const std::int64_t difference =
+            static_cast<std::int64_t>(sequence - position);
+
+        if (difference == 0) {
+            if (enqueue_position_.compare_exchange_weak(
+                    position,
+                    position + 1,
+                    std::memory_order_relaxed
+                )) {
+                return &slot;
+            }
+        } else if (difference < 0) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            dropped_total_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        } else {
+            position = enqueue_position_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Logger::publish_slot(Slot& slot, const std::uint64_t position) noexcept
+{
+    slot.sequence.store(position + 1, std::memory_order_release);
+
+    // Pairs with the fence in run(): either the consumer sees this slot
+    // before sleeping or we see it asleep and wake it.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (consumer_sleeping_.load(std::memory_order_relaxed)) {
+        wake_consumer();
+    }
+}
+
+void Logger::wake_consumer() noexcept
+{
+    wake_sequence_.fetch_add(1, std::memory_order_release);
+    wake_sequence_.notify_one();
+}
+
+bool Logger::drain()
+{
+    bool wrote = false;
+
+    while (true) {
+        Slot& slot = slots_[dequeue_position_ & (kQueueCapacity - 1)];
+
+        if (slot.sequence.load(std::memory_order_acquire) !=
+            dequeue_position_ + 1) {
+            break;
+        }
+
+        write_record(slot.record);
+        slot.sequence.store(
+            dequeue_position_ + kQueueCapacity,
+            std::memory_order_release
+        );
+        ++dequeue_position_;
+        wrote = true;
+    }
+
+    const std::uint64_t dropped =
+        dropped_.exchange(0, std::memory_order_relaxed);
+
+    if (dropped > 0) {
+        std::cerr << "[Midnight] Log queue full, dropped "
+                  << dropped
+                  << " messages\n";
+        wrote = true;
+    }
+
+    return wrote;
+}
+
+void Logger::run()
+{
+    while (true) {
+        const std::uint32_t wake_sequence =
+            wake_sequence_.load(std::memory_order_acquire);
+
+        if (drain()) {
+            std::cout.flush();
+            std::cerr.flush();
+        }
+
+        written_position_.store(dequeue_position_, std::memory_order_release);
+        written_position_.notify_all();
+
+        consumer_sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        const Slot& next = slots_[dequeue_position_ & (kQueueCapacity - 1)];
+        const bool pending =
+            next.sequence.load(std::memory_order_acquire) ==
+            dequeue_position_ + 1;
+
+        if (!pending) {
+            if (stopping_.load(std::memory_order_acquire)) {
+                return;
+            }
+
+            wake_sequence_.wait(wake_sequence, std::memory_order_acquire);
+        }
+
+        consumer_sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
+
+}
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+// Messages below this level, or in a category whose bit is clear in the
+// mask, compile to nothing and their arguments are never evaluated.
+#ifndef MIDNIGHT_LOG_MIN_LEVEL
+#if defined(MIDNIGHT_DEBUG) && MIDNIGHT_DEBUG
+#define MIDNIGHT_LOG_MIN_LEVEL 0
+#else
+#define MIDNIGHT_LOG_MIN_LEVEL 1
+#endif
+#endif
+
+#ifndef MIDNIGHT_LOG_CATEGORY_MASK
+#define MIDNIGHT_LOG_CATEGORY_MASK 0xFFFFFFFFu
+#endif
+
+namespace midnight {
+
+enum class LogLevel : std::uint8_t {
+    Debug,
+    Info,
+    Warning,
+    Error
+};
+
+enum class LogCategory : std::uint8_t {
+    Core,
+    Assets,
+    Map,
+    Editor,
+    Navigation,
+    Simulation,
+    Renderer,
+    Validation
+};
+
+[[nodiscard]] constexpr bool log_enabled(
+    const LogLevel level,
+    const LogCategory category
+) noexcept
+{
+    return static_cast<unsigned>(level) >= MIDNIGHT_LOG_MIN_LEVEL &&
+        ((MIDNIGHT_LOG_CATEGORY_MASK >> static_cast<unsigned>(category)) & 1u) != 0;
+}
+
+// Rate limit state for one call site. A site passes a burst of messages per
+// window; later ones are counted and the count rides along with the next
+// message the site lets through.
+class LogSite final {
+public:
+    static constexpr std::uint32_t kBurst = 20;
+    static constexpr std::int64_t kWindowNanoseconds = 1'000'000'000;
+
+    constexpr LogSite() noexcept = default;
+
+    LogSite(const LogSite&) = delete;
+    LogSite& operator=(const LogSite&) = delete;
+
+    LogSite(LogSite&&) = delete;
+    LogSite& operator=(LogSite&&) = delete;
+
+    [[nodiscard]] bool admit(std::uint32_t& suppressed) noexcept;
+
+private:
+    std::atomic<std::int64_t> window_start_ = 0;
+    std::atomic<std::uint32_t> window_count_ = 0;
+    std::atomic<std::uint32_t> suppressed_ = 0;
+};
+
+enum class LogArgumentType : std::uint8_t {
+    Signed,
+    Unsigned,
+    Floating,
+    Boolean,
+    Character,
+    Text,
+    Pointer
+};
+
+struct LogArgument final {
+    LogArgumentType type = LogArgumentType::Signed;
+    std::uint16_t text_offset = 0;
+    std::uint16_t text_length = 0;
+
+    union {
+        std::int64_t signed_value = 0;
+        std::uint64_t unsigned_value;
+        double floating_value;
+        const void* pointer_value;
+    };
+};
+
+// A message as captured on the calling thread: the format literal plus raw
+// argument values. Strings are copied into `text`; formatting happens on
+// the logger thread.
+struct LogRecord final {
+    static constexpr std::size_t kMaxArguments = 12;
+    static constexpr std::size_t kTextCapacity = 512;
+
+    const char* format = nullptr;
+    LogLevel level = LogLevel::Info;
+    LogCategory category = LogCategory::Core;
+    std::uint8_t argument_count = 0;
+    std::uint16_t text_used = 0;
+    std::uint32_t suppressed = 0;
+    std::array<LogArgument, kMaxArguments> arguments{};
+    std::array<char, kTextCapacity> text{};
+
+    void append_signed(std::int64_t value) noexcept;
+    void append_unsigned(std::uint64_t value) noexcept;
+    void append_floating(double value) noexcept;
+    void append_boolean(bool value) noexcept;
+    void append_character(char value) noexcept;
+    void append_text(std::string_view value) noexcept;
+    void append_pointer(const void* value) noexcept;
+};
+
+template <typename T>
+void append_log_argument(LogRecord& record, const T& value) noexcept
+{
+    using Value = std::remove_cvref_t<T>;
+
+    if constexpr (std::is_same_v<Value, bool>) {
+        record.append_boolean(value);
+    } else if constexpr (std::is_same_v<Value, char>) {
+        record.append_character(value);
+    } else if constexpr (std::is_integral_v<Value> && std::is_signed_v<Value>) {
+        record.append_signed(static_cast<std::int64_t>(value));
+    } else if constexpr (std::is_integral_v<Value>) {
+        record.append_unsigned(static_cast<std::uint64_t>(value));
+    } else if constexpr (std::is_floating_point_v<Value>) {
+        record.append_floating(static_cast<double>(value));
+    } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+        record.append_text(std::string_view(value));
+    } else if constexpr (std::is_pointer_v<Value>) {
+        record.append_pointer(static_cast<const void*>(value));
+    } else {
+        static_assert(!sizeof(T), "Unsupported log argument type");
+    }
+}
+
+// Process-wide asynchronous logger. Callers claim a slot in a bounded
+// multi-producer ring without locking and return; one background thread
+// formats records in order and writes them to stdout, or stderr for
+// warnings and errors. When the ring is full messages are dropped and
+// counted rather than blocking the caller.
+class Logger final {
+public:
+    static constexpr std::size_t kQueueCapacity = 1024;
+
+    [[nodiscard]] static Logger& instance();
+
+    ~Logger() noexcept;
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    Logger(Logger&&) = delete;
+    Logger& operator=(Logger&&) = delete;
+
+    template <typename... Arguments>
+    void write(
+        LogSite& site,
+        const LogLevel level,
+        const LogCategory category,
+        const char* format,
+        const Arguments&... arguments
+    ) noexcept
+    {
+        static_assert(
+            sizeof...(Arguments) <= LogRecord::kMaxArguments,
+            "Too many log arguments"
+        );
+
+        std::uint32_t suppressed = 0;
+
+        if (!site.admit(suppressed)) {
+            return;
+        }
+
+        std::uint64_t position = 0;
+        Slot* slot = claim_slot(position);
+
+        if (slot == nullptr) {
+            return;
+        }
+
+        LogRecord& record = slot->record;
+        record.format = format;
+        record.level = level;
+        record.category = category;
+        record.argument_count = 0;
+        record.text_used = 0;
+        record.suppressed = suppressed;
+        (append_log_argument(record, arguments), ...);
+
+        publish_slot(*slot, position);
+    }
+
+    // Blocks until everything logged before the call has been written.
+    void flush() noexcept;
+
+    [[nodiscard]] std::uint64_t dropped_count() const noexcept;
+
+private:
+    struct alignas(64) Slot final {
+        std::atomic<std::uint64_t> sequence = 0;
+        LogRecord record;
+    };
+
+    Logger();
+
+    [[nodiscard]] Slot* claim_slot(std::uint64_t& position) noexcept;
+    void publish_slot(Slot& slot, std::uint64_t position) noexcept;
+    void wake_consumer() noexcept;
+
+    [[nodiscard]] bool drain();
+    void run();
+
+    std::array<Slot, kQueueCapacity> slots_;
+    alignas(64) std::atomic<std::uint64_t> enqueue_position_ = 0;
+    alignas(64) std::uint64_t dequeue_position_ = 0;
+    std::atomic<std::uint64_t> written_position_ = 0;
+    std::atomic<std::uint32_t> wake_sequence_ = 0;
+    std::atomic<bool> consumer_sleeping_ = false;
+    std::atomic<bool> stopping_ = false;
+    std::atomic<std::uint64_t> dropped_ = 0;
+    std::atomic<std::uint64_t> dropped_total_ = 0;
+    std::thread thread_;
+};
+
+}
+
+#define MIDNIGHT_LOG(level, category, format, ...)                           \
+    do {                                                                     \
+        if constexpr (::midnight::log_enabled(                               \
+                          ::midnight::LogLevel::level,                       \
+                          ::midnight::LogCategory::category)) {              \
+            static ::midnight::LogSite midnight_log_site;                    \
+            ::midnight::Logger::instance().write(                            \
+                midnight_log_site,                                           \
+                ::midnight::LogLevel::level,                                 \
+                ::midnight::LogCategory::category,                           \
+                "" format __VA_OPT__(,) __VA_ARGS__                          \
+            );                                                               \
+        }                                                                    \
+    } while (false)
+
+#define MIDNIGHT_LOG_DEBUG(category, ...) MIDNIGHT_LOG(Debug, category, __VA_ARGS__)
+#define MIDNIGHT_LOG_INFO(category, ...) MIDNIGHT_LOG(Info, category, __VA_ARGS__)
+#define MIDNIGHT_LOG_WARNING(category, ...) MIDNIGHT_LOG(Warning, category, __VA_ARGS__)
+#define MIDNIGHT_LOG_ERROR(category, ...) MIDNIGHT_LOG(Error, category, __VA_ARGS__)
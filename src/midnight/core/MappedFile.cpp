@@ -0,0 +1,80 @@
+#include "midnight/core/MappedFile.hpp"
+
+#include "midnight/core/File.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace midnight {
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+    : path_(path)
+{
+#if defined(_WIN32)
+    fallback_data_ = read_binary_file(path_);
+    data_ = fallback_data_.data();
+    size_ = fallback_data_.size();
+#else
+    const int descriptor = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (descriptor < 0) {
+        throw std::runtime_error("Failed to open mapped file: " + path_.string());
+    }
+
+    struct stat status {};
+
+    if (::fstat(descriptor, &status) != 0) {
+        ::close(descriptor);
+        throw std::runtime_error("Failed to determine mapped file size: " + path_.string());
+    }
+
+    size_ = static_cast<std::size_t>(status.st_size);
+
+    if (size_ > 0) {
+        void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+        if (mapping == MAP_FAILED) {
+            ::close(descriptor);
+            throw std::runtime_error("Failed to map file: " + path_.string());
+        }
+
+        data_ = static_cast<const std::byte*>(mapping);
+        mapped_ = true;
+    }
+
+    ::close(descriptor);
+#endif
+}
+
+MappedFile::~MappedFile() noexcept
+{
+#if !defined(_WIN32)
+    if (mapped_) {
+        ::munmap(const_cast<std::byte*>(data_), size_);
+    }
+#endif
+}
+
+std::span<const std::byte> MappedFile::bytes() const noexcept
+{
+    return {data_, size_};
+}
+
+std::size_t MappedFile::size() const noexcept
+{
+    return size_;
+}
+
+const std::filesystem::path& MappedFile::path() const noexcept
+{
+    return path_;
+}
+
+}
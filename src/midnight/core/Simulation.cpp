@@ -0,0 +1,210 @@
+#include "midnight/core/Simulation.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace midnight {
+
+Simulation::Simulation(const CreateInfo& create_info)
+    : step_(create_info.step),
+      max_steps_per_update_(create_info.max_steps_per_update),
+      threaded_(create_info.threaded)
+{
+    if (step_.count() <= 0) {
+        throw std::runtime_error("Simulation step must be positive");
+    }
+
+    if (max_steps_per_update_ == 0) {
+        throw std::runtime_error("Simulation must allow at least one step per update");
+    }
+}
+
+Simulation::~Simulation() noexcept
+{
+    stop();
+}
+
+void Simulation::add_system(System system)
+{
+    if (started_) {
+        throw std::runtime_error("Cannot add a simulation system after the simulation has started");
+    }
+
+    if (!system) {
+        throw std::runtime_error("Cannot add an empty simulation system");
+    }
+
+    systems_.push_back(std::move(system));
+}
+
+std::unique_lock<std::mutex> Simulation::lock_state()
+{
+    if (!threaded_) {
+        return std::unique_lock<std::mutex>{};
+    }
+
+    return std::unique_lock{state_mutex_};
+}
+
+void Simulation::start()
+{
+    if (started_) {
+        return;
+    }
+
+    simulated_time_.store(
+        Clock::now().time_since_epoch().count(),
+        std::memory_order_release
+    );
+    started_ = true;
+
+    if (threaded_) {
+        worker_ = std::jthread([this](const std::stop_token stop_token) {
+            run_worker(stop_token);
+        });
+    }
+}
+
+void Simulation::stop() noexcept
+{
+    if (worker_.joinable()) {
+        worker_.request_stop();
+        worker_.join();
+    }
+
+    started_ = false;
+}
+
+void Simulation::update()
+{
+    if (!started_) {
+        return;
+    }
+
+    if (threaded_) {
+        std::exception_ptr worker_error;
+
+        {
+            const std::lock_guard lock(worker_error_mutex_);
+            worker_error = std::exchange(worker_error_, nullptr);
+        }
+
+        if (worker_error) {
+            stop();
+            std::rethrow_exception(worker_error);
+        }
+
+        return;
+    }
+
+    run_due_steps(Clock::now());
+}
+
+SimulationFrame Simulation::frame() const noexcept
+{
+    const std::uint64_t tick = tick_.load(std::memory_order_acquire);
+    const Clock::time_point simulated_time{
+        Clock::duration{simulated_time_.load(std::memory_order_acquire)}
+    };
+    const double alpha =
+        std::chrono::duration<double>(Clock::now() - simulated_time) /
+        std::chrono::duration<double>(step_);
+
+    return SimulationFrame{
+        .tick = tick,
+        .interpolation_alpha = std::clamp(alpha, 0.0, 1.0)
+    };
+}
+
+std::uint64_t Simulation::tick() const noexcept
+{
+    return tick_.load(std::memory_order_acquire);
+}
+
+std::uint64_t Simulation::dropped_steps() const noexcept
+{
+    return dropped_steps_.load(std::memory_order_relaxed);
+}
+
+std::chrono::nanoseconds Simulation::step() const noexcept
+{
+    return step_;
+}
+
+bool Simulation::threaded() const noexcept
+{
+    return threaded_;
+}
+
+void Simulation::run_due_steps(const Clock::time_point now)
+{
+    Clock::time_point simulated_time{
+        Clock::duration{simulated_time_.load(std::memory_order_acquire)}
+    };
+    const SimulationStep base_step{
+        .tick = 0,
+        .duration = step_,
+        .seconds = std::chrono::duration<double>(step_).count()
+    };
+
+    for (std::uint32_t step_index = 0;
+         step_index < max_steps_per_update_ && now - simulated_time >= step_;
+         ++step_index) {
+        SimulationStep step = base_step;
+        step.tick = tick_.load(std::memory_order_relaxed) + 1;
+
+        {
+            const std::unique_lock state_lock = lock_state();
+
+            for (const System& system : systems_) {
+                system(step);
+            }
+        }
+
+        simulated_time += step_;
+        simulated_time_.store(
+            simulated_time.time_since_epoch().count(),
+            std::memory_order_relaxed
+        );
+        tick_.store(step.tick, std::memory_order_release);
+    }
+
+    if (now - simulated_time >= step_) {
+        const auto skipped_steps = (now - simulated_time) / step_;
+
+        simulated_time += skipped_steps * step_;
+        simulated_time_.store(
+            simulated_time.time_since_epoch().count(),
+            std::memory_order_release
+        );
+        dropped_steps_.fetch_add(
+            static_cast<std::uint64_t>(skipped_steps),
+            std::memory_order_relaxed
+        );
+    }
+}
+
+void Simulation::run_worker(const std::stop_token stop_token)
+{
+    try {
+        while (!stop_token.stop_requested()) {
+            run_due_steps(Clock::now());
+
+            const Clock::time_point next_step_time =
+                Clock::time_point{
+                    Clock::duration{
+                        simulated_time_.load(std::memory_order_acquire)
+                    }
+                } +
+                step_;
+
+            std::this_thread::sleep_until(next_step_time);
+        }
+    } catch (...) {
+        const std::lock_guard lock(worker_error_mutex_);
+        worker_error_ = std::current_exception();
+    }
+}
+
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace midnight {
+
+struct SimulationStep final {
+    std::uint64_t tick = 0;
+    std::chrono::nanoseconds duration{};
+    double seconds = 0.0;
+};
+
+struct SimulationFrame final {
+    std::uint64_t tick = 0;
+    double interpolation_alpha = 0.0;
+};
+
+class Simulation final {
+public:
+    using Clock = std::chrono::steady_clock;
+    using System = std::function<void(const SimulationStep&)>;
+
+    struct CreateInfo final {
+        std::chrono::nanoseconds step = std::chrono::nanoseconds{16'666'667};
+        std::uint32_t max_steps_per_update = 5;
+        bool threaded = false;
+    };
+
+    explicit Simulation(const CreateInfo& create_info);
+    ~Simulation() noexcept;
+
+    Simulation(const Simulation&) = delete;
+    Simulation& operator=(const Simulation&) = delete;
+
+    Simulation(Simulation&&) = delete;
+    Simulation& operator=(Simulation&&) = delete;
+
+    void add_system(System system);
+
+    // Systems own the state they step. Threaded, the worker holds this lock
+    // for the whole of each step, so the main thread takes it before it
+    // touches that state; otherwise it locks nothing. Rendering should read
+    // a copy the systems publish at the end of a step instead of waiting.
+    [[nodiscard]] std::unique_lock<std::mutex> lock_state();
+
+    void start();
+    void stop() noexcept;
+    void update();
+
+    [[nodiscard]] SimulationFrame frame() const noexcept;
+    [[nodiscard]] std::uint64_t tick() const noexcept;
+    [[nodiscard]] std::uint64_t dropped_steps() const noexcept;
+    [[nodiscard]] std::chrono::nanoseconds step() const noexcept;
+    [[nodiscard]] bool threaded() const noexcept;
+
+private:
+    void run_due_steps(Clock::time_point now);
+    void run_worker(std::stop_token stop_token);
+
+    std::chrono::nanoseconds step_{};
+    std::uint32_t max_steps_per_update_ = 0;
+    bool threaded_ = false;
+    bool started_ = false;
+    std::vector<System> systems_;
+    std::atomic<std::uint64_t> tick_ = 0;
+    std::atomic<std::uint64_t> dropped_steps_ = 0;
+    std::atomic<Clock::rep> simulated_time_ = 0;
+    std::mutex state_mutex_;
+    std::mutex worker_error_mutex_;
+    std::exception_ptr worker_error_;
+    std::jthread worker_;
+};
+
+}
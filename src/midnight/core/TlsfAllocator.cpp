@@ -0,0 +1,375 @@
+#include "midnight/core/TlsfAllocator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <stdexcept>
+
+namespace midnight {
+
+TlsfAllocator::TlsfAllocator(const std::uint64_t capacity)
+    : capacity_(capacity)
+{
+    if (capacity_ == 0) {
+        throw std::runtime_error("TLSF allocator capacity must be non-zero");
+    }
+
+    for (std::array<Handle, kSecondLevelCount>& heads : free_heads_) {
+        heads.fill(kInvalidHandle);
+    }
+
+    insert_free(create_range(0, capacity_));
+}
+
+std::optional<TlsfAllocator::Allocation> TlsfAllocator::allocate(
+    std::uint64_t size,
+    const std::uint64_t alignment
+)
+{
+    if (alignment == 0 || !std::has_single_bit(alignment)) {
+        throw std::runtime_error("TLSF alignment must be a power of two");
+    }
+
+    size = std::max<std::uint64_t>(size, 1);
+
+    // Searching for the worst-case padding keeps the lookup to one bin probe;
+    // the padding that is not needed goes straight back to the free lists.
+    if (size > std::numeric_limits<std::uint64_t>::max() - (alignment - 1)) {
+        return std::nullopt;
+    }
+
+    const std::optional<Bin> bin = find_bin_fitting(size + alignment - 1);
+    Handle handle = kInvalidHandle;
+
+    if (bin.has_value()) {
+        handle = free_heads_[bin->first_level][bin->second_level];
+    } else {
+        handle = find_in_bin_of(size, alignment);
+    }
+
+    if (handle == kInvalidHandle) {
+        return std::nullopt;
+    }
+
+    remove_free(handle);
+
+    const std::uint64_t range_offset = ranges_[handle].offset;
+    const std::uint64_t aligned_offset =
+        (range_offset + alignment - 1) & ~(alignment - 1);
+    const std::uint64_t padding = aligned_offset - range_offset;
+
+    // Neighbours of a free range are never free themselves, so the pieces
+    // split off here cannot need merging.
+    if (padding > 0) {
+        const Handle front = create_range(range_offset, padding);
+        Range& range = ranges_[handle];
+
+        ranges_[front].previous_physical = range.previous_physical;
+        ranges_[front].next_physical = handle;
+
+        if (range.previous_physical != kInvalidHandle) {
+            ranges_[range.previous_physical].next_physical = front;
+        }
+
+        range.previous_physical = front;
+        range.offset = aligned_offset;
+        range.size -= padding;
+        insert_free(front);
+    }
+
+    if (ranges_[handle].size > size) {
+        const Handle back = create_range(
+            ranges_[handle].offset + size,
+            ranges_[handle].size - size
+        );
+        Range& range = ranges_[handle];
+
+        ranges_[back].previous_physical = handle;
+        ranges_[back].next_physical = range.next_physical;
+
+        if (range.next_physical != kInvalidHandle) {
+            ranges_[range.next_physical].previous_physical = back;
+        }
+
+        range.next_physical = back;
+        range.size = size;
+        insert_free(back);
+    }
+
+    used_ += size;
+    ++allocation_count_;
+
+    return Allocation{
+        .offset = ranges_[handle].offset,
+        .size = size,
+        .handle = handle
+    };
+}
+
+void TlsfAllocator::free(Handle handle)
+{
+    if (handle >= ranges_.size() ||
+        ranges_[handle].free ||
+        ranges_[handle].size == 0) {
+        throw std::runtime_error("Invalid TLSF allocation handle");
+    }
+
+    used_ -= ranges_[handle].size;
+    --allocation_count_;
+
+    const Handle previous = ranges_[handle].previous_physical;
+
+    if (previous != kInvalidHandle && ranges_[previous].free) {
+        remove_free(previous);
+
+        Range& merged = ranges_[previous];
+        merged.size += ranges_[handle].size;
+        merged.next_physical = ranges_[handle].next_physical;
+
+        if (merged.next_physical != kInvalidHandle) {
+            ranges_[merged.next_physical].previous_physical = previous;
+        }
+
+        release_range(handle);
+        handle = previous;
+    }
+
+    const Handle next = ranges_[handle].next_physical;
+
+    if (next != kInvalidHandle && ranges_[next].free) {
+        remove_free(next);
+
+        Range& merged = ranges_[handle];
+        merged.size += ranges_[next].size;
+        merged.next_physical = ranges_[next].next_physical;
+
+        if (merged.next_physical != kInvalidHandle) {
+            ranges_[merged.next_physical].previous_physical = handle;
+        }
+
+        release_range(next);
+    }
+
+    insert_free(handle);
+}
+
+bool TlsfAllocator::empty() const noexcept
+{
+    return allocation_count_ == 0;
+}
+
+TlsfAllocator::Stats TlsfAllocator::stats() const noexcept
+{
+    Stats stats{
+        .capacity = capacity_,
+        .used = used_,
+        .allocation_count = allocation_count_,
+        .free_range_count = free_range_count_,
+        .largest_free_range = 0
+    };
+
+    if (first_level_bitmap_ == 0) {
+        return stats;
+    }
+
+    // Every range in the highest occupied first level is larger than any
+    // range below it, so only that level needs walking.
+    const unsigned first_level =
+        static_cast<unsigned>(std::bit_width(first_level_bitmap_)) - 1;
+
+    for (const Handle head : free_heads_[first_level]) {
+        for (Handle handle = head;
+             handle != kInvalidHandle;
+             handle = ranges_[handle].next_free) {
+            stats.largest_free_range =
+                std::max(stats.largest_free_range, ranges_[handle].size);
+        }
+    }
+
+    return stats;
+}
+
+TlsfAllocator::Bin TlsfAllocator::bin_containing(
+    const std::uint64_t size
+) noexcept
+{
+    if (size < kSecondLevelCount) {
+        return Bin{
+            .first_level = 0,
+            .second_level = static_cast<unsigned>(size)
+        };
+    }
+
+    const unsigned top_bit =
+        static_cast<unsigned>(std::bit_width(size)) - 1;
+
+    return Bin{
+        .first_level = top_bit - kSecondLevelLog2 + 1,
+        .second_level = static_cast<unsigned>(
+            (size >> (top_bit - kSecondLevelLog2)) - kSecondLevelCount
+        )
+    };
+}
+
+std::optional<TlsfAllocator::Bin> TlsfAllocator::find_bin_fitting(
+    std::uint64_t size
+) const noexcept
+{
+    // Round up to the next bin boundary so any range in the bin found fits.
+    if (size >= kSecondLevelCount) {
+        const unsigned top_bit =
+            static_cast<unsigned>(std::bit_width(size)) - 1;
+        const std::uint64_t round_up =
+            (std::uint64_t{1} << (top_bit - kSecondLevelLog2)) - 1;
+
+        if (size > std::numeric_limits<std::uint64_t>::max() - round_up) {
+            return std::nullopt;
+        }
+
+        size += round_up;
+    }
+
+    Bin bin = bin_containing(size);
+    std::uint32_t second_level_map =
+        second_level_bitmaps_[bin.first_level] &
+        (~std::uint32_t{0} << bin.second_level);
+
+    if (second_level_map == 0) {
+        if (bin.first_level + 1 >= kFirstLevelCount) {
+            return std::nullopt;
+        }
+
+        const std::uint64_t first_level_map =
+            first_level_bitmap_ &
+            (~std::uint64_t{0} << (bin.first_level + 1));
+
+        if (first_level_map == 0) {
+            return std::nullopt;
+        }
+
+        bin.first_level =
+            static_cast<unsigned>(std::countr_zero(first_level_map));
+        second_level_map = second_level_bitmaps_[bin.first_level];
+    }
+
+    bin.second_level =
+        static_cast<unsigned>(std::countr_zero(second_level_map));
+
+    return bin;
+}
+
+TlsfAllocator::Handle TlsfAllocator::find_in_bin_of(
+    const std::uint64_t size,
+    const std::uint64_t alignment
+) const noexcept
+{
+    // The rounded search skips the bin that could hold an exact fit, which
+    // matters when a request is close to the largest free range.
+    const Bin bin = bin_containing(size);
+
+    for (Handle handle = free_heads_[bin.first_level][bin.second_level];
+         handle != kInvalidHandle;
+         handle = ranges_[handle].next_free) {
+        const Range& range = ranges_[handle];
+        const std::uint64_t padding =
+            ((range.offset + alignment - 1) & ~(alignment - 1)) -
+            range.offset;
+
+        if (range.size >= padding && range.size - padding >= size) {
+            return handle;
+        }
+    }
+
+    return kInvalidHandle;
+}
+
+TlsfAllocator::Handle TlsfAllocator::create_range(
+    const std::uint64_t offset,
+    const std::uint64_t size
+)
+{
+    Handle handle = kInvalidHandle;
+
+    if (!unused_ranges_.empty()) {
+        handle = unused_ranges_.back();
+        unused_ranges_.pop_back();
+    } else {
+        if (ranges_.size() >= kInvalidHandle) {
+            throw std::runtime_error("TLSF allocator ran out of range handles");
+        }
+
+        handle = static_cast<Handle>(ranges_.size());
+        ranges_.emplace_back();
+    }
+
+    ranges_[handle] = Range{
+        .offset = offset,
+        .size = size,
+        .previous_physical = kInvalidHandle,
+        .next_physical = kInvalidHandle,
+        .previous_free = kInvalidHandle,
+        .next_free = kInvalidHandle,
+        .free = false
+    };
+
+    return handle;
+}
+
+void TlsfAllocator::release_range(const Handle handle) noexcept
+{
+    ranges_[handle] = Range{};
+    unused_ranges_.push_back(handle);
+}
+
+void TlsfAllocator::insert_free(const Handle handle) noexcept
+{
+    Range& range = ranges_[handle];
+    const Bin bin = bin_containing(range.size);
+    Handle& head = free_heads_[bin.first_level][bin.second_level];
+
+    range.free = true;
+    range.previous_free = kInvalidHandle;
+    range.next_free = head;
+
+    if (head != kInvalidHandle) {
+        ranges_[head].previous_free = handle;
+    }
+
+    head = handle;
+    first_level_bitmap_ |= std::uint64_t{1} << bin.first_level;
+    second_level_bitmaps_[bin.first_level] |=
+        std::uint32_t{1} << bin.second_level;
+    ++free_range_count_;
+}
+
+void TlsfAllocator::remove_free(const Handle handle) noexcept
+{
+    Range& range = ranges_[handle];
+    const Bin bin = bin_containing(range.size);
+
+    if (range.previous_free != kInvalidHandle) {
+        ranges_[range.previous_free].next_free = range.next_free;
+    } else {
+        free_heads_[bin.first_level][bin.second_level] = range.next_free;
+    }
+
+    if (range.next_free != kInvalidHandle) {
+        ranges_[range.next_free].previous_free = range.previous_free;
+    }
+
+    if (free_heads_[bin.first_level][bin.second_level] == kInvalidHandle) {
+        second_level_bitmaps_[bin.first_level] &=
+            ~(std::uint32_t{1} << bin.second_level);
+
+        if (second_level_bitmaps_[bin.first_level] == 0) {
+            first_level_bitmap_ &= ~(std::uint64_t{1} << bin.first_level);
+        }
+    }
+
+    range.free = false;
+    range.previous_free = kInvalidHandle;
+    range.next_free = kInvalidHandle;
+    --free_range_count_;
+}
+
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace midnight {
+
+// Two-level segregated fit over an abstract range of `capacity` units. It
+// hands out offsets only, so the same allocator can carve up GPU memory
+// blocks, buffers or files. Allocation and free are O(1).
+class TlsfAllocator final {
+public:
+    using Handle = std::uint32_t;
+
+    static constexpr Handle kInvalidHandle = 0xFFFF'FFFFu;
+
+    struct Allocation final {
+        std::uint64_t offset = 0;
+        std::uint64_t size = 0;
+        Handle handle = kInvalidHandle;
+    };
+
+    struct Stats final {
+        std::uint64_t capacity = 0;
+        std::uint64_t used = 0;
+        std::size_t allocation_count = 0;
+        std::size_t free_range_count = 0;
+        std::uint64_t largest_free_range = 0;
+    };
+
+    explicit TlsfAllocator(std::uint64_t capacity);
+
+    TlsfAllocator(const TlsfAllocator&) = delete;
+    TlsfAllocator& operator=(const TlsfAllocator&) = delete;
+
+    TlsfAllocator(TlsfAllocator&&) noexcept = default;
+    TlsfAllocator& operator=(TlsfAllocator&&) noexcept = default;
+
+    // `alignment` must be a power of two. Returns nothing when no free range
+    // can hold the request.
+    [[nodiscard]] std::optional<Allocation> allocate(
+        std::uint64_t size,
+        std::uint64_t alignment
+    );
+
+    void free(Handle handle);
+
+    [[nodiscard]] bool empty() const noexcept;
+    [[nodiscard]] Stats stats() const noexcept;
+
+private:
+    static constexpr unsigned kSecondLevelLog2 = 4;
+    static constexpr unsigned kSecondLevelCount = 1u << kSecondLevelLog2;
+    static constexpr unsigned kFirstLevelCount = 64 - kSecondLevelLog2 + 1;
+
+    struct Range final {
+        std::uint64_t offset = 0;
+        std::uint64_t size = 0;
+        Handle previous_physical = kInvalidHandle;
+        Handle next_physical = kInvalidHandle;
+        Handle previous_free = kInvalidHandle;
+        Handle next_free = kInvalidHandle;
+        bool free = false;
+    };
+
+    struct Bin final {
+        unsigned first_level = 0;
+        unsigned second_level = 0;
+    };
+
+    [[nodiscard]] static Bin bin_containing(std::uint64_t size) noexcept;
+    [[nodiscard]] std::optional<Bin> find_bin_fitting(
+        std::uint64_t size
+    ) const noexcept;
+
+    [[nodiscard]] Handle find_in_bin_of(
+        std::uint64_t size,
+        std::uint64_t alignment
+    ) const noexcept;
+
+    [[nodiscard]] Handle create_range(
+        std::uint64_t offset,
+        std::uint64_t size
+    );
+    void release_range(Handle handle) noexcept;
+    void insert_free(Handle handle) noexcept;
+    void remove_free(Handle handle) noexcept;
+
+    std::uint64_t capacity_ = 0;
+    std::uint64_t used_ = 0;
+    std::size_t allocation_count_ = 0;
+    std::size_t free_range_count_ = 0;
+    std::vector<Range> ranges_;
+    std::vector<Handle> unused_ranges_;
+    std::uint64_t first_level_bitmap_ = 0;
+    std::array<std::uint32_t, kFirstLevelCount> second_level_bitmaps_{};
+    std::array<std::array<Handle, kSecondLevelCount>, kFirstLevelCount>
+        free_heads_{};
+};
+
+}
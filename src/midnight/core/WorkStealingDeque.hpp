@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace midnight {
+
+template <typename T>
+class WorkStealingDeque final {
+public:
+    explicit WorkStealingDeque(const std::size_t capacity = 256)
+    {
+        std::size_t rounded_capacity = 1;
+
+        while (rounded_capacity < capacity) {
+            rounded_capacity *= 2;
+        }
+
+        buffers_.push_back(std::make_unique<Buffer>(rounded_capacity));
+        buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    WorkStealingDeque(WorkStealingDeque&&) = delete;
+    WorkStealingDeque& operator=(WorkStealingDeque&&) = delete;
+
+    void push(T* item)
+    {
+        const std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        const std::int64_t top = top_.load(std::memory_order_acquire);
+        Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+
+        if (bottom - top > static_cast<std::int64_t>(buffer->capacity) - 1) {
+            buffer = grow(buffer, bottom, top);
+        }
+
+        buffer->put(bottom, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] T* pop()
+    {
+        const std::int64_t bottom =
+            bottom_.load(std::memory_order_relaxed) - 1;
+        Buffer* buffer = buffer_.load(std::memory_order_relaxed);
+
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        std::int64_t top = top_.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T* item = buffer->get(bottom);
+
+        if (top == bottom) {
+            if (!top_.compare_exchange_strong(
+                    top,
+                    top + 1,
+                    std::memory_order_seq_cst,
+                    std::memory_order_relaxed
+                )) {
+                item = nullptr;
+            }
+
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        return item;
+    }
+
+    [[nodiscard]] T* steal()
+    {
+        std::int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t bottom = bottom_.load(std::memory_order_acquire);
+
+        if (top >= bottom) {
+            return nullptr;
+        }
+
+        Buffer* buffer = buffer_.load(std::memory_order_acquire);
+        T* item = buffer->get(top);
+
+        if (!top_.compare_exchange_strong(
+                top,
+                top + 1,
+                std::memory_order_seq_cst,
+                std::memory_order_relaxed
+            )) {
+            return nullptr;
+        }
+
+        return item;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return bottom_.load(std::memory_order_relaxed) <=
+            top_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Buffer final {
+        explicit Buffer(const std::size_t buffer_capacity)
+            : capacity(buffer_capacity),
+              items(std::make_unique<std::atomic<T*>[]>(buffer_capacity))
+        {
+        }
+
+        void put(const std::int64_t index, T* item) noexcept
+        {
+            items[static_cast<std::size_t>(index) & (capacity - 1)].store(
+                item,
+                std::memory_order_relaxed
+            );
+        }
+
+        [[nodiscard]] T* get(const std::int64_t index) const noexcept
+        {
+            return items[static_cast<std::size_t>(index) & (capacity - 1)]
+                .load(std::memory_order_relaxed);
+        }
+
+        std::size_t capacity = 0;
+        std::unique_ptr<std::atomic<T*>[]> items;
+    };
+
+    Buffer* grow(
+        Buffer* buffer,
+        const std::int64_t bottom,
+        const std::int64_t top
+    )
+    {
+        buffers_.push_back(std::make_unique<Buffer>(buffer->capacity * 2));
+        Buffer* grown_buffer = buffers_.back().get();
+
+        for (std::int64_t index = top; index < bottom; ++index) {
+            grown_buffer->put(index, buffer->get(index));
+        }
+
+        buffer_.store(grown_buffer, std::memory_order_release);
+        return grown_buffer;
+    }
+
+    std::atomic<std::int64_t> top_ = 0;
+    std::atomic<std::int64_t> bottom_ = 0;
+    std::atomic<Buffer*> buffer_ = nullptr;
+    std::vector<std::unique_ptr<Buffer>> buffers_;
+};
+
+}
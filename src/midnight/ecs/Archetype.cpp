@@ -0,0 +1,102 @@
+#include "midnight/ecs/Archetype.hpp"
+
+#include <cstring>
+
+namespace midnight {
+
+Archetype::Archetype(const ComponentMask mask)
+    : mask_(mask)
+{
+    for (std::size_t component_type = 0;
+         component_type < kMaxComponentTypes;
+         ++component_type) {
+        if ((mask_ & (ComponentMask{1} << component_type)) == 0) {
+            continue;
+        }
+
+        column_indices_[component_type] =
+            static_cast<std::uint8_t>(columns_.size());
+        columns_.push_back(Column{
+            .element_size = component_type_info(component_type).size,
+            .bytes = {}
+        });
+    }
+}
+
+ComponentMask Archetype::mask() const noexcept
+{
+    return mask_;
+}
+
+std::size_t Archetype::size() const noexcept
+{
+    return entities_.size();
+}
+
+std::span<const Entity> Archetype::entities() const noexcept
+{
+    return entities_;
+}
+
+void Archetype::reserve(const std::size_t capacity)
+{
+    entities_.reserve(capacity);
+
+    for (Column& column : columns_) {
+        column.bytes.reserve(capacity * column.element_size);
+    }
+}
+
+void Archetype::append(const std::span<const Entity> entities)
+{
+    const std::size_t new_size = entities_.size() + entities.size();
+
+    entities_.insert(entities_.end(), entities.begin(), entities.end());
+
+    for (Column& column : columns_) {
+        column.bytes.resize(new_size * column.element_size);
+    }
+}
+
+bool Archetype::swap_remove(const std::size_t row, Entity& moved_entity)
+{
+    const std::size_t last_row = entities_.size() - 1;
+    const bool moved = row != last_row;
+
+    if (moved) {
+        for (Column& column : columns_) {
+            std::memcpy(
+                column.bytes.data() + row * column.element_size,
+                column.bytes.data() + last_row * column.element_size,
+                column.element_size
+            );
+        }
+
+        entities_[row] = entities_[last_row];
+        moved_entity = entities_[row];
+    }
+
+    entities_.pop_back();
+
+    for (Column& column : columns_) {
+        column.bytes.resize(last_row * column.element_size);
+    }
+
+    return moved;
+}
+
+void Archetype::clear() noexcept
+{
+    entities_.clear();
+
+    for (Column& column : columns_) {
+        column.bytes.clear();
+    }
+}
+
+std::byte* Archetype::column_data(const std::size_t component_type) noexcept
+{
+    return columns_[column_indices_[component_type]].bytes.data();
+}
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "midnight/ecs/ComponentType.hpp"
+#include "midnight/ecs/Entity.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace midnight {
+
+class Archetype final {
+public:
+    explicit Archetype(ComponentMask mask);
+
+    Archetype(const Archetype&) = delete;
+    Archetype& operator=(const Archetype&) = delete;
+
+    Archetype(Archetype&&) = delete;
+    Archetype& operator=(Archetype&&) = delete;
+
+    [[nodiscard]] ComponentMask mask() const noexcept;
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] std::span<const Entity> entities() const noexcept;
+
+    template <typename Component>
+    [[nodiscard]] Component* components() noexcept
+    {
+        return reinterpret_cast<Component*>(
+            column_data(component_type_id<Component>())
+        );
+    }
+
+    void reserve(std::size_t capacity);
+    void append(std::span<const Entity> entities);
+    [[nodiscard]] bool swap_remove(std::size_t row, Entity& moved_entity);
+    void clear() noexcept;
+
+private:
+    struct Column final {
+        std::size_t element_size = 0;
+        std::vector<std::byte> bytes;
+    };
+
+    [[nodiscard]] std::byte* column_data(
+        std::size_t component_type
+    ) noexcept;
+
+    ComponentMask mask_ = 0;
+    std::vector<Column> columns_;
+    std::array<std::uint8_t, kMaxComponentTypes> column_indices_{};
+    std::vector<Entity> entities_;
+};
+
+}
@@ -0,0 +1,50 @@
+#include "midnight/ecs/ComponentType.hpp"
+
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace midnight {
+namespace {
+
+std::mutex& component_type_mutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<ComponentTypeInfo>& component_types()
+{
+    static std::vector<ComponentTypeInfo> types;
+    return types;
+}
+
+}
+
+std::size_t register_component_type(
+    const std::size_t size,
+    const std::size_t alignment
+)
+{
+    const std::lock_guard lock(component_type_mutex());
+    std::vector<ComponentTypeInfo>& types = component_types();
+
+    if (types.size() == kMaxComponentTypes) {
+        throw std::runtime_error("Too many ECS component types registered");
+    }
+
+    types.push_back(ComponentTypeInfo{
+        .size = size,
+        .alignment = alignment
+    });
+
+    return types.size() - 1;
+}
+
+ComponentTypeInfo component_type_info(const std::size_t component_type)
+{
+    const std::lock_guard lock(component_type_mutex());
+    return component_types().at(component_type);
+}
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+namespace midnight {
+
+using ComponentMask = std::uint64_t;
+
+inline constexpr std::size_t kMaxComponentTypes = 64;
+
+struct ComponentTypeInfo final {
+    std::size_t size = 0;
+    std::size_t alignment = 0;
+};
+
+[[nodiscard]] std::size_t register_component_type(
+    std::size_t size,
+    std::size_t alignment
+);
+
+[[nodiscard]] ComponentTypeInfo component_type_info(
+    std::size_t component_type
+);
+
+template <typename Component>
+[[nodiscard]] std::size_t component_type_id()
+{
+    static_assert(std::is_trivially_copyable_v<Component>);
+    static_assert(
+        alignof(Component) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__
+    );
+
+    static const std::size_t id =
+        register_component_type(sizeof(Component), alignof(Component));
+
+    return id;
+}
+
+template <typename... Components>
+[[nodiscard]] ComponentMask component_mask()
+{
+    return (ComponentMask{0} | ... |
+        (ComponentMask{1} << component_type_id<Components>()));
+}
+
+}
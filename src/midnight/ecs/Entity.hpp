@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+
+namespace midnight {
+
+struct Entity final {
+    std::uint32_t index = 0;
+    std::uint32_t generation = 0;
+
+    friend bool operator==(const Entity&, const Entity&) = default;
+};
+
+}
@@ -0,0 +1,400 @@
+#include "midnight/ecs/SpatialGrid.hpp"
+
+#include "midnight/core/JobSystem.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <stdexcept>
+
+namespace midnight {
+namespace {
+
+constexpr std::size_t kParallelSpatialGridItemThreshold = 16384;
+
+float squared_distance(
+    const SpatialGrid::Item& item,
+    const float x,
+    const float y
+) noexcept
+{
+    const float delta_x = item.x - x;
+    const float delta_y = item.y - y;
+
+    return delta_x * delta_x + delta_y * delta_y;
+}
+
+}
+
+SpatialGrid::SpatialGrid(
+    const std::uint32_t columns,
+    const std::uint32_t rows,
+    const std::uint32_t bucket_size,
+    JobSystem* jobs
+)
+    : columns_(columns),
+      rows_(rows),
+      bucket_size_(bucket_size),
+      jobs_(jobs)
+{
+    if (columns_ == 0 || rows_ == 0) {
+        throw std::runtime_error("Cannot create an empty spatial grid");
+    }
+
+    if (bucket_size_ == 0) {
+        throw std::runtime_error("Spatial grid bucket size must be positive");
+    }
+
+    bucket_columns_ = (columns_ + bucket_size_ - 1) / bucket_size_;
+    bucket_rows_ = (rows_ + bucket_size_ - 1) / bucket_size_;
+    bucket_starts_.assign(
+        static_cast<std::size_t>(bucket_columns_) * bucket_rows_ + 1,
+        0
+    );
+}
+
+void SpatialGrid::rebuild(const std::span<const Item> items)
+{
+    const std::size_t item_count = items.size();
+    const std::size_t bucket_count = bucket_starts_.size() - 1;
+    const std::size_t partition_count =
+        item_count < kParallelSpatialGridItemThreshold || jobs_ == nullptr
+            ? 1
+            : jobs_->concurrency();
+
+    item_buckets_.resize(item_count);
+    sorted_items_.resize(item_count);
+    worker_bucket_offsets_.assign(partition_count * bucket_count, 0);
+
+    const auto run_workers = [this, partition_count](const auto& work) {
+        if (partition_count == 1) {
+            work(0);
+            return;
+        }
+
+        jobs_->parallel_for(
+            partition_count,
+            1,
+            [&work](const std::size_t first, const std::size_t end) {
+                for (std::size_t worker = first; worker < end; ++worker) {
+                    work(worker);
+                }
+            }
+        );
+    };
+
+    run_workers([&](const std::size_t worker) {
+        const std::size_t first = item_count * worker / partition_count;
+        const std::size_t end = item_count * (worker + 1) / partition_count;
+        std::uint32_t* bucket_counts =
+            worker_bucket_offsets_.data() + worker * bucket_count;
+
+        for (std::size_t item = first; item < end; ++item) {
+            const auto bucket = static_cast<std::uint32_t>(
+                bucket_index(items[item].x, items[item].y)
+            );
+
+            item_buckets_[item] = bucket;
+            ++bucket_counts[bucket];
+        }
+    });
+
+    std::uint32_t running_offset = 0;
+
+    for (std::size_t bucket = 0; bucket < bucket_count; ++bucket) {
+        bucket_starts_[bucket] = running_offset;
+
+        for (std::size_t worker = 0; worker < partition_count; ++worker) {
+            std::uint32_t& offset =
+                worker_bucket_offsets_[worker * bucket_count + bucket];
+            const std::uint32_t bucket_item_count = offset;
+
+            offset = running_offset;
+            running_offset += bucket_item_count;
+        }
+    }
+
+    bucket_starts_[bucket_count] = running_offset;
+
+    run_workers([&](const std::size_t worker) {
+        const std::size_t first = item_count * worker / partition_count;
+        const std::size_t end = item_count * (worker + 1) / partition_count;
+        std::uint32_t* bucket_offsets =
+            worker_bucket_offsets_.data() + worker * bucket_count;
+
+        for (std::size_t item = first; item < end; ++item) {
+            sorted_items_[bucket_offsets[item_buckets_[item]]++] = items[item];
+        }
+    });
+}
+
+std::size_t SpatialGrid::size() const noexcept
+{
+    return sorted_items_.size();
+}
+
+std::uint32_t SpatialGrid::bucket_size() const noexcept
+{
+    return bucket_size_;
+}
+
+void SpatialGrid::query_cell(
+    const std::uint32_t column,
+    const std::uint32_t row,
+    std::vector<Item>& items
+) const
+{
+    query_range(
+        static_cast<float>(column),
+        static_cast<float>(row),
+        std::nextafter(static_cast<float>(column + 1), 0.0f),
+        std::nextafter(static_cast<float>(row + 1), 0.0f),
+        items
+    );
+}
+
+void SpatialGrid::query_range(
+    const float left,
+    const float top,
+    const float right,
+    const float bottom,
+    std::vector<Item>& items
+) const
+{
+    items.clear();
+
+    if (right < left || bottom < top) {
+        return;
+    }
+
+    const std::size_t first_bucket = bucket_index(left, top);
+    const std::size_t last_bucket = bucket_index(right, bottom);
+    const std::size_t first_column = first_bucket % bucket_columns_;
+    const std::size_t first_row = first_bucket / bucket_columns_;
+    const std::size_t last_column = last_bucket % bucket_columns_;
+    const std::size_t last_row = last_bucket / bucket_columns_;
+
+    for (std::size_t row = first_row; row <= last_row; ++row) {
+        for (std::size_t column = first_column; column <= last_column; ++column) {
+            for (const Item& item : bucket_items(
+                     static_cast<std::uint32_t>(column),
+                     static_cast<std::uint32_t>(row)
+                 )) {
+                if (item.x >= left &&
+                    item.x <= right &&
+                    item.y >= top &&
+                    item.y <= bottom) {
+                    items.push_back(item);
+                }
+            }
+        }
+    }
+}
+
+void SpatialGrid::query_radius(
+    const float x,
+    const float y,
+    const float radius,
+    std::vector<Item>& items
+) const
+{
+    query_range(x - radius, y - radius, x + radius, y + radius, items);
+
+    const float squared_radius = radius * radius;
+
+    std::erase_if(items, [&](const Item& item) {
+        return squared_distance(item, x, y) > squared_radius;
+    });
+}
+
+void SpatialGrid::query_nearest(
+    const float x,
+    const float y,
+    const std::size_t count,
+    std::vector<Item>& items
+) const
+{
+    items.clear();
+
+    if (count == 0 || sorted_items_.empty()) {
+        return;
+    }
+
+    struct Candidate final {
+        float squared_distance = 0.0f;
+        Item item{};
+
+        bool operator<(const Candidate& other) const noexcept
+        {
+            return squared_distance < other.squared_distance;
+        }
+    };
+
+    std::priority_queue<Candidate> nearest;
+    const std::size_t center_bucket = bucket_index(x, y);
+    const auto center_column =
+        static_cast<std::int64_t>(center_bucket % bucket_columns_);
+    const auto center_row =
+        static_cast<std::int64_t>(center_bucket / bucket_columns_);
+    const std::int64_t max_ring =
+        std::max(bucket_columns_, bucket_rows_);
+
+    const auto visit_bucket = [&](
+        const std::int64_t column,
+        const std::int64_t row
+    ) {
+        if (column < 0 ||
+            row < 0 ||
+            column >= static_cast<std::int64_t>(bucket_columns_) ||
+            row >= static_cast<std::int64_t>(bucket_rows_)) {
+            return;
+        }
+
+        for (const Item& item : bucket_items(
+                 static_cast<std::uint32_t>(column),
+                 static_cast<std::uint32_t>(row)
+             )) {
+            const float distance = squared_distance(item, x, y);
+
+            if (nearest.size() < count) {
+                nearest.push(Candidate{.squared_distance = distance, .item = item});
+            } else if (distance < nearest.top().squared_distance) {
+                nearest.pop();
+                nearest.push(Candidate{.squared_distance = distance, .item = item});
+            }
+        }
+    };
+
+    for (std::int64_t ring = 0; ring <= max_ring; ++ring) {
+        if (nearest.size() == count) {
+            const float ring_distance =
+                static_cast<float>((ring - 1) * bucket_size_);
+
+            if (ring > 0 &&
+                nearest.top().squared_distance <= ring_distance * ring_distance) {
+                break;
+            }
+        }
+
+        for (std::int64_t column = center_column - ring;
+             column <= center_column + ring;
+             ++column) {
+            visit_bucket(column, center_row - ring);
+
+            if (ring > 0) {
+                visit_bucket(column, center_row + ring);
+            }
+        }
+
+        for (std::int64_t row = center_row - ring + 1;
+             row <= center_row + ring - 1;
+             ++row) {
+            visit_bucket(center_column - ring, row);
+            visit_bucket(center_column + ring, row);
+        }
+    }
+
+    items.resize(nearest.size());
+
+    for (std::size_t index = items.size(); index > 0; --index) {
+        items[index - 1] = nearest.top().item;
+        nearest.pop();
+    }
+}
+
+void SpatialGrid::query_overlapping_pairs(
+    const float max_distance,
+    std::vector<std::pair<Entity, Entity>>& pairs
+) const
+{
+    pairs.clear();
+
+    const float squared_max_distance = max_distance * max_distance;
+    const auto reach = std::max<std::int64_t>(
+        1,
+        static_cast<std::int64_t>(
+            std::ceil(max_distance / static_cast<float>(bucket_size_))
+        )
+    );
+
+    const auto append_pair = [&](const Item& first, const Item& second) {
+        if (squared_distance(first, second.x, second.y) <=
+            squared_max_distance) {
+            pairs.emplace_back(first.entity, second.entity);
+        }
+    };
+
+    for (std::int64_t row = 0; row < bucket_rows_; ++row) {
+        for (std::int64_t column = 0; column < bucket_columns_; ++column) {
+            const std::span<const Item> bucket = bucket_items(
+                static_cast<std::uint32_t>(column),
+                static_cast<std::uint32_t>(row)
+            );
+
+            for (std::size_t first = 0; first < bucket.size(); ++first) {
+                for (std::size_t second = first + 1;
+                     second < bucket.size();
+                     ++second) {
+                    append_pair(bucket[first], bucket[second]);
+                }
+            }
+
+            for (std::int64_t neighbor_row = row;
+                 neighbor_row <= std::min<std::int64_t>(row + reach, bucket_rows_ - 1);
+                 ++neighbor_row) {
+                for (std::int64_t neighbor_column = std::max<std::int64_t>(column - reach, 0);
+                     neighbor_column <= std::min<std::int64_t>(column + reach, bucket_columns_ - 1);
+                     ++neighbor_column) {
+                    if (neighbor_row == row && neighbor_column <= column) {
+                        continue;
+                    }
+
+                    for (const Item& neighbor : bucket_items(
+                             static_cast<std::uint32_t>(neighbor_column),
+                             static_cast<std::uint32_t>(neighbor_row)
+                         )) {
+                        for (const Item& item : bucket) {
+                            append_pair(item, neighbor);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+std::size_t SpatialGrid::bucket_index(
+    const float x,
+    const float y
+) const noexcept
+{
+    const auto column = std::clamp<std::int64_t>(
+        static_cast<std::int64_t>(std::floor(x)),
+        0,
+        static_cast<std::int64_t>(columns_) - 1
+    );
+    const auto row = std::clamp<std::int64_t>(
+        static_cast<std::int64_t>(std::floor(y)),
+        0,
+        static_cast<std::int64_t>(rows_) - 1
+    );
+
+    return static_cast<std::size_t>(row / bucket_size_) * bucket_columns_ +
+        static_cast<std::size_t>(column / bucket_size_);
+}
+
+std::span<const SpatialGrid::Item> SpatialGrid::bucket_items(
+    const std::uint32_t bucket_column,
+    const std::uint32_t bucket_row
+) const noexcept
+{
+    const std::size_t bucket =
+        static_cast<std::size_t>(bucket_row) * bucket_columns_ + bucket_column;
+
+    return std::span<const Item>(
+        sorted_items_.data() + bucket_starts_[bucket],
+        bucket_starts_[bucket + 1] - bucket_starts_[bucket]
+    );
+}
+
+}
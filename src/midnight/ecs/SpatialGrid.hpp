@@ -0,0 +1,89 @@
+#pragma once
+
+#include "midnight/ecs/Entity.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace midnight {
+
+class JobSystem;
+
+class SpatialGrid final {
+public:
+    struct Item final {
+        Entity entity{};
+        float x = 0.0f;
+        float y = 0.0f;
+    };
+
+    SpatialGrid(
+        std::uint32_t columns,
+        std::uint32_t rows,
+        std::uint32_t bucket_size,
+        JobSystem* jobs
+    );
+
+    SpatialGrid(const SpatialGrid&) = delete;
+    SpatialGrid& operator=(const SpatialGrid&) = delete;
+
+    SpatialGrid(SpatialGrid&&) = delete;
+    SpatialGrid& operator=(SpatialGrid&&) = delete;
+
+    void rebuild(std::span<const Item> items);
+
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] std::uint32_t bucket_size() const noexcept;
+
+    void query_cell(
+        std::uint32_t column,
+        std::uint32_t row,
+        std::vector<Item>& items
+    ) const;
+    void query_range(
+        float left,
+        float top,
+        float right,
+        float bottom,
+        std::vector<Item>& items
+    ) const;
+    void query_radius(
+        float x,
+        float y,
+        float radius,
+        std::vector<Item>& items
+    ) const;
+    void query_nearest(
+        float x,
+        float y,
+        std::size_t count,
+        std::vector<Item>& items
+    ) const;
+    void query_overlapping_pairs(
+        float max_distance,
+        std::vector<std::pair<Entity, Entity>>& pairs
+    ) const;
+
+private:
+    [[nodiscard]] std::size_t bucket_index(float x, float y) const noexcept;
+    [[nodiscard]] std::span<const Item> bucket_items(
+        std::uint32_t bucket_column,
+        std::uint32_t bucket_row
+    ) const noexcept;
+
+    std::uint32_t columns_ = 0;
+    std::uint32_t rows_ = 0;
+    std::uint32_t bucket_size_ = 0;
+    std::uint32_t bucket_columns_ = 0;
+    std::uint32_t bucket_rows_ = 0;
+    JobSystem* jobs_ = nullptr;
+    std::vector<std::uint32_t> bucket_starts_;
+    std::vector<std::uint32_t> item_buckets_;
+    std::vector<std::uint32_t> worker_bucket_offsets_;
+    std::vector<Item> sorted_items_;
+};
+
+}
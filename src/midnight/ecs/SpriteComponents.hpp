@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+namespace midnight {
+
+struct Position2D final {
+    float x = 0.0f;
+    float y = 0.0f;
+};
+
+struct PreviousPosition2D final {
+    float x = 0.0f;
+    float y = 0.0f;
+};
+
+struct Velocity2D final {
+    float x = 0.0f;
+    float y = 0.0f;
+};
+
+struct Sprite final {
+    std::uint32_t tileset_column = 0;
+    std::uint32_t tileset_row = 0;
+};
+
+}
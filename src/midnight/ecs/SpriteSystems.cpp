@@ -0,0 +1,253 @@
+#include "midnight/ecs/SpriteSystems.hpp"
+
+#include "midnight/core/JobSystem.hpp"
+#include "midnight/ecs/SpriteComponents.hpp"
+#include "midnight/ecs/World.hpp"
+
+#include <algorithm>
+
+namespace midnight {
+namespace {
+
+constexpr std::size_t kSpriteMotionGrainSize = 8192;
+
+void write_sprite_quads(
+    const SpriteRenderLayout& layout,
+    const float alpha,
+    const std::size_t count,
+    const Position2D* positions,
+    const PreviousPosition2D* previous_positions,
+    const Sprite* sprites,
+    Vertex2D* quad
+) noexcept
+{
+    const float texture_width = 1.0f / static_cast<float>(layout.atlas_columns);
+    const float texture_height = 1.0f / static_cast<float>(layout.atlas_rows);
+
+    for (std::size_t row = 0; row < count; ++row) {
+        const float x =
+            previous_positions[row].x +
+            (positions[row].x - previous_positions[row].x) * alpha;
+        const float y =
+            previous_positions[row].y +
+            (positions[row].y - previous_positions[row].y) * alpha;
+        const float left = layout.left + x * layout.cell_width;
+        const float top = layout.top + y * layout.cell_height;
+        const float right = left + layout.cell_width;
+        const float bottom = top + layout.cell_height;
+        const float texture_left =
+            static_cast<float>(sprites[row].tileset_column) *
+            texture_width;
+        const float texture_top =
+            static_cast<float>(sprites[row].tileset_row) *
+            texture_height;
+        const float texture_right = texture_left + texture_width;
+        const float texture_bottom = texture_top + texture_height;
+
+        quad[0] = Vertex2D{
+            left, top,
+            1.0f, 1.0f, 1.0f,
+            texture_left,
+            texture_top
+        };
+        quad[1] = Vertex2D{
+            right, top,
+            1.0f, 1.0f, 1.0f,
+            texture_right,
+            texture_top
+        };
+        quad[2] = Vertex2D{
+            right, bottom,
+            1.0f, 1.0f, 1.0f,
+            texture_right,
+            texture_bottom
+        };
+        quad[3] = Vertex2D{
+            left, bottom,
+            1.0f, 1.0f, 1.0f,
+            texture_left,
+            texture_bottom
+        };
+        quad += 4;
+    }
+}
+
+}
+
+void update_sprite_motion(
+    World& world,
+    const SimulationStep& step,
+    const SpriteMotionBounds& bounds,
+    JobSystem* jobs
+)
+{
+    const auto seconds = static_cast<float>(step.seconds);
+    const float max_x = std::max(bounds.width - 1.0f, 0.0f);
+    const float max_y = std::max(bounds.height - 1.0f, 0.0f);
+
+    world.each_chunk<Position2D, PreviousPosition2D, Velocity2D>(
+        [&](
+            const std::size_t count,
+            Position2D* positions,
+            PreviousPosition2D* previous_positions,
+            Velocity2D* velocities
+        ) {
+            const auto move_range = [&](
+                const std::size_t first,
+                const std::size_t end
+            ) {
+                for (std::size_t row = first; row < end; ++row) {
+                    Position2D& position = positions[row];
+                    Velocity2D& velocity = velocities[row];
+
+                    previous_positions[row] = PreviousPosition2D{
+                        .x = position.x,
+                        .y = position.y
+                    };
+                    position.x += velocity.x * seconds;
+                    position.y += velocity.y * seconds;
+
+                    if (position.x < 0.0f || position.x > max_x) {
+                        position.x = std::clamp(position.x, 0.0f, max_x);
+                        velocity.x = -velocity.x;
+                    }
+
+                    if (position.y < 0.0f || position.y > max_y) {
+                        position.y = std::clamp(position.y, 0.0f, max_y);
+                        velocity.y = -velocity.y;
+                    }
+                }
+            };
+
+            if (jobs != nullptr) {
+                jobs->parallel_for(count, kSpriteMotionGrainSize, move_range);
+            } else {
+                move_range(0, count);
+            }
+        }
+    );
+}
+
+void rebuild_sprite_spatial_grid(
+    World& world,
+    SpatialGrid& grid,
+    std::vector<SpatialGrid::Item>& items
+)
+{
+    items.clear();
+
+    world.each_entity_chunk<Position2D, Sprite>(
+        [&items](
+            const std::span<const Entity> entities,
+            const Position2D* positions,
+            const Sprite*
+        ) {
+            for (std::size_t row = 0; row < entities.size(); ++row) {
+                items.push_back(SpatialGrid::Item{
+                    .entity = entities[row],
+                    .x = positions[row].x + 0.5f,
+                    .y = positions[row].y + 0.5f
+                });
+            }
+        }
+    );
+
+    grid.rebuild(items);
+}
+
+std::size_t build_sprite_vertices(
+    World& world,
+    const SpriteRenderLayout& layout,
+    const double interpolation_alpha,
+    const std::span<Vertex2D> vertices
+)
+{
+    const auto alpha = static_cast<float>(interpolation_alpha);
+    const std::size_t quad_capacity = vertices.size() / 4;
+    std::size_t quad_count = 0;
+
+    world.each_chunk<Position2D, PreviousPosition2D, Sprite>(
+        [&](
+            const std::size_t count,
+            const Position2D* positions,
+            const PreviousPosition2D* previous_positions,
+            const Sprite* sprites
+        ) {
+            const std::size_t chunk_quad_count =
+                std::min(count, quad_capacity - quad_count);
+
+            write_sprite_quads(
+                layout,
+                alpha,
+                chunk_quad_count,
+                positions,
+                previous_positions,
+                sprites,
+                vertices.data() + quad_count * 4
+            );
+            quad_count += chunk_quad_count;
+        }
+    );
+
+    return quad_count;
+}
+
+void capture_sprite_render_snapshot(
+    World& world,
+    SpriteRenderSnapshot& snapshot
+)
+{
+    snapshot.positions.clear();
+    snapshot.previous_positions.clear();
+    snapshot.sprites.clear();
+
+    world.each_chunk<Position2D, PreviousPosition2D, Sprite>(
+        [&snapshot](
+            const std::size_t count,
+            const Position2D* positions,
+            const PreviousPosition2D* previous_positions,
+            const Sprite* sprites
+        ) {
+            snapshot.positions.insert(
+                snapshot.positions.end(),
+                positions,
+                positions + count
+            );
+            snapshot.previous_positions.insert(
+                snapshot.previous_positions.end(),
+                previous_positions,
+                previous_positions + count
+            );
+            snapshot.sprites.insert(
+                snapshot.sprites.end(),
+                sprites,
+                sprites + count
+            );
+        }
+    );
+}
+
+std::size_t build_sprite_vertices(
+    const SpriteRenderSnapshot& snapshot,
+    const SpriteRenderLayout& layout,
+    const double interpolation_alpha,
+    const std::span<Vertex2D> vertices
+)
+{
+    const std::size_t quad_count =
+        std::min(snapshot.sprites.size(), vertices.size() / 4);
+
+    write_sprite_quads(
+        layout,
+        static_cast<float>(interpolation_alpha),
+        quad_count,
+        snapshot.positions.data(),
+        snapshot.previous_positions.data(),
+        snapshot.sprites.data(),
+        vertices.data()
+    );
+
+    return quad_count;
+}
+
+}
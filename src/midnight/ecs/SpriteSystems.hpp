@@ -0,0 +1,72 @@
+#pragma once
+
+#include "midnight/core/Simulation.hpp"
+#include "midnight/ecs/SpatialGrid.hpp"
+#include "midnight/ecs/SpriteComponents.hpp"
+#include "midnight/renderer/Vertex2D.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace midnight {
+
+class JobSystem;
+class World;
+
+struct SpriteMotionBounds final {
+    float width = 0.0f;
+    float height = 0.0f;
+};
+
+// The components build_sprite_vertices() reads, copied out of a world so
+// rendering can go on while the world steps on another thread.
+struct SpriteRenderSnapshot final {
+    std::vector<Position2D> positions;
+    std::vector<PreviousPosition2D> previous_positions;
+    std::vector<Sprite> sprites;
+};
+
+struct SpriteRenderLayout final {
+    float left = 0.0f;
+    float top = 0.0f;
+    float cell_width = 0.0f;
+    float cell_height = 0.0f;
+    std::uint32_t atlas_columns = 1;
+    std::uint32_t atlas_rows = 1;
+};
+
+void update_sprite_motion(
+    World& world,
+    const SimulationStep& step,
+    const SpriteMotionBounds& bounds,
+    JobSystem* jobs = nullptr
+);
+
+void rebuild_sprite_spatial_grid(
+    World& world,
+    SpatialGrid& grid,
+    std::vector<SpatialGrid::Item>& items
+);
+
+[[nodiscard]] std::size_t build_sprite_vertices(
+    World& world,
+    const SpriteRenderLayout& layout,
+    double interpolation_alpha,
+    std::span<Vertex2D> vertices
+);
+
+void capture_sprite_render_snapshot(
+    World& world,
+    SpriteRenderSnapshot& snapshot
+);
+
+[[nodiscard]] std::size_t build_sprite_vertices(
+    const SpriteRenderSnapshot& snapshot,
+    const SpriteRenderLayout& layout,
+    double interpolation_alpha,
+    std::span<Vertex2D> vertices
+);
+
+}
@@ -0,0 +1,126 @@
+#include "midnight/ecs/World.hpp"
+
+#include <limits>
+#include <stdexcept>
+
+namespace midnight {
+
+void World::destroy_entity(const Entity entity)
+{
+    if (!alive(entity)) {
+        return;
+    }
+
+    EntityRecord& record = records_[entity.index];
+    Entity moved_entity{};
+
+    if (archetypes_[record.archetype]->swap_remove(record.row, moved_entity)) {
+        records_[moved_entity.index].row = record.row;
+    }
+
+    record.alive = false;
+    ++record.generation;
+    free_indices_.push_back(entity.index);
+    --entity_count_;
+}
+
+void World::destroy_entities(const std::span<const Entity> entities)
+{
+    for (const Entity entity : entities) {
+        destroy_entity(entity);
+    }
+}
+
+void World::clear() noexcept
+{
+    for (std::size_t index = 0; index < records_.size(); ++index) {
+        EntityRecord& record = records_[index];
+
+        if (record.alive) {
+            record.alive = false;
+            ++record.generation;
+            free_indices_.push_back(static_cast<std::uint32_t>(index));
+        }
+    }
+
+    for (const std::unique_ptr<Archetype>& archetype : archetypes_) {
+        archetype->clear();
+    }
+
+    entity_count_ = 0;
+}
+
+bool World::alive(const Entity entity) const noexcept
+{
+    return entity.index < records_.size() &&
+        records_[entity.index].alive &&
+        records_[entity.index].generation == entity.generation;
+}
+
+std::size_t World::entity_count() const noexcept
+{
+    return entity_count_;
+}
+
+Archetype& World::archetype_for(const ComponentMask mask)
+{
+    const auto existing = archetype_indices_.find(mask);
+
+    if (existing != archetype_indices_.end()) {
+        return *archetypes_[existing->second];
+    }
+
+    archetypes_.push_back(std::make_unique<Archetype>(mask));
+    archetype_indices_.emplace(
+        mask,
+        static_cast<std::uint32_t>(archetypes_.size() - 1)
+    );
+
+    return *archetypes_.back();
+}
+
+void World::allocate_entities(
+    const std::span<Entity> entities,
+    Archetype& archetype
+)
+{
+    if (records_.size() - free_indices_.size() + entities.size() >
+        std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error("Too many ECS entities");
+    }
+
+    const auto archetype_index = static_cast<std::uint32_t>(
+        archetype_indices_.at(archetype.mask())
+    );
+    const std::size_t first_row = archetype.size();
+    const std::size_t reused_count =
+        std::min(entities.size(), free_indices_.size());
+
+    records_.reserve(records_.size() + entities.size() - reused_count);
+
+    for (std::size_t offset = 0; offset < entities.size(); ++offset) {
+        std::uint32_t index = 0;
+
+        if (offset < reused_count) {
+            index = free_indices_.back();
+            free_indices_.pop_back();
+        } else {
+            index = static_cast<std::uint32_t>(records_.size());
+            records_.emplace_back();
+        }
+
+        EntityRecord& record = records_[index];
+        record.archetype = archetype_index;
+        record.row = static_cast<std::uint32_t>(first_row + offset);
+        record.alive = true;
+        entities[offset] = Entity{
+            .index = index,
+            .generation = record.generation
+        };
+    }
+
+    archetype.append(entities);
+    entity_count_ += entities.size();
+}
+
+}
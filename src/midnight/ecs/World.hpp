@@ -0,0 +1,144 @@
+#pragma once
+
+#include "midnight/ecs/Archetype.hpp"
+#include "midnight/ecs/ComponentType.hpp"
+#include "midnight/ecs/Entity.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace midnight {
+
+class World final {
+public:
+    World() = default;
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    World(World&&) = delete;
+    World& operator=(World&&) = delete;
+
+    template <typename... Components>
+    Entity create_entity(const Components&... components)
+    {
+        Entity entity{};
+        create_entities(std::span<Entity>(&entity, 1), components...);
+        return entity;
+    }
+
+    template <typename... Components>
+    void create_entities(
+        const std::span<Entity> entities,
+        const Components&... components
+    )
+    {
+        Archetype& archetype = archetype_for(component_mask<Components...>());
+        const std::size_t first_row = archetype.size();
+
+        allocate_entities(entities, archetype);
+        (
+            std::fill_n(
+                archetype.components<Components>() + first_row,
+                entities.size(),
+                components
+            ),
+            ...
+        );
+    }
+
+    void destroy_entity(Entity entity);
+    void destroy_entities(std::span<const Entity> entities);
+    void clear() noexcept;
+
+    [[nodiscard]] bool alive(Entity entity) const noexcept;
+    [[nodiscard]] std::size_t entity_count() const noexcept;
+
+    template <typename Component>
+    [[nodiscard]] Component* try_get(const Entity entity) noexcept
+    {
+        if (!alive(entity)) {
+            return nullptr;
+        }
+
+        const EntityRecord& record = records_[entity.index];
+        Archetype& archetype = *archetypes_[record.archetype];
+
+        if ((archetype.mask() &
+             (ComponentMask{1} << component_type_id<Component>())) == 0) {
+            return nullptr;
+        }
+
+        return archetype.components<Component>() + record.row;
+    }
+
+    template <typename... Components, typename Function>
+    void each_chunk(Function&& function)
+    {
+        const ComponentMask mask = component_mask<Components...>();
+
+        for (const std::unique_ptr<Archetype>& archetype : archetypes_) {
+            if ((archetype->mask() & mask) != mask || archetype->size() == 0) {
+                continue;
+            }
+
+            function(
+                archetype->size(),
+                archetype->components<Components>()...
+            );
+        }
+    }
+
+    template <typename... Components, typename Function>
+    void each_entity_chunk(Function&& function)
+    {
+        const ComponentMask mask = component_mask<Components...>();
+
+        for (const std::unique_ptr<Archetype>& archetype : archetypes_) {
+            if ((archetype->mask() & mask) != mask || archetype->size() == 0) {
+                continue;
+            }
+
+            function(
+                archetype->entities(),
+                archetype->components<Components>()...
+            );
+        }
+    }
+
+    template <typename... Components, typename Function>
+    void each(Function&& function)
+    {
+        each_chunk<Components...>(
+            [&function](const std::size_t count, Components*... columns) {
+                for (std::size_t row = 0; row < count; ++row) {
+                    function(columns[row]...);
+                }
+            }
+        );
+    }
+
+private:
+    struct EntityRecord final {
+        std::uint32_t generation = 1;
+        std::uint32_t archetype = 0;
+        std::uint32_t row = 0;
+        bool alive = false;
+    };
+
+    [[nodiscard]] Archetype& archetype_for(ComponentMask mask);
+    void allocate_entities(std::span<Entity> entities, Archetype& archetype);
+
+    std::vector<std::unique_ptr<Archetype>> archetypes_;
+    std::unordered_map<ComponentMask, std::uint32_t> archetype_indices_;
+    std::vector<EntityRecord> records_;
+    std::vector<std::uint32_t> free_indices_;
+    std::size_t entity_count_ = 0;
+};
+
+}
@@ -0,0 +1,452 @@
+#include "midnight/map/MapAutoTiler.hpp"
+
+#include "midnight/core/JobSystem.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace midnight {
+namespace {
+
+constexpr std::uint8_t kNeighbourNorth = 1u << 0;
+constexpr std::uint8_t kNeighbourNorthEast = 1u << 1;
+constexpr std::uint8_t kNeighbourEast = 1u << 2;
+constexpr std::uint8_t kNeighbourSouthEast = 1u << 3;
+constexpr std::uint8_t kNeighbourSouth = 1u << 4;
+constexpr std::uint8_t kNeighbourSouthWest = 1u << 5;
+constexpr std::uint8_t kNeighbourWest = 1u << 6;
+constexpr std::uint8_t kNeighbourNorthWest = 1u << 7;
+
+constexpr std::size_t kEdgeTileCount = 16;
+constexpr std::size_t kBlobTileCount = 47;
+
+// Areas below this many cells resolve on the calling thread; the chunks
+// are the units handed to the job system above it.
+constexpr std::size_t kParallelResolveCellCount = 64 * 64;
+constexpr std::uint32_t kResolveChunkSize = 64;
+
+struct NeighbourOffset final {
+    int column = 0;
+    int row = 0;
+    std::uint8_t bit = 0;
+};
+
+constexpr NeighbourOffset kNeighbourOffsets[] = {
+    {0, -1, kNeighbourNorth},
+    {1, -1, kNeighbourNorthEast},
+    {1, 0, kNeighbourEast},
+    {1, 1, kNeighbourSouthEast},
+    {0, 1, kNeighbourSouth},
+    {-1, 1, kNeighbourSouthWest},
+    {-1, 0, kNeighbourWest},
+    {-1, -1, kNeighbourNorthWest}
+};
+
+[[nodiscard]] constexpr std::uint8_t edge_tile_index(
+    const std::uint8_t mask
+) noexcept
+{
+    return static_cast<std::uint8_t>(
+        ((mask & kNeighbourNorth) != 0 ? 1 : 0) |
+        ((mask & kNeighbourEast) != 0 ? 2 : 0) |
+        ((mask & kNeighbourSouth) != 0 ? 4 : 0) |
+        ((mask & kNeighbourWest) != 0 ? 8 : 0)
+    );
+}
+
+[[nodiscard]] constexpr std::uint8_t reduce_blob_mask(
+    const std::uint8_t mask
+) noexcept
+{
+    const auto has = [mask](const std::uint8_t bit) {
+        return (mask & bit) != 0;
+    };
+
+    std::uint8_t reduced = mask & static_cast<std::uint8_t>(
+        kNeighbourNorth | kNeighbourEast | kNeighbourSouth | kNeighbourWest
+    );
+
+    if (has(kNeighbourNorthEast) && has(kNeighbourNorth) && has(kNeighbourEast)) {
+        reduced |= kNeighbourNorthEast;
+    }
+
+    if (has(kNeighbourSouthEast) && has(kNeighbourSouth) && has(kNeighbourEast)) {
+        reduced |= kNeighbourSouthEast;
+    }
+
+    if (has(kNeighbourSouthWest) && has(kNeighbourSouth) && has(kNeighbourWest)) {
+        reduced |= kNeighbourSouthWest;
+    }
+
+    if (has(kNeighbourNorthWest) && has(kNeighbourNorth) && has(kNeighbourWest)) {
+        reduced |= kNeighbourNorthWest;
+    }
+
+    return reduced;
+}
+
+// Raw 8-neighbour mask to blob tile index: the rank of its reduced mask
+// among the 47 distinct reduced masks.
+constexpr std::array<std::uint8_t, 256> kBlobTileIndices = [] {
+    std::array<bool, 256> reachable{};
+
+    for (std::size_t mask = 0; mask < reachable.size(); ++mask) {
+        reachable[reduce_blob_mask(static_cast<std::uint8_t>(mask))] = true;
+    }
+
+    std::array<std::uint8_t, 256> rank{};
+    std::uint8_t next_rank = 0;
+
+    for (std::size_t mask = 0; mask < rank.size(); ++mask) {
+        if (reachable[mask]) {
+            rank[mask] = next_rank++;
+        }
+    }
+
+    std::array<std::uint8_t, 256> indices{};
+
+    for (std::size_t mask = 0; mask < indices.size(); ++mask) {
+        indices[mask] = rank[reduce_blob_mask(static_cast<std::uint8_t>(mask))];
+    }
+
+    return indices;
+}();
+
+static_assert(kBlobTileIndices[0xff] == kBlobTileCount - 1);
+
+}
+
+MapTerrain make_map_terrain_from_block(
+    std::string name,
+    const std::uint32_t left,
+    const std::uint32_t top
+)
+{
+    MapTerrain terrain{
+        .name = std::move(name),
+        .connectivity = MapTerrainConnectivity::Edges,
+        .tiles = {}
+    };
+
+    terrain.tiles.reserve(kEdgeTileCount);
+
+    for (std::uint8_t index = 0; index < kEdgeTileCount; ++index) {
+        const bool north = (index & 1) != 0;
+        const bool east = (index & 2) != 0;
+        const bool south = (index & 4) != 0;
+        const bool west = (index & 8) != 0;
+
+        // A cell joined only to its east neighbour is the block's west edge,
+        // and so on; joined on both sides or neither, it takes the middle.
+        const std::uint32_t column = east == west ? 1 : (east ? 0 : 2);
+        const std::uint32_t row = north == south ? 1 : (south ? 0 : 2);
+
+        terrain.tiles.push_back(MapTile{
+            .tileset_column = left + column,
+            .tileset_row = top + row,
+            .occupied = true
+        });
+    }
+
+    return terrain;
+}
+
+MapAutoTiler::MapAutoTiler(std::vector<MapTerrain> terrains)
+    : terrains_(std::move(terrains))
+{
+    if (terrains_.size() > kMaxTerrainCount) {
+        throw std::runtime_error("Too many map terrains");
+    }
+
+    for (const MapTerrain& terrain : terrains_) {
+        const std::size_t expected_tile_count =
+            terrain.connectivity == MapTerrainConnectivity::Edges
+                ? kEdgeTileCount
+                : kBlobTileCount;
+
+        if (terrain.tiles.size() != expected_tile_count) {
+            throw std::runtime_error(
+                "Map terrain " + terrain.name + " needs " +
+                std::to_string(expected_tile_count) + " tiles"
+            );
+        }
+
+        for (const MapTile& tile : terrain.tiles) {
+            if (!tile.occupied) {
+                throw std::runtime_error(
+                    "Map terrain " + terrain.name + " has an empty tile"
+                );
+            }
+
+            lookup_columns_ = std::max(lookup_columns_, tile.tileset_column + 1);
+            lookup_rows_ = std::max(lookup_rows_, tile.tileset_row + 1);
+        }
+    }
+
+    terrain_lookup_.resize(
+        static_cast<std::size_t>(lookup_columns_) * lookup_rows_,
+        kNoTerrain
+    );
+    resolved_tiles_.resize(terrains_.size());
+
+    for (std::size_t index = 0; index < terrains_.size(); ++index) {
+        const MapTerrain& terrain = terrains_[index];
+        const std::uint8_t terrain_id = static_cast<std::uint8_t>(index + 1);
+
+        for (const MapTile& tile : terrain.tiles) {
+            std::uint8_t& owner = terrain_lookup_[
+                static_cast<std::size_t>(tile.tileset_row) * lookup_columns_ +
+                tile.tileset_column
+            ];
+
+            if (owner != kNoTerrain && owner != terrain_id) {
+                throw std::runtime_error(
+                    "Map terrains " + terrains_[owner - 1].name + " and " +
+                    terrain.name + " share a tile"
+                );
+            }
+
+            owner = terrain_id;
+        }
+
+        for (std::size_t mask = 0; mask < 256; ++mask) {
+            const std::size_t tile_index =
+                terrain.connectivity == MapTerrainConnectivity::Edges
+                    ? edge_tile_index(static_cast<std::uint8_t>(mask))
+                    : kBlobTileIndices[mask];
+
+            resolved_tiles_[index][mask] = pack_map_tile(terrain.tiles[tile_index]);
+        }
+    }
+}
+
+std::span<const MapTerrain> MapAutoTiler::terrains() const noexcept
+{
+    return terrains_;
+}
+
+std::uint8_t MapAutoTiler::terrain_of(const PackedMapTile tile) const noexcept
+{
+    if (!packed_map_tile_occupied(tile)) {
+        return kNoTerrain;
+    }
+
+    const std::uint32_t column = packed_map_tile_column(tile);
+    const std::uint32_t row = packed_map_tile_row(tile);
+
+    if (column >= lookup_columns_ || row >= lookup_rows_) {
+        return kNoTerrain;
+    }
+
+    return terrain_lookup_[static_cast<std::size_t>(row) * lookup_columns_ + column];
+}
+
+PackedMapTile MapAutoTiler::resolve(
+    const std::uint8_t terrain,
+    const std::uint8_t neighbour_mask
+) const noexcept
+{
+    return resolved_tiles_[terrain - 1][neighbour_mask];
+}
+
+std::size_t MapAutoTiler::paint(
+    TileMap& map,
+    const std::size_t layer,
+    const MapCellRect& area,
+    const std::uint8_t terrain,
+    std::vector<MapCellChange>& changes,
+    JobSystem* const jobs
+) const
+{
+    if (!map.contains(area)) {
+        throw std::runtime_error("Map terrain area is outside the map");
+    }
+
+    if (terrain > terrains_.size()) {
+        throw std::runtime_error("Unknown map terrain");
+    }
+
+    const auto grow = [&map](const MapCellRect& rect) {
+        return MapCellRect{
+            .left = rect.left > 0 ? rect.left - 1 : 0,
+            .top = rect.top > 0 ? rect.top - 1 : 0,
+            .right = std::min(rect.right + 1, map.columns() - 1),
+            .bottom = std::min(rect.bottom + 1, map.rows() - 1)
+        };
+    };
+
+    // Cells in `resolved` get new tiles; their neighbours' terrain comes
+    // from a snapshot of one more ring, taken first, so chunks can resolve
+    // concurrently without reading cells another chunk is writing.
+    const MapCellRect resolved = grow(area);
+    const MapCellRect sampled = grow(resolved);
+    const std::uint32_t sampled_columns = sampled.columns();
+    const std::span<PackedMapTile> tiles = map.layer(layer);
+    std::vector<std::uint8_t> terrain_ids(
+        static_cast<std::size_t>(sampled_columns) * sampled.rows()
+    );
+
+    const auto inside = [](
+        const MapCellRect& rect,
+        const std::uint32_t column,
+        const std::uint32_t row
+    ) {
+        return column >= rect.left &&
+            column <= rect.right &&
+            row >= rect.top &&
+            row <= rect.bottom;
+    };
+
+    const auto sample_rows = [&](const std::size_t first, const std::size_t end) {
+        for (std::size_t row = first; row < end; ++row) {
+            const std::uint32_t map_row = sampled.top + static_cast<std::uint32_t>(row);
+
+            for (std::uint32_t column = 0; column < sampled_columns; ++column) {
+                const std::uint32_t map_column = sampled.left + column;
+
+                terrain_ids[row * sampled_columns + column] =
+                    inside(area, map_column, map_row)
+                        ? terrain
+                        : terrain_of(tiles[map.cell_index(map_column, map_row)]);
+            }
+        }
+    };
+
+    const std::uint32_t chunk_columns =
+        (resolved.columns() + kResolveChunkSize - 1) / kResolveChunkSize;
+    const std::uint32_t chunk_rows =
+        (resolved.rows() + kResolveChunkSize - 1) / kResolveChunkSize;
+    std::vector<std::vector<MapCellChange>> chunk_changes(
+        static_cast<std::size_t>(chunk_columns) * chunk_rows
+    );
+
+    std::array<std::ptrdiff_t, 8> neighbour_strides{};
+
+    for (std::size_t neighbour = 0; neighbour < 8; ++neighbour) {
+        neighbour_strides[neighbour] =
+            static_cast<std::ptrdiff_t>(kNeighbourOffsets[neighbour].row) *
+                static_cast<std::ptrdiff_t>(sampled_columns) +
+            kNeighbourOffsets[neighbour].column;
+    }
+
+    const auto resolve_chunk = [&](const std::size_t chunk) {
+        const std::uint32_t first_column =
+            resolved.left +
+            static_cast<std::uint32_t>(chunk % chunk_columns) * kResolveChunkSize;
+        const std::uint32_t first_row =
+            resolved.top +
+            static_cast<std::uint32_t>(chunk / chunk_columns) * kResolveChunkSize;
+        const std::uint32_t last_column =
+            std::min(first_column + kResolveChunkSize - 1, resolved.right);
+        const std::uint32_t last_row =
+            std::min(first_row + kResolveChunkSize - 1, resolved.bottom);
+        std::vector<MapCellChange>& local_changes = chunk_changes[chunk];
+
+        for (std::uint32_t row = first_row; row <= last_row; ++row) {
+            for (std::uint32_t column = first_column; column <= last_column; ++column) {
+                const std::size_t sample =
+                    static_cast<std::size_t>(row - sampled.top) * sampled_columns +
+                    (column - sampled.left);
+                const std::uint8_t cell_terrain = terrain_ids[sample];
+                PackedMapTile tile = 0;
+
+                if (cell_terrain != kNoTerrain) {
+                    std::uint8_t mask = 0;
+
+                    if (column > 0 &&
+                        row > 0 &&
+                        column + 1 < map.columns() &&
+                        row + 1 < map.rows()) {
+                        // Away from the map edge every neighbour is in the
+                        // snapshot, so no bounds checks are needed.
+                        const std::uint8_t* const centre = &terrain_ids[sample];
+
+                        for (std::size_t neighbour = 0; neighbour < 8; ++neighbour) {
+                            if (centre[neighbour_strides[neighbour]] == cell_terrain) {
+                                mask |= kNeighbourOffsets[neighbour].bit;
+                            }
+                        }
+                    } else {
+                        for (const NeighbourOffset& offset : kNeighbourOffsets) {
+                            const std::int64_t neighbour_column =
+                                static_cast<std::int64_t>(column) + offset.column;
+                            const std::int64_t neighbour_row =
+                                static_cast<std::int64_t>(row) + offset.row;
+
+                            if (neighbour_column < 0 ||
+                                neighbour_row < 0 ||
+                                neighbour_column >= map.columns() ||
+                                neighbour_row >= map.rows() ||
+                                terrain_ids[
+                                    static_cast<std::size_t>(
+                                        neighbour_row - sampled.top
+                                    ) * sampled_columns +
+                                    static_cast<std::size_t>(
+                                        neighbour_column - sampled.left
+                                    )
+                                ] == cell_terrain) {
+                                mask |= offset.bit;
+                            }
+                        }
+                    }
+
+                    tile = resolve(cell_terrain, mask);
+                } else if (!inside(area, column, row)) {
+                    continue;
+                }
+
+                const std::size_t cell = map.cell_index(column, row);
+
+                if (tiles[cell] != tile) {
+                    local_changes.push_back(MapCellChange{
+                        .layer = static_cast<std::uint32_t>(layer),
+                        .cell = static_cast<std::uint32_t>(cell),
+                        .before = tiles[cell],
+                        .after = tile
+                    });
+                    tiles[cell] = tile;
+                }
+            }
+        }
+    };
+
+    const bool parallel =
+        jobs != nullptr &&
+        static_cast<std::size_t>(resolved.columns()) * resolved.rows() >=
+            kParallelResolveCellCount;
+
+    if (parallel) {
+        jobs->parallel_for(
+            sampled.rows(),
+            kResolveChunkSize,
+            sample_rows
+        );
+        jobs->parallel_for(
+            chunk_changes.size(),
+            1,
+            [&resolve_chunk](const std::size_t first, const std::size_t end) {
+                for (std::size_t chunk = first; chunk < end; ++chunk) {
+                    resolve_chunk(chunk);
+                }
+            }
+        );
+    } else {
+        sample_rows(0, sampled.rows());
+
+        for (std::size_t chunk = 0; chunk < chunk_changes.size(); ++chunk) {
+            resolve_chunk(chunk);
+        }
+    }
+
+    std::size_t changed_count = 0;
+
+    for (std::vector<MapCellChange>& chunk : chunk_changes) {
+        changes.insert(changes.end(), chunk.begin(), chunk.end());
+        changed_count += chunk.size();
+    }
+
+    return changed_count;
+}
+
+}
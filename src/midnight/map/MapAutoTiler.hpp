@@ -0,0 +1,90 @@
+#pragma once
+
+#include "midnight/map/MapEditing.hpp"
+#include "midnight/map/TileMap.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace midnight {
+
+class JobSystem;
+
+enum class MapTerrainConnectivity : std::uint8_t {
+    // 16 tiles indexed by the neighbour mask N = 1, E = 2, S = 4, W = 8.
+    Edges,
+    // The 47 blob tiles, in ascending order of their reduced neighbour
+    // mask N = 1, NE = 2, E = 4, SE = 8, S = 16, SW = 32, W = 64, NW = 128,
+    // where a corner only counts when both edges beside it do.
+    EdgesAndCorners
+};
+
+// A paintable terrain and the atlas tiles that draw it, in bitmask order.
+struct MapTerrain final {
+    std::string name;
+    MapTerrainConnectivity connectivity = MapTerrainConnectivity::Edges;
+    std::vector<MapTile> tiles;
+};
+
+// An Edges terrain drawn from a 3x3 atlas block: the centre tile, its four
+// edges and four outer corners. Strip ends and single cells have no tile of
+// their own and use the nearest of the nine.
+[[nodiscard]] MapTerrain make_map_terrain_from_block(
+    std::string name,
+    std::uint32_t left,
+    std::uint32_t top
+);
+
+// Resolves terrain cells to atlas tiles from their neighbours. A cell's
+// terrain is read back from its tile, so undo, loading and hand painting
+// need no extra state; tiles outside every terrain are left alone.
+// Neighbours past the map edge count as the same terrain.
+class MapAutoTiler final {
+public:
+    static constexpr std::uint8_t kNoTerrain = 0;
+    static constexpr std::size_t kMaxTerrainCount = 254;
+
+    explicit MapAutoTiler(std::vector<MapTerrain> terrains);
+
+    MapAutoTiler(const MapAutoTiler&) = delete;
+    MapAutoTiler& operator=(const MapAutoTiler&) = delete;
+
+    MapAutoTiler(MapAutoTiler&&) = delete;
+    MapAutoTiler& operator=(MapAutoTiler&&) = delete;
+
+    [[nodiscard]] std::span<const MapTerrain> terrains() const noexcept;
+
+    // A terrain id is the terrain's index + 1, or kNoTerrain.
+    [[nodiscard]] std::uint8_t terrain_of(PackedMapTile tile) const noexcept;
+    [[nodiscard]] PackedMapTile resolve(
+        std::uint8_t terrain,
+        std::uint8_t neighbour_mask
+    ) const noexcept;
+
+    // Sets every cell of `area` to `terrain`, or empties it for kNoTerrain,
+    // then re-resolves the area and the ring of cells around it, which
+    // covers the 3x3 neighbourhood of every changed cell. With `jobs`,
+    // large areas resolve in parallel by chunk. Returns the number of
+    // cells changed.
+    std::size_t paint(
+        TileMap& map,
+        std::size_t layer,
+        const MapCellRect& area,
+        std::uint8_t terrain,
+        std::vector<MapCellChange>& changes,
+        JobSystem* jobs = nullptr
+    ) const;
+
+private:
+    std::vector<MapTerrain> terrains_;
+    std::vector<std::array<PackedMapTile, 256>> resolved_tiles_;
+    std::vector<std::uint8_t> terrain_lookup_;
+    std::uint32_t lookup_columns_ = 0;
+    std::uint32_t lookup_rows_ = 0;
+};
+
+}
@@ -0,0 +1,434 @@
+#include "midnight/map/MapEditJournal.hpp"
+
+#include "midnight/core/BinaryStream.hpp"
+#include "midnight/core/File.hpp"
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+namespace midnight {
+namespace {
+
+// Journal: magic[8], u32 version, u32 reserved, then records of
+// u32 payload size, u32 checksum, u64 sequence, payload.
+// Snapshot: magic[8], u32 version, u32 checksum, u64 sequence,
+// u64 payload size, payload.
+constexpr std::array<char, 8> kJournalMagic{
+    'M', 'I', 'D', 'N', 'J', 'R', 'N', 'L'
+};
+constexpr std::array<char, 8> kSnapshotMagic{
+    'M', 'I', 'D', 'N', 'S', 'N', 'A', 'P'
+};
+constexpr std::uint32_t kJournalVersion = 1;
+constexpr std::size_t kJournalHeaderBytes = 16;
+constexpr std::size_t kRecordHeaderBytes = 16;
+constexpr std::size_t kSnapshotHeaderBytes = 32;
+
+std::uint32_t checksum(
+    const std::span<const std::byte> bytes,
+    std::uint32_t hash = 2'166'136'261u
+) noexcept
+{
+    for (const std::byte byte : bytes) {
+        hash ^= static_cast<std::uint32_t>(byte);
+        hash *= 16'777'619u;
+    }
+
+    return hash;
+}
+
+std::uint32_t record_checksum(
+    const std::uint64_t sequence,
+    const std::span<const std::byte> payload
+)
+{
+    ByteWriter sequence_bytes;
+    sequence_bytes.write_u64(sequence);
+
+    return checksum(payload, checksum(sequence_bytes.take()));
+}
+
+bool has_magic(
+    const std::span<const std::byte> bytes,
+    const std::array<char, 8>& magic
+) noexcept
+{
+    return bytes.size() >= magic.size() &&
+           std::memcmp(bytes.data(), magic.data(), magic.size()) == 0;
+}
+
+void write_all(
+    std::FILE* file,
+    const std::span<const std::byte> bytes,
+    const std::filesystem::path& path
+)
+{
+    if (!bytes.empty() &&
+        std::fwrite(bytes.data(), 1, bytes.size(), file) != bytes.size()) {
+        throw std::runtime_error("Failed to write map journal: " + path.string());
+    }
+}
+
+void sync_file(std::FILE* file, const std::filesystem::path& path)
+{
+    if (std::fflush(file) != 0) {
+        throw std::runtime_error("Failed to flush map journal: " + path.string());
+    }
+
+#if !defined(_WIN32)
+    if (::fsync(::fileno(file)) != 0) {
+        throw std::runtime_error("Failed to sync map journal: " + path.string());
+    }
+#endif
+}
+
+}
+
+MapEditJournal::Recovery MapEditJournal::recover(
+    const std::filesystem::path& journal_path,
+    const std::filesystem::path& snapshot_path
+)
+{
+    Recovery recovery{};
+    std::uint64_t snapshot_sequence = 0;
+
+    if (std::filesystem::exists(snapshot_path)) {
+        const std::vector<std::byte> bytes = read_binary_file(snapshot_path);
+        ByteReader reader(bytes);
+
+        if (!has_magic(bytes, kSnapshotMagic) ||
+            bytes.size() < kSnapshotHeaderBytes) {
+            throw std::runtime_error("Not a Midnight map snapshot: " + snapshot_path.string());
+        }
+
+        (void)reader.read_bytes(kSnapshotMagic.size());
+
+        const std::uint32_t version = reader.read_u32();
+        const std::uint32_t expected_checksum = reader.read_u32();
+
+        snapshot_sequence = reader.read_u64();
+
+        const std::uint64_t payload_size = reader.read_u64();
+
+        if (version != kJournalVersion ||
+            payload_size != reader.remaining()) {
+            throw std::runtime_error("Invalid map snapshot: " + snapshot_path.string());
+        }
+
+        const std::span<const std::byte> payload =
+            reader.read_bytes(static_cast<std::size_t>(payload_size));
+
+        if (checksum(payload) != expected_checksum) {
+            throw std::runtime_error("Corrupt map snapshot: " + snapshot_path.string());
+        }
+
+        recovery.snapshot.assign(payload.begin(), payload.end());
+    }
+
+    recovery.next_sequence = snapshot_sequence + 1;
+
+    if (!std::filesystem::exists(journal_path)) {
+        return recovery;
+    }
+
+    const std::vector<std::byte> bytes = read_binary_file(journal_path);
+
+    if (bytes.size() < kJournalHeaderBytes) {
+        recovery.discarded_bytes = bytes.size();
+        return recovery;
+    }
+
+    ByteReader reader(bytes);
+
+    if (!has_magic(bytes, kJournalMagic)) {
+        throw std::runtime_error("Not a Midnight map journal: " + journal_path.string());
+    }
+
+    (void)reader.read_bytes(kJournalMagic.size());
+
+    if (reader.read_u32() != kJournalVersion) {
+        throw std::runtime_error("Unsupported map journal version: " + journal_path.string());
+    }
+
+    (void)reader.read_u32();
+    recovery.journal_bytes = reader.offset();
+
+    std::uint64_t last_sequence = 0;
+
+    while (reader.remaining() >= kRecordHeaderBytes) {
+        const std::uint32_t payload_size = reader.read_u32();
+        const std::uint32_t expected_checksum = reader.read_u32();
+        const std::uint64_t sequence = reader.read_u64();
+
+        if (payload_size > reader.remaining()) {
+            break;
+        }
+
+        const std::span<const std::byte> payload = reader.read_bytes(payload_size);
+
+        if (record_checksum(sequence, payload) != expected_checksum ||
+            sequence <= last_sequence) {
+            break;
+        }
+
+        last_sequence = sequence;
+        recovery.journal_bytes = reader.offset();
+
+        if (sequence > snapshot_sequence) {
+            recovery.records.emplace_back(payload.begin(), payload.end());
+            recovery.next_sequence = sequence + 1;
+        }
+    }
+
+    recovery.discarded_bytes = bytes.size() - recovery.journal_bytes;
+
+    return recovery;
+}
+
+MapEditJournal::MapEditJournal(
+    std::filesystem::path journal_path,
+    std::filesystem::path snapshot_path,
+    const Recovery& recovery
+)
+    : journal_path_(std::move(journal_path)),
+      snapshot_path_(std::move(snapshot_path)),
+      journal_(nullptr, &std::fclose),
+      next_sequence_(recovery.next_sequence),
+      records_since_snapshot_(recovery.records.size())
+{
+    if (recovery.journal_bytes >= kJournalHeaderBytes) {
+        std::filesystem::resize_file(journal_path_, recovery.journal_bytes);
+        open_journal(false);
+    } else {
+        open_journal(true);
+    }
+
+    writer_ = std::jthread([this](const std::stop_token stop_token) {
+        run_writer(stop_token);
+    });
+}
+
+MapEditJournal::~MapEditJournal() noexcept
+{
+    writer_.request_stop();
+
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+}
+
+void MapEditJournal::append(std::vector<std::byte> record)
+{
+    enqueue(Command{
+        .sequence = next_sequence_++,
+        .payload = std::move(record),
+        .snapshot = false
+    });
+    ++records_since_snapshot_;
+}
+
+void MapEditJournal::write_snapshot(std::vector<std::byte> snapshot)
+{
+    enqueue(Command{
+        .sequence = next_sequence_ - 1,
+        .payload = std::move(snapshot),
+        .snapshot = true
+    });
+    records_since_snapshot_ = 0;
+}
+
+void MapEditJournal::flush()
+{
+    std::unique_lock lock(mutex_);
+
+    idle_.wait(lock, [this]() {
+        return writer_error_ != nullptr || (pending_.empty() && !writing_);
+    });
+
+    if (writer_error_ != nullptr) {
+        std::rethrow_exception(writer_error_);
+    }
+}
+
+std::size_t MapEditJournal::records_since_snapshot() const noexcept
+{
+    return records_since_snapshot_;
+}
+
+std::uint64_t MapEditJournal::commit_count() const noexcept
+{
+    return commit_count_.load(std::memory_order_relaxed);
+}
+
+void MapEditJournal::enqueue(Command command)
+{
+    {
+        const std::lock_guard lock(mutex_);
+
+        if (writer_error_ != nullptr) {
+            std::rethrow_exception(writer_error_);
+        }
+
+        pending_.push_back(std::move(command));
+    }
+
+    wake_.notify_one();
+}
+
+void MapEditJournal::run_writer(const std::stop_token stop_token)
+{
+    std::vector<Command> commands;
+
+    while (true) {
+        {
+            std::unique_lock lock(mutex_);
+
+            wake_.wait(lock, stop_token, [this]() {
+                return !pending_.empty();
+            });
+
+            if (pending_.empty()) {
+                return;
+            }
+
+            commands.swap(pending_);
+            writing_ = true;
+        }
+
+        std::exception_ptr error;
+
+        try {
+            write_commands(commands);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        commands.clear();
+
+        {
+            const std::lock_guard lock(mutex_);
+            writing_ = false;
+
+            if (error != nullptr) {
+                writer_error_ = error;
+                pending_.clear();
+            }
+        }
+
+        idle_.notify_all();
+
+        if (error != nullptr) {
+            return;
+        }
+    }
+}
+
+void MapEditJournal::write_commands(const std::vector<Command>& commands)
+{
+    for (const Command& command : commands) {
+        if (command.snapshot) {
+            write_snapshot_file(command);
+            continue;
+        }
+
+        ByteWriter header;
+        header.write_u32(static_cast<std::uint32_t>(command.payload.size()));
+        header.write_u32(record_checksum(command.sequence, command.payload));
+        header.write_u64(command.sequence);
+
+        write_all(journal_.get(), header.take(), journal_path_);
+        write_all(journal_.get(), command.payload, journal_path_);
+        journal_unsynced_ = true;
+    }
+
+    sync_journal();
+    commit_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MapEditJournal::write_snapshot_file(const Command& command)
+{
+    std::filesystem::path temporary_path = snapshot_path_;
+    temporary_path += ".tmp";
+
+    ByteWriter header;
+    header.write_bytes(std::as_bytes(std::span(kSnapshotMagic)));
+    header.write_u32(kJournalVersion);
+    header.write_u32(checksum(command.payload));
+    header.write_u64(command.sequence);
+    header.write_u64(command.payload.size());
+
+    try {
+        FileHandle file(
+            std::fopen(temporary_path.string().c_str(), "wb"),
+            &std::fclose
+        );
+
+        if (!file) {
+            throw std::runtime_error("Failed to create map snapshot: " + temporary_path.string());
+        }
+
+        write_all(file.get(), header.take(), temporary_path);
+        write_all(file.get(), command.payload, temporary_path);
+        sync_file(file.get(), temporary_path);
+
+        if (std::fclose(file.release()) != 0) {
+            throw std::runtime_error("Failed to close map snapshot: " + temporary_path.string());
+        }
+
+        std::filesystem::rename(temporary_path, snapshot_path_);
+    } catch (...) {
+        std::error_code error;
+        std::filesystem::remove(temporary_path, error);
+        throw;
+    }
+
+    // A crash must not keep the journal's truncation but lose the rename,
+    // or every edit since the previous snapshot would be gone.
+    sync_directory(snapshot_path_.parent_path());
+    open_journal(true);
+}
+
+void MapEditJournal::open_journal(const bool truncate)
+{
+    // Closing flushes whatever the old handle still buffers, which has to
+    // land before a truncating open rather than in the new journal.
+    journal_.reset();
+    journal_.reset(
+        std::fopen(journal_path_.string().c_str(), truncate ? "wb" : "ab")
+    );
+
+    if (!journal_) {
+        throw std::runtime_error("Failed to open map journal: " + journal_path_.string());
+    }
+
+    if (truncate) {
+        ByteWriter header;
+        header.write_bytes(std::as_bytes(std::span(kJournalMagic)));
+        header.write_u32(kJournalVersion);
+        header.write_u32(0);
+
+        write_all(journal_.get(), header.take(), journal_path_);
+        journal_unsynced_ = true;
+        sync_journal();
+    }
+}
+
+void MapEditJournal::sync_journal()
+{
+    if (!journal_unsynced_) {
+        return;
+    }
+
+    sync_file(journal_.get(), journal_path_);
+    journal_unsynced_ = false;
+}
+
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace midnight {
+
+// Append-only log of opaque edit records plus a compacted snapshot. Records
+// and snapshots are handed to a background writer thread, which batches
+// everything queued since its last pass behind a single fsync.
+class MapEditJournal final {
+public:
+    struct Recovery final {
+        std::vector<std::byte> snapshot;
+        std::vector<std::vector<std::byte>> records;
+        std::uint64_t next_sequence = 1;
+        std::uint64_t journal_bytes = 0;
+        std::uint64_t discarded_bytes = 0;
+    };
+
+    [[nodiscard]] static Recovery recover(
+        const std::filesystem::path& journal_path,
+        const std::filesystem::path& snapshot_path
+    );
+
+    MapEditJournal(
+        std::filesystem::path journal_path,
+        std::filesystem::path snapshot_path,
+        const Recovery& recovery
+    );
+    ~MapEditJournal() noexcept;
+
+    MapEditJournal(const MapEditJournal&) = delete;
+    MapEditJournal& operator=(const MapEditJournal&) = delete;
+
+    MapEditJournal(MapEditJournal&&) = delete;
+    MapEditJournal& operator=(MapEditJournal&&) = delete;
+
+    void append(std::vector<std::byte> record);
+    void write_snapshot(std::vector<std::byte> snapshot);
+    void flush();
+
+    [[nodiscard]] std::size_t records_since_snapshot() const noexcept;
+    [[nodiscard]] std::uint64_t commit_count() const noexcept;
+
+private:
+    struct Command final {
+        std::uint64_t sequence = 0;
+        std::vector<std::byte> payload;
+        bool snapshot = false;
+    };
+
+    using FileHandle = std::unique_ptr<std::FILE, int (*)(std::FILE*)>;
+
+    void enqueue(Command command);
+    void run_writer(std::stop_token stop_token);
+    void write_commands(const std::vector<Command>& commands);
+    void write_snapshot_file(const Command& command);
+    void open_journal(bool truncate);
+    void sync_journal();
+
+    std::filesystem::path journal_path_;
+    std::filesystem::path snapshot_path_;
+    FileHandle journal_;
+    bool journal_unsynced_ = false;
+    std::uint64_t next_sequence_ = 1;
+    std::size_t records_since_snapshot_ = 0;
+    std::atomic<std::uint64_t> commit_count_ = 0;
+    std::mutex mutex_;
+    std::condition_variable_any wake_;
+    std::condition_variable_any idle_;
+    std::vector<Command> pending_;
+    bool writing_ = false;
+    std::exception_ptr writer_error_;
+    std::jthread writer_;
+};
+
+}
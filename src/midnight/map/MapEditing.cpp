@@ -0,0 +1,646 @@
+#include "midnight/map/MapEditing.hpp"
+
+#include "midnight/map/MapTileSpans.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace midnight {
+namespace {
+
+bool write_tile(
+    const std::span<PackedMapTile> tiles,
+    const std::size_t layer,
+    const std::size_t cell,
+    const PackedMapTile tile,
+    std::vector<MapCellChange>& changes
+)
+{
+    if (tiles[cell] == tile) {
+        return false;
+    }
+
+    changes.push_back(MapCellChange{
+        .layer = static_cast<std::uint32_t>(layer),
+        .cell = static_cast<std::uint32_t>(cell),
+        .before = tiles[cell],
+        .after = tile
+    });
+    tiles[cell] = tile;
+    return true;
+}
+
+// The span writers below skip runs of unchanged cells with the span
+// kernels, record the runs between them cell by cell, then write the whole
+// row span in one go.
+
+std::size_t write_span(
+    const std::span<PackedMapTile> destination,
+    const std::span<const PackedMapTile> source,
+    const std::size_t layer,
+    const std::size_t first_cell,
+    std::vector<MapCellChange>& changes
+)
+{
+    std::size_t changed_count = 0;
+
+    for (std::size_t index = 0;;) {
+        index += find_map_tile_span_difference(
+            destination.subspan(index),
+            source.subspan(index)
+        );
+
+        if (index == source.size()) {
+            break;
+        }
+
+        do {
+            changes.push_back(MapCellChange{
+                .layer = static_cast<std::uint32_t>(layer),
+                .cell = static_cast<std::uint32_t>(first_cell + index),
+                .before = destination[index],
+                .after = source[index]
+            });
+            ++changed_count;
+            ++index;
+        } while (index < source.size() && destination[index] != source[index]);
+    }
+
+    if (changed_count > 0) {
+        copy_map_tile_span(destination, source);
+    }
+
+    return changed_count;
+}
+
+std::size_t fill_span(
+    const std::span<PackedMapTile> destination,
+    const PackedMapTile tile,
+    const std::size_t layer,
+    const std::size_t first_cell,
+    std::vector<MapCellChange>& changes
+)
+{
+    std::size_t changed_count = 0;
+
+    for (std::size_t index = 0;;) {
+        index += find_map_tile_span_difference(destination.subspan(index), tile);
+
+        if (index == destination.size()) {
+            break;
+        }
+
+        do {
+            changes.push_back(MapCellChange{
+                .layer = static_cast<std::uint32_t>(layer),
+                .cell = static_cast<std::uint32_t>(first_cell + index),
+                .before = destination[index],
+                .after = tile
+            });
+            ++changed_count;
+            ++index;
+        } while (index < destination.size() && destination[index] != tile);
+    }
+
+    if (changed_count > 0) {
+        fill_map_tile_span(destination, tile);
+    }
+
+    return changed_count;
+}
+
+// Empty cells of `source` leave `destination` as it is.
+std::size_t blend_span(
+    const std::span<PackedMapTile> destination,
+    const std::span<const PackedMapTile> source,
+    const std::size_t layer,
+    const std::size_t first_cell,
+    std::vector<MapCellChange>& changes
+)
+{
+    std::size_t changed_count = 0;
+
+    for (std::size_t index = 0;;) {
+        index += find_map_tile_span_difference(
+            destination.subspan(index),
+            source.subspan(index)
+        );
+
+        if (index == source.size()) {
+            break;
+        }
+
+        do {
+            if (packed_map_tile_occupied(source[index])) {
+                changes.push_back(MapCellChange{
+                    .layer = static_cast<std::uint32_t>(layer),
+                    .cell = static_cast<std::uint32_t>(first_cell + index),
+                    .before = destination[index],
+                    .after = source[index]
+                });
+                ++changed_count;
+            }
+
+            ++index;
+        } while (index < source.size() && destination[index] != source[index]);
+    }
+
+    if (changed_count > 0) {
+        blend_map_tile_span(destination, source);
+    }
+
+    return changed_count;
+}
+
+void require_area(const TileMap& map, const MapCellRect& area)
+{
+    if (!map.contains(area)) {
+        throw std::runtime_error("Map edit area is outside the map");
+    }
+}
+
+}
+
+bool set_map_tile(
+    TileMap& map,
+    const std::size_t layer,
+    const std::uint32_t column,
+    const std::uint32_t row,
+    const PackedMapTile tile,
+    std::vector<MapCellChange>& changes
+)
+{
+    if (!map.contains(column, row)) {
+        throw std::runtime_error("Map edit cell is outside the map");
+    }
+
+    return write_tile(
+        map.layer(layer),
+        layer,
+        map.cell_index(column, row),
+        tile,
+        changes
+    );
+}
+
+std::size_t paint_map_tile_pattern(
+    TileMap& map,
+    const std::size_t layer,
+    const MapCellRect& area,
+    const MapCellRect& pattern,
+    std::vector<MapCellChange>& changes,
+    std::pmr::memory_resource* const scratch
+)
+{
+    require_area(map, area);
+
+    if (pattern.left > pattern.right || pattern.top > pattern.bottom) {
+        throw std::runtime_error("Map paint pattern is empty");
+    }
+
+    const std::span<PackedMapTile> tiles = map.layer(layer);
+    const std::uint32_t width = area.columns();
+    const std::uint32_t pattern_columns = pattern.columns();
+    const std::uint32_t pattern_rows = pattern.rows();
+    const std::uint32_t row_count = std::min(pattern_rows, area.rows());
+
+    // The area repeats `pattern_rows` distinct rows, so those are packed
+    // once and every area row is written as a span of one of them.
+    std::pmr::vector<PackedMapTile> pattern_tiles(
+        static_cast<std::size_t>(width) * row_count,
+        scratch
+    );
+
+    for (std::uint32_t row = 0; row < row_count; ++row) {
+        for (std::uint32_t column = 0; column < width; ++column) {
+            pattern_tiles[static_cast<std::size_t>(row) * width + column] =
+                pack_map_tile(
+                    pattern.left + column % pattern_columns,
+                    pattern.top + row,
+                    true
+                );
+        }
+    }
+
+    std::size_t changed_count = 0;
+
+    for (std::uint32_t row = area.top; row <= area.bottom; ++row) {
+        const std::size_t first_cell = map.cell_index(area.left, row);
+
+        changed_count += write_span(
+            tiles.subspan(first_cell, width),
+            std::span<const PackedMapTile>(pattern_tiles).subspan(
+                static_cast<std::size_t>((row - area.top) % pattern_rows) * width,
+                width
+            ),
+            layer,
+            first_cell,
+            changes
+        );
+    }
+
+    return changed_count;
+}
+
+std::size_t fill_map_tiles(
+    TileMap& map,
+    const std::size_t layer,
+    const MapCellRect& area,
+    const PackedMapTile tile,
+    std::vector<MapCellChange>& changes
+)
+{
+    require_area(map, area);
+
+    const std::span<PackedMapTile> tiles = map.layer(layer);
+    std::size_t changed_count = 0;
+
+    for (std::uint32_t row = area.top; row <= area.bottom; ++row) {
+        const std::size_t first_cell = map.cell_index(area.left, row);
+
+        changed_count += fill_span(
+            tiles.subspan(first_cell, area.columns()),
+            tile,
+            layer,
+            first_cell,
+            changes
+        );
+    }
+
+    return changed_count;
+}
+
+std::size_t clear_map_tiles(
+    TileMap& map,
+    const std::size_t layer,
+    const MapCellRect& area,
+    std::vector<MapCellChange>& changes
+)
+{
+    return fill_map_tiles(map, layer, area, 0, changes);
+}
+
+std::size_t flood_fill_map_tiles(
+    TileMap& map,
+    const std::size_t layer,
+    const std::uint32_t column,
+    const std::uint32_t row,
+    const PackedMapTile replacement,
+    std::vector<MapCellChange>& changes,
+    std::pmr::memory_resource* const scratch
+)
+{
+    if (!map.contains(column, row)) {
+        throw std::runtime_error("Map flood fill starts outside the map");
+    }
+
+    const std::span<PackedMapTile> tiles = map.layer(layer);
+    const std::uint32_t columns = map.columns();
+    const PackedMapTile target = tiles[map.cell_index(column, row)];
+
+    if (target == replacement) {
+        return 0;
+    }
+
+    // Scanline fill: each seed expands to its whole horizontal run, then
+    // queues one seed per matching run in the rows above and below. Filled
+    // cells stop matching, so nothing is visited twice.
+    std::pmr::vector<std::uint32_t> seeds(scratch);
+    seeds.push_back(static_cast<std::uint32_t>(map.cell_index(column, row)));
+    std::size_t filled_count = 0;
+
+    const auto queue_runs = [&](
+        const std::size_t row_start,
+        const std::uint32_t left,
+        const std::uint32_t right
+    ) {
+        bool in_run = false;
+
+        for (std::uint32_t run_column = left;
+             run_column <= right;
+             ++run_column) {
+            const bool matches = tiles[row_start + run_column] == target;
+
+            if (matches && !in_run) {
+                seeds.push_back(
+                    static_cast<std::uint32_t>(row_start + run_column)
+                );
+            }
+
+            in_run = matches;
+        }
+    };
+
+    while (!seeds.empty()) {
+        const std::uint32_t seed = seeds.back();
+        seeds.pop_back();
+
+        if (tiles[seed] != target) {
+            continue;
+        }
+
+        const std::uint32_t seed_row = seed / columns;
+        const std::size_t row_start =
+            static_cast<std::size_t>(seed_row) * columns;
+        std::uint32_t left = seed % columns;
+        std::uint32_t right = left;
+
+        while (left > 0 && tiles[row_start + left - 1] == target) {
+            --left;
+        }
+
+        while (right + 1 < columns && tiles[row_start + right + 1] == target) {
+            ++right;
+        }
+
+        (void)fill_span(
+            tiles.subspan(row_start + left, right - left + 1),
+            replacement,
+            layer,
+            row_start + left,
+            changes
+        );
+
+        filled_count += right - left + 1;
+
+        if (seed_row > 0) {
+            queue_runs(row_start - columns, left, right);
+        }
+
+        if (seed_row + 1 < map.rows()) {
+            queue_runs(row_start + columns, left, right);
+        }
+    }
+
+    return filled_count;
+}
+
+bool move_map_tiles(
+    TileMap& map,
+    const std::size_t layer,
+    const MapCellRect& area,
+    const int column_delta,
+    const int row_delta,
+    std::vector<MapCellChange>& changes,
+    std::pmr::memory_resource* const scratch
+)
+{
+    require_area(map, area);
+
+    const std::int64_t next_left =
+        static_cast<std::int64_t>(area.left) + column_delta;
+    const std::int64_t next_top =
+        static_cast<std::int64_t>(area.top) + row_delta;
+    const std::int64_t next_right =
+        static_cast<std::int64_t>(area.right) + column_delta;
+    const std::int64_t next_bottom =
+        static_cast<std::int64_t>(area.bottom) + row_delta;
+
+    if (next_left < 0 ||
+        next_top < 0 ||
+        next_right >= static_cast<std::int64_t>(map.columns()) ||
+        next_bottom >= static_cast<std::int64_t>(map.rows())) {
+        return false;
+    }
+
+    const MapCellRect destination{
+        .left = static_cast<std::uint32_t>(next_left),
+        .top = static_cast<std::uint32_t>(next_top),
+        .right = static_cast<std::uint32_t>(next_right),
+        .bottom = static_cast<std::uint32_t>(next_bottom)
+    };
+    const std::span<PackedMapTile> tiles = map.layer(layer);
+    const std::uint32_t width = area.columns();
+    std::pmr::vector<PackedMapTile> moved(
+        static_cast<std::size_t>(width) * area.rows(),
+        scratch
+    );
+
+    map.copy_block(layer, area.left, area.top, width, area.rows(), moved);
+
+    // Source cells the destination does not cover are emptied, then the
+    // destination is blitted a row at a time. The two sets are disjoint,
+    // so every cell is recorded at most once and the cost follows the
+    // area, not the map.
+    const auto clear_span = [&](
+        const std::uint32_t row,
+        const std::uint32_t left,
+        const std::uint32_t right
+    ) {
+        const std::size_t first_cell = map.cell_index(left, row);
+
+        (void)fill_span(
+            tiles.subspan(first_cell, right - left + 1),
+            0,
+            layer,
+            first_cell,
+            changes
+        );
+    };
+
+    for (std::uint32_t row = area.top; row <= area.bottom; ++row) {
+        if (row < destination.top || row > destination.bottom) {
+            clear_span(row, area.left, area.right);
+            continue;
+        }
+
+        if (area.left < destination.left) {
+            clear_span(
+                row,
+                area.left,
+                std::min(area.right, destination.left - 1)
+            );
+        }
+
+        if (area.right > destination.right) {
+            clear_span(
+                row,
+                std::max(area.left, destination.right + 1),
+                area.right
+            );
+        }
+    }
+
+    for (std::uint32_t row = 0; row < area.rows(); ++row) {
+        const std::size_t first_cell =
+            map.cell_index(destination.left, destination.top + row);
+
+        (void)write_span(
+            tiles.subspan(first_cell, width),
+            std::span<const PackedMapTile>(moved).subspan(
+                static_cast<std::size_t>(row) * width,
+                width
+            ),
+            layer,
+            first_cell,
+            changes
+        );
+    }
+
+    return true;
+}
+
+TileMap copy_map_region(
+    const TileMap& map,
+    const MapCellRect& area
+)
+{
+    require_area(map, area);
+
+    TileMap region(area.columns(), area.rows(), map.layer_count());
+
+    for (std::size_t layer = 0; layer < map.layer_count(); ++layer) {
+        map.copy_block(
+            layer,
+            area.left,
+            area.top,
+            area.columns(),
+            area.rows(),
+            region.layer(layer)
+        );
+    }
+
+    return region;
+}
+
+std::size_t paste_map_region(
+    TileMap& map,
+    const TileMap& region,
+    const std::uint32_t column,
+    const std::uint32_t row,
+    std::vector<MapCellChange>& changes,
+    const bool transparent
+)
+{
+    if (region.layer_count() != map.layer_count()) {
+        throw std::runtime_error("Pasted map region has a different layer count");
+    }
+
+    if (!map.contains(column, row)) {
+        throw std::runtime_error("Map paste starts outside the map");
+    }
+
+    const std::uint32_t width = std::min(region.columns(), map.columns() - column);
+    const std::uint32_t height = std::min(region.rows(), map.rows() - row);
+    std::size_t changed_count = 0;
+
+    for (std::size_t layer = 0; layer < map.layer_count(); ++layer) {
+        const std::span<PackedMapTile> tiles = map.layer(layer);
+        const std::span<const PackedMapTile> source = region.layer(layer);
+
+        for (std::uint32_t region_row = 0; region_row < height; ++region_row) {
+            const std::size_t first_cell =
+                map.cell_index(column, row + region_row);
+
+            const std::span<PackedMapTile> destination =
+                tiles.subspan(first_cell, width);
+            const std::span<const PackedMapTile> source_row =
+                source.subspan(region.cell_index(0, region_row), width);
+
+            changed_count += transparent
+                ? blend_span(destination, source_row, layer, first_cell, changes)
+                : write_span(destination, source_row, layer, first_cell, changes);
+        }
+    }
+
+    return changed_count;
+}
+
+std::size_t replace_map_tiles(
+    TileMap& map,
+    const TileMap& source,
+    std::vector<MapCellChange>& changes
+)
+{
+    if (source.columns() != map.columns() ||
+        source.rows() != map.rows() ||
+        source.layer_count() != map.layer_count()) {
+        throw std::runtime_error("Replacement map has a different shape");
+    }
+
+    std::size_t changed_count = 0;
+
+    for (std::size_t layer = 0; layer < map.layer_count(); ++layer) {
+        const std::span<PackedMapTile> tiles = map.layer(layer);
+        const std::span<const PackedMapTile> source_tiles = source.layer(layer);
+
+        changed_count += write_span(tiles, source_tiles, layer, 0, changes);
+    }
+
+    return changed_count;
+}
+
+void coalesce_map_changes(std::vector<MapCellChange>& changes)
+{
+    const auto cell_order = [](
+        const MapCellChange& first,
+        const MapCellChange& second
+    ) {
+        return first.layer != second.layer
+            ? first.layer < second.layer
+            : first.cell < second.cell;
+    };
+
+    // Stable, so the first change of a cell carries its original tile and
+    // the last one its final tile. Edits over whole areas usually come in
+    // order already, and sorting millions of them would dominate a commit.
+    if (!std::ranges::is_sorted(changes, cell_order)) {
+        std::ranges::stable_sort(changes, cell_order);
+    }
+
+    std::size_t kept = 0;
+
+    for (std::size_t index = 0; index < changes.size();) {
+        MapCellChange merged = changes[index];
+        std::size_t next = index + 1;
+
+        while (next < changes.size() &&
+               changes[next].layer == merged.layer &&
+               changes[next].cell == merged.cell) {
+            merged.after = changes[next].after;
+            ++next;
+        }
+
+        if (merged.before != merged.after) {
+            changes[kept++] = merged;
+        }
+
+        index = next;
+    }
+
+    changes.resize(kept);
+}
+
+void apply_map_changes(
+    TileMap& map,
+    const std::span<const MapCellChange> changes
+)
+{
+    for (const MapCellChange& change : changes) {
+        const std::span<PackedMapTile> tiles = map.layer(change.layer);
+
+        if (change.cell >= tiles.size()) {
+            throw std::runtime_error("Map change cell is outside the map");
+        }
+
+        tiles[change.cell] = change.after;
+    }
+}
+
+void revert_map_changes(
+    TileMap& map,
+    const std::span<const MapCellChange> changes
+)
+{
+    for (auto change = changes.rbegin(); change != changes.rend(); ++change) {
+        const std::span<PackedMapTile> tiles = map.layer(change->layer);
+
+        if (change->cell >= tiles.size()) {
+            throw std::runtime_error("Map change cell is outside the map");
+        }
+
+        tiles[change->cell] = change->before;
+    }
+}
+
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "midnight/map/TileMap.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+namespace midnight {
+
+struct MapCellChange final {
+    std::uint32_t layer = 0;
+    std::uint32_t cell = 0;
+    PackedMapTile before = 0;
+    PackedMapTile after = 0;
+
+    bool operator==(const MapCellChange&) const = default;
+};
+
+// Every edit writes through to the map and appends one change per cell it
+// actually altered, so the caller can sync exactly those cells and keep the
+// changes as an undo delta. Areas must lie inside the map. Temporary buffers
+// come from `scratch`, so a per-frame arena can back them.
+
+bool set_map_tile(
+    TileMap& map,
+    std::size_t layer,
+    std::uint32_t column,
+    std::uint32_t row,
+    PackedMapTile tile,
+    std::vector<MapCellChange>& changes
+);
+
+// Repeats the atlas region `pattern` across `area`, starting from the
+// area's top-left cell. Returns the number of cells changed.
+std::size_t paint_map_tile_pattern(
+    TileMap& map,
+    std::size_t layer,
+    const MapCellRect& area,
+    const MapCellRect& pattern,
+    std::vector<MapCellChange>& changes,
+    std::pmr::memory_resource* scratch = std::pmr::get_default_resource()
+);
+
+std::size_t fill_map_tiles(
+    TileMap& map,
+    std::size_t layer,
+    const MapCellRect& area,
+    PackedMapTile tile,
+    std::vector<MapCellChange>& changes
+);
+
+std::size_t clear_map_tiles(
+    TileMap& map,
+    std::size_t layer,
+    const MapCellRect& area,
+    std::vector<MapCellChange>& changes
+);
+
+// Fills the 4-connected run of cells matching the tile at (column, row).
+// Returns the number of cells filled.
+std::size_t flood_fill_map_tiles(
+    TileMap& map,
+    std::size_t layer,
+    std::uint32_t column,
+    std::uint32_t row,
+    PackedMapTile replacement,
+    std::vector<MapCellChange>& changes,
+    std::pmr::memory_resource* scratch = std::pmr::get_default_resource()
+);
+
+// Moves the tiles in `area` by the given delta, leaving the uncovered part
+// of the area empty. Returns false, changing nothing, when the destination
+// would leave the map.
+bool move_map_tiles(
+    TileMap& map,
+    std::size_t layer,
+    const MapCellRect& area,
+    int column_delta,
+    int row_delta,
+    std::vector<MapCellChange>& changes,
+    std::pmr::memory_resource* scratch = std::pmr::get_default_resource()
+);
+
+// Copies `area` on every layer into a map of the area's size, as the
+// clipboard and saved stamps hold it.
+[[nodiscard]] TileMap copy_map_region(
+    const TileMap& map,
+    const MapCellRect& area
+);
+
+// Writes every layer of `region`, which must have the map's layer count,
+// with its top-left cell at (column, row), clipped to the map. Empty cells
+// in the region are written too unless `transparent`, which leaves the
+// map's tiles under them. Returns the number of cells changed.
+std::size_t paste_map_region(
+    TileMap& map,
+    const TileMap& region,
+    std::uint32_t column,
+    std::uint32_t row,
+    std::vector<MapCellChange>& changes,
+    bool transparent = false
+);
+
+// Overwrites every layer with `source`, which must have the same shape.
+std::size_t replace_map_tiles(
+    TileMap& map,
+    const TileMap& source,
+    std::vector<MapCellChange>& changes
+);
+
+// An edit session can touch a cell several times. Folds those into one
+// change per cell, ordered by layer and cell, and drops cells that ended
+// where they started.
+void coalesce_map_changes(std::vector<MapCellChange>& changes);
+
+// Redo and undo: write each change's `after`, or its `before` walking the
+// changes backwards.
+void apply_map_changes(
+    TileMap& map,
+    std::span<const MapCellChange> changes
+);
+void revert_map_changes(
+    TileMap& map,
+    std::span<const MapCellChange> changes
+);
+
+}
@@ -0,0 +1,368 @@
+#include "midnight/map/MapEditor.hpp"
+
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace midnight {
+
+MapEditor::MapEditor(
+    const std::uint32_t columns,
+    const std::uint32_t rows,
+    const std::size_t layer_count
+)
+    : map_(columns, rows, layer_count),
+      tile_index_(map_)
+{
+}
+
+const TileMap& MapEditor::map() const noexcept
+{
+    return map_;
+}
+
+const MapTileIndex& MapEditor::tile_index() const noexcept
+{
+    return tile_index_;
+}
+
+bool MapEditor::editing() const noexcept
+{
+    return editing_;
+}
+
+std::span<const MapCellChange> MapEditor::session_changes() const noexcept
+{
+    return session_changes_;
+}
+
+std::span<const MapEditStep> MapEditor::undo_steps() const noexcept
+{
+    return undo_steps_;
+}
+
+std::span<const MapEditStep> MapEditor::redo_steps() const noexcept
+{
+    return redo_steps_;
+}
+
+void MapEditor::set_scratch_resource(
+    std::pmr::memory_resource* const scratch
+) noexcept
+{
+    scratch_ = scratch;
+}
+
+void MapEditor::set_auto_tiler(const MapAutoTiler* const auto_tiler) noexcept
+{
+    auto_tiler_ = auto_tiler;
+}
+
+void MapEditor::set_job_system(JobSystem* const jobs) noexcept
+{
+    jobs_ = jobs;
+}
+
+void MapEditor::begin(const std::optional<MapSelection> selection)
+{
+    if (editing_) {
+        throw std::runtime_error("Map edit session is already open");
+    }
+
+    session_changes_.clear();
+    session_selection_ = selection;
+    editing_ = true;
+}
+
+std::span<const MapCellChange> MapEditor::apply(
+    const MapEditCommand& command
+)
+{
+    require_session();
+
+    const std::size_t first_change = session_changes_.size();
+    bool indexed = false;
+
+    try {
+        std::visit(
+            [&](const auto& edit) {
+                using Command = std::decay_t<decltype(edit)>;
+
+                if constexpr (std::is_same_v<Command, MapSetTileCommand>) {
+                    (void)set_map_tile(
+                        map_,
+                        edit.layer,
+                        edit.column,
+                        edit.row,
+                        edit.tile,
+                        session_changes_
+                    );
+                } else if constexpr (std::is_same_v<Command, MapPaintStampCommand>) {
+                    (void)paint_map_tile_pattern(
+                        map_,
+                        edit.layer,
+                        edit.area,
+                        edit.pattern,
+                        session_changes_,
+                        scratch_
+                    );
+                } else if constexpr (std::is_same_v<Command, MapFillRectCommand>) {
+                    (void)fill_map_tiles(
+                        map_,
+                        edit.layer,
+                        edit.area,
+                        edit.tile,
+                        session_changes_
+                    );
+                } else if constexpr (std::is_same_v<Command, MapFloodFillCommand>) {
+                    (void)flood_fill_map_tiles(
+                        map_,
+                        edit.layer,
+                        edit.column,
+                        edit.row,
+                        edit.tile,
+                        session_changes_,
+                        scratch_
+                    );
+                } else if constexpr (std::is_same_v<Command, MapEraseCommand>) {
+                    (void)clear_map_tiles(
+                        map_,
+                        edit.layer,
+                        edit.area,
+                        session_changes_
+                    );
+                } else if constexpr (std::is_same_v<Command, MapMoveRegionCommand>) {
+                    (void)move_map_tiles(
+                        map_,
+                        edit.layer,
+                        edit.area,
+                        edit.column_delta,
+                        edit.row_delta,
+                        session_changes_,
+                        scratch_
+                    );
+                } else if constexpr (std::is_same_v<Command, MapPasteCommand>) {
+                    if (edit.region == nullptr) {
+                        throw std::runtime_error("Map paste has no region");
+                    }
+
+                    (void)paste_map_region(
+                        map_,
+                        *edit.region,
+                        edit.column,
+                        edit.row,
+                        session_changes_,
+                        edit.transparent
+                    );
+                } else if constexpr (std::is_same_v<Command, MapPaintTerrainCommand>) {
+                    if (auto_tiler_ == nullptr) {
+                        throw std::runtime_error("Map editor has no auto-tiler");
+                    }
+
+                    (void)auto_tiler_->paint(
+                        map_,
+                        edit.layer,
+                        edit.area,
+                        edit.terrain,
+                        session_changes_,
+                        jobs_
+                    );
+                } else {
+                    static_assert(std::is_same_v<Command, MapReplaceTileCommand>);
+
+                    // The index moves whole chunks over to the replacement
+                    // itself rather than replaying the changes.
+                    (void)tile_index_.replace(
+                        map_,
+                        edit.layer,
+                        edit.tile,
+                        edit.replacement,
+                        session_changes_,
+                        jobs_
+                    );
+                    indexed = true;
+                }
+            },
+            command
+        );
+    } catch (...) {
+        // Cells written before a command threw stay in the session, and
+        // revert_session() will take them out of the index again.
+        tile_index_.apply_changes(
+            map_,
+            std::span<const MapCellChange>(session_changes_)
+                .subspan(first_change),
+            jobs_
+        );
+        throw;
+    }
+
+    const std::span<const MapCellChange> changes =
+        std::span<const MapCellChange>(session_changes_).subspan(first_change);
+
+    if (!indexed) {
+        tile_index_.apply_changes(map_, changes, jobs_);
+    }
+
+    return changes;
+}
+
+std::span<const MapCellChange> MapEditor::apply(
+    const std::span<const MapEditCommand> commands
+)
+{
+    require_session();
+
+    const std::size_t first_change = session_changes_.size();
+
+    for (const MapEditCommand& command : commands) {
+        (void)apply(command);
+    }
+
+    return std::span<const MapCellChange>(session_changes_)
+        .subspan(first_change);
+}
+
+std::span<const MapCellChange> MapEditor::replace(const TileMap& source)
+{
+    require_session();
+
+    const std::size_t first_change = session_changes_.size();
+    (void)replace_map_tiles(map_, source, session_changes_);
+
+    const std::span<const MapCellChange> changes =
+        std::span<const MapCellChange>(session_changes_).subspan(first_change);
+    tile_index_.apply_changes(map_, changes, jobs_);
+
+    return changes;
+}
+
+std::vector<MapCellChange> MapEditor::revert_session()
+{
+    require_session();
+
+    std::vector<MapCellChange> reverted = std::exchange(session_changes_, {});
+    revert_map_changes(map_, reverted);
+    tile_index_.revert_changes(map_, reverted, jobs_);
+
+    return reverted;
+}
+
+const MapEditStep* MapEditor::commit(
+    const std::optional<MapSelection> selection
+)
+{
+    require_session();
+
+    editing_ = false;
+    coalesce_map_changes(session_changes_);
+
+    // Only sessions opened with a selection track it; a selection passed to
+    // any other commit has nothing to be compared against.
+    const std::optional<MapSelection> selection_after =
+        session_selection_.has_value() ? selection : std::nullopt;
+
+    if (session_changes_.empty() && selection_after == session_selection_) {
+        session_selection_.reset();
+        return nullptr;
+    }
+
+    undo_steps_.push_back(MapEditStep{
+        .changes = std::exchange(session_changes_, {}),
+        .selection_before = std::exchange(session_selection_, std::nullopt),
+        .selection_after = selection_after
+    });
+    redo_steps_.clear();
+
+    return &undo_steps_.back();
+}
+
+const MapEditStep* MapEditor::execute(
+    const std::span<const MapEditCommand> commands
+)
+{
+    begin();
+
+    try {
+        (void)apply(commands);
+    } catch (...) {
+        // A command that throws leaves the commands before it applied;
+        // they are rolled back so a failed batch changes nothing.
+        (void)revert_session();
+        editing_ = false;
+        throw;
+    }
+
+    return commit();
+}
+
+const MapEditStep* MapEditor::undo()
+{
+    if (editing_) {
+        throw std::runtime_error("Cannot undo during a map edit session");
+    }
+
+    if (undo_steps_.empty()) {
+        return nullptr;
+    }
+
+    revert_map_changes(map_, undo_steps_.back().changes);
+    tile_index_.revert_changes(map_, undo_steps_.back().changes, jobs_);
+    redo_steps_.push_back(std::move(undo_steps_.back()));
+    undo_steps_.pop_back();
+
+    return &redo_steps_.back();
+}
+
+const MapEditStep* MapEditor::redo()
+{
+    if (editing_) {
+        throw std::runtime_error("Cannot redo during a map edit session");
+    }
+
+    if (redo_steps_.empty()) {
+        return nullptr;
+    }
+
+    apply_map_changes(map_, redo_steps_.back().changes);
+    tile_index_.apply_changes(map_, redo_steps_.back().changes, jobs_);
+    undo_steps_.push_back(std::move(redo_steps_.back()));
+    redo_steps_.pop_back();
+
+    return &undo_steps_.back();
+}
+
+void MapEditor::restore(
+    TileMap map,
+    std::vector<MapEditStep> undo_steps,
+    std::vector<MapEditStep> redo_steps
+)
+{
+    map_ = std::move(map);
+    tile_index_.rebuild(map_, jobs_);
+    undo_steps_ = std::move(undo_steps);
+    redo_steps_ = std::move(redo_steps);
+    session_changes_.clear();
+    session_selection_.reset();
+    editing_ = false;
+}
+
+void MapEditor::reset()
+{
+    map_.clear();
+    tile_index_.rebuild(map_, jobs_);
+    undo_steps_.clear();
+    redo_steps_.clear();
+    session_changes_.clear();
+    session_selection_.reset();
+    editing_ = false;
+}
+
+void MapEditor::require_session() const
+{
+    if (!editing_) {
+        throw std::runtime_error("No map edit session is open");
+    }
+}
+
+}
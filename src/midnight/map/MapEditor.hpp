@@ -0,0 +1,178 @@
+#pragma once
+
+#include "midnight/map/MapAutoTiler.hpp"
+#include "midnight/map/MapEditing.hpp"
+#include "midnight/map/MapTileIndex.hpp"
+#include "midnight/map/TileMap.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <variant>
+#include <vector>
+
+namespace midnight {
+
+struct MapSelection final {
+    std::uint32_t left = 0;
+    std::uint32_t top = 0;
+    std::uint32_t right = 0;
+    std::uint32_t bottom = 0;
+    bool visible = false;
+
+    [[nodiscard]] constexpr MapCellRect area() const noexcept
+    {
+        return MapCellRect{
+            .left = left,
+            .top = top,
+            .right = right,
+            .bottom = bottom
+        };
+    }
+
+    bool operator==(const MapSelection&) const = default;
+};
+
+struct MapEditStep final {
+    std::vector<MapCellChange> changes;
+    std::optional<MapSelection> selection_before;
+    std::optional<MapSelection> selection_after;
+};
+
+struct MapSetTileCommand final {
+    std::size_t layer = 0;
+    std::uint32_t column = 0;
+    std::uint32_t row = 0;
+    PackedMapTile tile = 0;
+};
+
+struct MapPaintStampCommand final {
+    std::size_t layer = 0;
+    MapCellRect area;
+    MapCellRect pattern;
+};
+
+struct MapFillRectCommand final {
+    std::size_t layer = 0;
+    MapCellRect area;
+    PackedMapTile tile = 0;
+};
+
+struct MapFloodFillCommand final {
+    std::size_t layer = 0;
+    std::uint32_t column = 0;
+    std::uint32_t row = 0;
+    PackedMapTile tile = 0;
+};
+
+struct MapEraseCommand final {
+    std::size_t layer = 0;
+    MapCellRect area;
+};
+
+struct MapMoveRegionCommand final {
+    std::size_t layer = 0;
+    MapCellRect area;
+    int column_delta = 0;
+    int row_delta = 0;
+};
+
+struct MapPasteCommand final {
+    std::shared_ptr<const TileMap> region;
+    std::uint32_t column = 0;
+    std::uint32_t row = 0;
+    bool transparent = false;
+};
+
+struct MapPaintTerrainCommand final {
+    std::size_t layer = 0;
+    MapCellRect area;
+    std::uint8_t terrain = MapAutoTiler::kNoTerrain;
+};
+
+struct MapReplaceTileCommand final {
+    std::size_t layer = 0;
+    PackedMapTile tile = 0;
+    PackedMapTile replacement = 0;
+};
+
+using MapEditCommand = std::variant<
+    MapSetTileCommand,
+    MapPaintStampCommand,
+    MapFillRectCommand,
+    MapFloodFillCommand,
+    MapEraseCommand,
+    MapMoveRegionCommand,
+    MapPasteCommand,
+    MapPaintTerrainCommand,
+    MapReplaceTileCommand
+>;
+
+class MapEditor final {
+public:
+    MapEditor(std::uint32_t columns, std::uint32_t rows, std::size_t layer_count);
+
+    MapEditor(const MapEditor&) = delete;
+    MapEditor& operator=(const MapEditor&) = delete;
+
+    MapEditor(MapEditor&&) = delete;
+    MapEditor& operator=(MapEditor&&) = delete;
+
+    [[nodiscard]] const TileMap& map() const noexcept;
+    [[nodiscard]] const MapTileIndex& tile_index() const noexcept;
+    [[nodiscard]] bool editing() const noexcept;
+    [[nodiscard]] std::span<const MapCellChange> session_changes() const noexcept;
+    [[nodiscard]] std::span<const MapEditStep> undo_steps() const noexcept;
+    [[nodiscard]] std::span<const MapEditStep> redo_steps() const noexcept;
+
+    void set_scratch_resource(std::pmr::memory_resource* scratch) noexcept;
+
+    void set_auto_tiler(const MapAutoTiler* auto_tiler) noexcept;
+    void set_job_system(JobSystem* jobs) noexcept;
+
+    void begin(std::optional<MapSelection> selection = std::nullopt);
+
+    std::span<const MapCellChange> apply(const MapEditCommand& command);
+    std::span<const MapCellChange> apply(
+        std::span<const MapEditCommand> commands
+    );
+
+    std::span<const MapCellChange> replace(const TileMap& source);
+
+    std::vector<MapCellChange> revert_session();
+
+    const MapEditStep* commit(
+        std::optional<MapSelection> selection = std::nullopt
+    );
+
+    const MapEditStep* execute(std::span<const MapEditCommand> commands);
+
+    const MapEditStep* undo();
+    const MapEditStep* redo();
+
+    void restore(
+        TileMap map,
+        std::vector<MapEditStep> undo_steps,
+        std::vector<MapEditStep> redo_steps
+    );
+    void reset();
+
+private:
+    void require_session() const;
+
+    TileMap map_;
+    MapTileIndex tile_index_;
+    std::vector<MapCellChange> session_changes_;
+    std::optional<MapSelection> session_selection_;
+    std::vector<MapEditStep> undo_steps_;
+    std::vector<MapEditStep> redo_steps_;
+    std::pmr::memory_resource* scratch_ = std::pmr::get_default_resource();
+    const MapAutoTiler* auto_tiler_ = nullptr;
+    JobSystem* jobs_ = nullptr;
+    bool editing_ = false;
+};
+
+}
@@ -0,0 +1,564 @@
+#include "midnight/map/MapFile.hpp"
+
+#include "midnight/core/File.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+namespace midnight {
+namespace {
+
+// Header layout (little-endian):
+//   0  magic[8]
+//   8  u32 version
+//  12  u32 columns
+//  16  u32 rows
+//  20  u32 chunk size
+//  24  u32 layer count
+//  28  u32 reserved
+//  32  u64 layer table offset     (u32 flags, u32 reserved per layer)
+//  40  u64 chunk directory offset (u64 offset, u32 bytes, u32 encoding
+//                                  per layer-major chunk)
+constexpr std::array<char, 8> kMapFileMagic{
+    'M', 'I', 'D', 'N', 'M', 'A', 'P', '\0'
+};
+constexpr std::size_t kHeaderBytes = 48;
+constexpr std::size_t kLayerEntryBytes = 8;
+constexpr std::size_t kChunkEntryBytes = 16;
+constexpr std::uint32_t kMaxLayerCount = 64;
+constexpr std::uint32_t kMaxChunkSize = 1024;
+
+using FileHandle = std::unique_ptr<std::FILE, decltype(&std::fclose)>;
+
+std::uint32_t read_u32(
+    const std::span<const std::byte> bytes,
+    const std::size_t offset
+) noexcept
+{
+    std::uint32_t value = 0;
+
+    for (std::size_t byte = 0; byte < 4; ++byte) {
+        value |= static_cast<std::uint32_t>(bytes[offset + byte]) << (byte * 8);
+    }
+
+    return value;
+}
+
+std::uint64_t read_u64(
+    const std::span<const std::byte> bytes,
+    const std::size_t offset
+) noexcept
+{
+    return static_cast<std::uint64_t>(read_u32(bytes, offset)) |
+           static_cast<std::uint64_t>(read_u32(bytes, offset + 4)) << 32;
+}
+
+void write_u32(
+    const std::span<std::byte> bytes,
+    const std::size_t offset,
+    const std::uint32_t value
+) noexcept
+{
+    for (std::size_t byte = 0; byte < 4; ++byte) {
+        bytes[offset + byte] = static_cast<std::byte>(value >> (byte * 8));
+    }
+}
+
+void write_u64(
+    const std::span<std::byte> bytes,
+    const std::size_t offset,
+    const std::uint64_t value
+) noexcept
+{
+    write_u32(bytes, offset, static_cast<std::uint32_t>(value));
+    write_u32(bytes, offset + 4, static_cast<std::uint32_t>(value >> 32));
+}
+
+void append_u32(std::vector<std::byte>& bytes, const std::uint32_t value)
+{
+    const std::size_t offset = bytes.size();
+    bytes.resize(offset + 4);
+    write_u32(bytes, offset, value);
+}
+
+bool range_fits(
+    const std::uint64_t offset,
+    const std::uint64_t length,
+    const std::size_t size
+) noexcept
+{
+    return offset <= size && length <= size - offset;
+}
+
+void validate_layout(const MapFileLayout& layout)
+{
+    if (layout.columns == 0 ||
+        layout.rows == 0 ||
+        layout.chunk_size == 0 ||
+        layout.chunk_size > kMaxChunkSize ||
+        layout.layer_flags.empty() ||
+        layout.layer_flags.size() > kMaxLayerCount) {
+        throw std::runtime_error("Invalid map file layout");
+    }
+}
+
+MapChunkEncoding encode_chunk(
+    const std::span<const PackedMapTile> tiles,
+    std::vector<std::byte>& payload
+)
+{
+    payload.clear();
+
+    if (std::ranges::all_of(tiles, [](const PackedMapTile tile) {
+            return tile == 0;
+        })) {
+        return MapChunkEncoding::Empty;
+    }
+
+    std::size_t run_count = 1;
+
+    for (std::size_t index = 1; index < tiles.size(); ++index) {
+        run_count += tiles[index] != tiles[index - 1] ? 1 : 0;
+    }
+
+    if (run_count * 2 < tiles.size()) {
+        payload.reserve(run_count * 8);
+
+        std::size_t run_begin = 0;
+
+        for (std::size_t index = 1; index <= tiles.size(); ++index) {
+            if (index == tiles.size() || tiles[index] != tiles[run_begin]) {
+                append_u32(payload, static_cast<std::uint32_t>(index - run_begin));
+                append_u32(payload, tiles[run_begin]);
+                run_begin = index;
+            }
+        }
+
+        return MapChunkEncoding::RunLength;
+    }
+
+    payload.reserve(tiles.size() * 4);
+
+    for (const PackedMapTile tile : tiles) {
+        append_u32(payload, tile);
+    }
+
+    return MapChunkEncoding::Raw;
+}
+
+void write_bytes(
+    std::FILE* file,
+    const std::span<const std::byte> bytes,
+    const std::filesystem::path& path
+)
+{
+    if (!bytes.empty() &&
+        std::fwrite(bytes.data(), 1, bytes.size(), file) != bytes.size()) {
+        throw std::runtime_error("Failed to write map file: " + path.string());
+    }
+}
+
+}
+
+std::uint32_t MapFileLayout::layer_count() const noexcept
+{
+    return static_cast<std::uint32_t>(layer_flags.size());
+}
+
+std::uint32_t MapFileLayout::chunk_columns() const noexcept
+{
+    return (columns + chunk_size - 1) / chunk_size;
+}
+
+std::uint32_t MapFileLayout::chunk_rows() const noexcept
+{
+    return (rows + chunk_size - 1) / chunk_size;
+}
+
+std::size_t MapFileLayout::chunk_count() const noexcept
+{
+    return static_cast<std::size_t>(chunk_columns()) * chunk_rows();
+}
+
+std::size_t MapFileLayout::chunk_tile_count() const noexcept
+{
+    return static_cast<std::size_t>(chunk_size) * chunk_size;
+}
+
+std::size_t MapFileLayout::chunk_index(
+    const std::uint32_t column,
+    const std::uint32_t row
+) const noexcept
+{
+    return static_cast<std::size_t>(row / chunk_size) * chunk_columns() +
+           column / chunk_size;
+}
+
+MapFile::MapFile(const std::filesystem::path& path)
+    : file_(path)
+{
+    const std::span<const std::byte> bytes = file_.bytes();
+
+    if (bytes.size() < kHeaderBytes ||
+        std::memcmp(bytes.data(), kMapFileMagic.data(), kMapFileMagic.size()) != 0) {
+        throw std::runtime_error("Not a Midnight map file: " + path.string());
+    }
+
+    const std::uint32_t version = read_u32(bytes, 8);
+
+    if (version != kVersion) {
+        throw std::runtime_error(
+            "Unsupported map file version " +
+            std::to_string(version) +
+            ": " +
+            path.string()
+        );
+    }
+
+    layout_.columns = read_u32(bytes, 12);
+    layout_.rows = read_u32(bytes, 16);
+    layout_.chunk_size = read_u32(bytes, 20);
+
+    const std::uint32_t layer_count = read_u32(bytes, 24);
+    const std::uint64_t layer_table_offset = read_u64(bytes, 32);
+    const std::uint64_t directory_offset = read_u64(bytes, 40);
+
+    if (layer_count == 0 ||
+        layer_count > kMaxLayerCount ||
+        !range_fits(layer_table_offset, layer_count * kLayerEntryBytes, bytes.size())) {
+        throw std::runtime_error("Invalid map file layer table: " + path.string());
+    }
+
+    layout_.layer_flags.resize(layer_count);
+
+    for (std::uint32_t layer = 0; layer < layer_count; ++layer) {
+        layout_.layer_flags[layer] = read_u32(
+            bytes,
+            static_cast<std::size_t>(layer_table_offset) + layer * kLayerEntryBytes
+        );
+    }
+
+    validate_layout(layout_);
+
+    const std::uint64_t chunk_count =
+        static_cast<std::uint64_t>(layout_.chunk_columns()) *
+        layout_.chunk_rows();
+
+    if (chunk_count > bytes.size() / kChunkEntryBytes / layer_count ||
+        !range_fits(
+            directory_offset,
+            chunk_count * layer_count * kChunkEntryBytes,
+            bytes.size()
+        )) {
+        throw std::runtime_error("Invalid map file chunk directory: " + path.string());
+    }
+
+    const std::size_t slot_count =
+        static_cast<std::size_t>(chunk_count) * layer_count;
+
+    chunks_.resize(slot_count);
+
+    for (std::size_t slot = 0; slot < slot_count; ++slot) {
+        const std::size_t entry_offset =
+            static_cast<std::size_t>(directory_offset) + slot * kChunkEntryBytes;
+        ChunkEntry& chunk = chunks_[slot];
+        const std::uint32_t encoding = read_u32(bytes, entry_offset + 12);
+
+        chunk.offset = read_u64(bytes, entry_offset);
+        chunk.stored_bytes = read_u32(bytes, entry_offset + 8);
+
+        if (encoding > static_cast<std::uint32_t>(MapChunkEncoding::RunLength) ||
+            !range_fits(chunk.offset, chunk.stored_bytes, bytes.size())) {
+            throw std::runtime_error("Invalid map file chunk entry: " + path.string());
+        }
+
+        chunk.encoding = static_cast<MapChunkEncoding>(encoding);
+    }
+
+    decoded_chunks_.resize(slot_count);
+    chunk_decoded_.assign(slot_count, 0);
+}
+
+const std::filesystem::path& MapFile::path() const noexcept
+{
+    return file_.path();
+}
+
+const MapFileLayout& MapFile::layout() const noexcept
+{
+    return layout_;
+}
+
+std::size_t MapFile::decoded_chunk_count() const noexcept
+{
+    return decoded_chunk_count_;
+}
+
+std::span<const PackedMapTile> MapFile::chunk_tiles(
+    const std::uint32_t layer,
+    const std::size_t chunk_index
+)
+{
+    const std::size_t slot = chunk_slot(layer, chunk_index);
+
+    if (chunk_decoded_[slot] == 0) {
+        decode_chunk(slot);
+    }
+
+    return decoded_chunks_[slot];
+}
+
+PackedMapTile MapFile::tile(
+    const std::uint32_t layer,
+    const std::uint32_t column,
+    const std::uint32_t row
+)
+{
+    if (column >= layout_.columns || row >= layout_.rows) {
+        throw std::runtime_error("Map file tile is outside the map");
+    }
+
+    const std::span<const PackedMapTile> tiles =
+        chunk_tiles(layer, layout_.chunk_index(column, row));
+
+    return tiles[
+        static_cast<std::size_t>(row % layout_.chunk_size) * layout_.chunk_size +
+        column % layout_.chunk_size
+    ];
+}
+
+MapChunkEncoding MapFile::chunk_encoding(
+    const std::uint32_t layer,
+    const std::size_t chunk_index
+) const
+{
+    return chunks_[chunk_slot(layer, chunk_index)].encoding;
+}
+
+std::span<const std::byte> MapFile::chunk_payload(
+    const std::uint32_t layer,
+    const std::size_t chunk_index
+) const
+{
+    const ChunkEntry& chunk = chunks_[chunk_slot(layer, chunk_index)];
+
+    return file_.bytes().subspan(
+        static_cast<std::size_t>(chunk.offset),
+        chunk.stored_bytes
+    );
+}
+
+std::size_t MapFile::chunk_slot(
+    const std::uint32_t layer,
+    const std::size_t chunk_index
+) const
+{
+    if (layer >= layout_.layer_count() || chunk_index >= layout_.chunk_count()) {
+        throw std::runtime_error("Map file chunk is outside the map");
+    }
+
+    return static_cast<std::size_t>(layer) * layout_.chunk_count() + chunk_index;
+}
+
+void MapFile::decode_chunk(const std::size_t slot)
+{
+    const ChunkEntry& chunk = chunks_[slot];
+    const std::span<const std::byte> payload = file_.bytes().subspan(
+        static_cast<std::size_t>(chunk.offset),
+        chunk.stored_bytes
+    );
+    const std::size_t tile_count = layout_.chunk_tile_count();
+    std::vector<PackedMapTile> tiles(tile_count, 0);
+
+    const auto corrupt = [this]() {
+        return std::runtime_error("Corrupt map file chunk: " + file_.path().string());
+    };
+
+    switch (chunk.encoding) {
+        case MapChunkEncoding::Empty:
+            break;
+
+        case MapChunkEncoding::Raw:
+            if (payload.size() != tile_count * 4) {
+                throw corrupt();
+            }
+
+            for (std::size_t tile = 0; tile < tile_count; ++tile) {
+                tiles[tile] = read_u32(payload, tile * 4);
+            }
+            break;
+
+        case MapChunkEncoding::RunLength: {
+            if (payload.size() % 8 != 0) {
+                throw corrupt();
+            }
+
+            std::size_t position = 0;
+
+            for (std::size_t offset = 0; offset < payload.size(); offset += 8) {
+                const std::uint32_t run_length = read_u32(payload, offset);
+                const PackedMapTile value = read_u32(payload, offset + 4);
+
+                if (run_length == 0 || run_length > tile_count - position) {
+                    throw corrupt();
+                }
+
+                std::fill_n(
+                    tiles.begin() + static_cast<std::ptrdiff_t>(position),
+                    run_length,
+                    value
+                );
+                position += run_length;
+            }
+
+            if (position != tile_count) {
+                throw corrupt();
+            }
+            break;
+        }
+    }
+
+    decoded_chunks_[slot] = std::move(tiles);
+    chunk_decoded_[slot] = 1;
+    ++decoded_chunk_count_;
+}
+
+MapFileSaveStats save_map_file(
+    const std::filesystem::path& path,
+    const MapFileLayout& layout,
+    const MapChunkSource& chunk_source,
+    const std::span<const std::uint8_t> dirty_chunks,
+    const MapFile* previous
+)
+{
+    validate_layout(layout);
+
+    const std::uint32_t layer_count = layout.layer_count();
+    const std::size_t chunk_count = layout.chunk_count();
+    const std::size_t slot_count = chunk_count * layer_count;
+
+    if (dirty_chunks.size() != slot_count) {
+        throw std::runtime_error("Map file dirty chunk flags do not match the layout");
+    }
+
+    const bool reuse_previous =
+        previous != nullptr && previous->layout() == layout;
+    const std::size_t layer_table_offset = kHeaderBytes;
+    const std::size_t directory_offset =
+        layer_table_offset + layer_count * kLayerEntryBytes;
+    std::vector<std::byte> preamble(
+        directory_offset + slot_count * kChunkEntryBytes
+    );
+
+    std::memcpy(preamble.data(), kMapFileMagic.data(), kMapFileMagic.size());
+    write_u32(preamble, 8, MapFile::kVersion);
+    write_u32(preamble, 12, layout.columns);
+    write_u32(preamble, 16, layout.rows);
+    write_u32(preamble, 20, layout.chunk_size);
+    write_u32(preamble, 24, layer_count);
+    write_u64(preamble, 32, layer_table_offset);
+    write_u64(preamble, 40, directory_offset);
+
+    for (std::uint32_t layer = 0; layer < layer_count; ++layer) {
+        write_u32(
+            preamble,
+            layer_table_offset + layer * kLayerEntryBytes,
+            layout.layer_flags[layer]
+        );
+    }
+
+    std::filesystem::path temporary_path = path;
+    temporary_path += ".tmp";
+
+    MapFileSaveStats stats{};
+
+    try {
+        FileHandle file(std::fopen(temporary_path.string().c_str(), "wb"), &std::fclose);
+
+        if (!file) {
+            throw std::runtime_error("Failed to create map file: " + temporary_path.string());
+        }
+
+        write_bytes(file.get(), preamble, temporary_path);
+
+        std::uint64_t offset = preamble.size();
+        std::vector<PackedMapTile> tiles(layout.chunk_tile_count());
+        std::vector<std::byte> encoded;
+
+        for (std::size_t slot = 0; slot < slot_count; ++slot) {
+            const auto layer = static_cast<std::uint32_t>(slot / chunk_count);
+            const std::size_t chunk_index = slot % chunk_count;
+            MapChunkEncoding encoding = MapChunkEncoding::Empty;
+            std::span<const std::byte> payload;
+
+            if (reuse_previous && dirty_chunks[slot] == 0) {
+                encoding = previous->chunk_encoding(layer, chunk_index);
+                payload = previous->chunk_payload(layer, chunk_index);
+                ++stats.copied_chunk_count;
+            } else {
+                std::ranges::fill(tiles, PackedMapTile{0});
+                chunk_source(layer, chunk_index, tiles);
+                encoding = encode_chunk(tiles, encoded);
+                payload = encoded;
+                ++stats.encoded_chunk_count;
+            }
+
+            const std::size_t entry_offset = directory_offset + slot * kChunkEntryBytes;
+            write_u64(preamble, entry_offset, payload.empty() ? 0 : offset);
+            write_u32(preamble, entry_offset + 8, static_cast<std::uint32_t>(payload.size()));
+            write_u32(preamble, entry_offset + 12, static_cast<std::uint32_t>(encoding));
+
+            write_bytes(file.get(), payload, temporary_path);
+            offset += payload.size();
+        }
+
+        if (std::fseek(file.get(), static_cast<long>(directory_offset), SEEK_SET) != 0) {
+            throw std::runtime_error("Failed to seek map file: " + temporary_path.string());
+        }
+
+        write_bytes(
+            file.get(),
+            std::span<const std::byte>(preamble).subspan(directory_offset),
+            temporary_path
+        );
+
+        if (std::fflush(file.get()) != 0) {
+            throw std::runtime_error("Failed to flush map file: " + temporary_path.string());
+        }
+
+#if !defined(_WIN32)
+        if (::fsync(::fileno(file.get())) != 0) {
+            throw std::runtime_error("Failed to sync map file: " + temporary_path.string());
+        }
+#endif
+
+        if (std::fclose(file.release()) != 0) {
+            throw std::runtime_error("Failed to close map file: " + temporary_path.string());
+        }
+
+        std::filesystem::rename(temporary_path, path);
+
+        // The rename only survives a crash once the directory is synced.
+        sync_directory(path.parent_path());
+        stats.file_bytes = offset;
+    } catch (...) {
+        std::error_code error;
+        std::filesystem::remove(temporary_path, error);
+        throw;
+    }
+
+    return stats;
+}
+
+}
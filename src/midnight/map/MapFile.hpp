@@ -0,0 +1,164 @@
+#pragma once
+
+#include "midnight/core/MappedFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace midnight {
+
+// Occupied tiles store the tileset row in bits 16-30 and the tileset
+// column in bits 0-15; every unoccupied tile packs to zero.
+using PackedMapTile = std::uint32_t;
+
+inline constexpr PackedMapTile kPackedMapTileOccupied = 0x8000'0000u;
+inline constexpr std::uint32_t kPackedMapTileColumnLimit = 0x1'0000u;
+inline constexpr std::uint32_t kPackedMapTileRowLimit = 0x8000u;
+
+[[nodiscard]] constexpr PackedMapTile pack_map_tile(
+    const std::uint32_t tileset_column,
+    const std::uint32_t tileset_row,
+    const bool occupied
+) noexcept
+{
+    return occupied
+        ? kPackedMapTileOccupied | (tileset_row << 16) | tileset_column
+        : 0;
+}
+
+[[nodiscard]] constexpr bool packed_map_tile_occupied(
+    const PackedMapTile tile
+) noexcept
+{
+    return (tile & kPackedMapTileOccupied) != 0;
+}
+
+[[nodiscard]] constexpr std::uint32_t packed_map_tile_column(
+    const PackedMapTile tile
+) noexcept
+{
+    return tile & 0xFFFFu;
+}
+
+[[nodiscard]] constexpr std::uint32_t packed_map_tile_row(
+    const PackedMapTile tile
+) noexcept
+{
+    return (tile >> 16) & 0x7FFFu;
+}
+
+enum class MapChunkEncoding : std::uint32_t {
+    Empty,
+    Raw,
+    RunLength
+};
+
+struct MapFileLayout final {
+    static constexpr std::uint32_t kLayerBlocksMovement = 1u << 0;
+
+    std::uint32_t columns = 0;
+    std::uint32_t rows = 0;
+    std::uint32_t chunk_size = 0;
+    std::vector<std::uint32_t> layer_flags;
+
+    [[nodiscard]] std::uint32_t layer_count() const noexcept;
+    [[nodiscard]] std::uint32_t chunk_columns() const noexcept;
+    [[nodiscard]] std::uint32_t chunk_rows() const noexcept;
+    [[nodiscard]] std::size_t chunk_count() const noexcept;
+    [[nodiscard]] std::size_t chunk_tile_count() const noexcept;
+    [[nodiscard]] std::size_t chunk_index(
+        std::uint32_t column,
+        std::uint32_t row
+    ) const noexcept;
+
+    bool operator==(const MapFileLayout&) const = default;
+};
+
+// Maps a saved map read-only and decodes each chunk the first time it is
+// touched, so opening a file only parses the header and chunk directory.
+class MapFile final {
+public:
+    static constexpr std::uint32_t kVersion = 1;
+
+    explicit MapFile(const std::filesystem::path& path);
+
+    MapFile(const MapFile&) = delete;
+    MapFile& operator=(const MapFile&) = delete;
+
+    MapFile(MapFile&&) = delete;
+    MapFile& operator=(MapFile&&) = delete;
+
+    [[nodiscard]] const std::filesystem::path& path() const noexcept;
+    [[nodiscard]] const MapFileLayout& layout() const noexcept;
+    [[nodiscard]] std::size_t decoded_chunk_count() const noexcept;
+
+    [[nodiscard]] std::span<const PackedMapTile> chunk_tiles(
+        std::uint32_t layer,
+        std::size_t chunk_index
+    );
+    [[nodiscard]] PackedMapTile tile(
+        std::uint32_t layer,
+        std::uint32_t column,
+        std::uint32_t row
+    );
+
+    [[nodiscard]] MapChunkEncoding chunk_encoding(
+        std::uint32_t layer,
+        std::size_t chunk_index
+    ) const;
+    [[nodiscard]] std::span<const std::byte> chunk_payload(
+        std::uint32_t layer,
+        std::size_t chunk_index
+    ) const;
+
+private:
+    struct ChunkEntry final {
+        std::uint64_t offset = 0;
+        std::uint32_t stored_bytes = 0;
+        MapChunkEncoding encoding = MapChunkEncoding::Empty;
+    };
+
+    [[nodiscard]] std::size_t chunk_slot(
+        std::uint32_t layer,
+        std::size_t chunk_index
+    ) const;
+    void decode_chunk(std::size_t slot);
+
+    MappedFile file_;
+    MapFileLayout layout_;
+    std::vector<ChunkEntry> chunks_;
+    std::vector<std::vector<PackedMapTile>> decoded_chunks_;
+    std::vector<std::uint8_t> chunk_decoded_;
+    std::size_t decoded_chunk_count_ = 0;
+};
+
+struct MapFileSaveStats final {
+    std::size_t encoded_chunk_count = 0;
+    std::size_t copied_chunk_count = 0;
+    std::uint64_t file_bytes = 0;
+};
+
+// Fills a zeroed chunk_size x chunk_size tile block; cells past the map edge
+// must stay zero.
+using MapChunkSource = std::function<void(
+    std::uint32_t layer,
+    std::size_t chunk_index,
+    std::span<PackedMapTile> tiles
+)>;
+
+// Writes the map beside `path` and renames it into place. Chunks whose dirty
+// flag (indexed layer * chunk_count + chunk) is clear are copied verbatim
+// from `previous` when its layout matches; everything else is re-encoded.
+MapFileSaveStats save_map_file(
+    const std::filesystem::path& path,
+    const MapFileLayout& layout,
+    const MapChunkSource& chunk_source,
+    std::span<const std::uint8_t> dirty_chunks,
+    const MapFile* previous
+);
+
+}
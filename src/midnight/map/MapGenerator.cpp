@@ -0,0 +1,650 @@
+#include "midnight/map/MapGenerator.hpp"
+
+#include "midnight/core/JobSystem.hpp"
+
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace midnight {
+namespace {
+
+// The unit of parallel work; every band writes only its own rows.
+constexpr std::uint32_t kGeneratorBandRows = 64;
+constexpr std::uint32_t kMaxNoiseOctaves = 8;
+// Lattice values and interpolation weights are 15-bit fixed point, so a
+// difference times a weight fits an int32 and rows vectorize as plain
+// integer lanes.
+constexpr int kNoiseValueBits = 15;
+constexpr std::int64_t kNoiseOne = std::int64_t{1} << kNoiseValueBits;
+// B5678/S45: a cell is wall when at least this many of the nine cells
+// around and including it are.
+constexpr std::uint8_t kCaveWallCount = 5;
+
+// The standard distributions give different values on different standard
+// libraries, so all randomness comes from this and from hash_cell().
+class SplitMix64 final {
+public:
+    explicit SplitMix64(const std::uint64_t seed) noexcept
+        : state_(seed)
+    {
+    }
+
+    [[nodiscard]] std::uint64_t next() noexcept
+    {
+        std::uint64_t value = state_ += 0x9E37'79B9'7F4A'7C15ull;
+        value = (value ^ (value >> 30)) * 0xBF58'476D'1CE4'E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D0'49BB'1331'11EBull;
+        return value ^ (value >> 31);
+    }
+
+    // Inclusive of both ends.
+    [[nodiscard]] std::uint32_t between(
+        const std::uint32_t low,
+        const std::uint32_t high
+    ) noexcept
+    {
+        return low + static_cast<std::uint32_t>(
+            next() % (std::uint64_t{high} - low + 1)
+        );
+    }
+
+private:
+    std::uint64_t state_ = 0;
+};
+
+[[nodiscard]] constexpr std::uint32_t mix_bits(std::uint32_t value) noexcept
+{
+    value ^= value >> 16;
+    value *= 0x85EB'CA6Bu;
+    value ^= value >> 13;
+    value *= 0xC2B2'AE35u;
+    return value ^ (value >> 16);
+}
+
+[[nodiscard]] constexpr std::uint32_t hash_cell(
+    const std::uint32_t seed,
+    const std::uint32_t column,
+    const std::uint32_t row
+) noexcept
+{
+    return mix_bits(mix_bits(seed ^ column * 0x9E37'79B1u) ^ row * 0x85EB'CA77u);
+}
+
+// Independent streams for each stage, so changing one stage's settings
+// leaves the others' output alone.
+[[nodiscard]] std::uint32_t derive_seed(
+    const std::uint64_t seed,
+    const std::uint64_t stream
+) noexcept
+{
+    return static_cast<std::uint32_t>(
+        SplitMix64(seed ^ (stream * 0xD1B5'4A32'D192'ED03ull)).next() >> 32
+    );
+}
+
+template <typename Work>
+void for_each_band(
+    const std::uint32_t rows,
+    JobSystem* const jobs,
+    const Work& work
+)
+{
+    if (jobs == nullptr) {
+        work(0u, rows);
+        return;
+    }
+
+    jobs->parallel_for(
+        rows,
+        kGeneratorBandRows,
+        [&work](const std::size_t first, const std::size_t end) {
+            work(
+                static_cast<std::uint32_t>(first),
+                static_cast<std::uint32_t>(end)
+            );
+        }
+    );
+}
+
+// Wall flags inside a border of walls one cell wide, so neighbourhood sums
+// at the map edge need no bounds checks.
+class SolidGrid final {
+public:
+    explicit SolidGrid(const TileMap& map)
+        : stride_(static_cast<std::size_t>(map.columns()) + 2),
+          cells_(stride_ * (static_cast<std::size_t>(map.rows()) + 2), 1)
+    {
+    }
+
+    [[nodiscard]] std::size_t stride() const noexcept
+    {
+        return stride_;
+    }
+
+    [[nodiscard]] std::uint8_t* row(const std::uint32_t row) noexcept
+    {
+        return cells_.data() + (static_cast<std::size_t>(row) + 1) * stride_ + 1;
+    }
+
+private:
+    std::size_t stride_ = 0;
+    std::vector<std::uint8_t> cells_;
+};
+
+struct NoiseOctave final {
+    std::uint32_t period = 1;
+    std::uint32_t seed = 0;
+    int weight_shift = 0;
+    // Smoothstep weight for each offset within a period.
+    std::vector<std::int32_t> weights;
+};
+
+[[nodiscard]] std::vector<NoiseOctave> make_noise_octaves(
+    const MapGeneratorSettings& settings
+)
+{
+    std::vector<NoiseOctave> octaves(settings.noise_octaves);
+
+    for (std::uint32_t index = 0; index < settings.noise_octaves; ++index) {
+        NoiseOctave& octave = octaves[index];
+        octave.period = std::max(settings.noise_scale >> index, 1u);
+        octave.seed = derive_seed(settings.seed, index + 1);
+        octave.weight_shift =
+            static_cast<int>(settings.noise_octaves - 1 - index);
+        octave.weights.resize(octave.period);
+
+        for (std::uint32_t offset = 0; offset < octave.period; ++offset) {
+            const std::int64_t t =
+                (std::int64_t{offset} << kNoiseValueBits) / octave.period;
+
+            octave.weights[offset] = static_cast<std::int32_t>(
+                (t * t * (3 * kNoiseOne - 2 * t)) >> (2 * kNoiseValueBits)
+            );
+        }
+    }
+
+    return octaves;
+}
+
+[[nodiscard]] constexpr std::int32_t lattice_value(
+    const std::uint32_t seed,
+    const std::uint32_t column,
+    const std::uint32_t row
+) noexcept
+{
+    return static_cast<std::int32_t>(
+        hash_cell(seed, column, row) >> (32 - kNoiseValueBits)
+    );
+}
+
+// Sums the octaves for one row. Each octave interpolates its two lattice
+// rows once per lattice column, then sweeps each period with the weight
+// table, so the per-cell work is a multiply, a shift and an add.
+void sample_noise_row(
+    const std::span<const NoiseOctave> octaves,
+    const std::uint32_t row,
+    const std::span<std::int32_t> heights,
+    std::vector<std::int32_t>& lattice
+)
+{
+    const std::uint32_t columns = static_cast<std::uint32_t>(heights.size());
+    std::ranges::fill(heights, 0);
+
+    for (const NoiseOctave& octave : octaves) {
+        // Locals, since the int32 stores below may alias the octave.
+        const std::uint32_t period = octave.period;
+        const std::uint32_t seed = octave.seed;
+        const int weight_shift = octave.weight_shift;
+        const std::uint32_t lattice_row = row / period;
+        const std::int32_t row_weight = octave.weights[row % period];
+        const std::uint32_t lattice_count = (columns - 1) / period + 2;
+        lattice.resize(lattice_count);
+
+        for (std::uint32_t column = 0; column < lattice_count; ++column) {
+            const std::int32_t top =
+                lattice_value(seed, column, lattice_row);
+            const std::int32_t bottom =
+                lattice_value(seed, column, lattice_row + 1);
+
+            lattice[column] =
+                top + ((bottom - top) * row_weight >> kNoiseValueBits);
+        }
+
+        const std::int32_t* const weights = octave.weights.data();
+
+        for (std::uint32_t first = 0, column = 0;
+             first < columns;
+             first += period, ++column) {
+            const std::int32_t left = lattice[column];
+            const std::int32_t slope = lattice[column + 1] - left;
+            const std::uint32_t span = std::min(period, columns - first);
+            std::int32_t* const output = heights.data() + first;
+
+            for (std::uint32_t offset = 0; offset < span; ++offset) {
+                output[offset] +=
+                    (left + (slope * weights[offset] >> kNoiseValueBits))
+                    << weight_shift;
+            }
+        }
+    }
+}
+
+void generate_noise(
+    TileMap& map,
+    const MapGeneratorSettings& settings,
+    JobSystem* const jobs
+)
+{
+    const std::vector<NoiseOctave> octaves = make_noise_octaves(settings);
+    const std::uint32_t columns = map.columns();
+
+    // Thresholds scaled to the summed height range rather than each height
+    // scaled down to 16 bits.
+    const std::int64_t max_height =
+        (kNoiseOne - 1) * ((std::int64_t{1} << settings.noise_octaves) - 1);
+    const std::int32_t water_height = static_cast<std::int32_t>(
+        settings.water_height * max_height / 65'535
+    );
+    const std::int32_t wall_height = static_cast<std::int32_t>(
+        settings.wall_height * max_height / 65'535
+    );
+
+    const std::span<PackedMapTile> ground = map.layer(settings.ground_layer);
+    const std::span<PackedMapTile> walls = map.layer(settings.wall_layer);
+    const PackedMapTile ground_tile = settings.ground_tile;
+    const PackedMapTile water_tile = settings.water_tile;
+    const PackedMapTile wall_tile = settings.wall_tile;
+
+    for_each_band(
+        map.rows(),
+        jobs,
+        [&](const std::uint32_t first_row, const std::uint32_t end_row) {
+            std::vector<std::int32_t> heights(columns);
+            std::vector<std::int32_t> lattice;
+
+            for (std::uint32_t row = first_row; row < end_row; ++row) {
+                sample_noise_row(octaves, row, heights, lattice);
+
+                const std::size_t row_start =
+                    static_cast<std::size_t>(row) * columns;
+                PackedMapTile* const ground_row = ground.data() + row_start;
+                PackedMapTile* const wall_row = walls.data() + row_start;
+
+                for (std::uint32_t column = 0; column < columns; ++column) {
+                    const std::int32_t height = heights[column];
+
+                    ground_row[column] =
+                        height < water_height ? water_tile : ground_tile;
+                    wall_row[column] = height >= wall_height ? wall_tile : 0;
+                }
+            }
+        }
+    );
+}
+
+void write_solid_rows(
+    TileMap& map,
+    const MapGeneratorSettings& settings,
+    SolidGrid& solid,
+    const std::uint32_t first_row,
+    const std::uint32_t end_row
+)
+{
+    // Tiles copied out of `settings`, which the tile stores could otherwise
+    // alias and force to be reloaded every cell.
+    const std::uint32_t columns = map.columns();
+    const std::span<PackedMapTile> ground = map.layer(settings.ground_layer);
+    const std::span<PackedMapTile> walls = map.layer(settings.wall_layer);
+    const PackedMapTile ground_tile = settings.ground_tile;
+    const PackedMapTile wall_tile = settings.wall_tile;
+
+    for (std::uint32_t row = first_row; row < end_row; ++row) {
+        const std::size_t row_start = static_cast<std::size_t>(row) * columns;
+        const std::uint8_t* const solid_row = solid.row(row);
+        PackedMapTile* const wall_row = walls.data() + row_start;
+
+        std::fill_n(ground.data() + row_start, columns, ground_tile);
+
+        for (std::uint32_t column = 0; column < columns; ++column) {
+            wall_row[column] = solid_row[column] != 0 ? wall_tile : 0;
+        }
+    }
+}
+
+void generate_caves(
+    TileMap& map,
+    const MapGeneratorSettings& settings,
+    JobSystem* const jobs
+)
+{
+    const std::uint32_t columns = map.columns();
+    const std::uint32_t seed = derive_seed(settings.seed, kMaxNoiseOctaves + 1);
+    const std::uint32_t wall_percent = settings.cave_wall_percent;
+    SolidGrid current(map);
+    SolidGrid next(map);
+
+    for_each_band(
+        map.rows(),
+        jobs,
+        [&](const std::uint32_t first_row, const std::uint32_t end_row) {
+            for (std::uint32_t row = first_row; row < end_row; ++row) {
+                std::uint8_t* const solid_row = current.row(row);
+
+                for (std::uint32_t column = 0; column < columns; ++column) {
+                    solid_row[column] =
+                        hash_cell(seed, column, row) % 100 < wall_percent;
+                }
+            }
+        }
+    );
+
+    // Each step reads only the previous generation, so bands never see
+    // each other's writes.
+    for (std::uint32_t step = 0; step < settings.cave_steps; ++step) {
+        for_each_band(
+            map.rows(),
+            jobs,
+            [&](const std::uint32_t first_row, const std::uint32_t end_row) {
+                const std::size_t stride = current.stride();
+
+                for (std::uint32_t row = first_row; row < end_row; ++row) {
+                    const std::uint8_t* const middle = current.row(row) - 1;
+                    const std::uint8_t* const above = middle - stride;
+                    const std::uint8_t* const below = middle + stride;
+                    std::uint8_t* const output = next.row(row);
+
+                    for (std::uint32_t column = 0; column < columns; ++column) {
+                        const std::uint8_t wall_count = static_cast<std::uint8_t>(
+                            above[column] + above[column + 1] +
+                            above[column + 2] + middle[column] +
+                            middle[column + 1] + middle[column + 2] +
+                            below[column] + below[column + 1] +
+                            below[column + 2]
+                        );
+
+                        output[column] = wall_count >= kCaveWallCount;
+                    }
+                }
+            }
+        );
+
+        std::swap(current, next);
+    }
+
+    for_each_band(
+        map.rows(),
+        jobs,
+        [&](const std::uint32_t first_row, const std::uint32_t end_row) {
+            write_solid_rows(map, settings, current, first_row, end_row);
+        }
+    );
+}
+
+struct RoomPoint final {
+    std::uint32_t column = 0;
+    std::uint32_t row = 0;
+};
+
+struct RoomPartition final {
+    SplitMix64 random;
+    std::uint32_t min_size = 0;
+    std::uint32_t max_size = 0;
+    std::vector<MapCellRect> floors;
+};
+
+// A side for a room inside a leaf `extent` cells long, keeping a wall on
+// both sides when the leaf has room for one. Returns the room's offset
+// into the leaf and its length.
+[[nodiscard]] std::pair<std::uint32_t, std::uint32_t> place_room_side(
+    RoomPartition& partition,
+    const std::uint32_t extent
+)
+{
+    const std::uint32_t margin = extent >= 3 ? 1 : 0;
+    const std::uint32_t available = extent - margin * 2;
+    const std::uint32_t longest = std::min(partition.max_size, available);
+    const std::uint32_t length = partition.random.between(
+        std::min(partition.min_size, longest),
+        longest
+    );
+
+    return {
+        margin + partition.random.between(0, available - length),
+        length
+    };
+}
+
+[[nodiscard]] RoomPoint carve_room(
+    RoomPartition& partition,
+    const MapCellRect& leaf
+)
+{
+    const auto [column_offset, room_columns] =
+        place_room_side(partition, leaf.columns());
+    const auto [row_offset, room_rows] =
+        place_room_side(partition, leaf.rows());
+    const MapCellRect& room = partition.floors.emplace_back(MapCellRect{
+        .left = leaf.left + column_offset,
+        .top = leaf.top + row_offset,
+        .right = leaf.left + column_offset + room_columns - 1,
+        .bottom = leaf.top + row_offset + room_rows - 1
+    });
+
+    return RoomPoint{
+        .column = room.left + (room.columns() - 1) / 2,
+        .row = room.top + (room.rows() - 1) / 2
+    };
+}
+
+// An L-shaped corridor one cell wide, turning at a random elbow.
+void carve_corridor(
+    RoomPartition& partition,
+    const RoomPoint& from,
+    const RoomPoint& to
+)
+{
+    const bool across_first = (partition.random.next() & 1) != 0;
+    const RoomPoint elbow = across_first
+        ? RoomPoint{.column = to.column, .row = from.row}
+        : RoomPoint{.column = from.column, .row = to.row};
+
+    for (const auto& [start, end] : {std::pair(from, elbow), std::pair(elbow, to)}) {
+        partition.floors.push_back(MapCellRect{
+            .left = std::min(start.column, end.column),
+            .top = std::min(start.row, end.row),
+            .right = std::max(start.column, end.column),
+            .bottom = std::max(start.row, end.row)
+        });
+    }
+}
+
+// Splits `leaf` until its pieces fit a room, carving a room into every
+// piece and joining each pair of halves. Returns the centre of one of the
+// subtree's rooms for the caller's corridor to aim at.
+RoomPoint partition_rooms(RoomPartition& partition, const MapCellRect& leaf)
+{
+    const std::uint32_t min_leaf = partition.min_size + 2;
+    const bool fits_room =
+        leaf.columns() <= partition.max_size + 2 &&
+        leaf.rows() <= partition.max_size + 2;
+    const bool split_columns = leaf.columns() >= min_leaf * 2;
+    const bool split_rows = leaf.rows() >= min_leaf * 2;
+
+    if (fits_room || (!split_columns && !split_rows)) {
+        return carve_room(partition, leaf);
+    }
+
+    // Cut across the longer side so leaves stay close to square.
+    bool cut_columns = split_columns;
+
+    if (split_columns && split_rows) {
+        if (leaf.columns() * 4 > leaf.rows() * 5) {
+            cut_columns = true;
+        } else if (leaf.rows() * 4 > leaf.columns() * 5) {
+            cut_columns = false;
+        } else {
+            cut_columns = (partition.random.next() & 1) != 0;
+        }
+    }
+
+    MapCellRect first = leaf;
+    MapCellRect second = leaf;
+
+    if (cut_columns) {
+        const std::uint32_t cut = leaf.left +
+            partition.random.between(min_leaf, leaf.columns() - min_leaf);
+        first.right = cut - 1;
+        second.left = cut;
+    } else {
+        const std::uint32_t cut = leaf.top +
+            partition.random.between(min_leaf, leaf.rows() - min_leaf);
+        first.bottom = cut - 1;
+        second.top = cut;
+    }
+
+    const RoomPoint first_room = partition_rooms(partition, first);
+    const RoomPoint second_room = partition_rooms(partition, second);
+    carve_corridor(partition, first_room, second_room);
+
+    return (partition.random.next() & 1) != 0 ? first_room : second_room;
+}
+
+void generate_rooms(
+    TileMap& map,
+    const MapGeneratorSettings& settings,
+    JobSystem* const jobs
+)
+{
+    // The partition is a few draws per leaf, so it runs serially and keeps
+    // the draw order fixed; carving the floors is the part that scales with
+    // the map.
+    RoomPartition partition{
+        .random = SplitMix64(derive_seed(settings.seed, kMaxNoiseOctaves + 2)),
+        .min_size = settings.room_min_size,
+        .max_size = settings.room_max_size,
+        .floors = {}
+    };
+    (void)partition_rooms(
+        partition,
+        MapCellRect{
+            .left = 0,
+            .top = 0,
+            .right = map.columns() - 1,
+            .bottom = map.rows() - 1
+        }
+    );
+
+    const std::size_t band_count =
+        (map.rows() + kGeneratorBandRows - 1) / kGeneratorBandRows;
+    std::vector<std::vector<std::uint32_t>> band_floors(band_count);
+
+    for (std::size_t index = 0; index < partition.floors.size(); ++index) {
+        const MapCellRect& floor = partition.floors[index];
+
+        for (std::uint32_t band = floor.top / kGeneratorBandRows;
+             band <= floor.bottom / kGeneratorBandRows;
+             ++band) {
+            band_floors[band].push_back(static_cast<std::uint32_t>(index));
+        }
+    }
+
+    SolidGrid solid(map);
+
+    for_each_band(
+        map.rows(),
+        jobs,
+        [&](const std::uint32_t first_row, const std::uint32_t end_row) {
+            const std::uint32_t first_band = first_row / kGeneratorBandRows;
+            const std::uint32_t last_band = (end_row - 1) / kGeneratorBandRows;
+
+            // A floor in two of these bands is carved twice, which is
+            // harmless; rows outside the range are left to their own band.
+            for (std::uint32_t band = first_band; band <= last_band; ++band) {
+                for (const std::uint32_t index : band_floors[band]) {
+                    const MapCellRect& floor = partition.floors[index];
+                    const std::uint32_t top = std::max(floor.top, first_row);
+                    const std::uint32_t bottom =
+                        std::min(floor.bottom + 1, end_row);
+
+                    for (std::uint32_t row = top; row < bottom; ++row) {
+                        std::fill_n(
+                            solid.row(row) + floor.left,
+                            floor.columns(),
+                            std::uint8_t{0}
+                        );
+                    }
+                }
+            }
+
+            write_solid_rows(map, settings, solid, first_row, end_row);
+        }
+    );
+}
+
+void validate_settings(
+    const TileMap& map,
+    const MapGeneratorSettings& settings
+)
+{
+    if (settings.ground_layer >= map.layer_count() ||
+        settings.wall_layer >= map.layer_count()) {
+        throw std::runtime_error("Map generator layer is outside the map");
+    }
+
+    if (settings.ground_layer == settings.wall_layer) {
+        throw std::runtime_error(
+            "Map generator needs separate ground and wall layers"
+        );
+    }
+
+    if (settings.noise_scale == 0 ||
+        settings.noise_octaves == 0 ||
+        settings.noise_octaves > kMaxNoiseOctaves) {
+        throw std::runtime_error(
+            "Map generator noise needs a scale and 1 to 8 octaves"
+        );
+    }
+
+    if (settings.cave_wall_percent > 100) {
+        throw std::runtime_error("Map generator cave wall share is over 100%");
+    }
+
+    if (settings.room_min_size == 0 ||
+        settings.room_max_size < settings.room_min_size) {
+        throw std::runtime_error("Map generator room size range is invalid");
+    }
+}
+
+}
+
+void generate_map(
+    TileMap& map,
+    const MapGeneratorSettings& settings,
+    JobSystem* const jobs
+)
+{
+    validate_settings(map, settings);
+
+    if (map.cell_count() == 0) {
+        return;
+    }
+
+    switch (settings.kind) {
+        case MapGeneratorKind::Noise:
+            generate_noise(map, settings, jobs);
+            break;
+
+        case MapGeneratorKind::Caves:
+            generate_caves(map, settings, jobs);
+            break;
+
+        case MapGeneratorKind::Rooms:
+            generate_rooms(map, settings, jobs);
+            break;
+    }
+}
+
+}
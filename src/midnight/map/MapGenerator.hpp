@@ -0,0 +1,65 @@
+#pragma once
+
+#include "midnight/map/TileMap.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace midnight {
+
+class JobSystem;
+
+enum class MapGeneratorKind : std::uint8_t {
+    // Fractal value noise read as a height field: low ground floods with
+    // water and high ground becomes wall.
+    Noise,
+    // Random walls smoothed by a cellular automaton into open caverns.
+    Caves,
+    // Rooms carved into the leaves of a binary space partition, each pair
+    // of sibling subtrees joined by a corridor.
+    Rooms
+};
+
+struct MapGeneratorSettings final {
+    MapGeneratorKind kind = MapGeneratorKind::Caves;
+    std::uint64_t seed = 0;
+
+    // The generator owns these two layers and overwrites every cell of
+    // them; the ground layer gets ground or water tiles and the wall layer
+    // walls or empty cells.
+    std::size_t ground_layer = 0;
+    std::size_t wall_layer = 1;
+    PackedMapTile ground_tile = 0;
+    PackedMapTile water_tile = 0;
+    PackedMapTile wall_tile = 0;
+
+    // Noise: the largest feature size in cells, and how many octaves are
+    // summed, each half the size and weight of the one before. Heights
+    // below `water_height` or from `wall_height` up, out of 65535, become
+    // water or wall.
+    std::uint32_t noise_scale = 32;
+    std::uint32_t noise_octaves = 4;
+    std::uint16_t water_height = 20'000;
+    std::uint16_t wall_height = 44'000;
+
+    // Caves: the share of cells that start as wall, and the smoothing
+    // steps run over them. Cells past the map edge count as wall.
+    std::uint32_t cave_wall_percent = 45;
+    std::uint32_t cave_steps = 4;
+
+    // Rooms: the range of room sides in cells, walls not included.
+    std::uint32_t room_min_size = 4;
+    std::uint32_t room_max_size = 12;
+};
+
+// Generates straight into the map's layer storage, in bands of rows that
+// run on `jobs` when one is given. Every cell depends only on the settings
+// and its position, never on how the rows were split up, so a seed gives
+// the same tiles for any thread count.
+void generate_map(
+    TileMap& map,
+    const MapGeneratorSettings& settings,
+    JobSystem* jobs = nullptr
+);
+
+}
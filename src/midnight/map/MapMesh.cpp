@@ -0,0 +1,43 @@
+#include "midnight/map/MapMesh.hpp"
+
+#include <stdexcept>
+
+namespace midnight {
+
+void append_map_chunk_vertices(
+    const MapMeshLayout& layout,
+    const std::span<const PackedMapTile> tiles,
+    const std::uint32_t chunk_size,
+    const std::uint32_t first_column,
+    const std::uint32_t first_row,
+    std::vector<Vertex2D>& vertices
+)
+{
+    if (tiles.size() != static_cast<std::size_t>(chunk_size) * chunk_size) {
+        throw std::runtime_error("Map chunk block has the wrong size");
+    }
+
+    for (std::size_t cell = 0; cell < tiles.size(); ++cell) {
+        const PackedMapTile tile = tiles[cell];
+
+        if (!packed_map_tile_occupied(tile)) {
+            continue;
+        }
+
+        const MapTileVertices cell_vertices = make_map_tile_vertices(
+            layout,
+            first_column + static_cast<std::uint32_t>(cell % chunk_size),
+            first_row + static_cast<std::uint32_t>(cell / chunk_size),
+            packed_map_tile_column(tile),
+            packed_map_tile_row(tile)
+        );
+
+        vertices.insert(
+            vertices.end(),
+            cell_vertices.begin(),
+            cell_vertices.end()
+        );
+    }
+}
+
+}
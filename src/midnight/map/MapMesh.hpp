@@ -0,0 +1,140 @@
+#pragma once
+
+#include "midnight/map/TileMap.hpp"
+#include "midnight/renderer/Vertex2D.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace midnight {
+
+// Where the map canvas sits in clip space, and how the padded map atlas is
+// laid out: each cell holds one tile surrounded by `atlas_tile_padding`
+// extruded edge pixels.
+struct MapMeshLayout final {
+    float left = 0.0f;
+    float top = 0.0f;
+    float cell_width = 0.0f;
+    float cell_height = 0.0f;
+    std::uint32_t tile_width = 0;
+    std::uint32_t tile_height = 0;
+    std::uint32_t atlas_width = 0;
+    std::uint32_t atlas_height = 0;
+    std::uint32_t atlas_tile_padding = 0;
+};
+
+using MapTileVertices = std::array<Vertex2D, 4>;
+
+[[nodiscard]] constexpr MapTileVertices make_map_tile_vertices(
+    const MapMeshLayout& layout,
+    const std::uint32_t map_column,
+    const std::uint32_t map_row,
+    const std::uint32_t tileset_column,
+    const std::uint32_t tileset_row
+)
+{
+    const float left =
+        layout.left + static_cast<float>(map_column) * layout.cell_width;
+    const float top =
+        layout.top + static_cast<float>(map_row) * layout.cell_height;
+    const float right = left + layout.cell_width;
+    const float bottom = top + layout.cell_height;
+
+    const std::uint32_t atlas_left =
+        tileset_column * (layout.tile_width + layout.atlas_tile_padding * 2) +
+        layout.atlas_tile_padding;
+    const std::uint32_t atlas_top =
+        tileset_row * (layout.tile_height + layout.atlas_tile_padding * 2) +
+        layout.atlas_tile_padding;
+    const float texture_left =
+        static_cast<float>(atlas_left) /
+        static_cast<float>(layout.atlas_width);
+    const float texture_top =
+        static_cast<float>(atlas_top) /
+        static_cast<float>(layout.atlas_height);
+    const float texture_right =
+        static_cast<float>(atlas_left + layout.tile_width) /
+        static_cast<float>(layout.atlas_width);
+    const float texture_bottom =
+        static_cast<float>(atlas_top + layout.tile_height) /
+        static_cast<float>(layout.atlas_height);
+
+    return {{
+        Vertex2D{
+            left, top,
+            1.0f, 1.0f, 1.0f,
+            texture_left,
+            texture_top
+        },
+        Vertex2D{
+            right, top,
+            1.0f, 1.0f, 1.0f,
+            texture_right,
+            texture_top
+        },
+        Vertex2D{
+            right, bottom,
+            1.0f, 1.0f, 1.0f,
+            texture_right,
+            texture_bottom
+        },
+        Vertex2D{
+            left, bottom,
+            1.0f, 1.0f, 1.0f,
+            texture_left,
+            texture_bottom
+        }
+    }};
+}
+
+// Appends one quad per occupied tile of a square chunk block, as copied out
+// by TileMap::copy_block().
+void append_map_chunk_vertices(
+    const MapMeshLayout& layout,
+    std::span<const PackedMapTile> tiles,
+    std::uint32_t chunk_size,
+    std::uint32_t first_column,
+    std::uint32_t first_row,
+    std::vector<Vertex2D>& vertices
+);
+
+constexpr void append_quad_indices(
+    const std::span<std::uint16_t> indices,
+    std::size_t& next_index,
+    const std::uint16_t first_vertex
+)
+{
+    indices[next_index++] = first_vertex;
+    indices[next_index++] = first_vertex + 1;
+    indices[next_index++] = first_vertex + 2;
+    indices[next_index++] = first_vertex + 2;
+    indices[next_index++] = first_vertex + 3;
+    indices[next_index++] = first_vertex;
+}
+
+// Four quads joining an outer ring of vertices to the inner ring that
+// follows it.
+constexpr void append_outline_indices(
+    const std::span<std::uint16_t> indices,
+    std::size_t& next_index,
+    const std::uint16_t outer
+)
+{
+    const std::uint16_t inner = outer + 4;
+
+    for (std::uint16_t side = 0; side < 4; ++side) {
+        const std::uint16_t next_side = (side + 1) % 4;
+
+        indices[next_index++] = outer + side;
+        indices[next_index++] = outer + next_side;
+        indices[next_index++] = inner + next_side;
+        indices[next_index++] = inner + next_side;
+        indices[next_index++] = inner + side;
+        indices[next_index++] = outer + side;
+    }
+}
+
+}
@@ -0,0 +1,263 @@
+#include "midnight/map/MapMinimap.hpp"
+
+#include "midnight/core/JobSystem.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace midnight {
+namespace {
+
+constexpr std::size_t kBytesPerTexel = RgbaImage::bytes_per_pixel;
+constexpr std::size_t kRefreshRowsPerJob = 16;
+
+[[nodiscard]] constexpr std::uint32_t blend_channel(
+    const std::uint32_t below,
+    const std::uint32_t above,
+    const std::uint32_t alpha
+) noexcept
+{
+    return (below * (255 - alpha) + above * alpha + 127) / 255;
+}
+
+}
+
+MapMinimap::MapMinimap(const CreateInfo& create_info)
+    : columns_(create_info.columns),
+      rows_(create_info.rows),
+      cells_per_texel_(cells_per_texel(
+          create_info.columns,
+          create_info.rows,
+          std::max(create_info.max_extent, 1u)
+      )),
+      width_((columns_ + cells_per_texel_ - 1) / cells_per_texel_),
+      height_((rows_ + cells_per_texel_ - 1) / cells_per_texel_),
+      background_(create_info.background),
+      pixels_(static_cast<std::size_t>(width_) * height_ * kBytesPerTexel),
+      texel_dirty_(static_cast<std::size_t>(width_) * height_, 0)
+{
+}
+
+std::uint32_t MapMinimap::width() const noexcept
+{
+    return width_;
+}
+
+std::uint32_t MapMinimap::height() const noexcept
+{
+    return height_;
+}
+
+std::uint32_t MapMinimap::cells_per_texel() const noexcept
+{
+    return cells_per_texel_;
+}
+
+std::span<const std::uint8_t> MapMinimap::pixels() const noexcept
+{
+    return pixels_;
+}
+
+void MapMinimap::set_tile_colors(RgbaImage tile_colors)
+{
+    if (tile_colors.pixels.size() !=
+        static_cast<std::size_t>(tile_colors.width) *
+            tile_colors.height * kBytesPerTexel) {
+        throw std::runtime_error(
+            "Minimap tile colours do not match their dimensions"
+        );
+    }
+
+    tile_colors_ = std::move(tile_colors);
+    mark_all_dirty();
+}
+
+void MapMinimap::mark_cell_dirty(
+    const std::uint32_t column,
+    const std::uint32_t row
+)
+{
+    if (all_dirty_) {
+        return;
+    }
+
+    const std::size_t texel =
+        static_cast<std::size_t>(row / cells_per_texel_) * width_ +
+        column / cells_per_texel_;
+
+    if (texel_dirty_[texel] == 0) {
+        texel_dirty_[texel] = 1;
+        dirty_texels_.push_back(static_cast<std::uint32_t>(texel));
+    }
+}
+
+void MapMinimap::mark_all_dirty() noexcept
+{
+    all_dirty_ = true;
+}
+
+std::optional<MapCellRect> MapMinimap::refresh(
+    const TileMap& map,
+    JobSystem* const jobs
+)
+{
+    if (map.columns() != columns_ || map.rows() != rows_) {
+        throw std::runtime_error("Minimap and map sizes differ");
+    }
+
+    std::vector<std::span<const PackedMapTile>> layers;
+    layers.reserve(map.layer_count());
+
+    for (std::size_t layer = 0; layer < map.layer_count(); ++layer) {
+        layers.push_back(map.layer(layer));
+    }
+
+    if (all_dirty_) {
+        all_dirty_ = false;
+        std::ranges::fill(texel_dirty_, std::uint8_t{0});
+        dirty_texels_.clear();
+
+        if (width_ == 0 || height_ == 0) {
+            return std::nullopt;
+        }
+
+        const auto refresh_rows = [&](
+            const std::size_t first_row,
+            const std::size_t end_row
+        ) {
+            for (std::size_t y = first_row; y < end_row; ++y) {
+                for (std::uint32_t x = 0; x < width_; ++x) {
+                    refresh_texel(layers, x, static_cast<std::uint32_t>(y));
+                }
+            }
+        };
+
+        if (jobs != nullptr) {
+            jobs->parallel_for(height_, kRefreshRowsPerJob, refresh_rows);
+        } else {
+            refresh_rows(0, height_);
+        }
+
+        return MapCellRect{
+            .left = 0,
+            .top = 0,
+            .right = width_ - 1,
+            .bottom = height_ - 1
+        };
+    }
+
+    if (dirty_texels_.empty()) {
+        return std::nullopt;
+    }
+
+    MapCellRect bounds{
+        .left = std::numeric_limits<std::uint32_t>::max(),
+        .top = std::numeric_limits<std::uint32_t>::max(),
+        .right = 0,
+        .bottom = 0
+    };
+
+    for (const std::uint32_t texel : dirty_texels_) {
+        const std::uint32_t x = texel % width_;
+        const std::uint32_t y = texel / width_;
+
+        refresh_texel(layers, x, y);
+        texel_dirty_[texel] = 0;
+
+        bounds.left = std::min(bounds.left, x);
+        bounds.top = std::min(bounds.top, y);
+        bounds.right = std::max(bounds.right, x);
+        bounds.bottom = std::max(bounds.bottom, y);
+    }
+
+    dirty_texels_.clear();
+
+    return bounds;
+}
+
+void MapMinimap::refresh_texel(
+    const std::span<const std::span<const PackedMapTile>> layers,
+    const std::uint32_t x,
+    const std::uint32_t y
+)
+{
+    const std::uint32_t first_column = x * cells_per_texel_;
+    const std::uint32_t first_row = y * cells_per_texel_;
+    const std::uint32_t end_column =
+        std::min(first_column + cells_per_texel_, columns_);
+    const std::uint32_t end_row =
+        std::min(first_row + cells_per_texel_, rows_);
+
+    std::array<std::uint32_t, 3> sum{};
+
+    for (std::uint32_t row = first_row; row < end_row; ++row) {
+        for (std::uint32_t column = first_column;
+             column < end_column;
+             ++column) {
+            const std::size_t cell =
+                static_cast<std::size_t>(row) * columns_ + column;
+            std::array<std::uint32_t, 3> color{
+                background_[0],
+                background_[1],
+                background_[2]
+            };
+
+            for (const std::span<const PackedMapTile> layer : layers) {
+                const PackedMapTile tile = layer[cell];
+
+                if (!packed_map_tile_occupied(tile) ||
+                    packed_map_tile_column(tile) >= tile_colors_.width ||
+                    packed_map_tile_row(tile) >= tile_colors_.height) {
+                    continue;
+                }
+
+                const std::uint8_t* const tile_color =
+                    tile_colors_.pixels.data() + (
+                        static_cast<std::size_t>(packed_map_tile_row(tile)) *
+                            tile_colors_.width +
+                        packed_map_tile_column(tile)
+                    ) * kBytesPerTexel;
+
+                // Most tiles are fully opaque or fully clear, and those
+                // need no division.
+                if (tile_color[3] == 255) {
+                    color = {tile_color[0], tile_color[1], tile_color[2]};
+                    continue;
+                }
+
+                if (tile_color[3] == 0) {
+                    continue;
+                }
+
+                for (std::size_t channel = 0; channel < 3; ++channel) {
+                    color[channel] = blend_channel(
+                        color[channel],
+                        tile_color[channel],
+                        tile_color[3]
+                    );
+                }
+            }
+
+            for (std::size_t channel = 0; channel < 3; ++channel) {
+                sum[channel] += color[channel];
+            }
+        }
+    }
+
+    const std::uint32_t cell_count =
+        (end_column - first_column) * (end_row - first_row);
+    std::uint8_t* const texel = pixels_.data() +
+        (static_cast<std::size_t>(y) * width_ + x) * kBytesPerTexel;
+
+    for (std::size_t channel = 0; channel < 3; ++channel) {
+        texel[channel] = static_cast<std::uint8_t>(
+            (sum[channel] + cell_count / 2) / cell_count
+        );
+    }
+
+    texel[3] = background_[3];
+}
+
+}
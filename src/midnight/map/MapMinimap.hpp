@@ -0,0 +1,94 @@
+#pragma once
+
+#include "midnight/assets/RgbaImage.hpp"
+#include "midnight/map/TileMap.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace midnight {
+
+class JobSystem;
+
+// A colour overview of a tile map, small enough to upload as one texture.
+// Each RGBA8 texel covers a square block of cells and holds the average of
+// their colours; a cell's colour is its tiles' average colours blended
+// bottom layer first over the background. Edits only mark cells, and
+// refresh() recomputes just the texels they fall in.
+class MapMinimap final {
+public:
+    struct CreateInfo final {
+        std::uint32_t columns = 0;
+        std::uint32_t rows = 0;
+        // The larger side of the image in texels. Maps that fit get one
+        // texel per cell.
+        std::uint32_t max_extent = 256;
+        std::array<std::uint8_t, 4> background{0, 0, 0, 255};
+    };
+
+    [[nodiscard]] static constexpr std::uint32_t cells_per_texel(
+        const std::uint32_t columns,
+        const std::uint32_t rows,
+        const std::uint32_t max_extent
+    ) noexcept
+    {
+        const std::uint32_t longest = columns > rows ? columns : rows;
+        return longest > max_extent
+            ? (longest + max_extent - 1) / max_extent
+            : 1;
+    }
+
+    explicit MapMinimap(const CreateInfo& create_info);
+
+    MapMinimap(const MapMinimap&) = delete;
+    MapMinimap& operator=(const MapMinimap&) = delete;
+
+    MapMinimap(MapMinimap&&) = delete;
+    MapMinimap& operator=(MapMinimap&&) = delete;
+
+    [[nodiscard]] std::uint32_t width() const noexcept;
+    [[nodiscard]] std::uint32_t height() const noexcept;
+    [[nodiscard]] std::uint32_t cells_per_texel() const noexcept;
+    [[nodiscard]] std::span<const std::uint8_t> pixels() const noexcept;
+
+    // One texel per atlas tile, as average_atlas_tile_colors() builds.
+    // Tiles outside it draw as empty. Marks every texel dirty.
+    void set_tile_colors(RgbaImage tile_colors);
+
+    void mark_cell_dirty(std::uint32_t column, std::uint32_t row);
+    void mark_all_dirty() noexcept;
+
+    // Recomputes the dirty texels from `map`, which must have the
+    // minimap's size, and returns the texel rectangle covering them, or
+    // nothing when no cell was marked. A full refresh runs on `jobs` by
+    // rows of texels when one is given.
+    std::optional<MapCellRect> refresh(
+        const TileMap& map,
+        JobSystem* jobs = nullptr
+    );
+
+private:
+    void refresh_texel(
+        std::span<const std::span<const PackedMapTile>> layers,
+        std::uint32_t x,
+        std::uint32_t y
+    );
+
+    std::uint32_t columns_ = 0;
+    std::uint32_t rows_ = 0;
+    std::uint32_t cells_per_texel_ = 1;
+    std::uint32_t width_ = 0;
+    std::uint32_t height_ = 0;
+    std::array<std::uint8_t, 4> background_{};
+    RgbaImage tile_colors_;
+    std::vector<std::uint8_t> pixels_;
+    std::vector<std::uint8_t> texel_dirty_;
+    std::vector<std::uint32_t> dirty_texels_;
+    bool all_dirty_ = true;
+};
+
+}
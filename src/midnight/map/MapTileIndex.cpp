@@ -0,0 +1,571 @@
+#include "midnight/map/MapTileIndex.hpp"
+
+#include "midnight/core/JobSystem.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <stdexcept>
+
+namespace midnight {
+namespace {
+
+constexpr std::size_t kRebuildChunksPerJob = 64;
+constexpr std::size_t kReplaceChunksPerJob = 16;
+
+// Walking a quarter of every cell one change at a time costs more than
+// indexing the map again in parallel.
+constexpr std::size_t kRebuildChangeFraction = 4;
+
+}
+
+MapTileIndex::MapTileIndex(const TileMap& map, JobSystem* const jobs)
+{
+    rebuild(map, jobs);
+}
+
+void MapTileIndex::rebuild(const TileMap& map, JobSystem* const jobs)
+{
+    columns_ = map.columns();
+    rows_ = map.rows();
+    layer_count_ = map.layer_count();
+    chunk_columns_ = (columns_ + kChunkSize - 1) / kChunkSize;
+    chunks_per_layer_ =
+        static_cast<std::size_t>(chunk_columns_) *
+        ((rows_ + kChunkSize - 1) / kChunkSize);
+    chunks_.assign(chunks_per_layer_ * layer_count_, {});
+    tiles_.clear();
+    tile_slots_.clear();
+
+    if (chunks_.empty()) {
+        return;
+    }
+
+    std::vector<std::span<const PackedMapTile>> layers;
+    layers.reserve(layer_count_);
+
+    for (std::size_t layer = 0; layer < layer_count_; ++layer) {
+        layers.push_back(map.layer(layer));
+    }
+
+    // Chunks are filled independently; tile slots are handed out afterwards
+    // in chunk order so they do not depend on how the work was split.
+    const auto index_chunks = [&](
+        const std::size_t first_chunk,
+        const std::size_t end_chunk
+    ) {
+        for (std::size_t chunk = first_chunk; chunk < end_chunk; ++chunk) {
+            const std::span<const PackedMapTile> tiles =
+                layers[chunk / chunks_per_layer_];
+            const std::size_t layer_chunk = chunk % chunks_per_layer_;
+            const std::uint32_t first_column =
+                static_cast<std::uint32_t>(layer_chunk % chunk_columns_) *
+                kChunkSize;
+            const std::uint32_t first_row =
+                static_cast<std::uint32_t>(layer_chunk / chunk_columns_) *
+                kChunkSize;
+            const std::uint32_t end_column =
+                std::min(first_column + kChunkSize, columns_);
+            const std::uint32_t end_row =
+                std::min(first_row + kChunkSize, rows_);
+            std::vector<ChunkTile>& entries = chunks_[chunk];
+            std::size_t entry = 0;
+
+            for (std::uint32_t row = first_row; row < end_row; ++row) {
+                for (std::uint32_t column = first_column;
+                     column < end_column;
+                     ++column) {
+                    const PackedMapTile tile =
+                        tiles[static_cast<std::size_t>(row) * columns_ + column];
+
+                    if (!packed_map_tile_occupied(tile)) {
+                        continue;
+                    }
+
+                    // Neighbouring cells usually repeat a tile, so the last
+                    // entry is checked before searching.
+                    if (entry >= entries.size() || entries[entry].tile != tile) {
+                        entry = static_cast<std::size_t>(
+                            std::ranges::find(entries, tile, &ChunkTile::tile) -
+                            entries.begin()
+                        );
+
+                        if (entry == entries.size()) {
+                            entries.push_back(ChunkTile{.tile = tile});
+                        }
+                    }
+
+                    const std::uint32_t bit =
+                        (row - first_row) * kChunkSize + column - first_column;
+
+                    ++entries[entry].count;
+                    entries[entry].cells[bit / 64] |= std::uint64_t{1} << (bit % 64);
+                }
+            }
+        }
+    };
+
+    if (jobs != nullptr) {
+        jobs->parallel_for(chunks_.size(), kRebuildChunksPerJob, index_chunks);
+    } else {
+        index_chunks(0, chunks_.size());
+    }
+
+    for (std::size_t chunk = 0; chunk < chunks_.size(); ++chunk) {
+        for (ChunkTile& entry : chunks_[chunk]) {
+            entry.slot = slot_for(entry.tile);
+            tiles_[entry.slot].count += entry.count;
+            set_chunk_bit(entry.slot, chunk, true);
+        }
+    }
+}
+
+void MapTileIndex::apply_changes(
+    const TileMap& map,
+    const std::span<const MapCellChange> changes,
+    JobSystem* const jobs
+)
+{
+    update(map, changes, false, jobs);
+}
+
+void MapTileIndex::revert_changes(
+    const TileMap& map,
+    const std::span<const MapCellChange> changes,
+    JobSystem* const jobs
+)
+{
+    update(map, changes, true, jobs);
+}
+
+std::uint64_t MapTileIndex::count(const PackedMapTile tile) const
+{
+    const TileUsage* const tile_usage = find_tile(tile);
+    return tile_usage != nullptr ? tile_usage->count : 0;
+}
+
+std::vector<MapTileUsage> MapTileIndex::usage() const
+{
+    std::vector<MapTileUsage> result;
+
+    for (const TileUsage& tile_usage : tiles_) {
+        if (tile_usage.count != 0) {
+            result.push_back(MapTileUsage{
+                .tile = tile_usage.tile,
+                .count = tile_usage.count
+            });
+        }
+    }
+
+    std::ranges::sort(result, {}, &MapTileUsage::tile);
+
+    return result;
+}
+
+std::size_t MapTileIndex::find(
+    const PackedMapTile tile,
+    const std::size_t layer,
+    std::vector<std::uint32_t>& cells
+) const
+{
+    if (layer >= layer_count_) {
+        throw std::runtime_error("Tile index layer is out of range");
+    }
+
+    const TileUsage* const tile_usage = find_tile(tile);
+
+    if (tile_usage == nullptr) {
+        return 0;
+    }
+
+    const std::size_t first_cell = cells.size();
+
+    for (const std::size_t chunk : layer_chunks(*tile_usage, layer)) {
+        const ChunkTile& entry =
+            *std::ranges::find(chunks_[chunk], tile, &ChunkTile::tile);
+
+        for (std::size_t word = 0; word < kChunkBitmapWords; ++word) {
+            for (std::uint64_t bits = entry.cells[word];
+                 bits != 0;
+                 bits &= bits - 1) {
+                cells.push_back(chunk_cell(
+                    chunk,
+                    static_cast<std::uint32_t>(
+                        word * 64 + static_cast<std::size_t>(std::countr_zero(bits))
+                    )
+                ));
+            }
+        }
+    }
+
+    return cells.size() - first_cell;
+}
+
+std::size_t MapTileIndex::replace(
+    TileMap& map,
+    const std::size_t layer,
+    const PackedMapTile tile,
+    const PackedMapTile replacement,
+    std::vector<MapCellChange>& changes,
+    JobSystem* const jobs
+)
+{
+    if (map.columns() != columns_ ||
+        map.rows() != rows_ ||
+        map.layer_count() != layer_count_) {
+        throw std::runtime_error("Tile index and map sizes differ");
+    }
+
+    if (layer >= layer_count_) {
+        throw std::runtime_error("Tile index layer is out of range");
+    }
+
+    if (!packed_map_tile_occupied(tile)) {
+        throw std::runtime_error("Only placed tiles can be replaced by index");
+    }
+
+    const TileUsage* const tile_usage = find_tile(tile);
+
+    if (replacement == tile || tile_usage == nullptr) {
+        return 0;
+    }
+
+    const std::vector<std::size_t> chunks = layer_chunks(*tile_usage, layer);
+    std::vector<const ChunkTile*> sources(chunks.size());
+
+    for (std::size_t index = 0; index < chunks.size(); ++index) {
+        sources[index] =
+            &*std::ranges::find(chunks_[chunks[index]], tile, &ChunkTile::tile);
+    }
+
+    // Changes are laid out row-major over the layer, so committing them does
+    // not have to sort millions of changes: every row of a chunk gets an
+    // offset after the same row of the chunks to its left, and a band of
+    // chunks starts after the band above it. The chunks are in ascending
+    // order, so each band is a contiguous run of them.
+    std::vector<std::size_t> row_offsets(chunks.size() * kChunkSize);
+    std::size_t next_offset = changes.size();
+
+    for (std::size_t first_index = 0; first_index < chunks.size();) {
+        const std::size_t band =
+            chunks[first_index] % chunks_per_layer_ / chunk_columns_;
+        std::size_t end_index = first_index + 1;
+
+        while (end_index < chunks.size() &&
+               chunks[end_index] % chunks_per_layer_ / chunk_columns_ == band) {
+            ++end_index;
+        }
+
+        for (std::uint32_t chunk_row = 0; chunk_row < kChunkSize; ++chunk_row) {
+            for (std::size_t index = first_index; index < end_index; ++index) {
+                row_offsets[index * kChunkSize + chunk_row] = next_offset;
+                next_offset += static_cast<std::size_t>(
+                    std::popcount(row_bits(*sources[index], chunk_row))
+                );
+            }
+        }
+
+        first_index = end_index;
+    }
+
+    const std::size_t first_change = changes.size();
+
+    if (next_offset == first_change) {
+        return 0;
+    }
+
+    changes.resize(next_offset);
+
+    const std::span<PackedMapTile> tiles = map.layer(layer);
+    const auto replace_chunks = [&](
+        const std::size_t first_index,
+        const std::size_t end_index
+    ) {
+        for (std::size_t index = first_index; index < end_index; ++index) {
+            const std::size_t chunk = chunks[index];
+
+            for (std::uint32_t chunk_row = 0; chunk_row < kChunkSize; ++chunk_row) {
+                std::size_t next_change =
+                    row_offsets[index * kChunkSize + chunk_row];
+
+                for (std::uint64_t bits = row_bits(*sources[index], chunk_row);
+                     bits != 0;
+                     bits &= bits - 1) {
+                    const std::uint32_t cell = chunk_cell(
+                        chunk,
+                        chunk_row * kChunkSize +
+                            static_cast<std::uint32_t>(std::countr_zero(bits))
+                    );
+
+                    tiles[cell] = replacement;
+                    changes[next_change++] = MapCellChange{
+                        .layer = static_cast<std::uint32_t>(layer),
+                        .cell = cell,
+                        .before = tile,
+                        .after = replacement
+                    };
+                }
+            }
+        }
+    };
+
+    if (jobs != nullptr) {
+        jobs->parallel_for(chunks.size(), kReplaceChunksPerJob, replace_chunks);
+    } else {
+        replace_chunks(0, chunks.size());
+    }
+
+    // The replaced cells keep their bitmaps; each chunk's entry is folded
+    // into the replacement's instead of being updated cell by cell.
+    const std::uint32_t slot = tile_slots_.at(tile);
+    const bool placed = packed_map_tile_occupied(replacement);
+    const std::uint32_t replacement_slot = placed ? slot_for(replacement) : 0;
+
+    for (const std::size_t chunk : chunks) {
+        std::vector<ChunkTile>& entries = chunks_[chunk];
+        const auto replaced =
+            std::ranges::find(entries, tile, &ChunkTile::tile);
+        const ChunkTile moved = *replaced;
+
+        *replaced = entries.back();
+        entries.pop_back();
+        tiles_[slot].count -= moved.count;
+        set_chunk_bit(slot, chunk, false);
+
+        if (!placed) {
+            continue;
+        }
+
+        auto target = std::ranges::find(entries, replacement, &ChunkTile::tile);
+
+        if (target == entries.end()) {
+            entries.push_back(ChunkTile{
+                .tile = replacement,
+                .slot = replacement_slot
+            });
+            set_chunk_bit(replacement_slot, chunk, true);
+            target = std::prev(entries.end());
+        }
+
+        target->count += moved.count;
+
+        for (std::size_t word = 0; word < kChunkBitmapWords; ++word) {
+            target->cells[word] |= moved.cells[word];
+        }
+
+        tiles_[replacement_slot].count += moved.count;
+    }
+
+    return next_offset - first_change;
+}
+
+void MapTileIndex::update(
+    const TileMap& map,
+    const std::span<const MapCellChange> changes,
+    const bool revert,
+    JobSystem* const jobs
+)
+{
+    if (map.columns() != columns_ ||
+        map.rows() != rows_ ||
+        map.layer_count() != layer_count_) {
+        throw std::runtime_error("Tile index and map sizes differ");
+    }
+
+    if (changes.size() >=
+        map.cell_count() * layer_count_ / kRebuildChangeFraction) {
+        rebuild(map, jobs);
+        return;
+    }
+
+    const auto update_cell = [this](
+        const MapCellChange& change,
+        const PackedMapTile from,
+        const PackedMapTile to
+    ) {
+        if (from == to) {
+            return;
+        }
+
+        if (packed_map_tile_occupied(from)) {
+            remove(change.layer, change.cell, from);
+        }
+
+        if (packed_map_tile_occupied(to)) {
+            add(change.layer, change.cell, to);
+        }
+    };
+
+    // A session can change a cell more than once, so reverting walks the
+    // changes backwards like revert_map_changes().
+    if (revert) {
+        for (auto change = changes.rbegin(); change != changes.rend(); ++change) {
+            update_cell(*change, change->after, change->before);
+        }
+    } else {
+        for (const MapCellChange& change : changes) {
+            update_cell(change, change.before, change.after);
+        }
+    }
+}
+
+void MapTileIndex::add(
+    const std::uint32_t layer,
+    const std::uint32_t cell,
+    const PackedMapTile tile
+)
+{
+    const auto [chunk, bit] = locate(layer, cell);
+    std::vector<ChunkTile>& entries = chunks_[chunk];
+    auto entry = std::ranges::find(entries, tile, &ChunkTile::tile);
+
+    if (entry == entries.end()) {
+        const std::uint32_t slot = slot_for(tile);
+
+        entries.push_back(ChunkTile{.tile = tile, .slot = slot});
+        set_chunk_bit(slot, chunk, true);
+        entry = std::prev(entries.end());
+    }
+
+    ++entry->count;
+    entry->cells[bit / 64] |= std::uint64_t{1} << (bit % 64);
+    ++tiles_[entry->slot].count;
+}
+
+void MapTileIndex::remove(
+    const std::uint32_t layer,
+    const std::uint32_t cell,
+    const PackedMapTile tile
+)
+{
+    const auto [chunk, bit] = locate(layer, cell);
+    const std::uint64_t mask = std::uint64_t{1} << (bit % 64);
+    std::vector<ChunkTile>& entries = chunks_[chunk];
+    const auto entry = std::ranges::find(entries, tile, &ChunkTile::tile);
+
+    if (entry == entries.end() || (entry->cells[bit / 64] & mask) == 0) {
+        throw std::runtime_error("Tile index does not match the map");
+    }
+
+    entry->cells[bit / 64] &= ~mask;
+    --tiles_[entry->slot].count;
+
+    if (--entry->count == 0) {
+        set_chunk_bit(entry->slot, chunk, false);
+        *entry = entries.back();
+        entries.pop_back();
+    }
+}
+
+MapTileIndex::CellLocation MapTileIndex::locate(
+    const std::uint32_t layer,
+    const std::uint32_t cell
+) const noexcept
+{
+    const std::uint32_t column = cell % columns_;
+    const std::uint32_t row = cell / columns_;
+
+    return CellLocation{
+        .chunk = layer * chunks_per_layer_ +
+            static_cast<std::size_t>(row / kChunkSize) * chunk_columns_ +
+            column / kChunkSize,
+        .bit = (row % kChunkSize) * kChunkSize + column % kChunkSize
+    };
+}
+
+std::uint64_t MapTileIndex::row_bits(
+    const ChunkTile& entry,
+    const std::uint32_t chunk_row
+) noexcept
+{
+    const std::uint32_t bit = chunk_row * kChunkSize;
+    return (entry.cells[bit / 64] >> (bit % 64)) & kChunkRowMask;
+}
+
+std::uint32_t MapTileIndex::chunk_cell(
+    const std::size_t chunk,
+    const std::uint32_t bit
+) const noexcept
+{
+    const std::size_t layer_chunk = chunk % chunks_per_layer_;
+    const std::uint32_t column =
+        static_cast<std::uint32_t>(layer_chunk % chunk_columns_) * kChunkSize +
+        bit % kChunkSize;
+    const std::uint32_t row =
+        static_cast<std::uint32_t>(layer_chunk / chunk_columns_) * kChunkSize +
+        bit / kChunkSize;
+
+    return row * columns_ + column;
+}
+
+std::vector<std::size_t> MapTileIndex::layer_chunks(
+    const TileUsage& tile_usage,
+    const std::size_t layer
+) const
+{
+    const std::size_t first_chunk = layer * chunks_per_layer_;
+    const std::size_t end_chunk = first_chunk + chunks_per_layer_;
+    std::vector<std::size_t> chunks;
+
+    for (std::size_t word = first_chunk / 64; word * 64 < end_chunk; ++word) {
+        for (std::uint64_t bits = tile_usage.chunks[word];
+             bits != 0;
+             bits &= bits - 1) {
+            const std::size_t chunk =
+                word * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+
+            if (chunk >= end_chunk) {
+                break;
+            }
+
+            if (chunk >= first_chunk) {
+                chunks.push_back(chunk);
+            }
+        }
+    }
+
+    return chunks;
+}
+
+const MapTileIndex::TileUsage* MapTileIndex::find_tile(
+    const PackedMapTile tile
+) const
+{
+    const auto slot = tile_slots_.find(tile);
+    return slot != tile_slots_.end() ? &tiles_[slot->second] : nullptr;
+}
+
+std::uint32_t MapTileIndex::slot_for(const PackedMapTile tile)
+{
+    const auto [slot, inserted] = tile_slots_.try_emplace(
+        tile,
+        static_cast<std::uint32_t>(tiles_.size())
+    );
+
+    if (inserted) {
+        tiles_.push_back(TileUsage{
+            .tile = tile,
+            .count = 0,
+            .chunks = std::vector<std::uint64_t>((chunks_.size() + 63) / 64)
+        });
+    }
+
+    return slot->second;
+}
+
+void MapTileIndex::set_chunk_bit(
+    const std::uint32_t slot,
+    const std::size_t chunk,
+    const bool present
+)
+{
+    const std::uint64_t mask = std::uint64_t{1} << (chunk % 64);
+
+    if (present) {
+        tiles_[slot].chunks[chunk / 64] |= mask;
+    } else {
+        tiles_[slot].chunks[chunk / 64] &= ~mask;
+    }
+}
+
+}
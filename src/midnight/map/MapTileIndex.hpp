@@ -0,0 +1,154 @@
+#pragma once
+
+#include "midnight/map/MapEditing.hpp"
+#include "midnight/map/TileMap.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace midnight {
+
+class JobSystem;
+
+struct MapTileUsage final {
+    PackedMapTile tile = 0;
+    std::uint64_t count = 0;
+
+    bool operator==(const MapTileUsage&) const = default;
+};
+
+// Where each atlas tile is used, kept current from the changes edits
+// return. Every layer is split into square chunks; a chunk lists the tiles
+// in it with a count and a bitmap of their cells, and a tile keeps a bitmap
+// of the chunks it appears in, so finding or replacing a tile visits only
+// the chunks that hold it. Empty cells are not indexed.
+class MapTileIndex final {
+public:
+    static constexpr std::uint32_t kChunkSize = 16;
+
+    explicit MapTileIndex(const TileMap& map, JobSystem* jobs = nullptr);
+
+    MapTileIndex(const MapTileIndex&) = delete;
+    MapTileIndex& operator=(const MapTileIndex&) = delete;
+
+    MapTileIndex(MapTileIndex&&) = delete;
+    MapTileIndex& operator=(MapTileIndex&&) = delete;
+
+    // Indexes `map` from scratch, by chunk on `jobs` when one is given.
+    void rebuild(const TileMap& map, JobSystem* jobs = nullptr);
+
+    // `map` must already hold the changes' `after` tiles, or their `before`
+    // tiles when reverting. Change sets covering a large share of the map
+    // rebuild the index instead.
+    void apply_changes(
+        const TileMap& map,
+        std::span<const MapCellChange> changes,
+        JobSystem* jobs = nullptr
+    );
+    void revert_changes(
+        const TileMap& map,
+        std::span<const MapCellChange> changes,
+        JobSystem* jobs = nullptr
+    );
+
+    [[nodiscard]] std::uint64_t count(PackedMapTile tile) const;
+
+    // Every tile on the map with its cell count over all layers, ordered by
+    // packed value. Atlas tiles missing from it are unused.
+    [[nodiscard]] std::vector<MapTileUsage> usage() const;
+
+    // Appends the cells of `layer` holding `tile`, chunk by chunk and
+    // row-major within a chunk. Returns the number of cells appended.
+    std::size_t find(
+        PackedMapTile tile,
+        std::size_t layer,
+        std::vector<std::uint32_t>& cells
+    ) const;
+
+    // Writes `replacement` over every `tile` on `layer` of `map`, which must
+    // be the indexed map, and updates the index chunk by chunk instead of
+    // cell by cell. Chunks are written in parallel on `jobs` when one is
+    // given; the changes are appended in row-major order.
+    // Returns the number of cells changed.
+    std::size_t replace(
+        TileMap& map,
+        std::size_t layer,
+        PackedMapTile tile,
+        PackedMapTile replacement,
+        std::vector<MapCellChange>& changes,
+        JobSystem* jobs = nullptr
+    );
+
+private:
+    static constexpr std::size_t kChunkCellCount =
+        static_cast<std::size_t>(kChunkSize) * kChunkSize;
+    static constexpr std::size_t kChunkBitmapWords = kChunkCellCount / 64;
+
+    static constexpr std::uint64_t kChunkRowMask =
+        (std::uint64_t{1} << kChunkSize) - 1;
+
+    static_assert(kChunkCellCount % 64 == 0 && 64 % kChunkSize == 0);
+
+    struct ChunkTile final {
+        PackedMapTile tile = 0;
+        std::uint32_t slot = 0;
+        std::uint32_t count = 0;
+        std::array<std::uint64_t, kChunkBitmapWords> cells{};
+    };
+
+    struct TileUsage final {
+        PackedMapTile tile = 0;
+        std::uint64_t count = 0;
+        // One bit per chunk of every layer, in the order of chunks_.
+        std::vector<std::uint64_t> chunks;
+    };
+
+    struct CellLocation final {
+        std::size_t chunk = 0;
+        std::uint32_t bit = 0;
+    };
+
+    void update(
+        const TileMap& map,
+        std::span<const MapCellChange> changes,
+        bool revert,
+        JobSystem* jobs
+    );
+    void add(std::uint32_t layer, std::uint32_t cell, PackedMapTile tile);
+    void remove(std::uint32_t layer, std::uint32_t cell, PackedMapTile tile);
+
+    [[nodiscard]] CellLocation locate(
+        std::uint32_t layer,
+        std::uint32_t cell
+    ) const noexcept;
+    [[nodiscard]] static std::uint64_t row_bits(
+        const ChunkTile& entry,
+        std::uint32_t chunk_row
+    ) noexcept;
+    [[nodiscard]] std::uint32_t chunk_cell(
+        std::size_t chunk,
+        std::uint32_t bit
+    ) const noexcept;
+    [[nodiscard]] std::vector<std::size_t> layer_chunks(
+        const TileUsage& tile_usage,
+        std::size_t layer
+    ) const;
+    [[nodiscard]] const TileUsage* find_tile(PackedMapTile tile) const;
+    [[nodiscard]] std::uint32_t slot_for(PackedMapTile tile);
+    void set_chunk_bit(std::uint32_t slot, std::size_t chunk, bool present);
+
+    std::uint32_t columns_ = 0;
+    std::uint32_t rows_ = 0;
+    std::size_t layer_count_ = 0;
+    std::uint32_t chunk_columns_ = 0;
+    std::size_t chunks_per_layer_ = 0;
+    std::vector<std::vector<ChunkTile>> chunks_;
+    std::vector<TileUsage> tiles_;
+    std::unordered_map<PackedMapTile, std::uint32_t> tile_slots_;
+};
+
+}
@@ -0,0 +1,554 @@
+#include "midnight/map/MapTileSpans.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <initializer_list>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MIDNIGHT_MAP_TILE_SPANS_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define MIDNIGHT_MAP_TILE_SPANS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace midnight {
+namespace {
+
+// The blends select on each lane's sign bit, which is the occupied flag.
+static_assert(kPackedMapTileOccupied == 0x8000'0000u);
+
+struct SpanKernels final {
+    MapTileSpanKernels kind = MapTileSpanKernels::Scalar;
+    void (*fill)(PackedMapTile*, std::size_t, PackedMapTile) noexcept = nullptr;
+    std::size_t (*find_difference)(
+        const PackedMapTile*,
+        const PackedMapTile*,
+        std::size_t
+    ) noexcept = nullptr;
+    std::size_t (*find_tile_difference)(
+        const PackedMapTile*,
+        std::size_t,
+        PackedMapTile
+    ) noexcept = nullptr;
+    void (*blend)(PackedMapTile*, const PackedMapTile*, std::size_t) noexcept =
+        nullptr;
+};
+
+void fill_scalar(
+    PackedMapTile* const tiles,
+    const std::size_t count,
+    const PackedMapTile tile
+) noexcept
+{
+    std::fill_n(tiles, count, tile);
+}
+
+std::size_t find_difference_scalar(
+    const PackedMapTile* const first,
+    const PackedMapTile* const second,
+    const std::size_t count
+) noexcept
+{
+    std::size_t index = 0;
+
+    while (index < count && first[index] == second[index]) {
+        ++index;
+    }
+
+    return index;
+}
+
+std::size_t find_tile_difference_scalar(
+    const PackedMapTile* const tiles,
+    const std::size_t count,
+    const PackedMapTile tile
+) noexcept
+{
+    std::size_t index = 0;
+
+    while (index < count && tiles[index] == tile) {
+        ++index;
+    }
+
+    return index;
+}
+
+void blend_scalar(
+    PackedMapTile* const destination,
+    const PackedMapTile* const source,
+    const std::size_t count
+) noexcept
+{
+    for (std::size_t index = 0; index < count; ++index) {
+        if (packed_map_tile_occupied(source[index])) {
+            destination[index] = source[index];
+        }
+    }
+}
+
+constexpr SpanKernels kScalarKernels{
+    .kind = MapTileSpanKernels::Scalar,
+    .fill = fill_scalar,
+    .find_difference = find_difference_scalar,
+    .find_tile_difference = find_tile_difference_scalar,
+    .blend = blend_scalar
+};
+
+#if defined(MIDNIGHT_MAP_TILE_SPANS_X86)
+
+// Each vector loop leaves the last partial vector to the scalar kernel.
+
+__attribute__((target("sse4.1")))
+void fill_sse41(
+    PackedMapTile* const tiles,
+    const std::size_t count,
+    const PackedMapTile tile
+) noexcept
+{
+    const __m128i value = _mm_set1_epi32(static_cast<int>(tile));
+    std::size_t index = 0;
+
+    for (; index + 4 <= count; index += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(tiles + index), value);
+    }
+
+    fill_scalar(tiles + index, count - index, tile);
+}
+
+__attribute__((target("sse4.1")))
+std::size_t find_difference_sse41(
+    const PackedMapTile* const first,
+    const PackedMapTile* const second,
+    const std::size_t count
+) noexcept
+{
+    std::size_t index = 0;
+
+    for (; index + 4 <= count; index += 4) {
+        const __m128i equal = _mm_cmpeq_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + index)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(second + index))
+        );
+        const auto mask = static_cast<unsigned>(
+            _mm_movemask_ps(_mm_castsi128_ps(equal))
+        );
+
+        if (mask != 0xF) {
+            return index + static_cast<std::size_t>(std::countr_one(mask));
+        }
+    }
+
+    return index +
+        find_difference_scalar(first + index, second + index, count - index);
+}
+
+__attribute__((target("sse4.1")))
+std::size_t find_tile_difference_sse41(
+    const PackedMapTile* const tiles,
+    const std::size_t count,
+    const PackedMapTile tile
+) noexcept
+{
+    const __m128i value = _mm_set1_epi32(static_cast<int>(tile));
+    std::size_t index = 0;
+
+    for (; index + 4 <= count; index += 4) {
+        const __m128i equal = _mm_cmpeq_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(tiles + index)),
+            value
+        );
+        const auto mask = static_cast<unsigned>(
+            _mm_movemask_ps(_mm_castsi128_ps(equal))
+        );
+
+        if (mask != 0xF) {
+            return index + static_cast<std::size_t>(std::countr_one(mask));
+        }
+    }
+
+    return index +
+        find_tile_difference_scalar(tiles + index, count - index, tile);
+}
+
+__attribute__((target("sse4.1")))
+void blend_sse41(
+    PackedMapTile* const destination,
+    const PackedMapTile* const source,
+    const std::size_t count
+) noexcept
+{
+    std::size_t index = 0;
+
+    for (; index + 4 <= count; index += 4) {
+        auto* const target = reinterpret_cast<__m128i*>(destination + index);
+        const __m128i placed =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + index));
+
+        _mm_storeu_si128(
+            target,
+            _mm_blendv_epi8(
+                _mm_loadu_si128(target),
+                placed,
+                _mm_srai_epi32(placed, 31)
+            )
+        );
+    }
+
+    blend_scalar(destination + index, source + index, count - index);
+}
+
+__attribute__((target("avx2")))
+void fill_avx2(
+    PackedMapTile* const tiles,
+    const std::size_t count,
+    const PackedMapTile tile
+) noexcept
+{
+    const __m256i value = _mm256_set1_epi32(static_cast<int>(tile));
+    std::size_t index = 0;
+
+    for (; index + 8 <= count; index += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(tiles + index), value);
+    }
+
+    fill_scalar(tiles + index, count - index, tile);
+}
+
+__attribute__((target("avx2")))
+std::size_t find_difference_avx2(
+    const PackedMapTile* const first,
+    const PackedMapTile* const second,
+    const std::size_t count
+) noexcept
+{
+    std::size_t index = 0;
+
+    for (; index + 8 <= count; index += 8) {
+        const __m256i equal = _mm256_cmpeq_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + index)),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(second + index))
+        );
+        const auto mask = static_cast<unsigned>(
+            _mm256_movemask_ps(_mm256_castsi256_ps(equal))
+        );
+
+        if (mask != 0xFF) {
+            return index + static_cast<std::size_t>(std::countr_one(mask));
+        }
+    }
+
+    return index +
+        find_difference_scalar(first + index, second + index, count - index);
+}
+
+__attribute__((target("avx2")))
+std::size_t find_tile_difference_avx2(
+    const PackedMapTile* const tiles,
+    const std::size_t count,
+    const PackedMapTile tile
+) noexcept
+{
+    const __m256i value = _mm256_set1_epi32(static_cast<int>(tile));
+    std::size_t index = 0;
+
+    for (; index + 8 <= count; index += 8) {
+        const __m256i equal = _mm256_cmpeq_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tiles + index)),
+            value
+        );
+        const auto mask = static_cast<unsigned>(
+            _mm256_movemask_ps(_mm256_castsi256_ps(equal))
+        );
+
+        if (mask != 0xFF) {
+            return index + static_cast<std::size_t>(std::countr_one(mask));
+        }
+    }
+
+    return index +
+        find_tile_difference_scalar(tiles + index, count - index, tile);
+}
+
+__attribute__((target("avx2")))
+void blend_avx2(
+    PackedMapTile* const destination,
+    const PackedMapTile* const source,
+    const std::size_t count
+) noexcept
+{
+    std::size_t index = 0;
+
+    for (; index + 8 <= count; index += 8) {
+        auto* const target = reinterpret_cast<__m256i*>(destination + index);
+        const __m256i placed = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(source + index)
+        );
+
+        _mm256_storeu_si256(
+            target,
+            _mm256_blendv_epi8(
+                _mm256_loadu_si256(target),
+                placed,
+                _mm256_srai_epi32(placed, 31)
+            )
+        );
+    }
+
+    blend_scalar(destination + index, source + index, count - index);
+}
+
+constexpr SpanKernels kSse41Kernels{
+    .kind = MapTileSpanKernels::Sse41,
+    .fill = fill_sse41,
+    .find_difference = find_difference_sse41,
+    .find_tile_difference = find_tile_difference_sse41,
+    .blend = blend_sse41
+};
+
+constexpr SpanKernels kAvx2Kernels{
+    .kind = MapTileSpanKernels::Avx2,
+    .fill = fill_avx2,
+    .find_difference = find_difference_avx2,
+    .find_tile_difference = find_tile_difference_avx2,
+    .blend = blend_avx2
+};
+
+#elif defined(MIDNIGHT_MAP_TILE_SPANS_NEON)
+
+// NEON has no movemask, so a vector holding a difference is searched again
+// lane by lane.
+
+void fill_neon(
+    PackedMapTile* const tiles,
+    const std::size_t count,
+    const PackedMapTile tile
+) noexcept
+{
+    const uint32x4_t value = vdupq_n_u32(tile);
+    std::size_t index = 0;
+
+    for (; index + 4 <= count; index += 4) {
+        vst1q_u32(tiles + index, value);
+    }
+
+    fill_scalar(tiles + index, count - index, tile);
+}
+
+std::size_t find_difference_neon(
+    const PackedMapTile* const first,
+    const PackedMapTile* const second,
+    const std::size_t count
+) noexcept
+{
+    std::size_t index = 0;
+
+    for (; index + 4 <= count; index += 4) {
+        const uint32x4_t equal =
+            vceqq_u32(vld1q_u32(first + index), vld1q_u32(second + index));
+
+        if (vminvq_u32(equal) == 0) {
+            break;
+        }
+    }
+
+    return index +
+        find_difference_scalar(first + index, second + index, count - index);
+}
+
+std::size_t find_tile_difference_neon(
+    const PackedMapTile* const tiles,
+    const std::size_t count,
+    const PackedMapTile tile
+) noexcept
+{
+    const uint32x4_t value = vdupq_n_u32(tile);
+    std::size_t index = 0;
+
+    for (; index + 4 <= count; index += 4) {
+        if (vminvq_u32(vceqq_u32(vld1q_u32(tiles + index), value)) == 0) {
+            break;
+        }
+    }
+
+    return index +
+        find_tile_difference_scalar(tiles + index, count - index, tile);
+}
+
+void blend_neon(
+    PackedMapTile* const destination,
+    const PackedMapTile* const source,
+    const std::size_t count
+) noexcept
+{
+    std::size_t index = 0;
+
+    for (; index + 4 <= count; index += 4) {
+        const uint32x4_t placed = vld1q_u32(source + index);
+        const uint32x4_t mask = vreinterpretq_u32_s32(
+            vshrq_n_s32(vreinterpretq_s32_u32(placed), 31)
+        );
+
+        vst1q_u32(
+            destination + index,
+            vbslq_u32(mask, placed, vld1q_u32(destination + index))
+        );
+    }
+
+    blend_scalar(destination + index, source + index, count - index);
+}
+
+constexpr SpanKernels kNeonKernels{
+    .kind = MapTileSpanKernels::Neon,
+    .fill = fill_neon,
+    .find_difference = find_difference_neon,
+    .find_tile_difference = find_tile_difference_neon,
+    .blend = blend_neon
+};
+
+#endif
+
+// Null when the CPU cannot run `kernels`.
+const SpanKernels* kernels_for(const MapTileSpanKernels kernels) noexcept
+{
+    switch (kernels) {
+        case MapTileSpanKernels::Scalar:
+            return &kScalarKernels;
+
+#if defined(MIDNIGHT_MAP_TILE_SPANS_X86)
+        case MapTileSpanKernels::Sse41:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse4.1") ? &kSse41Kernels : nullptr;
+
+        case MapTileSpanKernels::Avx2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? &kAvx2Kernels : nullptr;
+
+#elif defined(MIDNIGHT_MAP_TILE_SPANS_NEON)
+        case MapTileSpanKernels::Neon:
+            return &kNeonKernels;
+
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+constinit std::atomic<const SpanKernels*> active_kernels{nullptr};
+
+const SpanKernels& kernels() noexcept
+{
+    const SpanKernels* table = active_kernels.load(std::memory_order_acquire);
+
+    // Racing first calls all pick the same table.
+    if (table == nullptr) {
+        table = kernels_for(best_map_tile_span_kernels());
+        active_kernels.store(table, std::memory_order_release);
+    }
+
+    return *table;
+}
+
+}
+
+MapTileSpanKernels best_map_tile_span_kernels() noexcept
+{
+    for (const MapTileSpanKernels kernels : {
+             MapTileSpanKernels::Avx2,
+             MapTileSpanKernels::Sse41,
+             MapTileSpanKernels::Neon
+         }) {
+        if (kernels_for(kernels) != nullptr) {
+            return kernels;
+        }
+    }
+
+    return MapTileSpanKernels::Scalar;
+}
+
+MapTileSpanKernels active_map_tile_span_kernels() noexcept
+{
+    return kernels().kind;
+}
+
+std::string_view map_tile_span_kernels_name(
+    const MapTileSpanKernels kernels
+) noexcept
+{
+    switch (kernels) {
+        case MapTileSpanKernels::Sse41:
+            return "sse4.1";
+
+        case MapTileSpanKernels::Avx2:
+            return "avx2";
+
+        case MapTileSpanKernels::Neon:
+            return "neon";
+
+        default:
+            return "scalar";
+    }
+}
+
+bool use_map_tile_span_kernels(const MapTileSpanKernels kernels) noexcept
+{
+    const SpanKernels* const table = kernels_for(kernels);
+
+    if (table == nullptr) {
+        return false;
+    }
+
+    active_kernels.store(table, std::memory_order_release);
+    return true;
+}
+
+void fill_map_tile_span(
+    const std::span<PackedMapTile> tiles,
+    const PackedMapTile tile
+) noexcept
+{
+    kernels().fill(tiles.data(), tiles.size(), tile);
+}
+
+void copy_map_tile_span(
+    const std::span<PackedMapTile> destination,
+    const std::span<const PackedMapTile> source
+) noexcept
+{
+    // The C library's memmove already picks its vector width at load time.
+    if (!source.empty()) {
+        std::memmove(destination.data(), source.data(), source.size_bytes());
+    }
+}
+
+std::size_t find_map_tile_span_difference(
+    const std::span<const PackedMapTile> first,
+    const std::span<const PackedMapTile> second
+) noexcept
+{
+    return kernels().find_difference(
+        first.data(),
+        second.data(),
+        std::min(first.size(), second.size())
+    );
+}
+
+std::size_t find_map_tile_span_difference(
+    const std::span<const PackedMapTile> tiles,
+    const PackedMapTile tile
+) noexcept
+{
+    return kernels().find_tile_difference(tiles.data(), tiles.size(), tile);
+}
+
+void blend_map_tile_span(
+    const std::span<PackedMapTile> destination,
+    const std::span<const PackedMapTile> source
+) noexcept
+{
+    kernels().blend(destination.data(), source.data(), source.size());
+}
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "midnight/map/MapFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace midnight {
+
+enum class MapTileSpanKernels : std::uint8_t {
+    Scalar,
+    Sse41,
+    Avx2,
+    Neon
+};
+
+// Row kernels over packed tiles, which map edits run on every row span they
+// touch. The first call picks the widest instruction set the CPU supports:
+// AVX2 or SSE4.1 on x86-64, NEON on AArch64, plain loops anywhere else.
+
+[[nodiscard]] MapTileSpanKernels best_map_tile_span_kernels() noexcept;
+[[nodiscard]] MapTileSpanKernels active_map_tile_span_kernels() noexcept;
+[[nodiscard]] std::string_view map_tile_span_kernels_name(
+    MapTileSpanKernels kernels
+) noexcept;
+
+// Switches every kernel to `kernels`, as benchmarks do to compare them.
+// Returns false, changing nothing, when the CPU cannot run them.
+bool use_map_tile_span_kernels(MapTileSpanKernels kernels) noexcept;
+
+void fill_map_tile_span(
+    std::span<PackedMapTile> tiles,
+    PackedMapTile tile
+) noexcept;
+
+// The spans may overlap; `destination` must hold at least `source`.
+void copy_map_tile_span(
+    std::span<PackedMapTile> destination,
+    std::span<const PackedMapTile> source
+) noexcept;
+
+// Index of the first cell where the spans differ, or of the first cell not
+// holding `tile`; the span size when there is none. The first overload
+// compares as many cells as the shorter span holds.
+[[nodiscard]] std::size_t find_map_tile_span_difference(
+    std::span<const PackedMapTile> first,
+    std::span<const PackedMapTile> second
+) noexcept;
+[[nodiscard]] std::size_t find_map_tile_span_difference(
+    std::span<const PackedMapTile> tiles,
+    PackedMapTile tile
+) noexcept;
+
+// Writes the placed cells of `source` over `destination` and leaves the
+// cells under its empty ones, as stamps with holes are laid down.
+// `destination` must hold at least `source`.
+void blend_map_tile_span(
+    std::span<PackedMapTile> destination,
+    std::span<const PackedMapTile> source
+) noexcept;
+
+}
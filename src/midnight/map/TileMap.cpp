@@ -0,0 +1,155 @@
+#include "midnight/map/TileMap.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace midnight {
+
+TileMap::TileMap(
+    const std::uint32_t columns,
+    const std::uint32_t rows,
+    const std::size_t layer_count
+)
+    : columns_(columns),
+      rows_(rows),
+      layer_count_(layer_count)
+{
+    if (columns == 0 || rows == 0 || layer_count == 0) {
+        throw std::runtime_error("Tile map needs at least one cell and layer");
+    }
+
+    // Cell indices travel as 32-bit values through change sets and the
+    // edit journal.
+    if (static_cast<std::uint64_t>(columns) * rows >
+        std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error("Tile map is too large");
+    }
+
+    tiles_.resize(cell_count() * layer_count);
+}
+
+std::uint32_t TileMap::columns() const noexcept
+{
+    return columns_;
+}
+
+std::uint32_t TileMap::rows() const noexcept
+{
+    return rows_;
+}
+
+std::size_t TileMap::layer_count() const noexcept
+{
+    return layer_count_;
+}
+
+std::size_t TileMap::cell_count() const noexcept
+{
+    return static_cast<std::size_t>(columns_) * rows_;
+}
+
+bool TileMap::contains(
+    const std::uint32_t column,
+    const std::uint32_t row
+) const noexcept
+{
+    return column < columns_ && row < rows_;
+}
+
+bool TileMap::contains(const MapCellRect& area) const noexcept
+{
+    return area.left <= area.right &&
+        area.top <= area.bottom &&
+        contains(area.right, area.bottom);
+}
+
+std::size_t TileMap::cell_index(
+    const std::uint32_t column,
+    const std::uint32_t row
+) const noexcept
+{
+    return static_cast<std::size_t>(row) * columns_ + column;
+}
+
+std::span<PackedMapTile> TileMap::layer(const std::size_t layer)
+{
+    if (layer >= layer_count_) {
+        throw std::runtime_error("Tile map layer is out of range");
+    }
+
+    return std::span<PackedMapTile>(tiles_).subspan(
+        layer * cell_count(),
+        cell_count()
+    );
+}
+
+std::span<const PackedMapTile> TileMap::layer(const std::size_t layer) const
+{
+    if (layer >= layer_count_) {
+        throw std::runtime_error("Tile map layer is out of range");
+    }
+
+    return std::span<const PackedMapTile>(tiles_).subspan(
+        layer * cell_count(),
+        cell_count()
+    );
+}
+
+MapTile TileMap::tile(
+    const std::size_t layer,
+    const std::uint32_t column,
+    const std::uint32_t row
+) const
+{
+    if (!contains(column, row)) {
+        throw std::runtime_error("Tile map cell is out of range");
+    }
+
+    return unpack_map_tile(this->layer(layer)[cell_index(column, row)]);
+}
+
+void TileMap::copy_block(
+    const std::size_t layer,
+    const std::uint32_t first_column,
+    const std::uint32_t first_row,
+    const std::uint32_t width,
+    const std::uint32_t height,
+    const std::span<PackedMapTile> block
+) const
+{
+    if (block.size() != static_cast<std::size_t>(width) * height) {
+        throw std::runtime_error("Tile map block has the wrong size");
+    }
+
+    const std::span<const PackedMapTile> tiles = this->layer(layer);
+    std::ranges::fill(block, PackedMapTile{0});
+
+    if (first_column >= columns_ || first_row >= rows_) {
+        return;
+    }
+
+    const std::uint32_t copy_width = std::min(width, columns_ - first_column);
+    const std::uint32_t copy_height = std::min(height, rows_ - first_row);
+
+    for (std::uint32_t row = 0; row < copy_height; ++row) {
+        const auto source =
+            tiles.begin() +
+            static_cast<std::ptrdiff_t>(
+                cell_index(first_column, first_row + row)
+            );
+
+        std::copy(
+            source,
+            source + copy_width,
+            block.begin() + static_cast<std::ptrdiff_t>(row) * width
+        );
+    }
+}
+
+void TileMap::clear() noexcept
+{
+    std::ranges::fill(tiles_, PackedMapTile{0});
+}
+
+}
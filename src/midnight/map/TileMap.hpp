@@ -0,0 +1,115 @@
+#pragma once
+
+#include "midnight/map/MapFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace midnight {
+
+struct MapTile final {
+    std::uint32_t tileset_column = 0;
+    std::uint32_t tileset_row = 0;
+    bool occupied = false;
+
+    bool operator==(const MapTile&) const = default;
+};
+
+[[nodiscard]] constexpr PackedMapTile pack_map_tile(
+    const MapTile& tile
+) noexcept
+{
+    return pack_map_tile(tile.tileset_column, tile.tileset_row, tile.occupied);
+}
+
+[[nodiscard]] constexpr MapTile unpack_map_tile(
+    const PackedMapTile tile
+) noexcept
+{
+    return packed_map_tile_occupied(tile)
+        ? MapTile{
+              .tileset_column = packed_map_tile_column(tile),
+              .tileset_row = packed_map_tile_row(tile),
+              .occupied = true
+          }
+        : MapTile{};
+}
+
+// Inclusive on every edge, like the editor's selections.
+struct MapCellRect final {
+    std::uint32_t left = 0;
+    std::uint32_t top = 0;
+    std::uint32_t right = 0;
+    std::uint32_t bottom = 0;
+
+    [[nodiscard]] constexpr std::uint32_t columns() const noexcept
+    {
+        return right - left + 1;
+    }
+
+    [[nodiscard]] constexpr std::uint32_t rows() const noexcept
+    {
+        return bottom - top + 1;
+    }
+
+    bool operator==(const MapCellRect&) const = default;
+};
+
+// Tile layers stored as packed tiles, row-major, one layer after another in
+// a single allocation. An empty cell is always stored as 0, so comparing
+// packed values compares tiles.
+class TileMap final {
+public:
+    TileMap() = default;
+    TileMap(std::uint32_t columns, std::uint32_t rows, std::size_t layer_count);
+
+    [[nodiscard]] std::uint32_t columns() const noexcept;
+    [[nodiscard]] std::uint32_t rows() const noexcept;
+    [[nodiscard]] std::size_t layer_count() const noexcept;
+    [[nodiscard]] std::size_t cell_count() const noexcept;
+
+    [[nodiscard]] bool contains(
+        std::uint32_t column,
+        std::uint32_t row
+    ) const noexcept;
+    [[nodiscard]] bool contains(const MapCellRect& area) const noexcept;
+    [[nodiscard]] std::size_t cell_index(
+        std::uint32_t column,
+        std::uint32_t row
+    ) const noexcept;
+
+    [[nodiscard]] std::span<PackedMapTile> layer(std::size_t layer);
+    [[nodiscard]] std::span<const PackedMapTile> layer(
+        std::size_t layer
+    ) const;
+    [[nodiscard]] MapTile tile(
+        std::size_t layer,
+        std::uint32_t column,
+        std::uint32_t row
+    ) const;
+
+    // Copies a width x height block starting at (first_column, first_row)
+    // into `block`, row-major; cells past the map edge read as empty.
+    void copy_block(
+        std::size_t layer,
+        std::uint32_t first_column,
+        std::uint32_t first_row,
+        std::uint32_t width,
+        std::uint32_t height,
+        std::span<PackedMapTile> block
+    ) const;
+
+    void clear() noexcept;
+
+    bool operator==(const TileMap&) const = default;
+
+private:
+    std::uint32_t columns_ = 0;
+    std::uint32_t rows_ = 0;
+    std::size_t layer_count_ = 0;
+    std::vector<PackedMapTile> tiles_;
+};
+
+}
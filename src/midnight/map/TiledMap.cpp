@@ -0,0 +1,1609 @@
+#include "midnight/map/TiledMap.hpp"
+
+#include "midnight/core/Base64.hpp"
+#include "midnight/core/JobSystem.hpp"
+#include "midnight/core/MappedFile.hpp"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <climits>
+#include <cstddef>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+namespace midnight {
+namespace {
+
+constexpr std::size_t kParallelSegmentBytes = 1024 * 1024;
+constexpr std::string_view kTiledVersion = "1.10";
+
+enum class LayerDataFormat : std::uint8_t {
+    Csv,
+    Base64,
+    XmlTiles
+};
+
+enum class LayerCompression : std::uint8_t {
+    None,
+    Zlib,
+    Zstd
+};
+
+// A tile layer whose data still points into the mapped file.
+struct LayerSource final {
+    std::string name;
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    LayerDataFormat format = LayerDataFormat::XmlTiles;
+    LayerCompression compression = LayerCompression::None;
+    std::string_view data;
+    std::vector<std::uint32_t> xml_gids;
+};
+
+bool is_space(const char character) noexcept
+{
+    return character == ' ' ||
+           character == '\n' ||
+           character == '\r' ||
+           character == '\t';
+}
+
+std::string_view trim(std::string_view text) noexcept
+{
+    while (!text.empty() && is_space(text.front())) {
+        text.remove_prefix(1);
+    }
+
+    while (!text.empty() && is_space(text.back())) {
+        text.remove_suffix(1);
+    }
+
+    return text;
+}
+
+std::uint32_t parse_uint(const std::string_view text, const char* field)
+{
+    std::uint32_t value = 0;
+    const std::string_view trimmed = trim(text);
+    const auto [end, error] = std::from_chars(
+        trimmed.data(),
+        trimmed.data() + trimmed.size(),
+        value
+    );
+
+    if (error != std::errc{} || end != trimmed.data() + trimmed.size()) {
+        throw std::runtime_error(
+            std::string("Invalid ") + field + " in Tiled map: " + std::string(text)
+        );
+    }
+
+    return value;
+}
+
+LayerCompression parse_compression(const std::string_view compression)
+{
+    if (compression.empty()) {
+        return LayerCompression::None;
+    }
+
+    if (compression == "zlib" || compression == "gzip") {
+        return LayerCompression::Zlib;
+    }
+
+    if (compression == "zstd") {
+        return LayerCompression::Zstd;
+    }
+
+    throw std::runtime_error(
+        "Unsupported Tiled layer compression: " + std::string(compression)
+    );
+}
+
+void append_utf8(std::string& text, const std::uint32_t code_point)
+{
+    if (code_point < 0x80) {
+        text.push_back(static_cast<char>(code_point));
+    } else if (code_point < 0x800) {
+        text.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        text.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else if (code_point < 0x10000) {
+        text.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        text.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        text.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    } else {
+        text.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        text.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        text.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        text.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+class XmlTokenizer final {
+public:
+    enum class Token : std::uint8_t {
+        StartElement,
+        EndElement,
+        Text,
+        End
+    };
+
+    explicit XmlTokenizer(const std::string_view text) noexcept
+        : text_(text)
+    {
+    }
+
+    Token next()
+    {
+        if (pending_end_) {
+            pending_end_ = false;
+            return Token::EndElement;
+        }
+
+        while (position_ < text_.size()) {
+            const std::string_view rest = text_.substr(position_);
+
+            if (rest.front() != '<') {
+                const std::size_t end = text_.find('<', position_);
+                const std::size_t text_end =
+                    end == std::string_view::npos ? text_.size() : end;
+
+                value_ = text_.substr(position_, text_end - position_);
+                position_ = text_end;
+                return Token::Text;
+            }
+
+            if (rest.starts_with("<?")) {
+                skip_past("?>");
+            } else if (rest.starts_with("<!--")) {
+                skip_past("-->");
+            } else if (rest.starts_with("<![CDATA[")) {
+                const std::size_t begin = position_ + 9;
+                skip_past("]]>");
+                value_ = text_.substr(begin, position_ - 3 - begin);
+                return Token::Text;
+            } else if (rest.starts_with("<!")) {
+                skip_past(">");
+            } else if (rest.starts_with("</")) {
+                const std::size_t begin = position_ + 2;
+                skip_past(">");
+                name_ = trim(text_.substr(begin, position_ - 1 - begin));
+                return Token::EndElement;
+            } else {
+                return read_start_element();
+            }
+        }
+
+        return Token::End;
+    }
+
+    [[nodiscard]] std::string_view name() const noexcept
+    {
+        return name_;
+    }
+
+    [[nodiscard]] std::string_view text() const noexcept
+    {
+        return value_;
+    }
+
+    [[nodiscard]] std::optional<std::string_view> attribute(
+        const std::string_view attribute_name
+    ) const
+    {
+        std::size_t position = 0;
+
+        while (true) {
+            while (position < attributes_.size() && is_space(attributes_[position])) {
+                ++position;
+            }
+
+            if (position >= attributes_.size()) {
+                return std::nullopt;
+            }
+
+            const std::size_t name_begin = position;
+
+            while (position < attributes_.size() &&
+                   attributes_[position] != '=' &&
+                   !is_space(attributes_[position])) {
+                ++position;
+            }
+
+            const std::string_view current_name =
+                attributes_.substr(name_begin, position - name_begin);
+
+            while (position < attributes_.size() && is_space(attributes_[position])) {
+                ++position;
+            }
+
+            if (position + 1 >= attributes_.size() || attributes_[position] != '=') {
+                throw std::runtime_error("Malformed XML attribute in Tiled map");
+            }
+
+            ++position;
+
+            while (position < attributes_.size() && is_space(attributes_[position])) {
+                ++position;
+            }
+
+            if (position >= attributes_.size() ||
+                (attributes_[position] != '"' && attributes_[position] != '\'')) {
+                throw std::runtime_error("Malformed XML attribute in Tiled map");
+            }
+
+            const char quote = attributes_[position++];
+            const std::size_t value_end = attributes_.find(quote, position);
+
+            if (value_end == std::string_view::npos) {
+                throw std::runtime_error("Unterminated XML attribute in Tiled map");
+            }
+
+            if (current_name == attribute_name) {
+                return attributes_.substr(position, value_end - position);
+            }
+
+            position = value_end + 1;
+        }
+    }
+
+private:
+    void skip_past(const std::string_view terminator)
+    {
+        const std::size_t end = text_.find(terminator, position_);
+
+        if (end == std::string_view::npos) {
+            throw std::runtime_error("Unterminated XML markup in Tiled map");
+        }
+
+        position_ = end + terminator.size();
+    }
+
+    Token read_start_element()
+    {
+        const std::size_t name_begin = position_ + 1;
+        std::size_t position = name_begin;
+
+        while (position < text_.size() &&
+               !is_space(text_[position]) &&
+               text_[position] != '/' &&
+               text_[position] != '>') {
+            ++position;
+        }
+
+        name_ = text_.substr(name_begin, position - name_begin);
+
+        const std::size_t attributes_begin = position;
+        char quote = '\0';
+
+        for (; position < text_.size(); ++position) {
+            const char character = text_[position];
+
+            if (quote != '\0') {
+                quote = character == quote ? '\0' : quote;
+            } else if (character == '"' || character == '\'') {
+                quote = character;
+            } else if (character == '>') {
+                break;
+            }
+        }
+
+        if (position >= text_.size() || name_.empty()) {
+            throw std::runtime_error("Malformed XML element in Tiled map");
+        }
+
+        std::size_t attributes_end = position;
+        pending_end_ = text_[position - 1] == '/';
+
+        if (pending_end_) {
+            --attributes_end;
+        }
+
+        attributes_ = text_.substr(
+            attributes_begin,
+            std::max(attributes_end, attributes_begin) - attributes_begin
+        );
+        position_ = position + 1;
+
+        return Token::StartElement;
+    }
+
+    std::string_view text_;
+    std::size_t position_ = 0;
+    std::string_view name_;
+    std::string_view attributes_;
+    std::string_view value_;
+    bool pending_end_ = false;
+};
+
+std::string xml_unescape(const std::string_view text)
+{
+    std::string result;
+    result.reserve(text.size());
+
+    for (std::size_t index = 0; index < text.size(); ++index) {
+        if (text[index] != '&') {
+            result.push_back(text[index]);
+            continue;
+        }
+
+        const std::size_t end = text.find(';', index);
+
+        if (end == std::string_view::npos) {
+            throw std::runtime_error("Malformed XML entity in Tiled map");
+        }
+
+        const std::string_view entity = text.substr(index + 1, end - index - 1);
+
+        if (entity == "amp") {
+            result.push_back('&');
+        } else if (entity == "lt") {
+            result.push_back('<');
+        } else if (entity == "gt") {
+            result.push_back('>');
+        } else if (entity == "quot") {
+            result.push_back('"');
+        } else if (entity == "apos") {
+            result.push_back('\'');
+        } else if (entity.starts_with('#')) {
+            const bool hexadecimal = entity.starts_with("#x");
+            const std::string_view digits = entity.substr(hexadecimal ? 2 : 1);
+            std::uint32_t code_point = 0;
+            const auto [digits_end, error] = std::from_chars(
+                digits.data(),
+                digits.data() + digits.size(),
+                code_point,
+                hexadecimal ? 16 : 10
+            );
+
+            if (error != std::errc{} ||
+                digits_end != digits.data() + digits.size() ||
+                code_point > 0x10FFFF) {
+                throw std::runtime_error("Malformed XML entity in Tiled map");
+            }
+
+            append_utf8(result, code_point);
+        } else {
+            throw std::runtime_error("Unknown XML entity in Tiled map");
+        }
+
+        index = end;
+    }
+
+    return result;
+}
+
+// Pull reader over JSON text. Strings come back as raw views into the source;
+// only names are unescaped.
+class JsonReader final {
+public:
+    explicit JsonReader(const std::string_view text) noexcept
+        : text_(text)
+    {
+    }
+
+    char peek() noexcept
+    {
+        while (position_ < text_.size() && is_space(text_[position_])) {
+            ++position_;
+        }
+
+        return position_ < text_.size() ? text_[position_] : '\0';
+    }
+
+    void expect(const char character)
+    {
+        if (peek() != character) {
+            throw std::runtime_error(
+                std::string("Expected '") + character + "' in Tiled JSON map"
+            );
+        }
+
+        ++position_;
+    }
+
+    void begin_object()
+    {
+        expect('{');
+    }
+
+    bool next_member(std::string_view& key)
+    {
+        const char character = peek();
+
+        if (character == '}') {
+            ++position_;
+            return false;
+        }
+
+        if (character == ',') {
+            ++position_;
+        }
+
+        key = read_string();
+        expect(':');
+
+        return true;
+    }
+
+    void begin_array()
+    {
+        expect('[');
+    }
+
+    bool next_element()
+    {
+        const char character = peek();
+
+        if (character == ']') {
+            ++position_;
+            return false;
+        }
+
+        if (character == ',') {
+            ++position_;
+        }
+
+        return true;
+    }
+
+    std::string_view read_string()
+    {
+        expect('"');
+
+        const std::size_t begin = position_;
+
+        // Jump between quotes and treat one as escaped only when an odd run
+        // of backslashes precedes it; base64 layer data has none.
+        while (true) {
+            const std::size_t quote = text_.find('"', position_);
+
+            if (quote == std::string_view::npos) {
+                throw std::runtime_error("Unterminated string in Tiled JSON map");
+            }
+
+            std::size_t backslash_count = 0;
+
+            while (quote - backslash_count > begin &&
+                   text_[quote - backslash_count - 1] == '\\') {
+                ++backslash_count;
+            }
+
+            position_ = quote + 1;
+
+            if (backslash_count % 2 == 0) {
+                return text_.substr(begin, quote - begin);
+            }
+        }
+    }
+
+    std::uint32_t read_uint(const char* field)
+    {
+        (void)peek();
+
+        const std::size_t begin = position_;
+
+        while (position_ < text_.size() &&
+               text_[position_] >= '0' &&
+               text_[position_] <= '9') {
+            ++position_;
+        }
+
+        return parse_uint(text_.substr(begin, position_ - begin), field);
+    }
+
+    bool read_bool()
+    {
+        if (peek() == 't' && text_.substr(position_).starts_with("true")) {
+            position_ += 4;
+            return true;
+        }
+
+        if (peek() == 'f' && text_.substr(position_).starts_with("false")) {
+            position_ += 5;
+            return false;
+        }
+
+        throw std::runtime_error("Expected a boolean in Tiled JSON map");
+    }
+
+    // Returns the text between the brackets of a flat array of scalars.
+    std::string_view read_flat_array()
+    {
+        expect('[');
+
+        const std::size_t begin = position_;
+        const std::size_t end = text_.find(']', begin);
+
+        if (end == std::string_view::npos) {
+            throw std::runtime_error("Unterminated array in Tiled JSON map");
+        }
+
+        position_ = end + 1;
+
+        return text_.substr(begin, end - begin);
+    }
+
+    void skip_value()
+    {
+        switch (peek()) {
+            case '{': {
+                begin_object();
+                std::string_view key;
+
+                while (next_member(key)) {
+                    skip_value();
+                }
+                break;
+            }
+
+            case '[':
+                begin_array();
+
+                while (next_element()) {
+                    skip_value();
+                }
+                break;
+
+            case '"':
+                (void)read_string();
+                break;
+
+            case '\0':
+                throw std::runtime_error("Unexpected end of Tiled JSON map");
+
+            default: {
+                const std::size_t begin = position_;
+
+                while (position_ < text_.size() &&
+                       text_[position_] != ',' &&
+                       text_[position_] != '}' &&
+                       text_[position_] != ']' &&
+                       !is_space(text_[position_])) {
+                    ++position_;
+                }
+
+                if (position_ == begin) {
+                    throw std::runtime_error("Malformed value in Tiled JSON map");
+                }
+                break;
+            }
+        }
+    }
+
+private:
+    std::string_view text_;
+    std::size_t position_ = 0;
+};
+
+std::string json_unescape(const std::string_view text)
+{
+    std::string result;
+    result.reserve(text.size());
+
+    const auto read_hex = [&text](const std::size_t begin) {
+        std::uint32_t value = 0;
+
+        if (begin + 4 > text.size() ||
+            std::from_chars(text.data() + begin, text.data() + begin + 4, value, 16).ptr !=
+                text.data() + begin + 4) {
+            throw std::runtime_error("Malformed unicode escape in Tiled JSON map");
+        }
+
+        return value;
+    };
+
+    for (std::size_t index = 0; index < text.size(); ++index) {
+        if (text[index] != '\\') {
+            result.push_back(text[index]);
+            continue;
+        }
+
+        if (++index >= text.size()) {
+            throw std::runtime_error("Malformed escape in Tiled JSON map");
+        }
+
+        switch (text[index]) {
+            case 'b':
+                result.push_back('\b');
+                break;
+
+            case 'f':
+                result.push_back('\f');
+                break;
+
+            case 'n':
+                result.push_back('\n');
+                break;
+
+            case 'r':
+                result.push_back('\r');
+                break;
+
+            case 't':
+                result.push_back('\t');
+                break;
+
+            case 'u': {
+                std::uint32_t code_point = read_hex(index + 1);
+                index += 4;
+
+                if (code_point >= 0xD800 && code_point < 0xDC00 &&
+                    index + 2 < text.size() &&
+                    text[index + 1] == '\\' &&
+                    text[index + 2] == 'u') {
+                    const std::uint32_t low = read_hex(index + 3);
+
+                    if (low >= 0xDC00 && low < 0xE000) {
+                        code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                        index += 6;
+                    }
+                }
+
+                append_utf8(result, code_point);
+                break;
+            }
+
+            default:
+                result.push_back(text[index]);
+                break;
+        }
+    }
+
+    return result;
+}
+
+void parse_tmx(
+    const std::string_view text,
+    TiledMap& map,
+    std::vector<LayerSource>& layers
+)
+{
+    XmlTokenizer tokenizer(text);
+    bool in_tileset = false;
+    bool in_layer = false;
+    bool in_data = false;
+    bool saw_map = false;
+
+    const auto optional_uint = [&tokenizer](
+        const std::string_view name,
+        const std::uint32_t fallback = 0
+    ) {
+        const std::optional<std::string_view> value = tokenizer.attribute(name);
+        return value.has_value() ? parse_uint(value.value(), name.data()) : fallback;
+    };
+
+    const auto required_uint = [&tokenizer](const std::string_view name) {
+        const std::optional<std::string_view> value = tokenizer.attribute(name);
+
+        if (!value.has_value()) {
+            throw std::runtime_error(
+                "Tiled map is missing the " + std::string(name) + " attribute"
+            );
+        }
+
+        return parse_uint(value.value(), name.data());
+    };
+
+    while (true) {
+        switch (tokenizer.next()) {
+            case XmlTokenizer::Token::End:
+                if (!saw_map) {
+                    throw std::runtime_error("Tiled map has no map element");
+                }
+                return;
+
+            case XmlTokenizer::Token::StartElement: {
+                const std::string_view name = tokenizer.name();
+
+                if (name == "map") {
+                    if (tokenizer.attribute("infinite").value_or("0") != "0") {
+                        throw std::runtime_error("Infinite Tiled maps are not supported");
+                    }
+
+                    if (tokenizer.attribute("orientation").value_or("orthogonal") !=
+                        "orthogonal") {
+                        throw std::runtime_error("Only orthogonal Tiled maps are supported");
+                    }
+
+                    map.width = required_uint("width");
+                    map.height = required_uint("height");
+                    map.tile_width = optional_uint("tilewidth");
+                    map.tile_height = optional_uint("tileheight");
+                    saw_map = true;
+                } else if (name == "tileset" && !in_tileset) {
+                    in_tileset = true;
+
+                    TiledTileset& tileset = map.tilesets.emplace_back();
+                    tileset.first_gid = optional_uint("firstgid", 1);
+                    tileset.name = xml_unescape(
+                        tokenizer.attribute("name").value_or(
+                            tokenizer.attribute("source").value_or("")
+                        )
+                    );
+                    tileset.tile_width = optional_uint("tilewidth");
+                    tileset.tile_height = optional_uint("tileheight");
+                    tileset.tile_count = optional_uint("tilecount");
+                    tileset.columns = optional_uint("columns");
+                } else if (name == "image" && in_tileset) {
+                    TiledTileset& tileset = map.tilesets.back();
+                    tileset.image_source =
+                        xml_unescape(tokenizer.attribute("source").value_or(""));
+                    tileset.image_width = optional_uint("width");
+                    tileset.image_height = optional_uint("height");
+                } else if (name == "layer") {
+                    in_layer = true;
+
+                    LayerSource& layer = layers.emplace_back();
+                    layer.name = xml_unescape(tokenizer.attribute("name").value_or(""));
+                    layer.width = optional_uint("width", map.width);
+                    layer.height = optional_uint("height", map.height);
+                } else if (name == "data" && in_layer) {
+                    LayerSource& layer = layers.back();
+                    const std::string_view encoding =
+                        tokenizer.attribute("encoding").value_or("");
+
+                    if (encoding == "csv") {
+                        layer.format = LayerDataFormat::Csv;
+                    } else if (encoding == "base64") {
+                        layer.format = LayerDataFormat::Base64;
+                    } else if (encoding.empty()) {
+                        layer.format = LayerDataFormat::XmlTiles;
+                    } else {
+                        throw std::runtime_error(
+                            "Unsupported Tiled layer encoding: " + std::string(encoding)
+                        );
+                    }
+
+                    layer.compression = parse_compression(
+                        tokenizer.attribute("compression").value_or("")
+                    );
+                    in_data = true;
+                } else if (name == "chunk" && in_data) {
+                    throw std::runtime_error("Infinite Tiled maps are not supported");
+                } else if (name == "tile" && in_data) {
+                    layers.back().xml_gids.push_back(optional_uint("gid"));
+                }
+                break;
+            }
+
+            case XmlTokenizer::Token::EndElement: {
+                const std::string_view name = tokenizer.name();
+
+                if (name == "tileset") {
+                    in_tileset = false;
+                } else if (name == "layer") {
+                    in_layer = false;
+                } else if (name == "data") {
+                    in_data = false;
+                }
+                break;
+            }
+
+            case XmlTokenizer::Token::Text:
+                if (in_data && layers.back().format != LayerDataFormat::XmlTiles) {
+                    layers.back().data = tokenizer.text();
+                }
+                break;
+        }
+    }
+}
+
+void parse_tmj_layers(JsonReader& reader, std::vector<LayerSource>& layers)
+{
+    reader.begin_array();
+
+    while (reader.next_element()) {
+        LayerSource layer{};
+        std::string_view type;
+        std::string_view encoding = "csv";
+        std::vector<LayerSource> children;
+        std::string_view key;
+
+        reader.begin_object();
+
+        while (reader.next_member(key)) {
+            if (key == "type") {
+                type = reader.read_string();
+            } else if (key == "name") {
+                layer.name = json_unescape(reader.read_string());
+            } else if (key == "width") {
+                layer.width = reader.read_uint("layer width");
+            } else if (key == "height") {
+                layer.height = reader.read_uint("layer height");
+            } else if (key == "data") {
+                if (reader.peek() == '[') {
+                    layer.data = reader.read_flat_array();
+                    layer.format = LayerDataFormat::Csv;
+                } else {
+                    layer.data = reader.read_string();
+                    layer.format = LayerDataFormat::Base64;
+                }
+            } else if (key == "encoding") {
+                encoding = reader.read_string();
+            } else if (key == "compression") {
+                layer.compression = parse_compression(reader.read_string());
+            } else if (key == "layers") {
+                parse_tmj_layers(reader, children);
+            } else if (key == "chunks") {
+                throw std::runtime_error("Infinite Tiled maps are not supported");
+            } else {
+                reader.skip_value();
+            }
+        }
+
+        if (type == "tilelayer") {
+            if (encoding != "csv" && encoding != "base64") {
+                throw std::runtime_error(
+                    "Unsupported Tiled layer encoding: " + std::string(encoding)
+                );
+            }
+
+            layers.push_back(std::move(layer));
+        } else if (type == "group") {
+            layers.insert(
+                layers.end(),
+                std::make_move_iterator(children.begin()),
+                std::make_move_iterator(children.end())
+            );
+        }
+    }
+}
+
+void parse_tmj_tilesets(JsonReader& reader, std::vector<TiledTileset>& tilesets)
+{
+    reader.begin_array();
+
+    while (reader.next_element()) {
+        TiledTileset& tileset = tilesets.emplace_back();
+        std::string_view key;
+
+        reader.begin_object();
+
+        while (reader.next_member(key)) {
+            if (key == "firstgid") {
+                tileset.first_gid = reader.read_uint("firstgid");
+            } else if (key == "name" || (key == "source" && tileset.name.empty())) {
+                tileset.name = json_unescape(reader.read_string());
+            } else if (key == "tilewidth") {
+                tileset.tile_width = reader.read_uint("tilewidth");
+            } else if (key == "tileheight") {
+                tileset.tile_height = reader.read_uint("tileheight");
+            } else if (key == "tilecount") {
+                tileset.tile_count = reader.read_uint("tilecount");
+            } else if (key == "columns") {
+                tileset.columns = reader.read_uint("columns");
+            } else if (key == "image") {
+                tileset.image_source = json_unescape(reader.read_string());
+            } else if (key == "imagewidth") {
+                tileset.image_width = reader.read_uint("imagewidth");
+            } else if (key == "imageheight") {
+                tileset.image_height = reader.read_uint("imageheight");
+            } else {
+                reader.skip_value();
+            }
+        }
+    }
+}
+
+void parse_tmj(
+    const std::string_view text,
+    TiledMap& map,
+    std::vector<LayerSource>& layers
+)
+{
+    JsonReader reader(text);
+    std::string_view key;
+    bool saw_width = false;
+    bool saw_height = false;
+
+    reader.begin_object();
+
+    while (reader.next_member(key)) {
+        if (key == "width") {
+            map.width = reader.read_uint("width");
+            saw_width = true;
+        } else if (key == "height") {
+            map.height = reader.read_uint("height");
+            saw_height = true;
+        } else if (key == "tilewidth") {
+            map.tile_width = reader.read_uint("tilewidth");
+        } else if (key == "tileheight") {
+            map.tile_height = reader.read_uint("tileheight");
+        } else if (key == "infinite") {
+            if (reader.read_bool()) {
+                throw std::runtime_error("Infinite Tiled maps are not supported");
+            }
+        } else if (key == "orientation") {
+            if (reader.read_string() != "orthogonal") {
+                throw std::runtime_error("Only orthogonal Tiled maps are supported");
+            }
+        } else if (key == "layers") {
+            parse_tmj_layers(reader, layers);
+        } else if (key == "tilesets") {
+            parse_tmj_tilesets(reader, map.tilesets);
+        } else {
+            reader.skip_value();
+        }
+    }
+
+    if (!saw_width || !saw_height) {
+        throw std::runtime_error("Tiled JSON map is missing its dimensions");
+    }
+}
+
+template <typename Work>
+void for_each_range(
+    JobSystem* jobs,
+    const std::size_t count,
+    const std::size_t grain_size,
+    const Work& work
+)
+{
+    if (jobs != nullptr && count > grain_size) {
+        jobs->parallel_for(count, grain_size, work);
+    } else {
+        work(0, count);
+    }
+}
+
+// Parses comma/whitespace separated gids. With a null output it only counts.
+std::size_t parse_csv_gids(
+    const std::string_view text,
+    std::uint32_t* output,
+    const std::size_t output_count
+)
+{
+    std::size_t count = 0;
+    std::uint64_t value = 0;
+    bool in_number = false;
+
+    for (const char character : text) {
+        if (character >= '0' && character <= '9') {
+            value = value * 10 + static_cast<std::uint64_t>(character - '0');
+            in_number = true;
+
+            if (value > UINT32_MAX) {
+                throw std::runtime_error("Tiled CSV gid is out of range");
+            }
+        } else if (character == ',' || is_space(character)) {
+            if (in_number) {
+                if (output != nullptr) {
+                    if (count >= output_count) {
+                        throw std::runtime_error("Tiled CSV layer has too many tiles");
+                    }
+
+                    output[count] = static_cast<std::uint32_t>(value);
+                }
+
+                ++count;
+                value = 0;
+                in_number = false;
+            }
+        } else {
+            throw std::runtime_error("Invalid character in Tiled CSV layer data");
+        }
+    }
+
+    if (in_number) {
+        if (output != nullptr) {
+            if (count >= output_count) {
+                throw std::runtime_error("Tiled CSV layer has too many tiles");
+            }
+
+            output[count] = static_cast<std::uint32_t>(value);
+        }
+
+        ++count;
+    }
+
+    return count;
+}
+
+std::vector<std::uint32_t> decode_csv_layer(
+    const std::string_view text,
+    const std::size_t tile_count,
+    JobSystem* jobs
+)
+{
+    std::vector<std::uint32_t> gids(tile_count);
+
+    if (jobs == nullptr || text.size() < 2 * kParallelSegmentBytes) {
+        if (parse_csv_gids(text, gids.data(), gids.size()) != tile_count) {
+            throw std::runtime_error("Tiled CSV layer has the wrong number of tiles");
+        }
+
+        return gids;
+    }
+
+    // Split on separators so no number straddles two segments, count each
+    // segment in parallel, then parse every segment into its own offset.
+    std::vector<std::string_view> segments;
+    std::size_t begin = 0;
+
+    while (begin < text.size()) {
+        std::size_t end = std::min(begin + kParallelSegmentBytes, text.size());
+
+        while (end < text.size() && text[end] >= '0' && text[end] <= '9') {
+            ++end;
+        }
+
+        segments.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+
+    std::vector<std::size_t> offsets(segments.size() + 1, 0);
+
+    for_each_range(jobs, segments.size(), 1, [&](const std::size_t first, const std::size_t end) {
+        for (std::size_t segment = first; segment < end; ++segment) {
+            offsets[segment + 1] = parse_csv_gids(segments[segment], nullptr, 0);
+        }
+    });
+
+    for (std::size_t segment = 0; segment < segments.size(); ++segment) {
+        offsets[segment + 1] += offsets[segment];
+    }
+
+    if (offsets.back() != tile_count) {
+        throw std::runtime_error("Tiled CSV layer has the wrong number of tiles");
+    }
+
+    for_each_range(jobs, segments.size(), 1, [&](const std::size_t first, const std::size_t end) {
+        for (std::size_t segment = first; segment < end; ++segment) {
+            (void)parse_csv_gids(
+                segments[segment],
+                gids.data() + offsets[segment],
+                offsets[segment + 1] - offsets[segment]
+            );
+        }
+    });
+
+    return gids;
+}
+
+// Decodes whitespace-free base64 in 4-character-aligned segments on the job
+// system, falling back to a single pass when any segment comes up short.
+std::size_t decode_base64_segments(
+    std::string_view text,
+    const std::span<std::byte> output,
+    JobSystem* jobs
+)
+{
+    text = trim(text);
+
+    if (jobs == nullptr || text.size() < 2 * kParallelSegmentBytes) {
+        return decode_base64(text, output);
+    }
+
+    constexpr std::size_t kSegmentCharacters = kParallelSegmentBytes / 4 * 4;
+    constexpr std::size_t kSegmentBytes = kSegmentCharacters / 4 * 3;
+    const std::size_t segment_count =
+        (text.size() + kSegmentCharacters - 1) / kSegmentCharacters;
+    std::vector<std::size_t> decoded_sizes(segment_count, 0);
+    std::atomic<bool> aligned = true;
+
+    for_each_range(jobs, segment_count, 1, [&](const std::size_t first, const std::size_t end) {
+        for (std::size_t segment = first; segment < end; ++segment) {
+            const std::size_t output_offset = segment * kSegmentBytes;
+
+            if (output_offset > output.size()) {
+                aligned.store(false, std::memory_order_relaxed);
+                return;
+            }
+
+            try {
+                decoded_sizes[segment] = decode_base64(
+                    text.substr(segment * kSegmentCharacters, kSegmentCharacters),
+                    output.subspan(output_offset)
+                );
+            } catch (const std::exception&) {
+                aligned.store(false, std::memory_order_relaxed);
+                return;
+            }
+
+            if (segment + 1 < segment_count && decoded_sizes[segment] != kSegmentBytes) {
+                aligned.store(false, std::memory_order_relaxed);
+            }
+        }
+    });
+
+    if (!aligned.load(std::memory_order_relaxed)) {
+        return decode_base64(text, output);
+    }
+
+    return (segment_count - 1) * kSegmentBytes + decoded_sizes.back();
+}
+
+std::size_t inflate_tile_data(
+    const std::span<const std::byte> input,
+    const std::span<std::byte> output
+)
+{
+    z_stream stream{};
+
+    // 32 + MAX_WBITS accepts both zlib and gzip headers.
+    if (inflateInit2(&stream, 32 + MAX_WBITS) != Z_OK) {
+        throw std::runtime_error("Failed to initialize zlib");
+    }
+
+    const std::byte* input_position = input.data();
+    std::size_t input_remaining = input.size();
+    std::byte* output_position = output.data();
+    std::size_t output_remaining = output.size();
+    int result = Z_OK;
+
+    while (result != Z_STREAM_END) {
+        const auto input_chunk =
+            static_cast<uInt>(std::min<std::size_t>(input_remaining, UINT_MAX));
+        const auto output_chunk =
+            static_cast<uInt>(std::min<std::size_t>(output_remaining, UINT_MAX));
+
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<std::byte*>(input_position));
+        stream.avail_in = input_chunk;
+        stream.next_out = reinterpret_cast<Bytef*>(output_position);
+        stream.avail_out = output_chunk;
+
+        result = inflate(&stream, Z_NO_FLUSH);
+
+        const std::size_t consumed = input_chunk - stream.avail_in;
+        const std::size_t produced = output_chunk - stream.avail_out;
+
+        input_position += consumed;
+        input_remaining -= consumed;
+        output_position += produced;
+        output_remaining -= produced;
+
+        if (result == Z_STREAM_END) {
+            break;
+        }
+
+        if ((result != Z_OK && result != Z_BUF_ERROR) ||
+            (consumed == 0 && produced == 0)) {
+            inflateEnd(&stream);
+            throw std::runtime_error("Failed to inflate Tiled layer data");
+        }
+    }
+
+    inflateEnd(&stream);
+
+    return output.size() - output_remaining;
+}
+
+void gids_from_little_endian(std::span<std::uint32_t> gids) noexcept
+{
+    if constexpr (std::endian::native == std::endian::big) {
+        for (std::uint32_t& gid : gids) {
+            gid = (gid >> 24) |
+                  ((gid >> 8) & 0x0000'FF00u) |
+                  ((gid << 8) & 0x00FF'0000u) |
+                  (gid << 24);
+        }
+    } else {
+        (void)gids;
+    }
+}
+
+std::vector<std::uint32_t> decode_base64_layer(
+    const LayerSource& layer,
+    const std::size_t tile_count,
+    JobSystem* jobs
+)
+{
+    if (layer.compression == LayerCompression::Zstd) {
+        throw std::runtime_error("zstd-compressed Tiled layers are not supported");
+    }
+
+    std::vector<std::uint32_t> gids(tile_count);
+    const std::span<std::byte> gid_bytes = std::as_writable_bytes(std::span(gids));
+    std::size_t decoded_bytes = 0;
+
+    if (layer.compression == LayerCompression::None) {
+        decoded_bytes = decode_base64_segments(layer.data, gid_bytes, jobs);
+    } else {
+        std::vector<std::byte> compressed(layer.data.size() / 4 * 3 + 3);
+        compressed.resize(decode_base64_segments(layer.data, compressed, jobs));
+        decoded_bytes = inflate_tile_data(compressed, gid_bytes);
+    }
+
+    if (decoded_bytes != gid_bytes.size()) {
+        throw std::runtime_error("Tiled base64 layer has the wrong number of tiles");
+    }
+
+    gids_from_little_endian(gids);
+
+    return gids;
+}
+
+TiledTileLayer decode_layer(
+    LayerSource& layer,
+    const TiledMap& map,
+    JobSystem* jobs
+)
+{
+    if (layer.width != map.width || layer.height != map.height) {
+        throw std::runtime_error(
+            "Tiled layer " + layer.name + " does not match the map dimensions"
+        );
+    }
+
+    const std::size_t tile_count =
+        static_cast<std::size_t>(layer.width) * layer.height;
+    TiledTileLayer decoded{.name = std::move(layer.name), .gids = {}};
+
+    switch (layer.format) {
+        case LayerDataFormat::Csv:
+            if (layer.compression != LayerCompression::None) {
+                throw std::runtime_error("Compressed CSV Tiled layers are not supported");
+            }
+
+            decoded.gids = decode_csv_layer(layer.data, tile_count, jobs);
+            break;
+
+        case LayerDataFormat::Base64:
+            decoded.gids = decode_base64_layer(layer, tile_count, jobs);
+            break;
+
+        case LayerDataFormat::XmlTiles:
+            if (layer.xml_gids.size() != tile_count) {
+                throw std::runtime_error("Tiled XML layer has the wrong number of tiles");
+            }
+
+            decoded.gids = std::move(layer.xml_gids);
+            break;
+    }
+
+    return decoded;
+}
+
+void append_uint(std::string& text, const std::uint32_t value)
+{
+    char buffer[16];
+    const auto result = std::to_chars(std::begin(buffer), std::end(buffer), value);
+    text.append(buffer, result.ptr);
+}
+
+void append_xml_escaped(std::string& text, const std::string_view value)
+{
+    for (const char character : value) {
+        switch (character) {
+            case '&':
+                text += "&amp;";
+                break;
+
+            case '<':
+                text += "&lt;";
+                break;
+
+            case '>':
+                text += "&gt;";
+                break;
+
+            case '"':
+                text += "&quot;";
+                break;
+
+            default:
+                text.push_back(character);
+                break;
+        }
+    }
+}
+
+void append_json_string(std::string& text, const std::string_view value)
+{
+    static constexpr char kHexDigits[] = "0123456789abcdef";
+
+    text.push_back('"');
+
+    for (const char character : value) {
+        const auto byte = static_cast<unsigned char>(character);
+
+        if (character == '"' || character == '\\') {
+            text.push_back('\\');
+            text.push_back(character);
+        } else if (byte < 0x20) {
+            text += "\\u00";
+            text.push_back(kHexDigits[byte >> 4]);
+            text.push_back(kHexDigits[byte & 0x0F]);
+        } else {
+            text.push_back(character);
+        }
+    }
+
+    text.push_back('"');
+}
+
+void append_csv_gids(
+    std::string& text,
+    const TiledMap& map,
+    const std::vector<std::uint32_t>& gids,
+    const bool line_per_row
+)
+{
+    for (std::size_t index = 0; index < gids.size(); ++index) {
+        append_uint(text, gids[index]);
+
+        if (index + 1 < gids.size()) {
+            text.push_back(',');
+
+            if (line_per_row && (index + 1) % map.width == 0) {
+                text.push_back('\n');
+            }
+        }
+    }
+}
+
+std::string encode_base64_gids(
+    const std::vector<std::uint32_t>& gids,
+    const TiledDataEncoding encoding
+)
+{
+    std::vector<std::uint32_t> little_endian_gids;
+    std::span<const std::uint32_t> source(gids);
+
+    if constexpr (std::endian::native == std::endian::big) {
+        little_endian_gids = gids;
+        gids_from_little_endian(little_endian_gids);
+        source = little_endian_gids;
+    }
+
+    const std::span<const std::byte> bytes = std::as_bytes(source);
+
+    if (encoding != TiledDataEncoding::Base64Zlib) {
+        return encode_base64(bytes);
+    }
+
+    uLongf compressed_size = compressBound(static_cast<uLong>(bytes.size()));
+    std::vector<std::byte> compressed(compressed_size);
+
+    if (compress2(
+            reinterpret_cast<Bytef*>(compressed.data()),
+            &compressed_size,
+            reinterpret_cast<const Bytef*>(bytes.data()),
+            static_cast<uLong>(bytes.size()),
+            Z_DEFAULT_COMPRESSION
+        ) != Z_OK) {
+        throw std::runtime_error("Failed to compress Tiled layer data");
+    }
+
+    compressed.resize(compressed_size);
+
+    return encode_base64(compressed);
+}
+
+std::string write_tmx(const TiledMap& map, const TiledDataEncoding encoding)
+{
+    std::string text;
+    text += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    text += "<map version=\"";
+    text += kTiledVersion;
+    text += "\" orientation=\"orthogonal\" renderorder=\"right-down\" width=\"";
+    append_uint(text, map.width);
+    text += "\" height=\"";
+    append_uint(text, map.height);
+    text += "\" tilewidth=\"";
+    append_uint(text, map.tile_width);
+    text += "\" tileheight=\"";
+    append_uint(text, map.tile_height);
+    text += "\" infinite=\"0\" nextlayerid=\"";
+    append_uint(text, static_cast<std::uint32_t>(map.layers.size() + 1));
+    text += "\" nextobjectid=\"1\">\n";
+
+    for (const TiledTileset& tileset : map.tilesets) {
+        text += " <tileset firstgid=\"";
+        append_uint(text, tileset.first_gid);
+        text += "\" name=\"";
+        append_xml_escaped(text, tileset.name);
+        text += "\" tilewidth=\"";
+        append_uint(text, tileset.tile_width);
+        text += "\" tileheight=\"";
+        append_uint(text, tileset.tile_height);
+        text += "\" tilecount=\"";
+        append_uint(text, tileset.tile_count);
+        text += "\" columns=\"";
+        append_uint(text, tileset.columns);
+        text += "\">\n  <image source=\"";
+        append_xml_escaped(text, tileset.image_source);
+        text += "\" width=\"";
+        append_uint(text, tileset.image_width);
+        text += "\" height=\"";
+        append_uint(text, tileset.image_height);
+        text += "\"/>\n </tileset>\n";
+    }
+
+    for (std::size_t layer = 0; layer < map.layers.size(); ++layer) {
+        text += " <layer id=\"";
+        append_uint(text, static_cast<std::uint32_t>(layer + 1));
+        text += "\" name=\"";
+        append_xml_escaped(text, map.layers[layer].name);
+        text += "\" width=\"";
+        append_uint(text, map.width);
+        text += "\" height=\"";
+        append_uint(text, map.height);
+        text += "\">\n";
+
+        if (encoding == TiledDataEncoding::Csv) {
+            text += "  <data encoding=\"csv\">\n";
+            append_csv_gids(text, map, map.layers[layer].gids, true);
+            text += "\n</data>\n";
+        } else {
+            text += encoding == TiledDataEncoding::Base64Zlib
+                ? "  <data encoding=\"base64\" compression=\"zlib\">\n   "
+                : "  <data encoding=\"base64\">\n   ";
+            text += encode_base64_gids(map.layers[layer].gids, encoding);
+            text += "\n  </data>\n";
+        }
+
+        text += " </layer>\n";
+    }
+
+    text += "</map>\n";
+
+    return text;
+}
+
+std::string write_tmj(const TiledMap& map, const TiledDataEncoding encoding)
+{
+    std::string text;
+    text += "{ \"compressionlevel\":-1,\n \"height\":";
+    append_uint(text, map.height);
+    text += ",\n \"infinite\":false,\n \"layers\":[";
+
+    for (std::size_t layer = 0; layer < map.layers.size(); ++layer) {
+        text += layer == 0 ? "\n  {\n" : ",\n  {\n";
+
+        if (encoding == TiledDataEncoding::Csv) {
+            text += "   \"data\":[";
+            append_csv_gids(text, map, map.layers[layer].gids, false);
+            text += "],\n";
+        } else {
+            if (encoding == TiledDataEncoding::Base64Zlib) {
+                text += "   \"compression\":\"zlib\",\n";
+            }
+
+            text += "   \"data\":\"";
+            text += encode_base64_gids(map.layers[layer].gids, encoding);
+            text += "\",\n   \"encoding\":\"base64\",\n";
+        }
+
+        text += "   \"height\":";
+        append_uint(text, map.height);
+        text += ",\n   \"id\":";
+        append_uint(text, static_cast<std::uint32_t>(layer + 1));
+        text += ",\n   \"name\":";
+        append_json_string(text, map.layers[layer].name);
+        text += ",\n   \"opacity\":1,\n   \"type\":\"tilelayer\",\n   \"visible\":true,\n   \"width\":";
+        append_uint(text, map.width);
+        text += ",\n   \"x\":0,\n   \"y\":0\n  }";
+    }
+
+    text += "],\n \"nextlayerid\":";
+    append_uint(text, static_cast<std::uint32_t>(map.layers.size() + 1));
+    text += ",\n \"nextobjectid\":1,\n \"orientation\":\"orthogonal\",\n \"renderorder\":\"right-down\",\n \"tiledversion\":\"";
+    text += kTiledVersion;
+    text += "\",\n \"tileheight\":";
+    append_uint(text, map.tile_height);
+    text += ",\n \"tilesets\":[";
+
+    for (std::size_t index = 0; index < map.tilesets.size(); ++index) {
+        const TiledTileset& tileset = map.tilesets[index];
+
+        text += index == 0 ? "\n  {\n   \"columns\":" : ",\n  {\n   \"columns\":";
+        append_uint(text, tileset.columns);
+        text += ",\n   \"firstgid\":";
+        append_uint(text, tileset.first_gid);
+        text += ",\n   \"image\":";
+        append_json_string(text, tileset.image_source);
+        text += ",\n   \"imageheight\":";
+        append_uint(text, tileset.image_height);
+        text += ",\n   \"imagewidth\":";
+        append_uint(text, tileset.image_width);
+        text += ",\n   \"margin\":0,\n   \"name\":";
+        append_json_string(text, tileset.name);
+        text += ",\n   \"spacing\":0,\n   \"tilecount\":";
+        append_uint(text, tileset.tile_count);
+        text += ",\n   \"tileheight\":";
+        append_uint(text, tileset.tile_height);
+        text += ",\n   \"tilewidth\":";
+        append_uint(text, tileset.tile_width);
+        text += "\n  }";
+    }
+
+    text += "],\n \"tilewidth\":";
+    append_uint(text, map.tile_width);
+    text += ",\n \"type\":\"map\",\n \"version\":\"";
+    text += kTiledVersion;
+    text += "\",\n \"width\":";
+    append_uint(text, map.width);
+    text += "\n}\n";
+
+    return text;
+}
+
+}
+
+TiledMap import_tiled_map(
+    const std::filesystem::path& path,
+    JobSystem* jobs
+)
+{
+    const MappedFile file(path);
+    const std::span<const std::byte> bytes = file.bytes();
+    const std::string_view text(
+        reinterpret_cast<const char*>(bytes.data()),
+        bytes.size()
+    );
+    const std::string_view content = trim(text);
+
+    TiledMap map;
+    std::vector<LayerSource> layers;
+
+    try {
+        if (content.starts_with('<')) {
+            parse_tmx(content, map, layers);
+        } else if (content.starts_with('{')) {
+            parse_tmj(content, map, layers);
+        } else {
+            throw std::runtime_error("Unrecognized Tiled map format");
+        }
+
+        if (map.width == 0 || map.height == 0) {
+            throw std::runtime_error("Tiled map has no tiles");
+        }
+
+        map.layers.resize(layers.size());
+
+        for_each_range(jobs, layers.size(), 1, [&](const std::size_t first, const std::size_t end) {
+            for (std::size_t layer = first; layer < end; ++layer) {
+                map.layers[layer] = decode_layer(layers[layer], map, jobs);
+            }
+        });
+    } catch (const std::exception& error) {
+        throw std::runtime_error(path.string() + ": " + error.what());
+    }
+
+    return map;
+}
+
+void export_tiled_map(
+    const std::filesystem::path& path,
+    const TiledMap& map,
+    const TiledDataEncoding encoding
+)
+{
+    const std::size_t tile_count = static_cast<std::size_t>(map.width) * map.height;
+
+    for (const TiledTileLayer& layer : map.layers) {
+        if (layer.gids.size() != tile_count) {
+            throw std::runtime_error(
+                "Tiled layer " + layer.name + " does not match the map dimensions"
+            );
+        }
+    }
+
+    const std::filesystem::path extension = path.extension();
+    const std::string text =
+        extension == ".tmj" || extension == ".json"
+            ? write_tmj(map, encoding)
+            : write_tmx(map, encoding);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+    if (!file) {
+        throw std::runtime_error("Failed to create Tiled map: " + path.string());
+    }
+
+    file.write(text.data(), static_cast<std::streamsize>(text.size()));
+
+    if (!file) {
+        throw std::runtime_error("Failed to write Tiled map: " + path.string());
+    }
+}
+
+}
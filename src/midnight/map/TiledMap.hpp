@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace midnight {
+
+class JobSystem;
+
+// Tiled stores flip and rotation flags in the top four bits of each gid.
+inline constexpr std::uint32_t kTiledGidMask = 0x0FFF'FFFFu;
+
+enum class TiledDataEncoding : std::uint8_t {
+    Csv,
+    Base64,
+    Base64Zlib
+};
+
+struct TiledTileset final {
+    std::uint32_t first_gid = 1;
+    std::string name;
+    std::uint32_t tile_width = 0;
+    std::uint32_t tile_height = 0;
+    std::uint32_t tile_count = 0;
+    std::uint32_t columns = 0;
+    std::string image_source;
+    std::uint32_t image_width = 0;
+    std::uint32_t image_height = 0;
+};
+
+struct TiledTileLayer final {
+    std::string name;
+    std::vector<std::uint32_t> gids;
+};
+
+struct TiledMap final {
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    std::uint32_t tile_width = 0;
+    std::uint32_t tile_height = 0;
+    std::vector<TiledTileset> tilesets;
+    std::vector<TiledTileLayer> layers;
+};
+
+// Reads a finite orthogonal TMX (XML) or TMJ (JSON) map, chosen by the first
+// character of the file. Tile layers inside groups are flattened in document
+// order. Layer data may be CSV, XML tiles or base64 with optional zlib/gzip
+// compression; layers are decoded on `jobs` when it is given.
+[[nodiscard]] TiledMap import_tiled_map(
+    const std::filesystem::path& path,
+    JobSystem* jobs
+);
+
+// Writes TMJ for .tmj/.json paths and TMX otherwise.
+void export_tiled_map(
+    const std::filesystem::path& path,
+    const TiledMap& map,
+    TiledDataEncoding encoding
+);
+
+}
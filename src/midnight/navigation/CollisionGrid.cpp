@@ -0,0 +1,128 @@
+#include "midnight/navigation/CollisionGrid.hpp"
+
+#include <stdexcept>
+
+namespace midnight {
+
+CollisionGrid::CollisionGrid(
+    const std::uint32_t columns,
+    const std::uint32_t rows,
+    const std::uint32_t chunk_size
+)
+    : columns_(columns),
+      rows_(rows),
+      chunk_size_(chunk_size)
+{
+    if (columns_ == 0 || rows_ == 0) {
+        throw std::runtime_error("Cannot create an empty collision grid");
+    }
+
+    if (chunk_size_ == 0) {
+        throw std::runtime_error("Collision grid chunk size must be positive");
+    }
+
+    chunk_columns_ = (columns_ + chunk_size_ - 1) / chunk_size_;
+    chunk_rows_ = (rows_ + chunk_size_ - 1) / chunk_size_;
+    blocked_cells_.assign(cell_count(), 0);
+    chunk_revisions_.assign(chunk_count(), 0);
+}
+
+std::uint32_t CollisionGrid::columns() const noexcept
+{
+    return columns_;
+}
+
+std::uint32_t CollisionGrid::rows() const noexcept
+{
+    return rows_;
+}
+
+std::size_t CollisionGrid::cell_count() const noexcept
+{
+    return static_cast<std::size_t>(columns_) * rows_;
+}
+
+std::uint32_t CollisionGrid::chunk_size() const noexcept
+{
+    return chunk_size_;
+}
+
+std::uint32_t CollisionGrid::chunk_columns() const noexcept
+{
+    return chunk_columns_;
+}
+
+std::uint32_t CollisionGrid::chunk_rows() const noexcept
+{
+    return chunk_rows_;
+}
+
+std::size_t CollisionGrid::chunk_count() const noexcept
+{
+    return static_cast<std::size_t>(chunk_columns_) * chunk_rows_;
+}
+
+bool CollisionGrid::contains(
+    const std::int64_t column,
+    const std::int64_t row
+) const noexcept
+{
+    return column >= 0 &&
+        row >= 0 &&
+        column < static_cast<std::int64_t>(columns_) &&
+        row < static_cast<std::int64_t>(rows_);
+}
+
+bool CollisionGrid::blocked(
+    const std::uint32_t column,
+    const std::uint32_t row
+) const noexcept
+{
+    return blocked(static_cast<std::size_t>(row) * columns_ + column);
+}
+
+bool CollisionGrid::blocked(const std::size_t cell_index) const noexcept
+{
+    return blocked_cells_[cell_index] != 0;
+}
+
+bool CollisionGrid::set_blocked(
+    const std::uint32_t column,
+    const std::uint32_t row,
+    const bool blocked
+)
+{
+    if (column >= columns_ || row >= rows_) {
+        throw std::runtime_error("Collision grid cell is outside the grid");
+    }
+
+    std::uint8_t& cell =
+        blocked_cells_[static_cast<std::size_t>(row) * columns_ + column];
+    const std::uint8_t value = blocked ? 1 : 0;
+
+    if (cell == value) {
+        return false;
+    }
+
+    cell = value;
+    ++chunk_revisions_[chunk_index(column, row)];
+    return true;
+}
+
+std::size_t CollisionGrid::chunk_index(
+    const std::uint32_t column,
+    const std::uint32_t row
+) const noexcept
+{
+    return static_cast<std::size_t>(row / chunk_size_) * chunk_columns_ +
+        column / chunk_size_;
+}
+
+std::uint64_t CollisionGrid::chunk_revision(
+    const std::size_t chunk_index
+) const noexcept
+{
+    return chunk_revisions_[chunk_index];
+}
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace midnight {
+
+class CollisionGrid final {
+public:
+    CollisionGrid(
+        std::uint32_t columns,
+        std::uint32_t rows,
+        std::uint32_t chunk_size
+    );
+
+    [[nodiscard]] std::uint32_t columns() const noexcept;
+    [[nodiscard]] std::uint32_t rows() const noexcept;
+    [[nodiscard]] std::size_t cell_count() const noexcept;
+    [[nodiscard]] std::uint32_t chunk_size() const noexcept;
+    [[nodiscard]] std::uint32_t chunk_columns() const noexcept;
+    [[nodiscard]] std::uint32_t chunk_rows() const noexcept;
+    [[nodiscard]] std::size_t chunk_count() const noexcept;
+
+    [[nodiscard]] bool contains(
+        std::int64_t column,
+        std::int64_t row
+    ) const noexcept;
+    [[nodiscard]] bool blocked(
+        std::uint32_t column,
+        std::uint32_t row
+    ) const noexcept;
+    [[nodiscard]] bool blocked(std::size_t cell_index) const noexcept;
+    bool set_blocked(
+        std::uint32_t column,
+        std::uint32_t row,
+        bool blocked
+    );
+
+    [[nodiscard]] std::size_t chunk_index(
+        std::uint32_t column,
+        std::uint32_t row
+    ) const noexcept;
+    [[nodiscard]] std::uint64_t chunk_revision(
+        std::size_t chunk_index
+    ) const noexcept;
+
+private:
+    std::uint32_t columns_ = 0;
+    std::uint32_t rows_ = 0;
+    std::uint32_t chunk_size_ = 0;
+    std::uint32_t chunk_columns_ = 0;
+    std::uint32_t chunk_rows_ = 0;
+    std::vector<std::uint8_t> blocked_cells_;
+    std::vector<std::uint64_t> chunk_revisions_;
+};
+
+}
@@ -0,0 +1,315 @@
+#include "midnight/navigation/FlowField.hpp"
+
+#include "midnight/core/JobSystem.hpp"
+#include "midnight/navigation/CollisionGrid.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+
+namespace midnight {
+namespace {
+
+constexpr std::size_t kFlowFieldFrontierGrainSize = 4096;
+
+}
+
+FlowField::FlowField(
+    const CollisionGrid& grid,
+    const std::uint32_t goal_column,
+    const std::uint32_t goal_row,
+    JobSystem* jobs
+)
+    : columns_(grid.columns()),
+      rows_(grid.rows())
+{
+    if (!grid.contains(goal_column, goal_row)) {
+        throw std::runtime_error("Flow field goal is outside the collision grid");
+    }
+
+    goal_cell_ = goal_row * columns_ + goal_column;
+    build_integration_field(grid, jobs);
+    record_dependencies(grid);
+}
+
+std::uint32_t FlowField::columns() const noexcept
+{
+    return columns_;
+}
+
+std::uint32_t FlowField::rows() const noexcept
+{
+    return rows_;
+}
+
+std::uint32_t FlowField::goal_cell() const noexcept
+{
+    return goal_cell_;
+}
+
+std::size_t FlowField::reachable_cell_count() const noexcept
+{
+    return reachable_cell_count_;
+}
+
+std::uint32_t FlowField::integration(
+    const std::uint32_t column,
+    const std::uint32_t row
+) const noexcept
+{
+    return integration_[static_cast<std::size_t>(row) * columns_ + column];
+}
+
+FlowDirection FlowField::direction(
+    const std::uint32_t column,
+    const std::uint32_t row
+) const noexcept
+{
+    return directions_[static_cast<std::size_t>(row) * columns_ + column];
+}
+
+bool FlowField::current(const CollisionGrid& grid) const noexcept
+{
+    if (grid.columns() != columns_ || grid.rows() != rows_) {
+        return false;
+    }
+
+    for (std::size_t dependency = 0;
+         dependency < dependency_chunks_.size();
+         ++dependency) {
+        if (grid.chunk_revision(dependency_chunks_[dependency]) !=
+            dependency_revisions_[dependency]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void FlowField::build_integration_field(
+    const CollisionGrid& grid,
+    JobSystem* jobs
+)
+{
+    const std::size_t cell_count = grid.cell_count();
+
+    integration_.assign(cell_count, kUnreachable);
+    directions_.assign(cell_count, FlowDirection::None);
+
+    if (grid.blocked(static_cast<std::size_t>(goal_cell_))) {
+        return;
+    }
+
+    integration_[goal_cell_] = 0;
+    reachable_cell_count_ = 1;
+
+    std::vector<std::uint32_t> frontier;
+    frontier.reserve(cell_count);
+    frontier.push_back(goal_cell_);
+
+    std::vector<std::vector<std::uint32_t>> next_frontiers;
+    std::uint32_t level = 0;
+
+    const auto for_each_range = [jobs](
+        const std::size_t count,
+        const std::size_t grain_size,
+        const JobSystem::RangeWork& work
+    ) {
+        if (jobs != nullptr) {
+            jobs->parallel_for(count, grain_size, work);
+        } else {
+            work(0, count);
+        }
+    };
+
+    while (!frontier.empty()) {
+        const std::size_t range_count =
+            (frontier.size() + kFlowFieldFrontierGrainSize - 1) /
+            kFlowFieldFrontierGrainSize;
+
+        if (next_frontiers.size() < range_count) {
+            next_frontiers.resize(range_count);
+        }
+
+        for_each_range(
+            frontier.size(),
+            kFlowFieldFrontierGrainSize,
+            [&](const std::size_t first, const std::size_t end) {
+                std::vector<std::uint32_t>& next_frontier =
+                    next_frontiers[first / kFlowFieldFrontierGrainSize];
+
+                const auto visit = [&](const std::uint32_t neighbor_cell) {
+                    if (grid.blocked(static_cast<std::size_t>(neighbor_cell))) {
+                        return;
+                    }
+
+                    std::atomic_ref<std::uint32_t> neighbor_integration(
+                        integration_[neighbor_cell]
+                    );
+                    std::uint32_t expected = kUnreachable;
+
+                    if (neighbor_integration.load(std::memory_order_relaxed) ==
+                            kUnreachable &&
+                        neighbor_integration.compare_exchange_strong(
+                            expected,
+                            level + 1,
+                            std::memory_order_relaxed
+                        )) {
+                        next_frontier.push_back(neighbor_cell);
+                    }
+                };
+
+                for (std::size_t index = first; index < end; ++index) {
+                    const std::uint32_t cell = frontier[index];
+                    const std::uint32_t column = cell % columns_;
+                    const std::uint32_t row = cell / columns_;
+
+                    if (column > 0) {
+                        visit(cell - 1);
+                    }
+
+                    if (column + 1 < columns_) {
+                        visit(cell + 1);
+                    }
+
+                    if (row > 0) {
+                        visit(cell - columns_);
+                    }
+
+                    if (row + 1 < rows_) {
+                        visit(cell + columns_);
+                    }
+                }
+            }
+        );
+
+        frontier.clear();
+
+        for (std::size_t range = 0; range < range_count; ++range) {
+            frontier.insert(
+                frontier.end(),
+                next_frontiers[range].begin(),
+                next_frontiers[range].end()
+            );
+            next_frontiers[range].clear();
+        }
+
+        reachable_cell_count_ += frontier.size();
+        ++level;
+    }
+
+    for_each_range(
+        rows_,
+        std::max<std::size_t>(kFlowFieldFrontierGrainSize / columns_, 1),
+        [this](const std::size_t first_row, const std::size_t end_row) {
+            build_direction_rows(
+                static_cast<std::uint32_t>(first_row),
+                static_cast<std::uint32_t>(end_row)
+            );
+        }
+    );
+}
+
+void FlowField::build_direction_rows(
+    const std::uint32_t first_row,
+    const std::uint32_t end_row
+) noexcept
+{
+    for (std::uint32_t row = first_row; row < end_row; ++row) {
+        for (std::uint32_t column = 0; column < columns_; ++column) {
+            const std::size_t cell =
+                static_cast<std::size_t>(row) * columns_ + column;
+            std::uint32_t best_integration = integration_[cell];
+            FlowDirection best_direction = FlowDirection::None;
+
+            const auto consider = [&](
+                const std::size_t neighbor_cell,
+                const FlowDirection direction
+            ) {
+                if (integration_[neighbor_cell] < best_integration) {
+                    best_integration = integration_[neighbor_cell];
+                    best_direction = direction;
+                }
+            };
+
+            if (best_integration == kUnreachable || best_integration == 0) {
+                continue;
+            }
+
+            if (column > 0) {
+                consider(cell - 1, FlowDirection::Left);
+            }
+
+            if (column + 1 < columns_) {
+                consider(cell + 1, FlowDirection::Right);
+            }
+
+            if (row > 0) {
+                consider(cell - columns_, FlowDirection::Up);
+            }
+
+            if (row + 1 < rows_) {
+                consider(cell + columns_, FlowDirection::Down);
+            }
+
+            directions_[cell] = best_direction;
+        }
+    }
+}
+
+void FlowField::record_dependencies(const CollisionGrid& grid)
+{
+    std::vector<std::uint8_t> reached_chunks(grid.chunk_count(), 0);
+    reached_chunks[
+        grid.chunk_index(goal_cell_ % columns_, goal_cell_ / columns_)
+    ] = 1;
+
+    for (std::size_t cell = 0; cell < integration_.size(); ++cell) {
+        if (integration_[cell] != kUnreachable) {
+            reached_chunks[
+                grid.chunk_index(
+                    static_cast<std::uint32_t>(cell % columns_),
+                    static_cast<std::uint32_t>(cell / columns_)
+                )
+            ] = 1;
+        }
+    }
+
+    const std::uint32_t chunk_columns = grid.chunk_columns();
+    std::vector<std::uint8_t> dependent_chunks(reached_chunks.size(), 0);
+
+    for (std::size_t chunk = 0; chunk < reached_chunks.size(); ++chunk) {
+        if (reached_chunks[chunk] == 0) {
+            continue;
+        }
+
+        const std::size_t chunk_column = chunk % chunk_columns;
+
+        dependent_chunks[chunk] = 1;
+
+        if (chunk_column > 0) {
+            dependent_chunks[chunk - 1] = 1;
+        }
+
+        if (chunk_column + 1 < chunk_columns) {
+            dependent_chunks[chunk + 1] = 1;
+        }
+
+        if (chunk >= chunk_columns) {
+            dependent_chunks[chunk - chunk_columns] = 1;
+        }
+
+        if (chunk + chunk_columns < dependent_chunks.size()) {
+            dependent_chunks[chunk + chunk_columns] = 1;
+        }
+    }
+
+    for (std::size_t chunk = 0; chunk < dependent_chunks.size(); ++chunk) {
+        if (dependent_chunks[chunk] != 0) {
+            dependency_chunks_.push_back(chunk);
+            dependency_revisions_.push_back(grid.chunk_revision(chunk));
+        }
+    }
+}
+
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace midnight {
+
+class CollisionGrid;
+class JobSystem;
+
+enum class FlowDirection : std::uint8_t {
+    None,
+    Left,
+    Right,
+    Up,
+    Down
+};
+
+class FlowField final {
+public:
+    static constexpr std::uint32_t kUnreachable =
+        std::numeric_limits<std::uint32_t>::max();
+
+    FlowField(
+        const CollisionGrid& grid,
+        std::uint32_t goal_column,
+        std::uint32_t goal_row,
+        JobSystem* jobs
+    );
+
+    FlowField(const FlowField&) = delete;
+    FlowField& operator=(const FlowField&) = delete;
+
+    FlowField(FlowField&&) = delete;
+    FlowField& operator=(FlowField&&) = delete;
+
+    [[nodiscard]] std::uint32_t columns() const noexcept;
+    [[nodiscard]] std::uint32_t rows() const noexcept;
+    [[nodiscard]] std::uint32_t goal_cell() const noexcept;
+    [[nodiscard]] std::size_t reachable_cell_count() const noexcept;
+
+    [[nodiscard]] std::uint32_t integration(
+        std::uint32_t column,
+        std::uint32_t row
+    ) const noexcept;
+    [[nodiscard]] FlowDirection direction(
+        std::uint32_t column,
+        std::uint32_t row
+    ) const noexcept;
+
+    [[nodiscard]] bool current(const CollisionGrid& grid) const noexcept;
+
+private:
+    void build_integration_field(
+        const CollisionGrid& grid,
+        JobSystem* jobs
+    );
+    void build_direction_rows(
+        std::uint32_t first_row,
+        std::uint32_t end_row
+    ) noexcept;
+    void record_dependencies(const CollisionGrid& grid);
+
+    std::uint32_t columns_ = 0;
+    std::uint32_t rows_ = 0;
+    std::uint32_t goal_cell_ = 0;
+    std::size_t reachable_cell_count_ = 0;
+    std::vector<std::uint32_t> integration_;
+    std::vector<FlowDirection> directions_;
+    std::vector<std::size_t> dependency_chunks_;
+    std::vector<std::uint64_t> dependency_revisions_;
+};
+
+}
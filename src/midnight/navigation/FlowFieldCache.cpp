@@ -0,0 +1,88 @@
+#include "midnight/navigation/FlowFieldCache.hpp"
+
+#include "midnight/navigation/CollisionGrid.hpp"
+
+#include <stdexcept>
+
+namespace midnight {
+
+FlowFieldCache::FlowFieldCache(
+    const CollisionGrid& grid,
+    const std::size_t capacity,
+    JobSystem* jobs
+)
+    : grid_(grid),
+      capacity_(capacity),
+      jobs_(jobs)
+{
+    if (capacity_ == 0) {
+        throw std::runtime_error("Flow field cache capacity must be positive");
+    }
+}
+
+std::shared_ptr<const FlowField> FlowFieldCache::field_to(
+    const std::uint32_t goal_column,
+    const std::uint32_t goal_row
+)
+{
+    if (!grid_.contains(goal_column, goal_row)) {
+        throw std::runtime_error("Flow field goal is outside the collision grid");
+    }
+
+    const std::uint32_t goal_cell = goal_row * grid_.columns() + goal_column;
+    const auto cached = fields_by_goal_.find(goal_cell);
+
+    if (cached != fields_by_goal_.end()) {
+        if ((*cached->second)->current(grid_)) {
+            ++stats_.hits;
+            fields_.splice(fields_.begin(), fields_, cached->second);
+            return fields_.front();
+        }
+
+        ++stats_.invalidations;
+        fields_.erase(cached->second);
+        fields_by_goal_.erase(cached);
+    }
+
+    ++stats_.misses;
+
+    auto field = std::make_shared<const FlowField>(
+        grid_,
+        goal_column,
+        goal_row,
+        jobs_
+    );
+
+    if (fields_.size() == capacity_) {
+        fields_by_goal_.erase(fields_.back()->goal_cell());
+        fields_.pop_back();
+        ++stats_.evictions;
+    }
+
+    fields_.push_front(field);
+    fields_by_goal_.emplace(goal_cell, fields_.begin());
+    return field;
+}
+
+void FlowFieldCache::clear() noexcept
+{
+    fields_.clear();
+    fields_by_goal_.clear();
+}
+
+std::size_t FlowFieldCache::size() const noexcept
+{
+    return fields_.size();
+}
+
+std::size_t FlowFieldCache::capacity() const noexcept
+{
+    return capacity_;
+}
+
+const FlowFieldCache::Stats& FlowFieldCache::stats() const noexcept
+{
+    return stats_;
+}
+
+}
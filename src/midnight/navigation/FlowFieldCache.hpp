@@ -0,0 +1,59 @@
+#pragma once
+
+#include "midnight/navigation/FlowField.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace midnight {
+
+class CollisionGrid;
+class JobSystem;
+
+class FlowFieldCache final {
+public:
+    struct Stats final {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t invalidations = 0;
+        std::size_t evictions = 0;
+    };
+
+    FlowFieldCache(
+        const CollisionGrid& grid,
+        std::size_t capacity,
+        JobSystem* jobs
+    );
+
+    FlowFieldCache(const FlowFieldCache&) = delete;
+    FlowFieldCache& operator=(const FlowFieldCache&) = delete;
+
+    FlowFieldCache(FlowFieldCache&&) = delete;
+    FlowFieldCache& operator=(FlowFieldCache&&) = delete;
+
+    [[nodiscard]] std::shared_ptr<const FlowField> field_to(
+        std::uint32_t goal_column,
+        std::uint32_t goal_row
+    );
+
+    void clear() noexcept;
+
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] std::size_t capacity() const noexcept;
+    [[nodiscard]] const Stats& stats() const noexcept;
+
+private:
+    using FieldList = std::list<std::shared_ptr<const FlowField>>;
+
+    const CollisionGrid& grid_;
+    std::size_t capacity_ = 0;
+    JobSystem* jobs_ = nullptr;
+    FieldList fields_;
+    std::unordered_map<std::uint32_t, FieldList::iterator> fields_by_goal_;
+    Stats stats_{};
+};
+
+}
@@ -0,0 +1,777 @@
+#include "midnight/navigation/HierarchicalPathfinder.hpp"
+
+#include "midnight/core/LinearArena.hpp"
+#include "midnight/navigation/CollisionGrid.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <memory_resource>
+#include <queue>
+#include <unordered_map>
+
+namespace midnight {
+namespace {
+
+constexpr std::uint32_t kUnreachable =
+    std::numeric_limits<std::uint32_t>::max();
+constexpr std::uint32_t kMaxSingleTransitionEntranceWidth = 6;
+
+template <typename TransitionList, typename MakeTransition>
+void append_border_entrances(
+    const CollisionGrid& grid,
+    TransitionList& transitions,
+    const std::uint32_t border_length,
+    const MakeTransition& make_transition
+)
+{
+    const auto open = [&](const std::uint32_t offset) {
+        const auto transition = make_transition(offset);
+
+        return !grid.blocked(static_cast<std::size_t>(transition.near_cell)) &&
+            !grid.blocked(static_cast<std::size_t>(transition.far_cell));
+    };
+
+    std::uint32_t offset = 0;
+
+    while (offset < border_length) {
+        if (!open(offset)) {
+            ++offset;
+            continue;
+        }
+
+        const std::uint32_t entrance_start = offset;
+
+        while (offset < border_length && open(offset)) {
+            ++offset;
+        }
+
+        const std::uint32_t entrance_width = offset - entrance_start;
+
+        if (entrance_width < kMaxSingleTransitionEntranceWidth) {
+            transitions.push_back(
+                make_transition(entrance_start + entrance_width / 2)
+            );
+        } else {
+            transitions.push_back(make_transition(entrance_start));
+            transitions.push_back(make_transition(offset - 1));
+        }
+    }
+}
+
+}
+
+HierarchicalPathfinder::HierarchicalPathfinder(const CollisionGrid& grid)
+    : grid_(grid),
+      vertical_borders_(
+          static_cast<std::size_t>(grid.chunk_columns() - 1) *
+          grid.chunk_rows()
+      ),
+      horizontal_borders_(
+          static_cast<std::size_t>(grid.chunk_columns()) *
+          (grid.chunk_rows() - 1)
+      ),
+      chunk_graphs_(grid.chunk_count()),
+      built_chunk_revisions_(grid.chunk_count(), 0),
+      chunk_built_(grid.chunk_count(), 0)
+{
+}
+
+std::size_t HierarchicalPathfinder::refresh()
+{
+    const std::uint32_t chunk_columns = grid_.chunk_columns();
+    const std::uint32_t chunk_rows = grid_.chunk_rows();
+    std::vector<std::uint8_t> regraph_chunks(grid_.chunk_count(), 0);
+    std::vector<std::uint8_t> dirty_vertical_borders(
+        vertical_borders_.size(),
+        0
+    );
+    std::vector<std::uint8_t> dirty_horizontal_borders(
+        horizontal_borders_.size(),
+        0
+    );
+    bool any_chunk_dirty = false;
+
+    for (std::size_t chunk_index = 0;
+         chunk_index < grid_.chunk_count();
+         ++chunk_index) {
+        if (chunk_built_[chunk_index] != 0 &&
+            built_chunk_revisions_[chunk_index] ==
+                grid_.chunk_revision(chunk_index)) {
+            continue;
+        }
+
+        any_chunk_dirty = true;
+        chunk_built_[chunk_index] = 1;
+        built_chunk_revisions_[chunk_index] =
+            grid_.chunk_revision(chunk_index);
+        regraph_chunks[chunk_index] = 1;
+
+        const auto chunk_column =
+            static_cast<std::uint32_t>(chunk_index % chunk_columns);
+        const auto chunk_row =
+            static_cast<std::uint32_t>(chunk_index / chunk_columns);
+
+        if (chunk_column > 0) {
+            dirty_vertical_borders[
+                static_cast<std::size_t>(chunk_row) * (chunk_columns - 1) +
+                chunk_column - 1
+            ] = 1;
+            regraph_chunks[chunk_index - 1] = 1;
+        }
+
+        if (chunk_column + 1 < chunk_columns) {
+            dirty_vertical_borders[
+                static_cast<std::size_t>(chunk_row) * (chunk_columns - 1) +
+                chunk_column
+            ] = 1;
+            regraph_chunks[chunk_index + 1] = 1;
+        }
+
+        if (chunk_row > 0) {
+            dirty_horizontal_borders[chunk_index - chunk_columns] = 1;
+            regraph_chunks[chunk_index - chunk_columns] = 1;
+        }
+
+        if (chunk_row + 1 < chunk_rows) {
+            dirty_horizontal_borders[chunk_index] = 1;
+            regraph_chunks[chunk_index + chunk_columns] = 1;
+        }
+    }
+
+    if (!any_chunk_dirty) {
+        return 0;
+    }
+
+    for (std::size_t border_index = 0;
+         border_index < dirty_vertical_borders.size();
+         ++border_index) {
+        if (dirty_vertical_borders[border_index] != 0) {
+            rebuild_vertical_border(
+                static_cast<std::uint32_t>(
+                    border_index % (chunk_columns - 1)
+                ),
+                static_cast<std::uint32_t>(
+                    border_index / (chunk_columns - 1)
+                )
+            );
+        }
+    }
+
+    for (std::size_t border_index = 0;
+         border_index < dirty_horizontal_borders.size();
+         ++border_index) {
+        if (dirty_horizontal_borders[border_index] != 0) {
+            rebuild_horizontal_border(
+                static_cast<std::uint32_t>(border_index % chunk_columns),
+                static_cast<std::uint32_t>(border_index / chunk_columns)
+            );
+        }
+    }
+
+    std::size_t rebuilt_chunk_count = 0;
+
+    for (std::size_t chunk_index = 0;
+         chunk_index < regraph_chunks.size();
+         ++chunk_index) {
+        if (regraph_chunks[chunk_index] != 0) {
+            rebuild_chunk_graph(chunk_index);
+            ++rebuilt_chunk_count;
+        }
+    }
+
+    return rebuilt_chunk_count;
+}
+
+std::optional<HierarchicalPathfinder::Path>
+HierarchicalPathfinder::find_path(
+    const std::uint32_t start_column,
+    const std::uint32_t start_row,
+    const std::uint32_t goal_column,
+    const std::uint32_t goal_row
+)
+{
+    if (!grid_.contains(start_column, start_row) ||
+        !grid_.contains(goal_column, goal_row) ||
+        grid_.blocked(start_column, start_row) ||
+        grid_.blocked(goal_column, goal_row)) {
+        return std::nullopt;
+    }
+
+    (void)refresh();
+
+    const std::uint32_t start =
+        start_row * grid_.columns() + start_column;
+    const std::uint32_t goal =
+        goal_row * grid_.columns() + goal_column;
+
+    if (start == goal) {
+        return Path{.cells = {start}, .cost = 0};
+    }
+
+    ScratchArena scratch;
+    const std::size_t start_chunk = cell_chunk_index(start);
+    const std::size_t goal_chunk = cell_chunk_index(goal);
+    std::optional<Path> direct_path;
+
+    if (start_chunk == goal_chunk) {
+        search_chunk(start_chunk, start);
+
+        if (searched_distance(goal) != kUnreachable) {
+            direct_path = Path{
+                .cells = {start},
+                .cost = searched_distance(goal)
+            };
+            append_searched_path(goal, direct_path->cells);
+        }
+    }
+
+    const ChunkGraph& goal_graph = chunk_graphs_[goal_chunk];
+    std::pmr::vector<std::uint32_t> goal_distances(
+        goal_graph.node_cells.size(),
+        scratch.resource()
+    );
+    search_chunk(goal_chunk, goal);
+
+    for (std::size_t node = 0; node < goal_distances.size(); ++node) {
+        goal_distances[node] =
+            searched_distance(goal_graph.node_cells[node]);
+    }
+
+    const ChunkGraph& start_graph = chunk_graphs_[start_chunk];
+    std::pmr::vector<std::uint32_t> start_distances(
+        start_graph.node_cells.size(),
+        scratch.resource()
+    );
+    search_chunk(start_chunk, start);
+
+    for (std::size_t node = 0; node < start_distances.size(); ++node) {
+        start_distances[node] =
+            searched_distance(start_graph.node_cells[node]);
+    }
+
+    struct SearchRecord final {
+        std::uint32_t cost = kUnreachable;
+        std::uint32_t parent = 0;
+        bool closed = false;
+    };
+
+    struct OpenEntry final {
+        std::uint32_t estimate = 0;
+        std::uint32_t cost = 0;
+        std::uint32_t cell = 0;
+
+        bool operator>(const OpenEntry& other) const noexcept
+        {
+            return estimate != other.estimate
+                ? estimate > other.estimate
+                : cost < other.cost;
+        }
+    };
+
+    std::pmr::unordered_map<std::uint32_t, SearchRecord> records(
+        scratch.resource()
+    );
+    std::priority_queue<
+        OpenEntry,
+        std::pmr::vector<OpenEntry>,
+        std::greater<>
+    > open_entries(
+        std::greater<>{},
+        std::pmr::vector<OpenEntry>(scratch.resource())
+    );
+
+    const auto heuristic = [&](const std::uint32_t cell) {
+        const std::uint32_t column = cell % grid_.columns();
+        const std::uint32_t row = cell / grid_.columns();
+
+        return (column > goal_column ? column - goal_column : goal_column - column) +
+            (row > goal_row ? row - goal_row : goal_row - row);
+    };
+
+    const auto relax = [&](
+        const std::uint32_t from,
+        const std::uint32_t to,
+        const std::uint32_t cost
+    ) {
+        SearchRecord& record = records[to];
+
+        if (record.closed || cost >= record.cost) {
+            return;
+        }
+
+        record.cost = cost;
+        record.parent = from;
+        open_entries.push(OpenEntry{
+            .estimate = cost + heuristic(to),
+            .cost = cost,
+            .cell = to
+        });
+    };
+
+    const std::uint32_t direct_cost =
+        direct_path.has_value() ? direct_path->cost : kUnreachable;
+    bool goal_reached = false;
+
+    records[start] = SearchRecord{.cost = 0, .parent = start};
+    open_entries.push(OpenEntry{
+        .estimate = heuristic(start),
+        .cost = 0,
+        .cell = start
+    });
+
+    while (!open_entries.empty()) {
+        const OpenEntry entry = open_entries.top();
+        open_entries.pop();
+
+        if (entry.estimate >= direct_cost) {
+            break;
+        }
+
+        SearchRecord& record = records[entry.cell];
+
+        if (record.closed || entry.cost != record.cost) {
+            continue;
+        }
+
+        record.closed = true;
+
+        if (entry.cell == goal) {
+            goal_reached = true;
+            break;
+        }
+
+        if (entry.cell == start) {
+            for (std::size_t node = 0; node < start_distances.size(); ++node) {
+                if (start_distances[node] != kUnreachable) {
+                    relax(
+                        start,
+                        start_graph.node_cells[node],
+                        start_distances[node]
+                    );
+                }
+            }
+        }
+
+        const std::size_t chunk_index = cell_chunk_index(entry.cell);
+        const std::optional<std::size_t> node_index =
+            chunk_node_index(chunk_index, entry.cell);
+
+        if (!node_index.has_value()) {
+            continue;
+        }
+
+        const ChunkGraph& graph = chunk_graphs_[chunk_index];
+        const std::size_t node_count = graph.node_cells.size();
+
+        for (std::size_t other = 0; other < node_count; ++other) {
+            const std::uint32_t distance =
+                graph.node_distances[node_index.value() * node_count + other];
+
+            if (other != node_index.value() && distance != kUnreachable) {
+                relax(
+                    entry.cell,
+                    graph.node_cells[other],
+                    entry.cost + distance
+                );
+            }
+        }
+
+        for (const std::uint32_t partner :
+             graph.node_partners[node_index.value()]) {
+            relax(entry.cell, partner, entry.cost + 1);
+        }
+
+        if (chunk_index == goal_chunk &&
+            goal_distances[node_index.value()] != kUnreachable) {
+            relax(
+                entry.cell,
+                goal,
+                entry.cost + goal_distances[node_index.value()]
+            );
+        }
+    }
+
+    if (!goal_reached) {
+        return direct_path;
+    }
+
+    std::pmr::vector<std::uint32_t> abstract_cells(scratch.resource());
+
+    for (std::uint32_t cell = goal; cell != start; cell = records[cell].parent) {
+        abstract_cells.push_back(cell);
+    }
+
+    abstract_cells.push_back(start);
+    std::reverse(abstract_cells.begin(), abstract_cells.end());
+
+    Path path{.cells = {start}, .cost = records[goal].cost};
+
+    for (std::size_t step = 1; step < abstract_cells.size(); ++step) {
+        const std::uint32_t from = abstract_cells[step - 1];
+        const std::uint32_t to = abstract_cells[step];
+        const std::size_t from_chunk = cell_chunk_index(from);
+
+        if (from_chunk != cell_chunk_index(to)) {
+            path.cells.push_back(to);
+            continue;
+        }
+
+        search_chunk(from_chunk, from);
+        append_searched_path(to, path.cells);
+    }
+
+    return path;
+}
+
+std::size_t HierarchicalPathfinder::abstract_node_count() const noexcept
+{
+    std::size_t node_count = 0;
+
+    for (const ChunkGraph& graph : chunk_graphs_) {
+        node_count += graph.node_cells.size();
+    }
+
+    return node_count;
+}
+
+HierarchicalPathfinder::ChunkBounds
+HierarchicalPathfinder::chunk_bounds(
+    const std::size_t chunk_index
+) const noexcept
+{
+    const std::uint32_t chunk_size = grid_.chunk_size();
+    const auto left = static_cast<std::uint32_t>(
+        chunk_index % grid_.chunk_columns()
+    ) * chunk_size;
+    const auto top = static_cast<std::uint32_t>(
+        chunk_index / grid_.chunk_columns()
+    ) * chunk_size;
+
+    return ChunkBounds{
+        .left = left,
+        .top = top,
+        .right = std::min(left + chunk_size, grid_.columns()),
+        .bottom = std::min(top + chunk_size, grid_.rows())
+    };
+}
+
+std::size_t HierarchicalPathfinder::cell_chunk_index(
+    const std::uint32_t cell
+) const noexcept
+{
+    return grid_.chunk_index(
+        cell % grid_.columns(),
+        cell / grid_.columns()
+    );
+}
+
+void HierarchicalPathfinder::rebuild_vertical_border(
+    const std::uint32_t chunk_column,
+    const std::uint32_t chunk_row
+)
+{
+    std::vector<Transition>& transitions = vertical_borders_[
+        static_cast<std::size_t>(chunk_row) * (grid_.chunk_columns() - 1) +
+        chunk_column
+    ];
+    const std::uint32_t near_column =
+        (chunk_column + 1) * grid_.chunk_size() - 1;
+    const std::uint32_t first_row = chunk_row * grid_.chunk_size();
+    const std::uint32_t end_row =
+        std::min(first_row + grid_.chunk_size(), grid_.rows());
+
+    transitions.clear();
+    append_border_entrances(
+        grid_,
+        transitions,
+        end_row - first_row,
+        [&](const std::uint32_t offset) {
+            const std::uint32_t cell =
+                (first_row + offset) * grid_.columns() + near_column;
+
+            return Transition{.near_cell = cell, .far_cell = cell + 1};
+        }
+    );
+}
+
+void HierarchicalPathfinder::rebuild_horizontal_border(
+    const std::uint32_t chunk_column,
+    const std::uint32_t chunk_row
+)
+{
+    std::vector<Transition>& transitions = horizontal_borders_[
+        static_cast<std::size_t>(chunk_row) * grid_.chunk_columns() +
+        chunk_column
+    ];
+    const std::uint32_t near_row =
+        (chunk_row + 1) * grid_.chunk_size() - 1;
+    const std::uint32_t first_column = chunk_column * grid_.chunk_size();
+    const std::uint32_t end_column =
+        std::min(first_column + grid_.chunk_size(), grid_.columns());
+
+    transitions.clear();
+    append_border_entrances(
+        grid_,
+        transitions,
+        end_column - first_column,
+        [&](const std::uint32_t offset) {
+            const std::uint32_t cell =
+                near_row * grid_.columns() + first_column + offset;
+
+            return Transition{
+                .near_cell = cell,
+                .far_cell = cell + grid_.columns()
+            };
+        }
+    );
+}
+
+void HierarchicalPathfinder::rebuild_chunk_graph(
+    const std::size_t chunk_index
+)
+{
+    const std::uint32_t chunk_columns = grid_.chunk_columns();
+    const std::uint32_t chunk_rows = grid_.chunk_rows();
+    const auto chunk_column =
+        static_cast<std::uint32_t>(chunk_index % chunk_columns);
+    const auto chunk_row =
+        static_cast<std::uint32_t>(chunk_index / chunk_columns);
+    std::vector<Transition> links;
+
+    const auto collect = [&links](
+        const std::vector<Transition>& border,
+        const bool chunk_is_near_side
+    ) {
+        for (const Transition& transition : border) {
+            links.push_back(
+                chunk_is_near_side
+                    ? transition
+                    : Transition{
+                          .near_cell = transition.far_cell,
+                          .far_cell = transition.near_cell
+                      }
+            );
+        }
+    };
+
+    if (chunk_column > 0) {
+        collect(
+            vertical_borders_[
+                static_cast<std::size_t>(chunk_row) * (chunk_columns - 1) +
+                chunk_column - 1
+            ],
+            false
+        );
+    }
+
+    if (chunk_column + 1 < chunk_columns) {
+        collect(
+            vertical_borders_[
+                static_cast<std::size_t>(chunk_row) * (chunk_columns - 1) +
+                chunk_column
+            ],
+            true
+        );
+    }
+
+    if (chunk_row > 0) {
+        collect(horizontal_borders_[chunk_index - chunk_columns], false);
+    }
+
+    if (chunk_row + 1 < chunk_rows) {
+        collect(horizontal_borders_[chunk_index], true);
+    }
+
+    std::sort(
+        links.begin(),
+        links.end(),
+        [](const Transition& left, const Transition& right) {
+            return left.near_cell != right.near_cell
+                ? left.near_cell < right.near_cell
+                : left.far_cell < right.far_cell;
+        }
+    );
+
+    ChunkGraph& graph = chunk_graphs_[chunk_index];
+    graph.node_cells.clear();
+    graph.node_partners.clear();
+
+    for (const Transition& link : links) {
+        if (graph.node_cells.empty() ||
+            graph.node_cells.back() != link.near_cell) {
+            graph.node_cells.push_back(link.near_cell);
+            graph.node_partners.emplace_back();
+        }
+
+        graph.node_partners.back().push_back(link.far_cell);
+    }
+
+    const std::size_t node_count = graph.node_cells.size();
+    graph.node_distances.assign(node_count * node_count, kUnreachable);
+
+    for (std::size_t node = 0; node < node_count; ++node) {
+        search_chunk(chunk_index, graph.node_cells[node]);
+
+        for (std::size_t other = 0; other < node_count; ++other) {
+            graph.node_distances[node * node_count + other] =
+                searched_distance(graph.node_cells[other]);
+        }
+    }
+}
+
+void HierarchicalPathfinder::search_chunk(
+    const std::size_t chunk_index,
+    const std::uint32_t source_cell
+)
+{
+    searched_bounds_ = chunk_bounds(chunk_index);
+
+    const std::uint32_t width =
+        searched_bounds_.right - searched_bounds_.left;
+    const std::uint32_t height =
+        searched_bounds_.bottom - searched_bounds_.top;
+
+    search_distances_.assign(
+        static_cast<std::size_t>(width) * height,
+        kUnreachable
+    );
+    search_queue_.clear();
+
+    const auto local_index = [&](
+        const std::uint32_t column,
+        const std::uint32_t row
+    ) {
+        return static_cast<std::size_t>(row - searched_bounds_.top) * width +
+            (column - searched_bounds_.left);
+    };
+
+    search_distances_[
+        local_index(
+            source_cell % grid_.columns(),
+            source_cell / grid_.columns()
+        )
+    ] = 0;
+    search_queue_.push_back(source_cell);
+
+    for (std::size_t next = 0; next < search_queue_.size(); ++next) {
+        const std::uint32_t cell = search_queue_[next];
+        const std::uint32_t column = cell % grid_.columns();
+        const std::uint32_t row = cell / grid_.columns();
+        const std::uint32_t distance =
+            search_distances_[local_index(column, row)];
+
+        const auto visit = [&](
+            const std::uint32_t neighbor_column,
+            const std::uint32_t neighbor_row
+        ) {
+            const std::uint32_t neighbor_cell =
+                neighbor_row * grid_.columns() + neighbor_column;
+            std::uint32_t& neighbor_distance = search_distances_[
+                local_index(neighbor_column, neighbor_row)
+            ];
+
+            if (neighbor_distance != kUnreachable ||
+                grid_.blocked(static_cast<std::size_t>(neighbor_cell))) {
+                return;
+            }
+
+            neighbor_distance = distance + 1;
+            search_queue_.push_back(neighbor_cell);
+        };
+
+        if (column > searched_bounds_.left) {
+            visit(column - 1, row);
+        }
+
+        if (column + 1 < searched_bounds_.right) {
+            visit(column + 1, row);
+        }
+
+        if (row > searched_bounds_.top) {
+            visit(column, row - 1);
+        }
+
+        if (row + 1 < searched_bounds_.bottom) {
+            visit(column, row + 1);
+        }
+    }
+}
+
+std::uint32_t HierarchicalPathfinder::searched_distance(
+    const std::uint32_t cell
+) const noexcept
+{
+    const std::uint32_t column = cell % grid_.columns();
+    const std::uint32_t row = cell / grid_.columns();
+
+    if (column < searched_bounds_.left ||
+        column >= searched_bounds_.right ||
+        row < searched_bounds_.top ||
+        row >= searched_bounds_.bottom) {
+        return kUnreachable;
+    }
+
+    return search_distances_[
+        static_cast<std::size_t>(row - searched_bounds_.top) *
+            (searched_bounds_.right - searched_bounds_.left) +
+        (column - searched_bounds_.left)
+    ];
+}
+
+void HierarchicalPathfinder::append_searched_path(
+    const std::uint32_t target_cell,
+    std::vector<std::uint32_t>& cells
+) const
+{
+    std::vector<std::uint32_t> reversed_cells;
+    std::uint32_t cell = target_cell;
+    std::uint32_t distance = searched_distance(cell);
+
+    while (distance != 0 && distance != kUnreachable) {
+        reversed_cells.push_back(cell);
+
+        const std::uint32_t column = cell % grid_.columns();
+        const std::uint32_t row = cell / grid_.columns();
+        const std::uint32_t candidates[] = {
+            column > 0 ? cell - 1 : cell,
+            column + 1 < grid_.columns() ? cell + 1 : cell,
+            row > 0 ? cell - grid_.columns() : cell,
+            row + 1 < grid_.rows() ? cell + grid_.columns() : cell
+        };
+
+        for (const std::uint32_t candidate : candidates) {
+            if (candidate != cell &&
+                searched_distance(candidate) == distance - 1) {
+                cell = candidate;
+                break;
+            }
+        }
+
+        distance = searched_distance(cell);
+    }
+
+    cells.insert(cells.end(), reversed_cells.rbegin(), reversed_cells.rend());
+}
+
+std::optional<std::size_t> HierarchicalPathfinder::chunk_node_index(
+    const std::size_t chunk_index,
+    const std::uint32_t cell
+) const
+{
+    const std::vector<std::uint32_t>& node_cells =
+        chunk_graphs_[chunk_index].node_cells;
+    const auto node = std::lower_bound(
+        node_cells.begin(),
+        node_cells.end(),
+        cell
+    );
+
+    if (node == node_cells.end() || *node != cell) {
+        return std::nullopt;
+    }
+
+    return static_cast<std::size_t>(node - node_cells.begin());
+}
+
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace midnight {
+
+class CollisionGrid;
+
+class HierarchicalPathfinder final {
+public:
+    struct Path final {
+        std::vector<std::uint32_t> cells;
+        std::uint32_t cost = 0;
+    };
+
+    explicit HierarchicalPathfinder(const CollisionGrid& grid);
+
+    HierarchicalPathfinder(const HierarchicalPathfinder&) = delete;
+    HierarchicalPathfinder& operator=(const HierarchicalPathfinder&) = delete;
+
+    HierarchicalPathfinder(HierarchicalPathfinder&&) = delete;
+    HierarchicalPathfinder& operator=(HierarchicalPathfinder&&) = delete;
+
+    std::size_t refresh();
+
+    [[nodiscard]] std::optional<Path> find_path(
+        std::uint32_t start_column,
+        std::uint32_t start_row,
+        std::uint32_t goal_column,
+        std::uint32_t goal_row
+    );
+
+    [[nodiscard]] std::size_t abstract_node_count() const noexcept;
+
+private:
+    struct Transition final {
+        std::uint32_t near_cell = 0;
+        std::uint32_t far_cell = 0;
+    };
+
+    struct ChunkGraph final {
+        std::vector<std::uint32_t> node_cells;
+        std::vector<std::vector<std::uint32_t>> node_partners;
+        std::vector<std::uint32_t> node_distances;
+    };
+
+    struct ChunkBounds final {
+        std::uint32_t left = 0;
+        std::uint32_t top = 0;
+        std::uint32_t right = 0;
+        std::uint32_t bottom = 0;
+    };
+
+    [[nodiscard]] ChunkBounds chunk_bounds(
+        std::size_t chunk_index
+    ) const noexcept;
+    [[nodiscard]] std::size_t cell_chunk_index(
+        std::uint32_t cell
+    ) const noexcept;
+    void rebuild_vertical_border(std::uint32_t chunk_column, std::uint32_t chunk_row);
+    void rebuild_horizontal_border(std::uint32_t chunk_column, std::uint32_t chunk_row);
+    void rebuild_chunk_graph(std::size_t chunk_index);
+    void search_chunk(std::size_t chunk_index, std::uint32_t source_cell);
+    [[nodiscard]] std::uint32_t searched_distance(
+        std::uint32_t cell
+    ) const noexcept;
+    void append_searched_path(
+        std::uint32_t target_cell,
+        std::vector<std::uint32_t>& cells
+    ) const;
+    [[nodiscard]] std::optional<std::size_t> chunk_node_index(
+        std::size_t chunk_index,
+        std::uint32_t cell
+    ) const;
+
+    const CollisionGrid& grid_;
+    std::vector<std::vector<Transition>> vertical_borders_;
+    std::vector<std::vector<Transition>> horizontal_borders_;
+    std::vector<ChunkGraph> chunk_graphs_;
+    std::vector<std::uint64_t> built_chunk_revisions_;
+    std::vector<std::uint8_t> chunk_built_;
+    ChunkBounds searched_bounds_{};
+    std::vector<std::uint32_t> search_distances_;
+    std::vector<std::uint32_t> search_queue_;
+};
+
+}
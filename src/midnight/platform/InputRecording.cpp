@@ -0,0 +1,463 @@
+#include "midnight/platform/InputRecording.hpp"
+
+#include "midnight/core/File.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+namespace midnight {
+namespace {
+
+// Header: magic[8], u32 version, u32 reserved, u64 random seed,
+// u32 window width, u32 window height.
+// Records: varint frame delta, varint microsecond delta, u8 kind,
+// u8 ambient flags, the ambient fields named by the flags, then the
+// payload for the kind.
+constexpr std::array<char, 8> kInputMagic{
+    'M', 'I', 'D', 'N', 'I', 'N', 'P', 'T'
+};
+constexpr std::uint32_t kInputVersion = 1;
+
+enum class RecordedEventKind : std::uint8_t {
+    KeyDown,
+    MouseButtonDown,
+    MouseButtonUp,
+    MouseMotion,
+    WindowResized,
+    FocusGained,
+    FocusLost,
+    MouseEnter,
+    MouseLeave
+};
+
+enum AmbientFlags : std::uint8_t {
+    kAmbientModifiers = 1u << 0,
+    kAmbientFocus = 1u << 1,
+    kAmbientPosition = 1u << 2
+};
+
+RecordedEventKind recorded_event_kind(const SDL_Event& event)
+{
+    switch (event.type) {
+        case SDL_EVENT_KEY_DOWN:
+            return RecordedEventKind::KeyDown;
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+            return RecordedEventKind::MouseButtonDown;
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+            return RecordedEventKind::MouseButtonUp;
+        case SDL_EVENT_MOUSE_MOTION:
+            return RecordedEventKind::MouseMotion;
+        case SDL_EVENT_WINDOW_RESIZED:
+            return RecordedEventKind::WindowResized;
+        case SDL_EVENT_WINDOW_FOCUS_GAINED:
+            return RecordedEventKind::FocusGained;
+        case SDL_EVENT_WINDOW_FOCUS_LOST:
+            return RecordedEventKind::FocusLost;
+        case SDL_EVENT_WINDOW_MOUSE_ENTER:
+            return RecordedEventKind::MouseEnter;
+        case SDL_EVENT_WINDOW_MOUSE_LEAVE:
+            return RecordedEventKind::MouseLeave;
+        default:
+            throw std::runtime_error("Input event type is not recorded");
+    }
+}
+
+SDL_EventType sdl_event_type(const RecordedEventKind kind)
+{
+    switch (kind) {
+        case RecordedEventKind::KeyDown:
+            return SDL_EVENT_KEY_DOWN;
+        case RecordedEventKind::MouseButtonDown:
+            return SDL_EVENT_MOUSE_BUTTON_DOWN;
+        case RecordedEventKind::MouseButtonUp:
+            return SDL_EVENT_MOUSE_BUTTON_UP;
+        case RecordedEventKind::MouseMotion:
+            return SDL_EVENT_MOUSE_MOTION;
+        case RecordedEventKind::WindowResized:
+            return SDL_EVENT_WINDOW_RESIZED;
+        case RecordedEventKind::FocusGained:
+            return SDL_EVENT_WINDOW_FOCUS_GAINED;
+        case RecordedEventKind::FocusLost:
+            return SDL_EVENT_WINDOW_FOCUS_LOST;
+        case RecordedEventKind::MouseEnter:
+            return SDL_EVENT_WINDOW_MOUSE_ENTER;
+        case RecordedEventKind::MouseLeave:
+            return SDL_EVENT_WINDOW_MOUSE_LEAVE;
+    }
+
+    throw std::runtime_error("Unknown recorded input event kind");
+}
+
+// The ambient state an event implies on its own. Only differences from
+// this prediction are stored.
+void track_ambient(InputEvent& ambient, const SDL_Event& event) noexcept
+{
+    switch (event.type) {
+        case SDL_EVENT_KEY_DOWN:
+            ambient.modifiers = event.key.mod;
+            break;
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+            ambient.mouse_x = event.button.x;
+            ambient.mouse_y = event.button.y;
+            break;
+        case SDL_EVENT_MOUSE_MOTION:
+            ambient.mouse_x = event.motion.x;
+            ambient.mouse_y = event.motion.y;
+            break;
+        case SDL_EVENT_WINDOW_MOUSE_ENTER:
+            ambient.mouse_focused = true;
+            break;
+        case SDL_EVENT_WINDOW_MOUSE_LEAVE:
+            ambient.mouse_focused = false;
+            break;
+        default:
+            break;
+    }
+}
+
+void write_float(ByteWriter& writer, const float value)
+{
+    writer.write_u32(std::bit_cast<std::uint32_t>(value));
+}
+
+float read_float(ByteReader& reader)
+{
+    return std::bit_cast<float>(reader.read_u32());
+}
+
+std::uint32_t read_varint_u32(ByteReader& reader)
+{
+    const std::uint64_t value = reader.read_varint();
+
+    if (value > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error("Recorded input value is out of range");
+    }
+
+    return static_cast<std::uint32_t>(value);
+}
+
+}
+
+bool is_recorded_input_event(const SDL_Event& event) noexcept
+{
+    switch (event.type) {
+        case SDL_EVENT_KEY_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+        case SDL_EVENT_MOUSE_MOTION:
+        case SDL_EVENT_WINDOW_RESIZED:
+        case SDL_EVENT_WINDOW_FOCUS_GAINED:
+        case SDL_EVENT_WINDOW_FOCUS_LOST:
+        case SDL_EVENT_WINDOW_MOUSE_ENTER:
+        case SDL_EVENT_WINDOW_MOUSE_LEAVE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+InputRecorder::InputRecorder(
+    const std::filesystem::path& path,
+    const InputRecordingHeader& header
+)
+    : path_(path),
+      file_(std::fopen(path.string().c_str(), "wb"), &std::fclose),
+      start_ticks_ns_(SDL_GetTicksNS())
+{
+    if (!file_) {
+        throw std::runtime_error("Failed to create input recording: " + path_.string());
+    }
+
+    pending_.write_bytes(std::as_bytes(std::span(kInputMagic)));
+    pending_.write_u32(kInputVersion);
+    pending_.write_u32(0);
+    pending_.write_u64(header.random_seed);
+    pending_.write_u32(static_cast<std::uint32_t>(header.window_width));
+    pending_.write_u32(static_cast<std::uint32_t>(header.window_height));
+    flush();
+}
+
+InputRecorder::~InputRecorder() noexcept
+{
+    try {
+        flush();
+    } catch (const std::exception&) {
+    }
+}
+
+void InputRecorder::record(const std::uint64_t frame, const InputEvent& input)
+{
+    const SDL_Event& event = input.event;
+
+    if (!is_recorded_input_event(event)) {
+        return;
+    }
+
+    const std::uint64_t timestamp_ns =
+        event.common.timestamp > start_ticks_ns_
+            ? event.common.timestamp - start_ticks_ns_
+            : 0;
+    const std::uint64_t time_us =
+        std::max(timestamp_ns / 1000, last_time_us_);
+    const std::uint64_t record_frame = std::max(frame, last_frame_);
+
+    pending_.write_varint(record_frame - last_frame_);
+    pending_.write_varint(time_us - last_time_us_);
+    pending_.write_u8(static_cast<std::uint8_t>(recorded_event_kind(event)));
+
+    InputEvent predicted = last_ambient_;
+    track_ambient(predicted, event);
+
+    std::uint8_t ambient_flags = 0;
+
+    if (input.modifiers != predicted.modifiers) {
+        ambient_flags |= kAmbientModifiers;
+    }
+
+    if (input.mouse_focused != predicted.mouse_focused) {
+        ambient_flags |= kAmbientFocus;
+    }
+
+    if (input.mouse_x != predicted.mouse_x ||
+        input.mouse_y != predicted.mouse_y) {
+        ambient_flags |= kAmbientPosition;
+    }
+
+    pending_.write_u8(ambient_flags);
+
+    if ((ambient_flags & kAmbientModifiers) != 0) {
+        pending_.write_varint(input.modifiers);
+    }
+
+    if ((ambient_flags & kAmbientFocus) != 0) {
+        pending_.write_u8(input.mouse_focused ? 1 : 0);
+    }
+
+    if ((ambient_flags & kAmbientPosition) != 0) {
+        write_float(pending_, input.mouse_x);
+        write_float(pending_, input.mouse_y);
+    }
+
+    switch (event.type) {
+        case SDL_EVENT_KEY_DOWN:
+            pending_.write_varint(event.key.key);
+            pending_.write_varint(event.key.mod);
+            pending_.write_u8(event.key.repeat ? 1 : 0);
+            break;
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+            pending_.write_u8(event.button.button);
+            write_float(pending_, event.button.x);
+            write_float(pending_, event.button.y);
+            break;
+        case SDL_EVENT_MOUSE_MOTION:
+            pending_.write_varint(event.motion.state);
+            write_float(pending_, event.motion.x);
+            write_float(pending_, event.motion.y);
+            break;
+        case SDL_EVENT_WINDOW_RESIZED:
+            pending_.write_varint(static_cast<std::uint32_t>(event.window.data1));
+            pending_.write_varint(static_cast<std::uint32_t>(event.window.data2));
+            break;
+        default:
+            break;
+    }
+
+    last_frame_ = record_frame;
+    last_time_us_ = time_us;
+    last_ambient_ = input;
+    ++event_count_;
+}
+
+void InputRecorder::flush()
+{
+    const std::vector<std::byte> bytes = pending_.take();
+
+    if (!bytes.empty() &&
+        std::fwrite(bytes.data(), 1, bytes.size(), file_.get()) != bytes.size()) {
+        throw std::runtime_error("Failed to write input recording: " + path_.string());
+    }
+
+    if (std::fflush(file_.get()) != 0) {
+        throw std::runtime_error("Failed to flush input recording: " + path_.string());
+    }
+}
+
+std::uint64_t InputRecorder::event_count() const noexcept
+{
+    return event_count_;
+}
+
+InputReplay::InputReplay(const std::filesystem::path& path)
+{
+    const std::vector<std::byte> bytes = read_binary_file(path);
+    ByteReader reader(bytes);
+
+    if (bytes.size() < kInputMagic.size() ||
+        std::memcmp(bytes.data(), kInputMagic.data(), kInputMagic.size()) != 0) {
+        throw std::runtime_error("Not a Midnight input recording: " + path.string());
+    }
+
+    (void)reader.read_bytes(kInputMagic.size());
+
+    if (reader.read_u32() != kInputVersion) {
+        throw std::runtime_error("Unsupported input recording version: " + path.string());
+    }
+
+    (void)reader.read_u32();
+
+    header_.random_seed = reader.read_u64();
+    header_.window_width = static_cast<int>(reader.read_u32());
+    header_.window_height = static_cast<int>(reader.read_u32());
+
+    std::uint64_t frame = 0;
+    std::uint64_t time_us = 0;
+    InputEvent ambient{};
+
+    while (reader.remaining() > 0) {
+        frame += reader.read_varint();
+        time_us += reader.read_varint();
+
+        const std::uint8_t kind = reader.read_u8();
+
+        if (kind > static_cast<std::uint8_t>(RecordedEventKind::MouseLeave)) {
+            throw std::runtime_error("Corrupt input recording: " + path.string());
+        }
+
+        Record record{};
+        record.frame = frame;
+        record.time = std::chrono::microseconds{time_us};
+
+        SDL_Event& event = record.input.event;
+        event.type = sdl_event_type(static_cast<RecordedEventKind>(kind));
+
+        const std::uint8_t ambient_flags = reader.read_u8();
+        InputEvent recorded_ambient{};
+
+        if ((ambient_flags & kAmbientModifiers) != 0) {
+            recorded_ambient.modifiers =
+                static_cast<SDL_Keymod>(read_varint_u32(reader));
+        }
+
+        if ((ambient_flags & kAmbientFocus) != 0) {
+            recorded_ambient.mouse_focused = reader.read_u8() != 0;
+        }
+
+        if ((ambient_flags & kAmbientPosition) != 0) {
+            recorded_ambient.mouse_x = read_float(reader);
+            recorded_ambient.mouse_y = read_float(reader);
+        }
+
+        switch (event.type) {
+            case SDL_EVENT_KEY_DOWN:
+                event.key.key = static_cast<SDL_Keycode>(read_varint_u32(reader));
+                event.key.mod = static_cast<SDL_Keymod>(read_varint_u32(reader));
+                event.key.down = true;
+                event.key.repeat = reader.read_u8() != 0;
+                break;
+            case SDL_EVENT_MOUSE_BUTTON_DOWN:
+            case SDL_EVENT_MOUSE_BUTTON_UP:
+                event.button.button = reader.read_u8();
+                event.button.down = event.type == SDL_EVENT_MOUSE_BUTTON_DOWN;
+                event.button.x = read_float(reader);
+                event.button.y = read_float(reader);
+                break;
+            case SDL_EVENT_MOUSE_MOTION:
+                event.motion.state =
+                    static_cast<SDL_MouseButtonFlags>(read_varint_u32(reader));
+                event.motion.x = read_float(reader);
+                event.motion.y = read_float(reader);
+                break;
+            case SDL_EVENT_WINDOW_RESIZED:
+                event.window.data1 = static_cast<std::int32_t>(read_varint_u32(reader));
+                event.window.data2 = static_cast<std::int32_t>(read_varint_u32(reader));
+                break;
+            default:
+                break;
+        }
+
+        track_ambient(ambient, event);
+
+        if ((ambient_flags & kAmbientModifiers) != 0) {
+            ambient.modifiers = recorded_ambient.modifiers;
+        }
+
+        if ((ambient_flags & kAmbientFocus) != 0) {
+            ambient.mouse_focused = recorded_ambient.mouse_focused;
+        }
+
+        if ((ambient_flags & kAmbientPosition) != 0) {
+            ambient.mouse_x = recorded_ambient.mouse_x;
+            ambient.mouse_y = recorded_ambient.mouse_y;
+        }
+
+        record.input.modifiers = ambient.modifiers;
+        record.input.mouse_focused = ambient.mouse_focused;
+        record.input.mouse_x = ambient.mouse_x;
+        record.input.mouse_y = ambient.mouse_y;
+
+        records_.push_back(record);
+    }
+}
+
+const InputRecordingHeader& InputReplay::header() const noexcept
+{
+    return header_;
+}
+
+bool InputReplay::next(
+    const std::uint64_t frame,
+    const std::chrono::microseconds elapsed,
+    const bool by_frame,
+    InputEvent& input
+)
+{
+    if (finished()) {
+        return false;
+    }
+
+    const Record& record = records_[next_record_];
+
+    if (by_frame ? record.frame > frame : record.time > elapsed) {
+        return false;
+    }
+
+    input = record.input;
+    input.event.common.timestamp = SDL_GetTicksNS();
+    ambient_ = record.input;
+    ++next_record_;
+
+    return true;
+}
+
+void InputReplay::apply_ambient(InputEvent& input) const noexcept
+{
+    input.modifiers = ambient_.modifiers;
+    input.mouse_focused = ambient_.mouse_focused;
+    input.mouse_x = ambient_.mouse_x;
+    input.mouse_y = ambient_.mouse_y;
+}
+
+bool InputReplay::finished() const noexcept
+{
+    return next_record_ == records_.size();
+}
+
+std::size_t InputReplay::event_count() const noexcept
+{
+    return records_.size();
+}
+
+std::uint64_t InputReplay::frame_count() const noexcept
+{
+    return records_.empty() ? 0 : records_.back().frame + 1;
+}
+
+}
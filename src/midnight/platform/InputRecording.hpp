@@ -0,0 +1,118 @@
+#pragma once
+
+#include "midnight/core/BinaryStream.hpp"
+
+#include <SDL3/SDL.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace midnight {
+
+// An SDL event plus the input state the editor reads next to it. Capturing
+// the modifier and mouse state with the event keeps a replay from
+// consulting the live keyboard and pointer.
+struct InputEvent final {
+    SDL_Event event{};
+    SDL_Keymod modifiers = SDL_KMOD_NONE;
+    bool mouse_focused = false;
+    float mouse_x = 0.0f;
+    float mouse_y = 0.0f;
+};
+
+struct InputRecordingHeader final {
+    std::uint64_t random_seed = 0;
+    int window_width = 0;
+    int window_height = 0;
+};
+
+// Keyboard, mouse, focus and window size events; everything else comes
+// from the live event queue during a replay.
+[[nodiscard]] bool is_recorded_input_event(const SDL_Event& event) noexcept;
+
+// Appends input events to a compact binary file. Each record stores the
+// frame and time deltas since the previous record as varints, followed by
+// only the event fields and ambient state the editor uses.
+class InputRecorder final {
+public:
+    InputRecorder(
+        const std::filesystem::path& path,
+        const InputRecordingHeader& header
+    );
+    ~InputRecorder() noexcept;
+
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+    InputRecorder(InputRecorder&&) = delete;
+    InputRecorder& operator=(InputRecorder&&) = delete;
+
+    // Events that is_recorded_input_event() rejects are ignored.
+    void record(std::uint64_t frame, const InputEvent& input);
+
+    // Writes the records buffered since the last call.
+    void flush();
+
+    [[nodiscard]] std::uint64_t event_count() const noexcept;
+
+private:
+    using FileHandle = std::unique_ptr<std::FILE, int (*)(std::FILE*)>;
+
+    std::filesystem::path path_;
+    FileHandle file_;
+    ByteWriter pending_;
+    std::uint64_t start_ticks_ns_ = 0;
+    std::uint64_t last_frame_ = 0;
+    std::uint64_t last_time_us_ = 0;
+    InputEvent last_ambient_{};
+    std::uint64_t event_count_ = 0;
+};
+
+// A recording decoded up front. Events are handed out either on the frame
+// they were recorded in, or once as much time has passed since the replay
+// started as had passed in the recording.
+class InputReplay final {
+public:
+    explicit InputReplay(const std::filesystem::path& path);
+
+    InputReplay(const InputReplay&) = delete;
+    InputReplay& operator=(const InputReplay&) = delete;
+
+    InputReplay(InputReplay&&) = delete;
+    InputReplay& operator=(InputReplay&&) = delete;
+
+    [[nodiscard]] const InputRecordingHeader& header() const noexcept;
+
+    [[nodiscard]] bool next(
+        std::uint64_t frame,
+        std::chrono::microseconds elapsed,
+        bool by_frame,
+        InputEvent& input
+    );
+
+    // Gives a live event the ambient state of the newest replayed event.
+    void apply_ambient(InputEvent& input) const noexcept;
+
+    [[nodiscard]] bool finished() const noexcept;
+    [[nodiscard]] std::size_t event_count() const noexcept;
+    [[nodiscard]] std::uint64_t frame_count() const noexcept;
+
+private:
+    struct Record final {
+        std::uint64_t frame = 0;
+        std::chrono::microseconds time{};
+        InputEvent input;
+    };
+
+    InputRecordingHeader header_{};
+    std::vector<Record> records_;
+    std::size_t next_record_ = 0;
+    InputEvent ambient_{};
+};
+
+}
@@ -1,11 +1,11 @@
 #include "midnight/renderer/vulkan/VulkanBuffer.hpp"
 
+#include "midnight/core/Log.hpp"
 #include "midnight/renderer/vulkan/VulkanDevice.hpp"
 #include "midnight/renderer/vulkan/VulkanUtils.hpp"
 
 #include <cstddef>
 #include <cstring>
-#include <iostream>
 #include <stdexcept>
 
 namespace midnight {
@@ -46,38 +46,29 @@ VulkanBuffer::VulkanBuffer(
         &memory_requirements
     );
 
-    VkMemoryAllocateInfo allocate_info{};
-    allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocate_info.allocationSize = memory_requirements.size;
-    allocate_info.memoryTypeIndex = device_.find_memory_type(
-        memory_requirements.memoryTypeBits,
-        memory_properties
-    );
-
-    throw_if_vk_failed(
-        vkAllocateMemory(
-            device_.handle(),
-            &allocate_info,
-            nullptr,
-            &memory_
-        ),
-        "vkAllocateMemory"
-    );
-
-    throw_if_vk_failed(
-        vkBindBufferMemory(
-            device_.handle(),
-            buffer_,
-            memory_,
-            0
-        ),
-        "vkBindBufferMemory"
-    );
+    try {
+        allocation_ = device_.memory_allocator().allocate(
+            memory_requirements,
+            memory_properties,
+            VulkanMemoryAllocator::ResourceKind::Buffer
+        );
+
+        throw_if_vk_failed(
+            vkBindBufferMemory(
+                device_.handle(),
+                buffer_,
+                allocation_.memory,
+                allocation_.offset
+            ),
+            "vkBindBufferMemory"
+        );
+    } catch (...) {
+        vkDestroyBuffer(device_.handle(), buffer_, nullptr);
+        device_.memory_allocator().free(allocation_);
+        throw;
+    }
 
-    std::cout << "[Midnight] Vulkan buffer created: "
-              << byte_size_
-              << " bytes"
-              << '\n';
+    MIDNIGHT_LOG_DEBUG(Renderer, "Vulkan buffer created: {} bytes", byte_size_);
 }
 
 VulkanBuffer::~VulkanBuffer()
@@ -87,10 +78,7 @@ VulkanBuffer::~VulkanBuffer()
         buffer_ = VK_NULL_HANDLE;
     }
 
-    if (memory_ != VK_NULL_HANDLE) {
-        vkFreeMemory(device_.handle(), memory_, nullptr);
-        memory_ = VK_NULL_HANDLE;
-    }
+    device_.memory_allocator().free(allocation_);
 }
 
 VkBuffer VulkanBuffer::handle() const noexcept
@@ -121,27 +109,16 @@ void VulkanBuffer::upload(
         throw std::runtime_error("Vulkan buffer upload would write past the end of the buffer");
     }
 
-    void* mapped_memory = nullptr;
+    if (allocation_.mapped == nullptr) {
+        throw std::runtime_error("Vulkan buffer memory is not host-visible");
+    }
 
-    throw_if_vk_failed(
-        vkMapMemory(
-            device_.handle(),
-            memory_,
-            0,
-            VK_WHOLE_SIZE,
-            0,
-            &mapped_memory
-        ),
-        "vkMapMemory"
+    // Host-visible blocks are persistently mapped by the allocator.
+    std::memcpy(
+        allocation_.mapped + static_cast<std::size_t>(destination_offset),
+        source,
+        static_cast<std::size_t>(byte_size)
     );
-
-    auto* destination =
-        static_cast<std::byte*>(mapped_memory) +
-        static_cast<std::size_t>(destination_offset);
-
-    std::memcpy(destination, source, static_cast<std::size_t>(byte_size));
-
-    vkUnmapMemory(device_.handle(), memory_);
 }
 
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "midnight/renderer/vulkan/VulkanMemoryAllocator.hpp"
+
 #include <vulkan/vulkan.h>
 
 namespace midnight {
@@ -36,7 +38,7 @@ private:
     const VulkanDevice& device_;
 
     VkBuffer buffer_ = VK_NULL_HANDLE;
-    VkDeviceMemory memory_ = VK_NULL_HANDLE;
+    VulkanMemoryAllocator::Allocation allocation_{};
     VkDeviceSize byte_size_ = 0;
 };
 
@@ -0,0 +1,371 @@
+#include "midnight/renderer/vulkan/VulkanChunkMeshPool.hpp"
+
+#include "midnight/core/Log.hpp"
+#include "midnight/renderer/vulkan/VulkanTransferContext.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace midnight {
+namespace {
+
+constexpr std::uint32_t kVerticesPerQuad = 4;
+constexpr std::uint32_t kIndicesPerQuad = 6;
+
+VkDeviceSize slot_byte_size(const std::uint32_t max_quads_per_mesh)
+{
+    return static_cast<VkDeviceSize>(max_quads_per_mesh) *
+        kVerticesPerQuad *
+        sizeof(Vertex2D);
+}
+
+VkDeviceSize index_byte_size(const std::uint32_t max_quads_per_mesh)
+{
+    return static_cast<VkDeviceSize>(max_quads_per_mesh) *
+        kIndicesPerQuad *
+        sizeof(std::uint16_t);
+}
+
+VkDeviceSize validated_vertex_buffer_size(
+    const VulkanChunkMeshPool::CreateInfo& create_info
+)
+{
+    if (create_info.mesh_count == 0 ||
+        create_info.max_quads_per_mesh == 0) {
+        throw std::runtime_error("Chunk mesh pool needs at least one mesh and quad");
+    }
+
+    if (create_info.slot_count < create_info.mesh_count) {
+        throw std::runtime_error("Chunk mesh pool needs a slot for every mesh");
+    }
+
+    if (static_cast<std::size_t>(create_info.max_quads_per_mesh) *
+            kVerticesPerQuad >
+        std::size_t{0x1'0000}) {
+        throw std::runtime_error("Chunk meshes must fit 16-bit indices");
+    }
+
+    return slot_byte_size(create_info.max_quads_per_mesh) *
+        create_info.slot_count;
+}
+
+}
+
+VulkanChunkMeshPool::VulkanChunkMeshPool(
+    const VulkanDevice& device,
+    VulkanTransferContext& transfer_context,
+    const CreateInfo& create_info
+)
+    : transfer_context_(transfer_context),
+      max_quads_per_mesh_(create_info.max_quads_per_mesh),
+      vertex_buffer_(
+          device,
+          validated_vertex_buffer_size(create_info),
+          VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+              VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+      ),
+      index_buffer_(
+          device,
+          index_byte_size(create_info.max_quads_per_mesh),
+          VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+              VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+      ),
+      meshes_(create_info.mesh_count)
+{
+    free_slots_.reserve(create_info.slot_count);
+
+    // Hand out low slots first so a freshly started map packs at the front.
+    for (std::size_t slot = create_info.slot_count; slot > 0; --slot) {
+        free_slots_.push_back(static_cast<std::uint32_t>(slot - 1));
+    }
+
+    retired_slots_.reserve(create_info.slot_count);
+    upload_quad_indices();
+
+    MIDNIGHT_LOG_INFO(
+        Renderer,
+        "Chunk mesh pool created: {} meshes, {} slots of {} quads",
+        create_info.mesh_count,
+        create_info.slot_count,
+        create_info.max_quads_per_mesh
+    );
+}
+
+void VulkanChunkMeshPool::upload(
+    const std::span<const MeshUpload> uploads,
+    const std::uint64_t retire_frame
+)
+{
+    if (uploads.empty()) {
+        return;
+    }
+
+    if (uploads.size() > meshes_.size()) {
+        throw std::runtime_error("Chunk mesh upload batch is larger than the pool");
+    }
+
+    std::size_t slot_demand = 0;
+
+    for (const MeshUpload& mesh_upload : uploads) {
+        if (mesh_upload.mesh >= meshes_.size()) {
+            throw std::runtime_error("Chunk mesh id is out of range");
+        }
+
+        if (mesh_upload.vertices.size() % kVerticesPerQuad != 0 ||
+            mesh_upload.vertices.size() >
+                static_cast<std::size_t>(max_quads_per_mesh_) *
+                    kVerticesPerQuad) {
+            throw std::runtime_error("Chunk mesh does not fit its slot");
+        }
+
+        if (!mesh_upload.vertices.empty()) {
+            ++slot_demand;
+        }
+    }
+
+    if (slot_demand > free_slots_.size()) {
+        throw std::runtime_error("Chunk mesh pool has no free slots");
+    }
+
+    struct MeshCopy final {
+        VulkanTransferContext::StagingRange source;
+        VkBufferCopy region{};
+    };
+
+    std::vector<MeshCopy> copies;
+    std::vector<Mesh> replacements;
+    copies.reserve(slot_demand);
+    replacements.reserve(uploads.size());
+
+    for (const MeshUpload& mesh_upload : uploads) {
+        Mesh replacement{};
+
+        if (!mesh_upload.vertices.empty()) {
+            replacement.slot = free_slots_.back();
+            free_slots_.pop_back();
+            replacement.quad_count = static_cast<std::uint32_t>(
+                mesh_upload.vertices.size() / kVerticesPerQuad
+            );
+
+            const VkDeviceSize byte_size =
+                sizeof(Vertex2D) * mesh_upload.vertices.size();
+            const VulkanTransferContext::StagingRange source =
+                transfer_context_.stage(mesh_upload.vertices.data(), byte_size);
+
+            copies.push_back(MeshCopy{
+                .source = source,
+                .region = VkBufferCopy{
+                    .srcOffset = source.offset,
+                    .dstOffset = slot_byte_offset(replacement.slot),
+                    .size = byte_size
+                }
+            });
+        }
+
+        replacements.push_back(replacement);
+    }
+
+    if (!copies.empty()) {
+        transfer_context_.record(
+            [this, &copies](const VkCommandBuffer command_buffer) {
+                // Staged meshes can span more than one staging buffer, so
+                // each copy names its own source.
+                for (const MeshCopy& copy : copies) {
+                    vkCmdCopyBuffer(
+                        command_buffer,
+                        copy.source.buffer,
+                        vertex_buffer_.handle(),
+                        1,
+                        &copy.region
+                    );
+                }
+
+                VkMemoryBarrier to_vertex_input{};
+                to_vertex_input.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+                to_vertex_input.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                to_vertex_input.dstAccessMask =
+                    VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+
+                vkCmdPipelineBarrier(
+                    command_buffer,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT,
+                    VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                    0,
+                    1,
+                    &to_vertex_input,
+                    0,
+                    nullptr,
+                    0,
+                    nullptr
+                );
+            }
+        );
+    }
+
+    // Frames recorded from now on draw the new slots, and each of them waits
+    // for the batch holding the copies above.
+    for (std::size_t index = 0; index < uploads.size(); ++index) {
+        Mesh& mesh = meshes_[uploads[index].mesh];
+
+        if (mesh.slot != kNoSlot) {
+            retired_slots_.push_back(RetiredSlot{
+                .slot = mesh.slot,
+                .frame = retire_frame
+            });
+        }
+
+        mesh = replacements[index];
+    }
+}
+
+void VulkanChunkMeshPool::reclaim(const std::uint64_t completed_frame) noexcept
+{
+    std::erase_if(
+        retired_slots_,
+        [this, completed_frame](const RetiredSlot& retired) {
+            if (retired.frame > completed_frame) {
+                return false;
+            }
+
+            free_slots_.push_back(retired.slot);
+            return true;
+        }
+    );
+}
+
+void VulkanChunkMeshPool::reclaim_all() noexcept
+{
+    for (const RetiredSlot& retired : retired_slots_) {
+        free_slots_.push_back(retired.slot);
+    }
+
+    retired_slots_.clear();
+}
+
+void VulkanChunkMeshPool::record_draws(
+    const VkCommandBuffer command_buffer
+) const
+{
+    const VkBuffer vertex_buffers[] = {
+        vertex_buffer_.handle()
+    };
+
+    const VkDeviceSize vertex_buffer_offsets[] = {
+        0
+    };
+
+    vkCmdBindVertexBuffers(
+        command_buffer,
+        0,
+        1,
+        vertex_buffers,
+        vertex_buffer_offsets
+    );
+
+    vkCmdBindIndexBuffer(
+        command_buffer,
+        index_buffer_.handle(),
+        0,
+        VK_INDEX_TYPE_UINT16
+    );
+
+    for (const Mesh& mesh : meshes_) {
+        if (mesh.quad_count == 0) {
+            continue;
+        }
+
+        vkCmdDrawIndexed(
+            command_buffer,
+            mesh.quad_count * kIndicesPerQuad,
+            1,
+            0,
+            static_cast<std::int32_t>(
+                mesh.slot * max_quads_per_mesh_ * kVerticesPerQuad
+            ),
+            0
+        );
+    }
+}
+
+std::size_t VulkanChunkMeshPool::free_slot_count() const noexcept
+{
+    return free_slots_.size();
+}
+
+std::size_t VulkanChunkMeshPool::retired_slot_count() const noexcept
+{
+    return retired_slots_.size();
+}
+
+VkDeviceSize VulkanChunkMeshPool::slot_byte_offset(
+    const std::uint32_t slot
+) const noexcept
+{
+    return slot_byte_size(max_quads_per_mesh_) * slot;
+}
+
+void VulkanChunkMeshPool::upload_quad_indices()
+{
+    std::vector<std::uint16_t> indices;
+    indices.reserve(
+        static_cast<std::size_t>(max_quads_per_mesh_) * kIndicesPerQuad
+    );
+
+    for (std::uint32_t quad = 0; quad < max_quads_per_mesh_; ++quad) {
+        const auto first_vertex =
+            static_cast<std::uint16_t>(quad * kVerticesPerQuad);
+
+        indices.push_back(first_vertex);
+        indices.push_back(static_cast<std::uint16_t>(first_vertex + 1));
+        indices.push_back(static_cast<std::uint16_t>(first_vertex + 2));
+        indices.push_back(static_cast<std::uint16_t>(first_vertex + 2));
+        indices.push_back(static_cast<std::uint16_t>(first_vertex + 3));
+        indices.push_back(first_vertex);
+    }
+
+    const VkDeviceSize byte_size =
+        sizeof(std::uint16_t) * indices.size();
+
+    const VulkanTransferContext::StagingRange source =
+        transfer_context_.stage(indices.data(), byte_size);
+
+    transfer_context_.record(
+        [this, &source, byte_size](const VkCommandBuffer command_buffer) {
+            const VkBufferCopy copy{
+                .srcOffset = source.offset,
+                .dstOffset = 0,
+                .size = byte_size
+            };
+
+            vkCmdCopyBuffer(
+                command_buffer,
+                source.buffer,
+                index_buffer_.handle(),
+                1,
+                &copy
+            );
+
+            VkMemoryBarrier to_index_input{};
+            to_index_input.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            to_index_input.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            to_index_input.dstAccessMask = VK_ACCESS_INDEX_READ_BIT;
+
+            vkCmdPipelineBarrier(
+                command_buffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                0,
+                1,
+                &to_index_input,
+                0,
+                nullptr,
+                0,
+                nullptr
+            );
+        }
+    );
+}
+
+}
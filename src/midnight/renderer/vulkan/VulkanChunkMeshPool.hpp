@@ -0,0 +1,90 @@
+#pragma once
+
+#include "midnight/renderer/Vertex2D.hpp"
+#include "midnight/renderer/vulkan/VulkanBuffer.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace midnight {
+
+class VulkanDevice;
+class VulkanTransferContext;
+
+// Fixed-size quad meshes packed into one device-local vertex buffer. Each
+// mesh id maps to a slot; replacing a mesh copies it into a fresh slot and
+// retires the old one until the frames that may still read it complete.
+class VulkanChunkMeshPool final {
+public:
+    struct CreateInfo final {
+        std::size_t mesh_count = 0;
+        std::size_t slot_count = 0;
+        std::uint32_t max_quads_per_mesh = 0;
+    };
+
+    struct MeshUpload final {
+        std::size_t mesh = 0;
+        std::span<const Vertex2D> vertices;
+    };
+
+    VulkanChunkMeshPool(
+        const VulkanDevice& device,
+        VulkanTransferContext& transfer_context,
+        const CreateInfo& create_info
+    );
+
+    VulkanChunkMeshPool(const VulkanChunkMeshPool&) = delete;
+    VulkanChunkMeshPool& operator=(const VulkanChunkMeshPool&) = delete;
+
+    VulkanChunkMeshPool(VulkanChunkMeshPool&&) = delete;
+    VulkanChunkMeshPool& operator=(VulkanChunkMeshPool&&) = delete;
+
+    // Records every copy into the open transfer batch and swaps the mesh
+    // handles; the next frame submitted waits for that batch. Slots they
+    // replace are tagged with `retire_frame`, the last frame that may have
+    // recorded draws from them.
+    void upload(
+        std::span<const MeshUpload> uploads,
+        std::uint64_t retire_frame
+    );
+
+    void reclaim(std::uint64_t completed_frame) noexcept;
+    void reclaim_all() noexcept;
+
+    void record_draws(VkCommandBuffer command_buffer) const;
+
+    [[nodiscard]] std::size_t free_slot_count() const noexcept;
+    [[nodiscard]] std::size_t retired_slot_count() const noexcept;
+
+private:
+    static constexpr std::uint32_t kNoSlot = 0xFFFF'FFFFu;
+
+    struct Mesh final {
+        std::uint32_t slot = kNoSlot;
+        std::uint32_t quad_count = 0;
+    };
+
+    struct RetiredSlot final {
+        std::uint32_t slot = kNoSlot;
+        std::uint64_t frame = 0;
+    };
+
+    [[nodiscard]] VkDeviceSize slot_byte_offset(
+        std::uint32_t slot
+    ) const noexcept;
+    void upload_quad_indices();
+
+    VulkanTransferContext& transfer_context_;
+    std::uint32_t max_quads_per_mesh_ = 0;
+    VulkanBuffer vertex_buffer_;
+    VulkanBuffer index_buffer_;
+    std::vector<Mesh> meshes_;
+    std::vector<std::uint32_t> free_slots_;
+    std::vector<RetiredSlot> retired_slots_;
+};
+
+}
@@ -1,11 +1,12 @@
 #include "midnight/renderer/vulkan/VulkanDevice.hpp"
 
+#include "midnight/core/Log.hpp"
 #include "midnight/renderer/vulkan/VulkanInstance.hpp"
+#include "midnight/renderer/vulkan/VulkanMemoryAllocator.hpp"
 #include "midnight/renderer/vulkan/VulkanSurface.hpp"
 #include "midnight/renderer/vulkan/VulkanUtils.hpp"
 
 #include <algorithm>
-#include <iostream>
 #include <optional>
 #include <set>
 #include <stdexcept>
@@ -15,6 +16,10 @@
 namespace midnight {
 namespace {
 
+// Without resizable BAR, discrete GPUs expose at most this much of their
+// memory to the host.
+constexpr VkDeviceSize kLegacyBarHeapSize = 256ull * 1024 * 1024;
+
 const std::vector<const char*> kRequiredDeviceExtensions = {
     VK_KHR_SWAPCHAIN_EXTENSION_NAME
 };
@@ -243,13 +248,18 @@ VulkanDevice::VulkanDevice(
       surface_(surface)
 {
     pick_physical_device();
+    detect_host_visible_device_local_memory();
+    detect_timeline_semaphores();
+    detect_timestamps();
     create_logical_device();
+    memory_allocator_ = std::make_unique<VulkanMemoryAllocator>(*this);
 }
 
 VulkanDevice::~VulkanDevice()
 {
     if (device_ != VK_NULL_HANDLE) {
         (void)vkDeviceWaitIdle(device_);
+        memory_allocator_.reset();
         vkDestroyDevice(device_, nullptr);
         device_ = VK_NULL_HANDLE;
     }
@@ -314,6 +324,33 @@ std::uint32_t VulkanDevice::find_memory_type(
     throw std::runtime_error("No suitable Vulkan memory type found");
 }
 
+bool VulkanDevice::host_visible_device_local_memory() const noexcept
+{
+    return host_visible_device_local_memory_;
+}
+
+bool VulkanDevice::timeline_semaphores() const noexcept
+{
+    return timeline_semaphores_;
+}
+
+float VulkanDevice::timestamp_period() const noexcept
+{
+    return timestamp_valid_bits_ != 0
+        ? physical_device_properties_.limits.timestampPeriod
+        : 0.0f;
+}
+
+std::uint32_t VulkanDevice::timestamp_valid_bits() const noexcept
+{
+    return timestamp_valid_bits_;
+}
+
+VulkanMemoryAllocator& VulkanDevice::memory_allocator() const noexcept
+{
+    return *memory_allocator_;
+}
+
 void VulkanDevice::pick_physical_device()
 {
     std::uint32_t physical_device_count = 0;
@@ -345,7 +382,7 @@ void VulkanDevice::pick_physical_device()
     VkPhysicalDevice best_device = VK_NULL_HANDLE;
     int best_score = -1;
 
-    std::cout << "[Midnight] Vulkan physical devices found:\n";
+    MIDNIGHT_LOG_INFO(Renderer, "Vulkan physical devices found:");
 
     for (const VkPhysicalDevice candidate : physical_devices) {
         VkPhysicalDeviceProperties candidate_properties{};
@@ -354,10 +391,13 @@ void VulkanDevice::pick_physical_device()
         const int candidate_score =
             score_physical_device(candidate, surface_.handle());
 
-        std::cout << "  - " << candidate_properties.deviceName
-                  << " [" << vulkan_device_type_to_string(candidate_properties.deviceType)
-                  << "] score=" << candidate_score
-                  << '\n';
+        MIDNIGHT_LOG_INFO(
+            Renderer,
+            "  - {} [{}] score={}",
+            candidate_properties.deviceName,
+            vulkan_device_type_to_string(candidate_properties.deviceType),
+            candidate_score
+        );
 
         if (candidate_score > best_score) {
             best_score = candidate_score;
@@ -387,32 +427,138 @@ void VulkanDevice::pick_physical_device()
     const SwapchainSupportSummary swapchain_support =
         query_swapchain_support(physical_device_, surface_.handle());
 
-    std::cout << "[Midnight] Selected Vulkan device: "
-              << physical_device_properties_.deviceName
-              << '\n';
+    MIDNIGHT_LOG_INFO(
+        Renderer,
+        "Selected Vulkan device: {}",
+        physical_device_properties_.deviceName
+    );
+    MIDNIGHT_LOG_INFO(
+        Renderer,
+        "Device type: {}",
+        vulkan_device_type_to_string(physical_device_properties_.deviceType)
+    );
+    MIDNIGHT_LOG_INFO(
+        Renderer,
+        "Device API: {}",
+        vulkan_api_version_to_string(physical_device_properties_.apiVersion)
+    );
+    MIDNIGHT_LOG_INFO(
+        Renderer,
+        "Graphics queue family: {}",
+        graphics_queue_family_index_
+    );
+    MIDNIGHT_LOG_INFO(
+        Renderer,
+        "Present queue family: {}",
+        present_queue_family_index_
+    );
+    MIDNIGHT_LOG_INFO(
+        Renderer,
+        "Swapchain support: {} formats, {} present modes",
+        swapchain_support.format_count,
+        swapchain_support.present_mode_count
+    );
+}
+
+void VulkanDevice::detect_host_visible_device_local_memory()
+{
+    VkPhysicalDeviceMemoryProperties memory_properties{};
+    vkGetPhysicalDeviceMemoryProperties(
+        physical_device_,
+        &memory_properties
+    );
 
-    std::cout << "[Midnight] Device type: "
-              << vulkan_device_type_to_string(physical_device_properties_.deviceType)
-              << '\n';
+    constexpr VkMemoryPropertyFlags kRequiredProperties =
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
 
-    std::cout << "[Midnight] Device API: "
-              << vulkan_api_version_to_string(physical_device_properties_.apiVersion)
-              << '\n';
+    VkDeviceSize largest_heap_size = 0;
 
-    std::cout << "[Midnight] Graphics queue family: "
-              << graphics_queue_family_index_
-              << '\n';
+    for (std::uint32_t index = 0; index < memory_properties.memoryTypeCount; ++index) {
+        const VkMemoryType& memory_type = memory_properties.memoryTypes[index];
 
-    std::cout << "[Midnight] Present queue family: "
-              << present_queue_family_index_
-              << '\n';
+        if ((memory_type.propertyFlags & kRequiredProperties) == kRequiredProperties) {
+            largest_heap_size = std::max(
+                largest_heap_size,
+                memory_properties.memoryHeaps[memory_type.heapIndex].size
+            );
+        }
+    }
 
-    std::cout << "[Midnight] Swapchain support: "
-              << swapchain_support.format_count
-              << " formats, "
-              << swapchain_support.present_mode_count
-              << " present modes"
-              << '\n';
+    host_visible_device_local_memory_ = largest_heap_size > kLegacyBarHeapSize;
+
+    if (host_visible_device_local_memory_) {
+        MIDNIGHT_LOG_INFO(
+            Renderer,
+            "Host-visible device-local memory: {} MiB heap",
+            largest_heap_size / (1024 * 1024)
+        );
+    } else {
+        MIDNIGHT_LOG_INFO(Renderer, "Host-visible device-local memory: unavailable");
+    }
+}
+
+void VulkanDevice::detect_timeline_semaphores()
+{
+    if (instance_.api_version() < VK_API_VERSION_1_2 ||
+        physical_device_properties_.apiVersion < VK_API_VERSION_1_2) {
+        MIDNIGHT_LOG_INFO(Renderer, "Timeline semaphores: unavailable (Vulkan 1.2 required)");
+        return;
+    }
+
+    VkPhysicalDeviceTimelineSemaphoreFeatures timeline_features{};
+    timeline_features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+
+    VkPhysicalDeviceFeatures2 features{};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &timeline_features;
+
+    vkGetPhysicalDeviceFeatures2(physical_device_, &features);
+
+    timeline_semaphores_ = timeline_features.timelineSemaphore == VK_TRUE;
+
+    MIDNIGHT_LOG_INFO(
+        Renderer,
+        "Timeline semaphores: {}",
+        timeline_semaphores_ ? "enabled" : "unavailable"
+    );
+}
+
+void VulkanDevice::detect_timestamps()
+{
+    std::uint32_t queue_family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(
+        physical_device_,
+        &queue_family_count,
+        nullptr
+    );
+
+    std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+
+    vkGetPhysicalDeviceQueueFamilyProperties(
+        physical_device_,
+        &queue_family_count,
+        queue_families.data()
+    );
+
+    if (graphics_queue_family_index_ < queue_family_count &&
+        physical_device_properties_.limits.timestampPeriod > 0.0f) {
+        timestamp_valid_bits_ =
+            queue_families[graphics_queue_family_index_].timestampValidBits;
+    }
+
+    if (timestamp_valid_bits_ != 0) {
+        MIDNIGHT_LOG_INFO(
+            Renderer,
+            "GPU timestamps: {} bits, {} ns per tick",
+            timestamp_valid_bits_,
+            physical_device_properties_.limits.timestampPeriod
+        );
+    } else {
+        MIDNIGHT_LOG_INFO(Renderer, "GPU timestamps: unavailable");
+    }
 }
 
 void VulkanDevice::create_logical_device()
@@ -443,8 +589,14 @@ void VulkanDevice::create_logical_device()
     VkPhysicalDeviceFeatures enabled_features{};
     enabled_features.samplerAnisotropy = supported_features.samplerAnisotropy;
 
+    VkPhysicalDeviceTimelineSemaphoreFeatures timeline_features{};
+    timeline_features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+    timeline_features.timelineSemaphore = VK_TRUE;
+
     VkDeviceCreateInfo create_info{};
     create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    create_info.pNext = timeline_semaphores_ ? &timeline_features : nullptr;
     create_info.queueCreateInfoCount =
         static_cast<std::uint32_t>(queue_create_infos.size());
     create_info.pQueueCreateInfos = queue_create_infos.data();
@@ -472,12 +624,12 @@ void VulkanDevice::create_logical_device()
         &present_queue_
     );
 
-    std::cout << "[Midnight] Vulkan logical device created\n";
+    MIDNIGHT_LOG_INFO(Renderer, "Vulkan logical device created");
 
     if (enabled_features.samplerAnisotropy == VK_TRUE) {
-        std::cout << "[Midnight] Sampler anisotropy enabled\n";
+        MIDNIGHT_LOG_INFO(Renderer, "Sampler anisotropy enabled");
     } else {
-        std::cout << "[Midnight] Sampler anisotropy unavailable\n";
+        MIDNIGHT_LOG_INFO(Renderer, "Sampler anisotropy unavailable");
     }
 }
 
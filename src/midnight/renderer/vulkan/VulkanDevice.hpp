@@ -3,10 +3,12 @@
 #include <vulkan/vulkan.h>
 
 #include <cstdint>
+#include <memory>
 
 namespace midnight {
 
 class VulkanInstance;
+class VulkanMemoryAllocator;
 class VulkanSurface;
 
 class VulkanDevice final {
@@ -36,9 +38,26 @@ public:
         VkMemoryPropertyFlags properties
     ) const;
 
+    // True when a large device-local heap is also host-visible (resizable
+    // BAR or unified memory), so buffers the CPU rewrites can live there.
+    [[nodiscard]] bool host_visible_device_local_memory() const noexcept;
+
+    // Timeline semaphores need Vulkan 1.2 on both the instance and device.
+    [[nodiscard]] bool timeline_semaphores() const noexcept;
+
+    // Nanoseconds per timestamp tick on the graphics queue, or zero when
+    // that queue cannot write timestamps.
+    [[nodiscard]] float timestamp_period() const noexcept;
+    [[nodiscard]] std::uint32_t timestamp_valid_bits() const noexcept;
+
+    [[nodiscard]] VulkanMemoryAllocator& memory_allocator() const noexcept;
+
 private:
     void pick_physical_device();
     void create_logical_device();
+    void detect_host_visible_device_local_memory();
+    void detect_timeline_semaphores();
+    void detect_timestamps();
 
     const VulkanInstance& instance_;
     const VulkanSurface& surface_;
@@ -53,6 +72,12 @@ private:
 
     std::uint32_t graphics_queue_family_index_ = 0;
     std::uint32_t present_queue_family_index_ = 0;
+
+    bool host_visible_device_local_memory_ = false;
+    bool timeline_semaphores_ = false;
+    std::uint32_t timestamp_valid_bits_ = 0;
+
+    std::unique_ptr<VulkanMemoryAllocator> memory_allocator_;
 };
 
 }
@@ -0,0 +1,170 @@
+#include "midnight/renderer/vulkan/VulkanDynamicBuffer.hpp"
+
+#include "midnight/core/Log.hpp"
+#include "midnight/renderer/vulkan/VulkanDevice.hpp"
+#include "midnight/renderer/vulkan/VulkanTransferContext.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace midnight {
+
+VulkanDynamicBuffer::VulkanDynamicBuffer(
+    const VulkanDevice& device,
+    VulkanTransferContext& transfer_context,
+    const VkDeviceSize byte_size,
+    const VkBufferUsageFlags usage
+)
+    : transfer_context_(transfer_context),
+      staged_(!device.host_visible_device_local_memory()),
+      buffer_(
+          device,
+          byte_size,
+          staged_
+              ? usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT
+              : usage,
+          staged_
+              ? VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+              : VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+      )
+{
+    if (staged_) {
+        shadow_.resize(static_cast<std::size_t>(byte_size));
+        dirty_end_ = byte_size;
+    }
+
+    MIDNIGHT_LOG_INFO(
+        Renderer,
+        "Vulkan dynamic buffer: {}",
+        staged_ ? "device-local, staged" : "device-local, host-visible"
+    );
+}
+
+const VulkanBuffer& VulkanDynamicBuffer::buffer() const noexcept
+{
+    return buffer_;
+}
+
+bool VulkanDynamicBuffer::staged() const noexcept
+{
+    return staged_;
+}
+
+void VulkanDynamicBuffer::upload(
+    const void* source,
+    const VkDeviceSize byte_size,
+    const VkDeviceSize destination_offset
+)
+{
+    if (!staged_) {
+        buffer_.upload(source, byte_size, destination_offset);
+        return;
+    }
+
+    if (byte_size == 0) {
+        return;
+    }
+
+    if (source == nullptr) {
+        throw std::runtime_error("Cannot upload from a null source pointer");
+    }
+
+    if (destination_offset > buffer_.byte_size() ||
+        byte_size > buffer_.byte_size() - destination_offset) {
+        throw std::runtime_error("Vulkan buffer upload would write past the end of the buffer");
+    }
+
+    std::memcpy(
+        shadow_.data() + destination_offset,
+        source,
+        static_cast<std::size_t>(byte_size)
+    );
+
+    if (dirty_begin_ == dirty_end_) {
+        dirty_begin_ = destination_offset;
+        dirty_end_ = destination_offset + byte_size;
+    } else {
+        dirty_begin_ = std::min(dirty_begin_, destination_offset);
+        dirty_end_ = std::max(dirty_end_, destination_offset + byte_size);
+    }
+}
+
+void VulkanDynamicBuffer::flush()
+{
+    if (!staged_ || dirty_begin_ == dirty_end_) {
+        return;
+    }
+
+    const VkDeviceSize offset = dirty_begin_;
+    const VkDeviceSize byte_size = dirty_end_ - dirty_begin_;
+
+    const VulkanTransferContext::StagingRange staging =
+        transfer_context_.stage(shadow_.data() + offset, byte_size);
+
+    transfer_context_.record(
+        [this, &staging, offset, byte_size](const VkCommandBuffer command_buffer) {
+            // Frames submitted earlier may still be reading the old contents,
+            // and an unsubmitted batch may already hold an earlier flush.
+            VkMemoryBarrier before_copy{};
+            before_copy.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            before_copy.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            before_copy.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+            vkCmdPipelineBarrier(
+                command_buffer,
+                VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+                    VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                0,
+                1,
+                &before_copy,
+                0,
+                nullptr,
+                0,
+                nullptr
+            );
+
+            const VkBufferCopy copy_region{
+                .srcOffset = staging.offset,
+                .dstOffset = offset,
+                .size = byte_size
+            };
+
+            vkCmdCopyBuffer(
+                command_buffer,
+                staging.buffer,
+                buffer_.handle(),
+                1,
+                &copy_region
+            );
+
+            VkMemoryBarrier to_vertex_input{};
+            to_vertex_input.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            to_vertex_input.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            to_vertex_input.dstAccessMask =
+                VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |
+                VK_ACCESS_INDEX_READ_BIT;
+
+            vkCmdPipelineBarrier(
+                command_buffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                0,
+                1,
+                &to_vertex_input,
+                0,
+                nullptr,
+                0,
+                nullptr
+            );
+        }
+    );
+
+    dirty_begin_ = 0;
+    dirty_end_ = 0;
+}
+
+}
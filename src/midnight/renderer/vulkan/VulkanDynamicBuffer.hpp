@@ -0,0 +1,55 @@
+#pragma once
+
+#include "midnight/renderer/vulkan/VulkanBuffer.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace midnight {
+
+class VulkanDevice;
+class VulkanTransferContext;
+
+// A device-local buffer the CPU keeps rewriting. With host-visible device
+// memory it is written in place; otherwise writes land in a host shadow
+// and flush() records a copy of the dirty span into the open transfer batch.
+class VulkanDynamicBuffer final {
+public:
+    VulkanDynamicBuffer(
+        const VulkanDevice& device,
+        VulkanTransferContext& transfer_context,
+        VkDeviceSize byte_size,
+        VkBufferUsageFlags usage
+    );
+
+    VulkanDynamicBuffer(const VulkanDynamicBuffer&) = delete;
+    VulkanDynamicBuffer& operator=(const VulkanDynamicBuffer&) = delete;
+
+    VulkanDynamicBuffer(VulkanDynamicBuffer&&) = delete;
+    VulkanDynamicBuffer& operator=(VulkanDynamicBuffer&&) = delete;
+
+    [[nodiscard]] const VulkanBuffer& buffer() const noexcept;
+    [[nodiscard]] bool staged() const noexcept;
+
+    void upload(
+        const void* source,
+        VkDeviceSize byte_size,
+        VkDeviceSize destination_offset = 0
+    );
+
+    // Must run before the next frame that reads the buffer is submitted; that
+    // frame waits for the transfer batch holding the copy.
+    void flush();
+
+private:
+    VulkanTransferContext& transfer_context_;
+    bool staged_ = false;
+    VulkanBuffer buffer_;
+    std::vector<std::byte> shadow_;
+    VkDeviceSize dirty_begin_ = 0;
+    VkDeviceSize dirty_end_ = 0;
+};
+
+}
@@ -1,57 +1,104 @@
 #include "midnight/renderer/vulkan/VulkanFrameRenderer.hpp"
 
+#include "midnight/core/Log.hpp"
 #include "midnight/renderer/vulkan/VulkanBuffer.hpp"
+#include "midnight/renderer/vulkan/VulkanChunkMeshPool.hpp"
 #include "midnight/renderer/vulkan/VulkanDevice.hpp"
 #include "midnight/renderer/vulkan/VulkanGraphicsPipeline.hpp"
 #include "midnight/renderer/vulkan/VulkanRenderPass.hpp"
 #include "midnight/renderer/vulkan/VulkanSwapchain.hpp"
 #include "midnight/renderer/vulkan/VulkanTextureDescriptor.hpp"
+#include "midnight/renderer/vulkan/VulkanTransferContext.hpp"
 #include "midnight/renderer/vulkan/VulkanUtils.hpp"
 
+#include <algorithm>
 #include <array>
-#include <iostream>
+#include <cmath>
 #include <limits>
 #include <stdexcept>
 #include <string>
+#include <utility>
 
 namespace midnight {
 namespace {
 
 constexpr std::uint64_t kHostWaitTimeoutNanoseconds = 16'000'000;
 
+// Start and end of each in-flight frame.
+constexpr std::uint32_t kTimestampsPerFrame = 2;
+
+using WaitClock = std::chrono::steady_clock;
+
 }
 
 VulkanFrameRenderer::VulkanFrameRenderer(
     const VulkanDevice& device,
+    VulkanTransferContext& transfer_context,
     const VulkanSwapchain& swapchain,
     const VulkanRenderPass& render_pass,
     const VulkanGraphicsPipeline& graphics_pipeline,
     const VulkanTextureDescriptor& texture_descriptor,
+    const VulkanTextureDescriptor& map_texture_descriptor,
+    const VulkanTextureDescriptor& minimap_texture_descriptor,
     const VulkanBuffer& vertex_buffer,
     const VulkanBuffer& index_buffer,
     const std::uint32_t index_count,
-    const VkIndexType index_type
+    const VkIndexType index_type,
+    const VulkanChunkMeshPool& chunk_meshes,
+    const std::uint32_t chunk_mesh_first_index,
+    const std::uint32_t sprite_first_index,
+    const std::uint32_t sprite_index_count,
+    const std::uint32_t sprite_region_vertex_count,
+    const std::uint32_t minimap_first_index,
+    const std::uint64_t previous_frame_count
 )
     : device_(device),
+      transfer_context_(transfer_context),
       swapchain_(swapchain),
       render_pass_(render_pass),
       graphics_pipeline_(graphics_pipeline),
       texture_descriptor_(texture_descriptor),
+      map_texture_descriptor_(map_texture_descriptor),
+      minimap_texture_descriptor_(minimap_texture_descriptor),
       vertex_buffer_(vertex_buffer),
       index_buffer_(index_buffer),
       index_count_(index_count),
-      index_type_(index_type)
+      index_type_(index_type),
+      chunk_meshes_(chunk_meshes),
+      chunk_mesh_first_index_(chunk_mesh_first_index),
+      sprite_first_index_(sprite_first_index),
+      sprite_index_count_(sprite_index_count),
+      sprite_region_vertex_count_(sprite_region_vertex_count),
+      minimap_first_index_(minimap_first_index),
+      submitted_frame_count_(previous_frame_count),
+      completed_frame_count_(previous_frame_count)
 {
+    if (chunk_mesh_first_index_ > index_count_) {
+        throw std::runtime_error("Chunk mesh draw position is past the index count");
+    }
+
+    if (minimap_first_index_ < chunk_mesh_first_index_ ||
+        minimap_first_index_ > index_count_) {
+        throw std::runtime_error("Minimap draw position is outside the overlays");
+    }
+
+    if (sprite_first_index_ < chunk_mesh_first_index_ ||
+        sprite_first_index_ > minimap_first_index_ ||
+        sprite_index_count_ > minimap_first_index_ - sprite_first_index_) {
+        throw std::runtime_error("Sprite draw range is outside the overlays");
+    }
+
     create_command_pool();
     create_framebuffers();
     allocate_command_buffers();
     create_sync_objects();
+    create_timestamp_query_pool();
     image_has_been_presented_.resize(
         swapchain_.image_count(),
         false
     );
 
-    std::cout << "[Midnight] Vulkan frame renderer created\n";
+    MIDNIGHT_LOG_INFO(Renderer, "Vulkan frame renderer created");
 }
 
 VulkanFrameRenderer::~VulkanFrameRenderer()
@@ -59,6 +106,11 @@ VulkanFrameRenderer::~VulkanFrameRenderer()
     destroy_framebuffers();
     destroy_sync_objects();
 
+    if (timestamp_query_pool_ != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(device_.handle(), timestamp_query_pool_, nullptr);
+        timestamp_query_pool_ = VK_NULL_HANDLE;
+    }
+
     if (command_pool_ != VK_NULL_HANDLE) {
         vkDestroyCommandPool(device_.handle(), command_pool_, nullptr);
         command_pool_ = VK_NULL_HANDLE;
@@ -67,8 +119,16 @@ VulkanFrameRenderer::~VulkanFrameRenderer()
 
 bool VulkanFrameRenderer::draw_frame()
 {
+    // Submitted before any early return so uploads never sit unsubmitted
+    // while the swapchain is unavailable.
+    const VulkanTransferContext::Ticket upload_ticket =
+        transfer_context_.submit();
+    const VkSemaphore upload_semaphore =
+        transfer_context_.timeline_semaphore();
+
     const VkFence frame_fence = in_flight_fences_[current_frame_];
 
+    const WaitClock::time_point fence_wait_start = WaitClock::now();
     const VkResult frame_wait_result = vkWaitForFences(
         device_.handle(),
         1,
@@ -76,6 +136,7 @@ bool VulkanFrameRenderer::draw_frame()
         VK_TRUE,
         kHostWaitTimeoutNanoseconds
     );
+    last_frame_wait_ = WaitClock::now() - fence_wait_start;
 
     if (frame_wait_result == VK_TIMEOUT) {
         return true;
@@ -83,6 +144,13 @@ bool VulkanFrameRenderer::draw_frame()
 
     throw_if_vk_failed(frame_wait_result, "vkWaitForFences");
 
+    completed_frame_count_ = std::max(
+        completed_frame_count_,
+        frame_numbers_[current_frame_]
+    );
+
+    read_frame_timestamps();
+
     if (frame_reacquired_presented_image_[current_frame_]) {
         frame_reacquired_presented_image_[current_frame_] = false;
         present_completion_observed_ = true;
@@ -90,6 +158,7 @@ bool VulkanFrameRenderer::draw_frame()
 
     std::uint32_t image_index = 0;
 
+    const WaitClock::time_point acquire_start = WaitClock::now();
     const VkResult acquire_result = vkAcquireNextImageKHR(
         device_.handle(),
         swapchain_.handle(),
@@ -98,6 +167,7 @@ bool VulkanFrameRenderer::draw_frame()
         VK_NULL_HANDLE,
         &image_index
     );
+    last_frame_wait_ += WaitClock::now() - acquire_start;
 
     if (acquire_result == VK_TIMEOUT ||
         acquire_result == VK_NOT_READY) {
@@ -135,20 +205,39 @@ bool VulkanFrameRenderer::draw_frame()
     record_command_buffer(command_buffer, image_index);
 
     const VkSemaphore wait_semaphores[] = {
-        image_available_semaphores_[current_frame_]
+        image_available_semaphores_[current_frame_],
+        upload_semaphore
     };
 
     const VkPipelineStageFlags wait_stages[] = {
-        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+    };
+
+    // Binary semaphores ignore their value slot.
+    const std::uint64_t wait_values[] = {
+        0,
+        upload_ticket
     };
 
     const VkSemaphore signal_semaphores[] = {
         render_finished_semaphores_[image_index]
     };
 
+    const std::uint32_t wait_semaphore_count =
+        upload_semaphore != VK_NULL_HANDLE ? 2 : 1;
+
+    VkTimelineSemaphoreSubmitInfo timeline_info{};
+    timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timeline_info.waitSemaphoreValueCount = wait_semaphore_count;
+    timeline_info.pWaitSemaphoreValues = wait_values;
+
     VkSubmitInfo submit_info{};
     submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submit_info.waitSemaphoreCount = 1;
+    submit_info.pNext =
+        upload_semaphore != VK_NULL_HANDLE ? &timeline_info : nullptr;
+    submit_info.waitSemaphoreCount = wait_semaphore_count;
     submit_info.pWaitSemaphores = wait_semaphores;
     submit_info.pWaitDstStageMask = wait_stages;
     submit_info.commandBufferCount = 1;
@@ -166,8 +255,11 @@ bool VulkanFrameRenderer::draw_frame()
         "vkQueueSubmit"
     );
 
+    frame_numbers_[current_frame_] = ++submitted_frame_count_;
     frame_reacquired_presented_image_[current_frame_] =
         reacquired_presented_image;
+    frame_timestamps_written_[current_frame_] =
+        timestamp_query_pool_ != VK_NULL_HANDLE;
 
     const VkSwapchainKHR swapchains[] = {
         swapchain_.handle()
@@ -182,10 +274,12 @@ bool VulkanFrameRenderer::draw_frame()
     present_info.pImageIndices = &image_index;
     present_info.pResults = nullptr;
 
+    const WaitClock::time_point present_start = WaitClock::now();
     const VkResult present_result = vkQueuePresentKHR(
         device_.present_queue(),
         &present_info
     );
+    last_frame_wait_ += WaitClock::now() - present_start;
 
     if (present_result == VK_SUCCESS ||
         present_result == VK_SUBOPTIMAL_KHR) {
@@ -219,6 +313,8 @@ void VulkanFrameRenderer::wait_for_in_flight_frames()
         "vkWaitForFences"
     );
 
+    completed_frame_count_ = submitted_frame_count_;
+
     for (std::size_t frame_index = 0;
          frame_index < frame_reacquired_presented_image_.size();
          ++frame_index) {
@@ -236,6 +332,44 @@ bool VulkanFrameRenderer::consume_present_completion_observed() noexcept
     return completion_observed;
 }
 
+std::uint64_t VulkanFrameRenderer::submitted_frame_count() const noexcept
+{
+    return submitted_frame_count_;
+}
+
+std::uint64_t VulkanFrameRenderer::completed_frame_count() const noexcept
+{
+    return completed_frame_count_;
+}
+
+std::size_t VulkanFrameRenderer::sprite_vertex_region() const noexcept
+{
+    return static_cast<std::size_t>(
+        (submitted_frame_count_ + 1) % kSpriteVertexRegionCount
+    );
+}
+
+std::uint64_t VulkanFrameRenderer::sprite_vertex_region_released_frame()
+    const noexcept
+{
+    const std::uint64_t next_frame = submitted_frame_count_ + 1;
+
+    return next_frame > kSpriteVertexRegionCount
+        ? next_frame - kSpriteVertexRegionCount
+        : 0;
+}
+
+std::chrono::nanoseconds VulkanFrameRenderer::last_frame_wait() const noexcept
+{
+    return last_frame_wait_;
+}
+
+std::optional<std::chrono::nanoseconds>
+VulkanFrameRenderer::consume_gpu_frame_time() noexcept
+{
+    return std::exchange(gpu_frame_time_, std::nullopt);
+}
+
 void VulkanFrameRenderer::create_command_pool()
 {
     VkCommandPoolCreateInfo create_info{};
@@ -253,7 +387,7 @@ void VulkanFrameRenderer::create_command_pool()
         "vkCreateCommandPool"
     );
 
-    std::cout << "[Midnight] Vulkan command pool created\n";
+    MIDNIGHT_LOG_INFO(Renderer, "Vulkan command pool created");
 }
 
 void VulkanFrameRenderer::create_framebuffers()
@@ -283,9 +417,11 @@ void VulkanFrameRenderer::create_framebuffers()
         );
     }
 
-    std::cout << "[Midnight] Vulkan framebuffers created: "
-              << framebuffers_.size()
-              << '\n';
+    MIDNIGHT_LOG_INFO(
+        Renderer,
+        "Vulkan framebuffers created: {}",
+        framebuffers_.size()
+    );
 }
 
 void VulkanFrameRenderer::destroy_framebuffers() noexcept
@@ -319,9 +455,11 @@ void VulkanFrameRenderer::allocate_command_buffers()
         "vkAllocateCommandBuffers"
     );
 
-    std::cout << "[Midnight] Vulkan command buffers allocated: "
-              << command_buffers_.size()
-              << '\n';
+    MIDNIGHT_LOG_INFO(
+        Renderer,
+        "Vulkan command buffers allocated: {}",
+        command_buffers_.size()
+    );
 }
 
 void VulkanFrameRenderer::create_sync_objects()
@@ -376,7 +514,7 @@ void VulkanFrameRenderer::create_sync_objects()
         );
     }
 
-    std::cout << "[Midnight] Vulkan frame synchronization created\n";
+    MIDNIGHT_LOG_INFO(Renderer, "Vulkan frame synchronization created");
 }
 
 void VulkanFrameRenderer::destroy_sync_objects() noexcept
@@ -404,6 +542,71 @@ void VulkanFrameRenderer::destroy_sync_objects() noexcept
     image_available_semaphores_.clear();
 }
 
+void VulkanFrameRenderer::create_timestamp_query_pool()
+{
+    if (device_.timestamp_period() <= 0.0f) {
+        return;
+    }
+
+    VkQueryPoolCreateInfo create_info{};
+    create_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    create_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    create_info.queryCount =
+        static_cast<std::uint32_t>(kMaxFramesInFlight) * kTimestampsPerFrame;
+
+    throw_if_vk_failed(
+        vkCreateQueryPool(
+            device_.handle(),
+            &create_info,
+            nullptr,
+            &timestamp_query_pool_
+        ),
+        "vkCreateQueryPool"
+    );
+}
+
+// Called once the current frame's fence has signalled, so its queries are
+// available without waiting.
+void VulkanFrameRenderer::read_frame_timestamps()
+{
+    if (!frame_timestamps_written_[current_frame_]) {
+        return;
+    }
+
+    frame_timestamps_written_[current_frame_] = false;
+
+    std::array<std::uint64_t, kTimestampsPerFrame> timestamps{};
+
+    const VkResult result = vkGetQueryPoolResults(
+        device_.handle(),
+        timestamp_query_pool_,
+        static_cast<std::uint32_t>(current_frame_) * kTimestampsPerFrame,
+        kTimestampsPerFrame,
+        sizeof(timestamps),
+        timestamps.data(),
+        sizeof(std::uint64_t),
+        VK_QUERY_RESULT_64_BIT
+    );
+
+    if (result == VK_NOT_READY) {
+        return;
+    }
+
+    throw_if_vk_failed(result, "vkGetQueryPoolResults");
+
+    const std::uint32_t valid_bits = device_.timestamp_valid_bits();
+    const std::uint64_t mask = valid_bits >= 64
+        ? std::numeric_limits<std::uint64_t>::max()
+        : (std::uint64_t{1} << valid_bits) - 1;
+    const std::uint64_t ticks = (timestamps[1] - timestamps[0]) & mask;
+
+    gpu_frame_time_ = std::chrono::nanoseconds{
+        std::llround(
+            static_cast<double>(ticks) * device_.timestamp_period()
+        )
+    };
+}
+
 void VulkanFrameRenderer::record_command_buffer(
     const VkCommandBuffer command_buffer,
     const std::uint32_t image_index
@@ -418,6 +621,24 @@ void VulkanFrameRenderer::record_command_buffer(
         "vkBeginCommandBuffer"
     );
 
+    const std::uint32_t first_timestamp =
+        static_cast<std::uint32_t>(current_frame_) * kTimestampsPerFrame;
+
+    if (timestamp_query_pool_ != VK_NULL_HANDLE) {
+        vkCmdResetQueryPool(
+            command_buffer,
+            timestamp_query_pool_,
+            first_timestamp,
+            kTimestampsPerFrame
+        );
+        vkCmdWriteTimestamp(
+            command_buffer,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            timestamp_query_pool_,
+            first_timestamp
+        );
+    }
+
     VkClearValue clear_value{};
     clear_value.color.float32[0] = 0.035f;
     clear_value.color.float32[1] = 0.025f;
@@ -460,19 +681,22 @@ void VulkanFrameRenderer::record_command_buffer(
         graphics_pipeline_.handle()
     );
 
-    const VkDescriptorSet texture_descriptor_set =
-        texture_descriptor_.handle();
+    const auto bind_texture = [&](const VulkanTextureDescriptor& descriptor) {
+        const VkDescriptorSet descriptor_set = descriptor.handle();
 
-    vkCmdBindDescriptorSets(
-        command_buffer,
-        VK_PIPELINE_BIND_POINT_GRAPHICS,
-        graphics_pipeline_.layout(),
-        0,
-        1,
-        &texture_descriptor_set,
-        0,
-        nullptr
-    );
+        vkCmdBindDescriptorSets(
+            command_buffer,
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            graphics_pipeline_.layout(),
+            0,
+            1,
+            &descriptor_set,
+            0,
+            nullptr
+        );
+    };
+
+    bind_texture(texture_descriptor_);
 
     const VkBuffer vertex_buffers[] = {
         vertex_buffer_.handle()
@@ -497,10 +721,86 @@ void VulkanFrameRenderer::record_command_buffer(
         index_type_
     );
 
-    vkCmdDrawIndexed(command_buffer, index_count_, 1, 0, 0, 0);
+    // Map chunk meshes live in their own pool and are drawn between the
+    // canvas background and the overlays that follow it in the index stream.
+    // They sample the padded, mipmapped map atlas; everything else samples
+    // the plain one.
+    vkCmdDrawIndexed(command_buffer, chunk_mesh_first_index_, 1, 0, 0, 0);
+    bind_texture(map_texture_descriptor_);
+    chunk_meshes_.record_draws(command_buffer);
+    bind_texture(texture_descriptor_);
+
+    vkCmdBindVertexBuffers(
+        command_buffer,
+        0,
+        1,
+        vertex_buffers,
+        vertex_buffer_offsets
+    );
+
+    vkCmdBindIndexBuffer(
+        command_buffer,
+        index_buffer_.handle(),
+        0,
+        index_type_
+    );
+
+    vkCmdDrawIndexed(
+        command_buffer,
+        sprite_first_index_ - chunk_mesh_first_index_,
+        1,
+        chunk_mesh_first_index_,
+        0,
+        0
+    );
+
+    // The sprite indices address the first region; the vertex offset moves
+    // them to the one this frame was given.
+    vkCmdDrawIndexed(
+        command_buffer,
+        sprite_index_count_,
+        1,
+        sprite_first_index_,
+        static_cast<std::int32_t>(
+            sprite_vertex_region() * sprite_region_vertex_count_
+        ),
+        0
+    );
+
+    const std::uint32_t sprite_end_index =
+        sprite_first_index_ + sprite_index_count_;
+
+    vkCmdDrawIndexed(
+        command_buffer,
+        minimap_first_index_ - sprite_end_index,
+        1,
+        sprite_end_index,
+        0,
+        0
+    );
+
+    // The minimap closes the index stream so it draws over every overlay.
+    bind_texture(minimap_texture_descriptor_);
+    vkCmdDrawIndexed(
+        command_buffer,
+        index_count_ - minimap_first_index_,
+        1,
+        minimap_first_index_,
+        0,
+        0
+    );
 
     vkCmdEndRenderPass(command_buffer);
 
+    if (timestamp_query_pool_ != VK_NULL_HANDLE) {
+        vkCmdWriteTimestamp(
+            command_buffer,
+            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            timestamp_query_pool_,
+            first_timestamp + 1
+        );
+    }
+
     throw_if_vk_failed(
         vkEndCommandBuffer(command_buffer),
         "vkEndCommandBuffer"
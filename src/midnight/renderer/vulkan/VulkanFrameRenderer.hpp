@@ -3,31 +3,54 @@
 #include <vulkan/vulkan.h>
 
 #include <array>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <vector>
 
 namespace midnight {
 
 class VulkanBuffer;
+class VulkanChunkMeshPool;
 class VulkanDevice;
 class VulkanGraphicsPipeline;
 class VulkanRenderPass;
 class VulkanSwapchain;
 class VulkanTextureDescriptor;
+class VulkanTransferContext;
 
 class VulkanFrameRenderer final {
 public:
+    static constexpr std::size_t kMaxFramesInFlight = 2;
+
+    // Sprite vertices are rewritten every frame, so the vertex buffer holds
+    // one copy of them per region and each frame draws the sprite indices
+    // from the next region in turn. A region is written again only once the
+    // frame that last drew it has passed its fence wait.
+    static constexpr std::size_t kSpriteVertexRegionCount =
+        kMaxFramesInFlight + 1;
+
     VulkanFrameRenderer(
         const VulkanDevice& device,
+        VulkanTransferContext& transfer_context,
         const VulkanSwapchain& swapchain,
         const VulkanRenderPass& render_pass,
         const VulkanGraphicsPipeline& graphics_pipeline,
         const VulkanTextureDescriptor& texture_descriptor,
+        const VulkanTextureDescriptor& map_texture_descriptor,
+        const VulkanTextureDescriptor& minimap_texture_descriptor,
         const VulkanBuffer& vertex_buffer,
         const VulkanBuffer& index_buffer,
         std::uint32_t index_count,
-        VkIndexType index_type
+        VkIndexType index_type,
+        const VulkanChunkMeshPool& chunk_meshes,
+        std::uint32_t chunk_mesh_first_index,
+        std::uint32_t sprite_first_index,
+        std::uint32_t sprite_index_count,
+        std::uint32_t sprite_region_vertex_count,
+        std::uint32_t minimap_first_index,
+        std::uint64_t previous_frame_count
     );
 
     ~VulkanFrameRenderer();
@@ -38,13 +61,35 @@ public:
     VulkanFrameRenderer(VulkanFrameRenderer&&) = delete;
     VulkanFrameRenderer& operator=(VulkanFrameRenderer&&) = delete;
 
+    // Submits any pending transfer batch first; the frame waits for it on
+    // the GPU.
     [[nodiscard]] bool draw_frame();
     void wait_for_in_flight_frames();
     [[nodiscard]] bool consume_present_completion_observed() noexcept;
 
-private:
-    static constexpr std::size_t kMaxFramesInFlight = 2;
+    // Frames are numbered in submission order, continuing from the renderer
+    // this one replaces. Every frame this renderer submitted up to
+    // completed_frame_count() has finished executing on the GPU.
+    [[nodiscard]] std::uint64_t submitted_frame_count() const noexcept;
+    [[nodiscard]] std::uint64_t completed_frame_count() const noexcept;
 
+    // The region the next submitted frame draws its sprites from. Every
+    // frame that drew from it before has finished once
+    // completed_frame_count() reaches sprite_vertex_region_released_frame().
+    [[nodiscard]] std::size_t sprite_vertex_region() const noexcept;
+    [[nodiscard]] std::uint64_t sprite_vertex_region_released_frame()
+        const noexcept;
+
+    // Time the last draw_frame() spent blocked on the in-flight fence,
+    // image acquisition and presentation rather than doing CPU work.
+    [[nodiscard]] std::chrono::nanoseconds last_frame_wait() const noexcept;
+
+    // GPU execution time of the newest frame whose timestamps were read
+    // back since the last call. Empty without timestamp support.
+    [[nodiscard]] std::optional<std::chrono::nanoseconds>
+        consume_gpu_frame_time() noexcept;
+
+private:
     void create_command_pool();
     void create_framebuffers();
     void destroy_framebuffers() noexcept;
@@ -54,20 +99,32 @@ private:
     void create_sync_objects();
     void destroy_sync_objects() noexcept;
 
+    void create_timestamp_query_pool();
+    void read_frame_timestamps();
+
     void record_command_buffer(
         VkCommandBuffer command_buffer,
         std::uint32_t image_index
     );
 
     const VulkanDevice& device_;
+    VulkanTransferContext& transfer_context_;
     const VulkanSwapchain& swapchain_;
     const VulkanRenderPass& render_pass_;
     const VulkanGraphicsPipeline& graphics_pipeline_;
     const VulkanTextureDescriptor& texture_descriptor_;
+    const VulkanTextureDescriptor& map_texture_descriptor_;
+    const VulkanTextureDescriptor& minimap_texture_descriptor_;
     const VulkanBuffer& vertex_buffer_;
     const VulkanBuffer& index_buffer_;
     std::uint32_t index_count_ = 0;
     VkIndexType index_type_ = VK_INDEX_TYPE_UINT16;
+    const VulkanChunkMeshPool& chunk_meshes_;
+    std::uint32_t chunk_mesh_first_index_ = 0;
+    std::uint32_t sprite_first_index_ = 0;
+    std::uint32_t sprite_index_count_ = 0;
+    std::uint32_t sprite_region_vertex_count_ = 0;
+    std::uint32_t minimap_first_index_ = 0;
 
     VkCommandPool command_pool_ = VK_NULL_HANDLE;
     std::vector<VkFramebuffer> framebuffers_;
@@ -79,6 +136,14 @@ private:
     std::vector<bool> image_has_been_presented_;
     std::array<bool, kMaxFramesInFlight>
         frame_reacquired_presented_image_{};
+    std::array<std::uint64_t, kMaxFramesInFlight> frame_numbers_{};
+    std::uint64_t submitted_frame_count_ = 0;
+    std::uint64_t completed_frame_count_ = 0;
+
+    VkQueryPool timestamp_query_pool_ = VK_NULL_HANDLE;
+    std::array<bool, kMaxFramesInFlight> frame_timestamps_written_{};
+    std::optional<std::chrono::nanoseconds> gpu_frame_time_;
+    std::chrono::nanoseconds last_frame_wait_{};
 
     std::size_t current_frame_ = 0;
     bool present_completion_observed_ = false;
@@ -1,6 +1,7 @@
 #include "midnight/renderer/vulkan/VulkanGraphicsPipeline.hpp"
 
 #include "midnight/core/File.hpp"
+#include "midnight/core/Log.hpp"
 #include "midnight/renderer/Vertex2D.hpp"
 #include "midnight/renderer/vulkan/VulkanDevice.hpp"
 #include "midnight/renderer/vulkan/VulkanRenderPass.hpp"
@@ -11,7 +12,6 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
-#include <iostream>
 #include <stdexcept>
 #include <string>
 
@@ -47,7 +47,7 @@ VulkanGraphicsPipeline::VulkanGraphicsPipeline(
         throw;
     }
 
-    std::cout << "[Midnight] Vulkan graphics pipeline created\n";
+    MIDNIGHT_LOG_INFO(Renderer, "Vulkan graphics pipeline created");
 }
 
 VulkanGraphicsPipeline::~VulkanGraphicsPipeline()
@@ -155,7 +155,7 @@ void VulkanGraphicsPipeline::create_descriptor_set_layout()
         "vkCreateDescriptorSetLayout"
     );
 
-    std::cout << "[Midnight] Vulkan descriptor set layout created\n";
+    MIDNIGHT_LOG_INFO(Renderer, "Vulkan descriptor set layout created");
 }
 
 void VulkanGraphicsPipeline::create_pipeline_layout()
@@ -342,9 +342,11 @@ void VulkanGraphicsPipeline::create_graphics_pipeline()
 
     throw_if_vk_failed(result, "vkCreateGraphicsPipelines");
 
-    std::cout << "[Midnight] Loaded shaders from: "
-              << std::filesystem::path(MIDNIGHT_SHADER_DIR).string()
-              << '\n';
+    MIDNIGHT_LOG_INFO(
+        Renderer,
+        "Loaded shaders from: {}",
+        std::filesystem::path(MIDNIGHT_SHADER_DIR).string()
+    );
 
     (void)swapchain_;
 }
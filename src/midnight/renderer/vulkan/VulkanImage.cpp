@@ -1,10 +1,13 @@
 #include "midnight/renderer/vulkan/VulkanImage.hpp"
 
+#include "midnight/core/Log.hpp"
 #include "midnight/renderer/vulkan/VulkanDevice.hpp"
 #include "midnight/renderer/vulkan/VulkanUtils.hpp"
 
-#include <iostream>
+#include <algorithm>
+#include <bit>
 #include <stdexcept>
+#include <string>
 
 namespace midnight {
 
@@ -14,7 +17,8 @@ VulkanImage::VulkanImage(
 )
     : device_(device),
       extent_(create_info.extent),
-      format_(create_info.format)
+      format_(create_info.format),
+      mip_levels_(create_info.mip_levels)
 {
     if (extent_.width == 0 || extent_.height == 0) {
         throw std::runtime_error("Cannot create a zero-sized Vulkan image");
@@ -24,6 +28,14 @@ VulkanImage::VulkanImage(
         throw std::runtime_error("Cannot create a Vulkan image with an undefined format");
     }
 
+    const auto full_mip_chain = static_cast<std::uint32_t>(
+        std::bit_width(std::max(extent_.width, extent_.height))
+    );
+
+    if (mip_levels_ == 0 || mip_levels_ > full_mip_chain) {
+        throw std::runtime_error("Vulkan image mip level count does not fit its extent");
+    }
+
     if (create_info.usage == 0) {
         throw std::runtime_error("Cannot create a Vulkan image without a usage");
     }
@@ -40,13 +52,14 @@ VulkanImage::VulkanImage(
         throw;
     }
 
-    std::cout << "[Midnight] Vulkan image created: "
-              << extent_.width
-              << "x"
-              << extent_.height
-              << " "
-              << vulkan_format_to_string(format_)
-              << '\n';
+    MIDNIGHT_LOG_INFO(
+        Renderer,
+        "Vulkan image created: {}x{} {}, {} mip levels",
+        extent_.width,
+        extent_.height,
+        vulkan_format_to_string(format_),
+        mip_levels_
+    );
 }
 
 VulkanImage::~VulkanImage()
@@ -74,6 +87,11 @@ VkFormat VulkanImage::format() const noexcept
     return format_;
 }
 
+std::uint32_t VulkanImage::mip_levels() const noexcept
+{
+    return mip_levels_;
+}
+
 void VulkanImage::create_image(const VkImageUsageFlags usage)
 {
     VkImageCreateInfo create_info{};
@@ -85,7 +103,7 @@ void VulkanImage::create_image(const VkImageUsageFlags usage)
         .height = extent_.height,
         .depth = 1
     };
-    create_info.mipLevels = 1;
+    create_info.mipLevels = mip_levels_;
     create_info.arrayLayers = 1;
     create_info.samples = VK_SAMPLE_COUNT_1_BIT;
     create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
@@ -110,30 +128,18 @@ void VulkanImage::create_image(const VkImageUsageFlags usage)
         &memory_requirements
     );
 
-    VkMemoryAllocateInfo allocate_info{};
-    allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocate_info.allocationSize = memory_requirements.size;
-    allocate_info.memoryTypeIndex = device_.find_memory_type(
-        memory_requirements.memoryTypeBits,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
-    );
-
-    throw_if_vk_failed(
-        vkAllocateMemory(
-            device_.handle(),
-            &allocate_info,
-            nullptr,
-            &memory_
-        ),
-        "vkAllocateMemory"
+    allocation_ = device_.memory_allocator().allocate(
+        memory_requirements,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        VulkanMemoryAllocator::ResourceKind::Image
     );
 
     throw_if_vk_failed(
         vkBindImageMemory(
             device_.handle(),
             image_,
-            memory_,
-            0
+            allocation_.memory,
+            allocation_.offset
         ),
         "vkBindImageMemory"
     );
@@ -148,7 +154,7 @@ void VulkanImage::create_image_view(const VkImageAspectFlags aspect_mask)
     create_info.format = format_;
     create_info.subresourceRange.aspectMask = aspect_mask;
     create_info.subresourceRange.baseMipLevel = 0;
-    create_info.subresourceRange.levelCount = 1;
+    create_info.subresourceRange.levelCount = mip_levels_;
     create_info.subresourceRange.baseArrayLayer = 0;
     create_info.subresourceRange.layerCount = 1;
 
@@ -175,10 +181,7 @@ void VulkanImage::destroy() noexcept
         image_ = VK_NULL_HANDLE;
     }
 
-    if (memory_ != VK_NULL_HANDLE) {
-        vkFreeMemory(device_.handle(), memory_, nullptr);
-        memory_ = VK_NULL_HANDLE;
-    }
+    device_.memory_allocator().free(allocation_);
 }
 
 }
@@ -1,7 +1,11 @@
 #pragma once
 
+#include "midnight/renderer/vulkan/VulkanMemoryAllocator.hpp"
+
 #include <vulkan/vulkan.h>
 
+#include <cstdint>
+
 namespace midnight {
 
 class VulkanDevice;
@@ -13,6 +17,7 @@ public:
         VkFormat format = VK_FORMAT_UNDEFINED;
         VkImageUsageFlags usage = 0;
         VkImageAspectFlags aspect_mask = VK_IMAGE_ASPECT_COLOR_BIT;
+        std::uint32_t mip_levels = 1;
     };
 
     VulkanImage(const VulkanDevice& device, const CreateInfo& create_info);
@@ -28,6 +33,7 @@ public:
     [[nodiscard]] VkImageView image_view() const noexcept;
     [[nodiscard]] VkExtent2D extent() const noexcept;
     [[nodiscard]] VkFormat format() const noexcept;
+    [[nodiscard]] std::uint32_t mip_levels() const noexcept;
 
 private:
     void create_image(VkImageUsageFlags usage);
@@ -37,9 +43,10 @@ private:
     const VulkanDevice& device_;
     VkExtent2D extent_{};
     VkFormat format_ = VK_FORMAT_UNDEFINED;
+    std::uint32_t mip_levels_ = 1;
 
     VkImage image_ = VK_NULL_HANDLE;
-    VkDeviceMemory memory_ = VK_NULL_HANDLE;
+    VulkanMemoryAllocator::Allocation allocation_{};
     VkImageView image_view_ = VK_NULL_HANDLE;
 };
 
@@ -1,5 +1,6 @@
 #include "midnight/renderer/vulkan/VulkanInstance.hpp"
 
+#include "midnight/core/Log.hpp"
 #include "midnight/renderer/vulkan/VulkanUtils.hpp"
 
 #include <SDL3/SDL.h>
@@ -7,7 +8,6 @@
 
 #include <algorithm>
 #include <cstring>
-#include <iostream>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -138,11 +138,15 @@ VKAPI_ATTR VkBool32 VKAPI_CALL debug_callback(
     void* user_data
 )
 {
-    (void)message_severity;
     (void)message_type;
     (void)user_data;
 
-    std::cerr << "[Vulkan validation] " << callback_data->pMessage << '\n';
+    if ((message_severity &
+         VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT) != 0) {
+        MIDNIGHT_LOG_ERROR(Validation, "{}", callback_data->pMessage);
+    } else {
+        MIDNIGHT_LOG_WARNING(Validation, "{}", callback_data->pMessage);
+    }
 
     return VK_FALSE;
 }
@@ -192,13 +196,18 @@ bool VulkanInstance::validation_enabled() const noexcept
     return validation_enabled_;
 }
 
+std::uint32_t VulkanInstance::api_version() const noexcept
+{
+    return api_version_;
+}
+
 void VulkanInstance::create_instance()
 {
 #if MIDNIGHT_DEBUG
     validation_enabled_ = layer_available(kValidationLayerName);
 
     if (!validation_enabled_) {
-        std::cerr << "[Midnight] Vulkan validation layer not found. Continuing without validation.\n";
+        MIDNIGHT_LOG_WARNING(Renderer, "Vulkan validation layer not found. Continuing without validation.");
     }
 #else
     validation_enabled_ = false;
@@ -209,7 +218,7 @@ void VulkanInstance::create_instance()
         extension_available(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
 
     if (validation_enabled_ && !debug_utils_enabled_) {
-        std::cerr << "[Midnight] VK_EXT_debug_utils not found. Validation messages will not be captured.\n";
+        MIDNIGHT_LOG_WARNING(Renderer, "VK_EXT_debug_utils not found. Validation messages will not be captured.");
     }
 
     const std::vector<const char*> extensions =
@@ -221,7 +230,7 @@ void VulkanInstance::create_instance()
         layers.push_back(kValidationLayerName);
     }
 
-    const uint32_t api_version = choose_instance_api_version();
+    api_version_ = choose_instance_api_version();
 
     VkApplicationInfo app_info{};
     app_info.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
@@ -229,7 +238,7 @@ void VulkanInstance::create_instance()
     app_info.applicationVersion = VK_MAKE_VERSION(0, 1, 0);
     app_info.pEngineName = "Midnight Engine";
     app_info.engineVersion = VK_MAKE_VERSION(0, 1, 0);
-    app_info.apiVersion = api_version;
+    app_info.apiVersion = api_version_;
 
     VkDebugUtilsMessengerCreateInfoEXT debug_create_info{};
 
@@ -251,20 +260,21 @@ void VulkanInstance::create_instance()
         "vkCreateInstance"
     );
 
-    std::cout << "[Midnight] Vulkan instance created. API "
-              << vulkan_api_version_to_string(api_version)
-              << '\n';
-
-    std::cout << "[Midnight] Vulkan instance extensions:\n";
+    MIDNIGHT_LOG_INFO(
+        Renderer,
+        "Vulkan instance created. API {}",
+        vulkan_api_version_to_string(api_version_)
+    );
+    MIDNIGHT_LOG_INFO(Renderer, "Vulkan instance extensions:");
 
     for (const char* extension : extensions) {
-        std::cout << "  - " << extension << '\n';
+        MIDNIGHT_LOG_INFO(Renderer, "  - {}", extension);
     }
 
     if (validation_enabled_) {
-        std::cout << "[Midnight] Vulkan validation enabled\n";
+        MIDNIGHT_LOG_INFO(Renderer, "Vulkan validation enabled");
     } else {
-        std::cout << "[Midnight] Vulkan validation disabled\n";
+        MIDNIGHT_LOG_INFO(Renderer, "Vulkan validation disabled");
     }
 }
 
@@ -280,7 +290,7 @@ void VulkanInstance::setup_debug_messenger()
         );
 
     if (create_debug_utils_messenger == nullptr) {
-        std::cerr << "[Midnight] vkCreateDebugUtilsMessengerEXT was not available\n";
+        MIDNIGHT_LOG_WARNING(Renderer, "vkCreateDebugUtilsMessengerEXT was not available");
         return;
     }
 
@@ -292,7 +302,7 @@ void VulkanInstance::setup_debug_messenger()
         "vkCreateDebugUtilsMessengerEXT"
     );
 
-    std::cout << "[Midnight] Vulkan debug messenger created\n";
+    MIDNIGHT_LOG_INFO(Renderer, "Vulkan debug messenger created");
 }
 
 void VulkanInstance::destroy_debug_messenger() noexcept
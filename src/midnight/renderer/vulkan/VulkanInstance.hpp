@@ -2,6 +2,8 @@
 
 #include <vulkan/vulkan.h>
 
+#include <cstdint>
+
 namespace midnight {
 
 class VulkanInstance final {
@@ -17,6 +19,7 @@ public:
 
     [[nodiscard]] VkInstance handle() const noexcept;
     [[nodiscard]] bool validation_enabled() const noexcept;
+    [[nodiscard]] std::uint32_t api_version() const noexcept;
 
 private:
     void create_instance();
@@ -25,6 +28,7 @@ private:
 
     VkInstance instance_ = VK_NULL_HANDLE;
     VkDebugUtilsMessengerEXT debug_messenger_ = VK_NULL_HANDLE;
+    std::uint32_t api_version_ = VK_API_VERSION_1_0;
 
     bool validation_enabled_ = false;
     bool debug_utils_enabled_ = false;
@@ -0,0 +1,435 @@
+#include "midnight/renderer/vulkan/VulkanMemoryAllocator.hpp"
+
+#include "midnight/core/Log.hpp"
+#include "midnight/renderer/vulkan/VulkanDevice.hpp"
+#include "midnight/renderer/vulkan/VulkanUtils.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace midnight {
+namespace {
+
+constexpr VkDeviceSize kPreferredBlockSize = 64ull * 1024 * 1024;
+constexpr VkDeviceSize kMinimumBlockSize = 1ull * 1024 * 1024;
+constexpr VkDeviceSize kDedicatedImageSize = 16ull * 1024 * 1024;
+
+constexpr std::uint32_t pool_index(
+    const std::uint32_t memory_type_index,
+    const VulkanMemoryAllocator::ResourceKind kind
+)
+{
+    return memory_type_index * 2 + static_cast<std::uint32_t>(kind);
+}
+
+double mebibytes(const VkDeviceSize bytes)
+{
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+}
+
+VulkanMemoryAllocator::VulkanMemoryAllocator(const VulkanDevice& device)
+    : device_(device)
+{
+    vkGetPhysicalDeviceMemoryProperties(
+        device_.physical_device(),
+        &memory_properties_
+    );
+
+    pools_.resize(static_cast<std::size_t>(memory_properties_.memoryTypeCount) * 2);
+
+    for (std::uint32_t type_index = 0;
+         type_index < memory_properties_.memoryTypeCount;
+         ++type_index) {
+        const VkDeviceSize heap_size = memory_properties_.memoryHeaps[
+            memory_properties_.memoryTypes[type_index].heapIndex
+        ].size;
+        const VkDeviceSize block_size = std::clamp(
+            heap_size / 8,
+            kMinimumBlockSize,
+            kPreferredBlockSize
+        );
+
+        for (const ResourceKind kind : {ResourceKind::Buffer, ResourceKind::Image}) {
+            Pool& pool = pools_[pool_index(type_index, kind)];
+            pool.memory_type_index = type_index;
+            pool.kind = kind;
+            pool.block_size = block_size;
+        }
+    }
+}
+
+VulkanMemoryAllocator::~VulkanMemoryAllocator()
+{
+    std::size_t leaked_count = 0;
+
+    for (Pool& pool : pools_) {
+        for (std::unique_ptr<Block>& block : pool.blocks) {
+            if (block == nullptr) {
+                continue;
+            }
+
+            leaked_count += block->allocator.stats().allocation_count;
+            free_device_memory(block->memory);
+        }
+    }
+
+    for (const DedicatedAllocation& dedicated : dedicated_) {
+        if (dedicated.memory != VK_NULL_HANDLE) {
+            ++leaked_count;
+            free_device_memory(dedicated.memory);
+        }
+    }
+
+    if (leaked_count > 0) {
+        MIDNIGHT_LOG_WARNING(
+            Renderer,
+            "GPU memory allocator destroyed with {} live allocations",
+            leaked_count
+        );
+    }
+}
+
+VulkanMemoryAllocator::Allocation VulkanMemoryAllocator::allocate(
+    const VkMemoryRequirements& requirements,
+    const VkMemoryPropertyFlags properties,
+    const ResourceKind kind
+)
+{
+    const std::uint32_t memory_type_index = device_.find_memory_type(
+        requirements.memoryTypeBits,
+        properties
+    );
+
+    const std::scoped_lock lock(mutex_);
+    Pool& pool = pools_[pool_index(memory_type_index, kind)];
+
+    if (requirements.size > pool.block_size / 2 ||
+        (kind == ResourceKind::Image &&
+         requirements.size >= kDedicatedImageSize)) {
+        return allocate_dedicated(memory_type_index, requirements.size);
+    }
+
+    const VkDeviceSize alignment = std::max<VkDeviceSize>(
+        requirements.alignment,
+        1
+    );
+
+    const auto make_allocation = [&pool](
+        const std::uint32_t block_index,
+        const TlsfAllocator::Allocation& range
+    ) {
+        const Block& block = *pool.blocks[block_index];
+        Allocation allocation{};
+        allocation.memory = block.memory;
+        allocation.offset = range.offset;
+        allocation.size = range.size;
+        allocation.mapped = block.mapped != nullptr
+            ? block.mapped + range.offset
+            : nullptr;
+        allocation.pool = pool_index(pool.memory_type_index, pool.kind);
+        allocation.block = block_index;
+        allocation.handle = range.handle;
+
+        return allocation;
+    };
+
+    std::uint32_t free_block_index = kDedicatedPool;
+
+    for (std::uint32_t block_index = 0;
+         block_index < pool.blocks.size();
+         ++block_index) {
+        if (pool.blocks[block_index] == nullptr) {
+            free_block_index = std::min(free_block_index, block_index);
+            continue;
+        }
+
+        const std::optional<TlsfAllocator::Allocation> range =
+            pool.blocks[block_index]->allocator.allocate(
+                requirements.size,
+                alignment
+            );
+
+        if (range.has_value()) {
+            return make_allocation(block_index, range.value());
+        }
+    }
+
+    std::byte* mapped = nullptr;
+    const VkDeviceMemory memory = allocate_device_memory(
+        memory_type_index,
+        pool.block_size,
+        mapped
+    );
+
+    if (memory == VK_NULL_HANDLE) {
+        // The heap cannot fit another full block; an exact-size allocation
+        // may still succeed.
+        return allocate_dedicated(memory_type_index, requirements.size);
+    }
+
+    if (free_block_index == kDedicatedPool) {
+        free_block_index = static_cast<std::uint32_t>(pool.blocks.size());
+        pool.blocks.emplace_back();
+    }
+
+    pool.blocks[free_block_index] = std::make_unique<Block>(Block{
+        .memory = memory,
+        .mapped = mapped,
+        .allocator = TlsfAllocator(pool.block_size)
+    });
+
+    const std::optional<TlsfAllocator::Allocation> range =
+        pool.blocks[free_block_index]->allocator.allocate(
+            requirements.size,
+            alignment
+        );
+
+    if (!range.has_value()) {
+        throw std::runtime_error("GPU memory request does not fit a fresh block");
+    }
+
+    return make_allocation(free_block_index, range.value());
+}
+
+void VulkanMemoryAllocator::free(Allocation& allocation) noexcept
+{
+    if (allocation.memory == VK_NULL_HANDLE) {
+        return;
+    }
+
+    const std::scoped_lock lock(mutex_);
+
+    if (allocation.pool == kDedicatedPool) {
+        free_device_memory(allocation.memory);
+        dedicated_[allocation.block] = DedicatedAllocation{};
+        allocation = Allocation{};
+        return;
+    }
+
+    Pool& pool = pools_[allocation.pool];
+    Block& block = *pool.blocks[allocation.block];
+    block.allocator.free(allocation.handle);
+
+    // Keep one empty block per pool around so a resource that is recreated
+    // every few frames does not bounce through vkAllocateMemory.
+    if (block.allocator.empty()) {
+        const bool other_empty_block = std::ranges::any_of(
+            pool.blocks,
+            [&block](const std::unique_ptr<Block>& candidate) {
+                return candidate != nullptr &&
+                    candidate.get() != &block &&
+                    candidate->allocator.empty();
+            }
+        );
+
+        if (other_empty_block) {
+            free_device_memory(block.memory);
+            pool.blocks[allocation.block].reset();
+        }
+    }
+
+    allocation = Allocation{};
+}
+
+VulkanMemoryAllocator::Stats VulkanMemoryAllocator::stats() const
+{
+    const std::scoped_lock lock(mutex_);
+    Stats stats{};
+    stats.device_memory_count = device_memory_count_;
+
+    for (const Pool& pool : pools_) {
+        for (const std::unique_ptr<Block>& block : pool.blocks) {
+            if (block == nullptr) {
+                continue;
+            }
+
+            const TlsfAllocator::Stats block_stats = block->allocator.stats();
+            ++stats.block_count;
+            stats.allocation_count += block_stats.allocation_count;
+            stats.reserved_bytes += block_stats.capacity;
+            stats.used_bytes += block_stats.used;
+        }
+    }
+
+    for (const DedicatedAllocation& dedicated : dedicated_) {
+        if (dedicated.memory == VK_NULL_HANDLE) {
+            continue;
+        }
+
+        ++stats.dedicated_count;
+        ++stats.allocation_count;
+        stats.reserved_bytes += dedicated.size;
+        stats.used_bytes += dedicated.size;
+    }
+
+    return stats;
+}
+
+void VulkanMemoryAllocator::print_stats() const
+{
+    const Stats totals = stats();
+
+    MIDNIGHT_LOG_INFO(
+        Renderer,
+        "GPU memory: {} allocations in {} device memory objects "
+        "({} blocks, {} dedicated), {} / {} MiB used",
+        totals.allocation_count,
+        totals.device_memory_count,
+        totals.block_count,
+        totals.dedicated_count,
+        mebibytes(totals.used_bytes),
+        mebibytes(totals.reserved_bytes)
+    );
+
+    const std::scoped_lock lock(mutex_);
+
+    for (const Pool& pool : pools_) {
+        std::size_t block_count = 0;
+        TlsfAllocator::Stats pool_stats{};
+
+        for (const std::unique_ptr<Block>& block : pool.blocks) {
+            if (block == nullptr) {
+                continue;
+            }
+
+            const TlsfAllocator::Stats block_stats = block->allocator.stats();
+            ++block_count;
+            pool_stats.capacity += block_stats.capacity;
+            pool_stats.used += block_stats.used;
+            pool_stats.allocation_count += block_stats.allocation_count;
+            pool_stats.free_range_count += block_stats.free_range_count;
+            pool_stats.largest_free_range = std::max(
+                pool_stats.largest_free_range,
+                block_stats.largest_free_range
+            );
+        }
+
+        if (block_count == 0) {
+            continue;
+        }
+
+        MIDNIGHT_LOG_INFO(
+            Renderer,
+            "  - memory type {} {}: {} allocations in {} blocks, "
+            "{} / {} MiB used, {} free ranges, largest {} MiB",
+            pool.memory_type_index,
+            pool.kind == ResourceKind::Buffer ? "buffers" : "images",
+            pool_stats.allocation_count,
+            block_count,
+            mebibytes(pool_stats.used),
+            mebibytes(pool_stats.capacity),
+            pool_stats.free_range_count,
+            mebibytes(pool_stats.largest_free_range)
+        );
+    }
+}
+
+VulkanMemoryAllocator::Allocation VulkanMemoryAllocator::allocate_dedicated(
+    const std::uint32_t memory_type_index,
+    const VkDeviceSize size
+)
+{
+    std::byte* mapped = nullptr;
+    const VkDeviceMemory memory =
+        allocate_device_memory(memory_type_index, size, mapped);
+
+    if (memory == VK_NULL_HANDLE) {
+        throw std::runtime_error("vkAllocateMemory failed: out of device memory");
+    }
+
+    const auto slot = std::ranges::find_if(
+        dedicated_,
+        [](const DedicatedAllocation& dedicated) {
+            return dedicated.memory == VK_NULL_HANDLE;
+        }
+    );
+    const std::size_t slot_index =
+        static_cast<std::size_t>(slot - dedicated_.begin());
+
+    if (slot == dedicated_.end()) {
+        dedicated_.emplace_back();
+    }
+
+    dedicated_[slot_index] = DedicatedAllocation{
+        .memory = memory,
+        .size = size
+    };
+
+    Allocation allocation{};
+    allocation.memory = memory;
+    allocation.offset = 0;
+    allocation.size = size;
+    allocation.mapped = mapped;
+    allocation.pool = kDedicatedPool;
+    allocation.block = static_cast<std::uint32_t>(slot_index);
+
+    return allocation;
+}
+
+VkDeviceMemory VulkanMemoryAllocator::allocate_device_memory(
+    const std::uint32_t memory_type_index,
+    const VkDeviceSize size,
+    std::byte*& mapped
+)
+{
+    VkMemoryAllocateInfo allocate_info{};
+    allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocate_info.allocationSize = size;
+    allocate_info.memoryTypeIndex = memory_type_index;
+
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    const VkResult result = vkAllocateMemory(
+        device_.handle(),
+        &allocate_info,
+        nullptr,
+        &memory
+    );
+
+    if (result == VK_ERROR_OUT_OF_DEVICE_MEMORY ||
+        result == VK_ERROR_OUT_OF_HOST_MEMORY) {
+        return VK_NULL_HANDLE;
+    }
+
+    throw_if_vk_failed(result, "vkAllocateMemory");
+    ++device_memory_count_;
+
+    mapped = nullptr;
+
+    if ((memory_properties_.memoryTypes[memory_type_index].propertyFlags &
+         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0) {
+        void* mapped_memory = nullptr;
+
+        try {
+            throw_if_vk_failed(
+                vkMapMemory(
+                    device_.handle(),
+                    memory,
+                    0,
+                    VK_WHOLE_SIZE,
+                    0,
+                    &mapped_memory
+                ),
+                "vkMapMemory"
+            );
+        } catch (...) {
+            free_device_memory(memory);
+            throw;
+        }
+
+        mapped = static_cast<std::byte*>(mapped_memory);
+    }
+
+    return memory;
+}
+
+void VulkanMemoryAllocator::free_device_memory(
+    const VkDeviceMemory memory
+) noexcept
+{
+    vkFreeMemory(device_.handle(), memory, nullptr);
+    --device_memory_count_;
+}
+
+}
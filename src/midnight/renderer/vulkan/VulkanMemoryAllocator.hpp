@@ -0,0 +1,112 @@
+#pragma once
+
+#include "midnight/core/TlsfAllocator.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace midnight {
+
+class VulkanDevice;
+
+// Sub-allocates buffers and images out of large VkDeviceMemory blocks, one
+// block list per memory type and resource kind. Keeping linear (buffer) and
+// optimal-tiling (image) resources in separate blocks means neighbours can
+// never violate bufferImageGranularity. Host-visible blocks stay mapped for
+// their whole lifetime.
+class VulkanMemoryAllocator final {
+public:
+    enum class ResourceKind : std::uint8_t {
+        Buffer,
+        Image
+    };
+
+    struct Allocation final {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        std::byte* mapped = nullptr;
+
+    private:
+        friend class VulkanMemoryAllocator;
+
+        std::uint32_t pool = 0;
+        std::uint32_t block = 0;
+        TlsfAllocator::Handle handle = TlsfAllocator::kInvalidHandle;
+    };
+
+    struct Stats final {
+        std::size_t device_memory_count = 0;
+        std::size_t block_count = 0;
+        std::size_t dedicated_count = 0;
+        std::size_t allocation_count = 0;
+        VkDeviceSize reserved_bytes = 0;
+        VkDeviceSize used_bytes = 0;
+    };
+
+    explicit VulkanMemoryAllocator(const VulkanDevice& device);
+    ~VulkanMemoryAllocator();
+
+    VulkanMemoryAllocator(const VulkanMemoryAllocator&) = delete;
+    VulkanMemoryAllocator& operator=(const VulkanMemoryAllocator&) = delete;
+
+    VulkanMemoryAllocator(VulkanMemoryAllocator&&) = delete;
+    VulkanMemoryAllocator& operator=(VulkanMemoryAllocator&&) = delete;
+
+    [[nodiscard]] Allocation allocate(
+        const VkMemoryRequirements& requirements,
+        VkMemoryPropertyFlags properties,
+        ResourceKind kind
+    );
+
+    void free(Allocation& allocation) noexcept;
+
+    [[nodiscard]] Stats stats() const;
+    void print_stats() const;
+
+private:
+    static constexpr std::uint32_t kDedicatedPool = 0xFFFF'FFFFu;
+
+    struct Block final {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        std::byte* mapped = nullptr;
+        TlsfAllocator allocator;
+    };
+
+    struct Pool final {
+        std::uint32_t memory_type_index = 0;
+        ResourceKind kind = ResourceKind::Buffer;
+        VkDeviceSize block_size = 0;
+        std::vector<std::unique_ptr<Block>> blocks;
+    };
+
+    struct DedicatedAllocation final {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize size = 0;
+    };
+
+    [[nodiscard]] Allocation allocate_dedicated(
+        std::uint32_t memory_type_index,
+        VkDeviceSize size
+    );
+    [[nodiscard]] VkDeviceMemory allocate_device_memory(
+        std::uint32_t memory_type_index,
+        VkDeviceSize size,
+        std::byte*& mapped
+    );
+    void free_device_memory(VkDeviceMemory memory) noexcept;
+
+    const VulkanDevice& device_;
+    VkPhysicalDeviceMemoryProperties memory_properties_{};
+    mutable std::mutex mutex_;
+    std::vector<Pool> pools_;
+    std::vector<DedicatedAllocation> dedicated_;
+    std::size_t device_memory_count_ = 0;
+};
+
+}
@@ -1,11 +1,11 @@
 #include "midnight/renderer/vulkan/VulkanRenderPass.hpp"
 
+#include "midnight/core/Log.hpp"
 #include "midnight/renderer/vulkan/VulkanDevice.hpp"
 #include "midnight/renderer/vulkan/VulkanSwapchain.hpp"
 #include "midnight/renderer/vulkan/VulkanUtils.hpp"
 
 #include <array>
-#include <iostream>
 
 namespace midnight {
 
@@ -18,7 +18,7 @@ VulkanRenderPass::VulkanRenderPass(
 {
     create_render_pass();
 
-    std::cout << "[Midnight] Vulkan render pass created\n";
+    MIDNIGHT_LOG_INFO(Renderer, "Vulkan render pass created");
 }
 
 VulkanRenderPass::~VulkanRenderPass()
@@ -1,9 +1,9 @@
 #include "midnight/renderer/vulkan/VulkanSampler.hpp"
 
+#include "midnight/core/Log.hpp"
 #include "midnight/renderer/vulkan/VulkanDevice.hpp"
 #include "midnight/renderer/vulkan/VulkanUtils.hpp"
 
-#include <iostream>
 
 namespace midnight {
 
@@ -17,17 +17,17 @@ VulkanSampler::VulkanSampler(
     sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
     sampler_info.magFilter = create_info.mag_filter;
     sampler_info.minFilter = create_info.min_filter;
-    sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    sampler_info.mipmapMode = create_info.mipmap_mode;
     sampler_info.addressModeU = create_info.address_mode;
     sampler_info.addressModeV = create_info.address_mode;
     sampler_info.addressModeW = create_info.address_mode;
-    sampler_info.mipLodBias = 0.0f;
+    sampler_info.mipLodBias = create_info.mip_lod_bias;
     sampler_info.anisotropyEnable = VK_FALSE;
     sampler_info.maxAnisotropy = 1.0f;
     sampler_info.compareEnable = VK_FALSE;
     sampler_info.compareOp = VK_COMPARE_OP_ALWAYS;
     sampler_info.minLod = 0.0f;
-    sampler_info.maxLod = 0.0f;
+    sampler_info.maxLod = create_info.max_lod;
     sampler_info.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
     sampler_info.unnormalizedCoordinates = VK_FALSE;
 
@@ -41,7 +41,7 @@ VulkanSampler::VulkanSampler(
         "vkCreateSampler"
     );
 
-    std::cout << "[Midnight] Vulkan sampler created\n";
+    MIDNIGHT_LOG_INFO(Renderer, "Vulkan sampler created");
 }
 
 VulkanSampler::~VulkanSampler()
@@ -13,6 +13,9 @@ public:
         VkFilter mag_filter = VK_FILTER_NEAREST;
         VkSamplerAddressMode address_mode =
             VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        VkSamplerMipmapMode mipmap_mode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        float mip_lod_bias = 0.0f;
+        float max_lod = 0.0f;
     };
 
     VulkanSampler(const VulkanDevice& device, const CreateInfo& create_info);
@@ -1,12 +1,12 @@
 #include "midnight/renderer/vulkan/VulkanSurface.hpp"
 
+#include "midnight/core/Log.hpp"
 #include "midnight/platform/Window.hpp"
 #include "midnight/renderer/vulkan/VulkanInstance.hpp"
 
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_vulkan.h>
 
-#include <iostream>
 #include <stdexcept>
 #include <string>
 
@@ -21,7 +21,7 @@ VulkanSurface::VulkanSurface(const Window& window, const VulkanInstance& instanc
         );
     }
 
-    std::cout << "[Midnight] Vulkan surface created\n";
+    MIDNIGHT_LOG_INFO(Renderer, "Vulkan surface created");
 }
 
 VulkanSurface::~VulkanSurface()
@@ -1,12 +1,12 @@
 #include "midnight/renderer/vulkan/VulkanSwapchain.hpp"
 
+#include "midnight/core/Log.hpp"
 #include "midnight/platform/Window.hpp"
 #include "midnight/renderer/vulkan/VulkanDevice.hpp"
 #include "midnight/renderer/vulkan/VulkanSurface.hpp"
 #include "midnight/renderer/vulkan/VulkanUtils.hpp"
 
 #include <algorithm>
-#include <iostream>
 #include <limits>
 #include <stdexcept>
 #include <vector>
@@ -328,21 +328,24 @@ void VulkanSwapchain::create_swapchain(
         "vkGetSwapchainImagesKHR"
     );
 
-    std::cout << "[Midnight] Vulkan swapchain created\n";
-    std::cout << "[Midnight] Swapchain extent: "
-              << extent_.width
-              << "x"
-              << extent_.height
-              << '\n';
-    std::cout << "[Midnight] Swapchain format: "
-              << vulkan_format_to_string(image_format_)
-              << '\n';
-    std::cout << "[Midnight] Swapchain present mode: "
-              << vulkan_present_mode_to_string(present_mode)
-              << '\n';
-    std::cout << "[Midnight] Swapchain images: "
-              << images_.size()
-              << '\n';
+    MIDNIGHT_LOG_INFO(Renderer, "Vulkan swapchain created");
+    MIDNIGHT_LOG_INFO(
+        Renderer,
+        "Swapchain extent: {}x{}",
+        extent_.width,
+        extent_.height
+    );
+    MIDNIGHT_LOG_INFO(
+        Renderer,
+        "Swapchain format: {}",
+        vulkan_format_to_string(image_format_)
+    );
+    MIDNIGHT_LOG_INFO(
+        Renderer,
+        "Swapchain present mode: {}",
+        vulkan_present_mode_to_string(present_mode)
+    );
+    MIDNIGHT_LOG_INFO(Renderer, "Swapchain images: {}", images_.size());
 }
 
 void VulkanSwapchain::create_image_views()
@@ -378,9 +381,11 @@ void VulkanSwapchain::create_image_views()
         );
     }
 
-    std::cout << "[Midnight] Swapchain image views created: "
-              << image_views_.size()
-              << '\n';
+    MIDNIGHT_LOG_INFO(
+        Renderer,
+        "Swapchain image views created: {}",
+        image_views_.size()
+    );
 }
 
 void VulkanSwapchain::destroy_image_views() noexcept
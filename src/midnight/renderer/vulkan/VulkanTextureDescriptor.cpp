@@ -1,11 +1,11 @@
 #include "midnight/renderer/vulkan/VulkanTextureDescriptor.hpp"
 
+#include "midnight/core/Log.hpp"
 #include "midnight/renderer/vulkan/VulkanDevice.hpp"
 #include "midnight/renderer/vulkan/VulkanImage.hpp"
 #include "midnight/renderer/vulkan/VulkanSampler.hpp"
 #include "midnight/renderer/vulkan/VulkanUtils.hpp"
 
-#include <iostream>
 
 namespace midnight {
 
@@ -26,7 +26,7 @@ VulkanTextureDescriptor::VulkanTextureDescriptor(
         throw;
     }
 
-    std::cout << "[Midnight] Vulkan texture descriptor created\n";
+    MIDNIGHT_LOG_INFO(Renderer, "Vulkan texture descriptor created");
 }
 
 VulkanTextureDescriptor::~VulkanTextureDescriptor()
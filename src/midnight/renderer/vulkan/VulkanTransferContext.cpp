@@ -1,30 +1,44 @@
 #include "midnight/renderer/vulkan/VulkanTransferContext.hpp"
 
+#include "midnight/core/Log.hpp"
 #include "midnight/renderer/vulkan/VulkanBuffer.hpp"
 #include "midnight/renderer/vulkan/VulkanDevice.hpp"
 #include "midnight/renderer/vulkan/VulkanImage.hpp"
 #include "midnight/renderer/vulkan/VulkanUtils.hpp"
 
-#include <cstdint>
-#include <iostream>
+#include <algorithm>
+#include <bit>
 #include <limits>
 #include <stdexcept>
 
 namespace midnight {
+namespace {
+
+constexpr VkDeviceSize kMinimumStagingBufferSize = 1024 * 1024;
+
+// Covers texel-size and 4-byte offset rules for buffer-to-image copies.
+constexpr VkDeviceSize kStagingAlignment = 16;
+
+}
 
 VulkanTransferContext::VulkanTransferContext(const VulkanDevice& device)
     : device_(device)
 {
     try {
         create_command_pool();
-        allocate_command_buffer();
-        create_completion_fence();
+        allocate_command_buffers();
+        create_sync_objects();
     } catch (...) {
         destroy();
         throw;
     }
 
-    std::cout << "[Midnight] Vulkan transfer context created\n";
+    MIDNIGHT_LOG_INFO(
+        Renderer,
+        "Vulkan transfer context created: {} batches, {}",
+        kBatchCount,
+        timeline_semaphore_ != VK_NULL_HANDLE ? "timeline semaphore" : "fences"
+    );
 }
 
 VulkanTransferContext::~VulkanTransferContext()
@@ -32,83 +46,283 @@ VulkanTransferContext::~VulkanTransferContext()
     destroy();
 }
 
-void VulkanTransferContext::execute(const CommandRecorder& record_commands)
+VulkanTransferContext::Ticket VulkanTransferContext::record(
+    const CommandRecorder& record_commands
+)
 {
     if (!record_commands) {
-        throw std::runtime_error("Cannot execute empty Vulkan transfer commands");
+        throw std::runtime_error("Cannot record empty Vulkan transfer commands");
     }
 
-    throw_if_vk_failed(
-        vkResetCommandBuffer(command_buffer_, 0),
-        "vkResetCommandBuffer"
-    );
+    Batch& batch = open_batch();
+    record_commands(batch.command_buffer);
 
-    VkCommandBufferBeginInfo begin_info{};
-    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    return batch.ticket;
+}
 
-    throw_if_vk_failed(
-        vkBeginCommandBuffer(command_buffer_, &begin_info),
-        "vkBeginCommandBuffer"
-    );
+VulkanTransferContext::StagingRange VulkanTransferContext::stage(
+    const void* source,
+    const VkDeviceSize byte_size
+)
+{
+    if (byte_size == 0) {
+        throw std::runtime_error("Cannot stage an empty Vulkan transfer");
+    }
 
-    record_commands(command_buffer_);
+    Batch& batch = open_batch();
+    VkDeviceSize offset =
+        (batch.staging_used + kStagingAlignment - 1) & ~(kStagingAlignment - 1);
+
+    if (batch.staging_buffers.empty() ||
+        offset > batch.staging_buffers.back()->byte_size() ||
+        byte_size > batch.staging_buffers.back()->byte_size() - offset) {
+        // Earlier ranges may already be referenced by recorded copies, so a
+        // full batch grows by adding a buffer rather than replacing one.
+        batch.staging_buffers.push_back(std::make_unique<VulkanBuffer>(
+            device_,
+            std::max(
+                std::bit_ceil(std::max(byte_size, kMinimumStagingBufferSize)),
+                batch.staging_reserve
+            ),
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        ));
+        batch.staging_reserve = 0;
+        offset = 0;
+    }
 
-    throw_if_vk_failed(
-        vkEndCommandBuffer(command_buffer_),
-        "vkEndCommandBuffer"
-    );
+    const VulkanBuffer& staging_buffer = *batch.staging_buffers.back();
+    staging_buffer.upload(source, byte_size, offset);
+    batch.staging_used = offset + byte_size;
+
+    return StagingRange{
+        .buffer = staging_buffer.handle(),
+        .offset = offset
+    };
+}
+
+VulkanTransferContext::Ticket VulkanTransferContext::submit()
+{
+    Batch& batch = batches_[current_batch_];
+
+    if (!batch.recording) {
+        return submitted_ticket_;
+    }
+
+    batch.recording = false;
 
     throw_if_vk_failed(
-        vkResetFences(device_.handle(), 1, &completion_fence_),
-        "vkResetFences"
+        vkEndCommandBuffer(batch.command_buffer),
+        "vkEndCommandBuffer"
     );
 
     VkSubmitInfo submit_info{};
     submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     submit_info.commandBufferCount = 1;
-    submit_info.pCommandBuffers = &command_buffer_;
+    submit_info.pCommandBuffers = &batch.command_buffer;
+
+    VkTimelineSemaphoreSubmitInfo timeline_info{};
+    VkFence fence = VK_NULL_HANDLE;
+
+    if (timeline_semaphore_ != VK_NULL_HANDLE) {
+        timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timeline_info.signalSemaphoreValueCount = 1;
+        timeline_info.pSignalSemaphoreValues = &batch.ticket;
+
+        submit_info.pNext = &timeline_info;
+        submit_info.signalSemaphoreCount = 1;
+        submit_info.pSignalSemaphores = &timeline_semaphore_;
+    } else {
+        fence = batch.fence;
+
+        throw_if_vk_failed(
+            vkResetFences(device_.handle(), 1, &fence),
+            "vkResetFences"
+        );
+    }
 
     throw_if_vk_failed(
         vkQueueSubmit(
             device_.graphics_queue(),
             1,
             &submit_info,
-            completion_fence_
+            fence
         ),
         "vkQueueSubmit"
     );
 
-    throw_if_vk_failed(
-        vkWaitForFences(
-            device_.handle(),
-            1,
-            &completion_fence_,
-            VK_TRUE,
-            std::numeric_limits<std::uint64_t>::max()
-        ),
-        "vkWaitForFences"
-    );
+    submitted_ticket_ = batch.ticket;
+    current_batch_ = (current_batch_ + 1) % kBatchCount;
+
+    return submitted_ticket_;
+}
+
+bool VulkanTransferContext::complete(const Ticket ticket)
+{
+    if (ticket <= completed_ticket_) {
+        return true;
+    }
+
+    if (ticket > submitted_ticket_) {
+        return false;
+    }
+
+    if (timeline_semaphore_ != VK_NULL_HANDLE) {
+        Ticket value = 0;
+
+        throw_if_vk_failed(
+            vkGetSemaphoreCounterValue(
+                device_.handle(),
+                timeline_semaphore_,
+                &value
+            ),
+            "vkGetSemaphoreCounterValue"
+        );
+
+        completed_ticket_ = std::max(completed_ticket_, value);
+        return ticket <= completed_ticket_;
+    }
+
+    // Advance in ticket order so completed_ticket_ never skips a batch whose
+    // fence has not signalled yet.
+    for (bool advanced = true; advanced;) {
+        advanced = false;
+
+        for (const Batch& batch : batches_) {
+            if (batch.ticket != completed_ticket_ + 1 ||
+                batch.ticket > submitted_ticket_) {
+                continue;
+            }
+
+            const VkResult status =
+                vkGetFenceStatus(device_.handle(), batch.fence);
+
+            if (status == VK_NOT_READY) {
+                break;
+            }
+
+            throw_if_vk_failed(status, "vkGetFenceStatus");
+            completed_ticket_ = batch.ticket;
+            advanced = true;
+        }
+    }
+
+    return ticket <= completed_ticket_;
+}
+
+void VulkanTransferContext::wait(const Ticket ticket)
+{
+    if (ticket <= completed_ticket_) {
+        return;
+    }
+
+    if (ticket > submitted_ticket_) {
+        submit();
+    }
+
+    if (timeline_semaphore_ != VK_NULL_HANDLE) {
+        VkSemaphoreWaitInfo wait_info{};
+        wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        wait_info.semaphoreCount = 1;
+        wait_info.pSemaphores = &timeline_semaphore_;
+        wait_info.pValues = &ticket;
+
+        throw_if_vk_failed(
+            vkWaitSemaphores(
+                device_.handle(),
+                &wait_info,
+                std::numeric_limits<std::uint64_t>::max()
+            ),
+            "vkWaitSemaphores"
+        );
+    } else {
+        std::array<VkFence, kBatchCount> fences{};
+        std::uint32_t fence_count = 0;
+
+        for (const Batch& batch : batches_) {
+            if (batch.ticket > completed_ticket_ &&
+                batch.ticket <= ticket &&
+                !batch.recording) {
+                fences[fence_count++] = batch.fence;
+            }
+        }
+
+        if (fence_count > 0) {
+            throw_if_vk_failed(
+                vkWaitForFences(
+                    device_.handle(),
+                    fence_count,
+                    fences.data(),
+                    VK_TRUE,
+                    std::numeric_limits<std::uint64_t>::max()
+                ),
+                "vkWaitForFences"
+            );
+        }
+    }
+
+    completed_ticket_ = ticket;
 }
 
-void VulkanTransferContext::upload_to_new_sampled_image(
+void VulkanTransferContext::execute(const CommandRecorder& record_commands)
+{
+    wait(record(record_commands));
+}
+
+VulkanTransferContext::Ticket VulkanTransferContext::upload_to_new_sampled_image(
     const VulkanImage& destination_image,
     const void* source,
     const VkDeviceSize byte_size
 )
 {
-    VulkanBuffer staging_buffer(
-        device_,
-        byte_size,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-    );
+    const VkExtent2D image_extent = destination_image.extent();
+    const std::uint32_t mip_levels = destination_image.mip_levels();
+    VkDeviceSize texel_count = 0;
+
+    for (std::uint32_t level = 0; level < mip_levels; ++level) {
+        texel_count +=
+            static_cast<VkDeviceSize>(std::max(image_extent.width >> level, 1u)) *
+            std::max(image_extent.height >> level, 1u);
+    }
+
+    if (byte_size == 0 || byte_size % texel_count != 0) {
+        throw std::runtime_error("Image upload size does not match its mip chain");
+    }
 
-    staging_buffer.upload(source, byte_size);
+    const VkDeviceSize texel_size = byte_size / texel_count;
+    const StagingRange staging = stage(source, byte_size);
+
+    std::vector<VkBufferImageCopy> copy_regions(mip_levels);
+    VkDeviceSize level_offset = staging.offset;
+
+    for (std::uint32_t level = 0; level < mip_levels; ++level) {
+        const std::uint32_t level_width =
+            std::max(image_extent.width >> level, 1u);
+        const std::uint32_t level_height =
+            std::max(image_extent.height >> level, 1u);
+
+        VkBufferImageCopy& copy_region = copy_regions[level];
+        copy_region.bufferOffset = level_offset;
+        copy_region.bufferRowLength = 0;
+        copy_region.bufferImageHeight = 0;
+        copy_region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        copy_region.imageSubresource.mipLevel = level;
+        copy_region.imageSubresource.baseArrayLayer = 0;
+        copy_region.imageSubresource.layerCount = 1;
+        copy_region.imageOffset = VkOffset3D{.x = 0, .y = 0, .z = 0};
+        copy_region.imageExtent = VkExtent3D{
+            .width = level_width,
+            .height = level_height,
+            .depth = 1
+        };
+
+        level_offset +=
+            static_cast<VkDeviceSize>(level_width) * level_height * texel_size;
+    }
 
-    execute(
-        [&staging_buffer, &destination_image](
+    const Ticket ticket = record(
+        [&staging, &destination_image, &copy_regions, mip_levels](
             const VkCommandBuffer command_buffer
         ) {
             VkImageMemoryBarrier to_transfer_destination{};
@@ -128,7 +342,7 @@ void VulkanTransferContext::upload_to_new_sampled_image(
             to_transfer_destination.subresourceRange.aspectMask =
                 VK_IMAGE_ASPECT_COLOR_BIT;
             to_transfer_destination.subresourceRange.baseMipLevel = 0;
-            to_transfer_destination.subresourceRange.levelCount = 1;
+            to_transfer_destination.subresourceRange.levelCount = mip_levels;
             to_transfer_destination.subresourceRange.baseArrayLayer = 0;
             to_transfer_destination.subresourceRange.layerCount = 1;
 
@@ -145,31 +359,13 @@ void VulkanTransferContext::upload_to_new_sampled_image(
                 &to_transfer_destination
             );
 
-            const VkExtent2D image_extent = destination_image.extent();
-
-            VkBufferImageCopy copy_region{};
-            copy_region.bufferOffset = 0;
-            copy_region.bufferRowLength = 0;
-            copy_region.bufferImageHeight = 0;
-            copy_region.imageSubresource.aspectMask =
-                VK_IMAGE_ASPECT_COLOR_BIT;
-            copy_region.imageSubresource.mipLevel = 0;
-            copy_region.imageSubresource.baseArrayLayer = 0;
-            copy_region.imageSubresource.layerCount = 1;
-            copy_region.imageOffset = VkOffset3D{.x = 0, .y = 0, .z = 0};
-            copy_region.imageExtent = VkExtent3D{
-                .width = image_extent.width,
-                .height = image_extent.height,
-                .depth = 1
-            };
-
             vkCmdCopyBufferToImage(
                 command_buffer,
-                staging_buffer.handle(),
+                staging.buffer,
                 destination_image.handle(),
                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                1,
-                &copy_region
+                static_cast<std::uint32_t>(copy_regions.size()),
+                copy_regions.data()
             );
 
             VkImageMemoryBarrier to_shader_read{};
@@ -184,7 +380,7 @@ void VulkanTransferContext::upload_to_new_sampled_image(
             to_shader_read.subresourceRange.aspectMask =
                 VK_IMAGE_ASPECT_COLOR_BIT;
             to_shader_read.subresourceRange.baseMipLevel = 0;
-            to_shader_read.subresourceRange.levelCount = 1;
+            to_shader_read.subresourceRange.levelCount = mip_levels;
             to_shader_read.subresourceRange.baseArrayLayer = 0;
             to_shader_read.subresourceRange.layerCount = 1;
 
@@ -203,9 +399,201 @@ void VulkanTransferContext::upload_to_new_sampled_image(
         }
     );
 
-    std::cout << "[Midnight] Vulkan image upload completed: "
-              << byte_size
-              << " bytes\n";
+    MIDNIGHT_LOG_DEBUG(Renderer, "Vulkan image upload queued: {} bytes", byte_size);
+
+    return ticket;
+}
+
+VulkanTransferContext::Ticket VulkanTransferContext::update_sampled_image_region(
+    const VulkanImage& destination_image,
+    const VkRect2D& region,
+    const void* source,
+    const std::uint32_t source_row_length,
+    const VkDeviceSize byte_size
+)
+{
+    const VkExtent2D image_extent = destination_image.extent();
+
+    if (region.offset.x < 0 ||
+        region.offset.y < 0 ||
+        region.extent.width == 0 ||
+        region.extent.height == 0 ||
+        static_cast<std::uint32_t>(region.offset.x) + region.extent.width >
+            image_extent.width ||
+        static_cast<std::uint32_t>(region.offset.y) + region.extent.height >
+            image_extent.height ||
+        source_row_length < static_cast<std::uint32_t>(region.offset.x) +
+            region.extent.width) {
+        throw std::runtime_error("Image region update lies outside the image");
+    }
+
+    const VkDeviceSize texel_count =
+        static_cast<VkDeviceSize>(source_row_length) * region.extent.height;
+
+    if (byte_size == 0 || byte_size % texel_count != 0) {
+        throw std::runtime_error("Image region update size does not match its rows");
+    }
+
+    const VkDeviceSize texel_size = byte_size / texel_count;
+    const StagingRange staging = stage(source, byte_size);
+
+    VkBufferImageCopy copy_region{};
+    copy_region.bufferOffset =
+        staging.offset +
+        static_cast<VkDeviceSize>(region.offset.x) * texel_size;
+    copy_region.bufferRowLength = source_row_length;
+    copy_region.bufferImageHeight = region.extent.height;
+    copy_region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    copy_region.imageSubresource.mipLevel = 0;
+    copy_region.imageSubresource.baseArrayLayer = 0;
+    copy_region.imageSubresource.layerCount = 1;
+    copy_region.imageOffset = VkOffset3D{
+        .x = region.offset.x,
+        .y = region.offset.y,
+        .z = 0
+    };
+    copy_region.imageExtent = VkExtent3D{
+        .width = region.extent.width,
+        .height = region.extent.height,
+        .depth = 1
+    };
+
+    const Ticket ticket = record(
+        [&staging, &destination_image, &copy_region](
+            const VkCommandBuffer command_buffer
+        ) {
+            VkImageMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = destination_image.handle();
+            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            barrier.subresourceRange.baseMipLevel = 0;
+            barrier.subresourceRange.levelCount = 1;
+            barrier.subresourceRange.baseArrayLayer = 0;
+            barrier.subresourceRange.layerCount = 1;
+
+            // Keeps the contents, unlike a transition from UNDEFINED, and
+            // only needs to wait for reads, so no access is made visible.
+            barrier.srcAccessMask = 0;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+
+            vkCmdPipelineBarrier(
+                command_buffer,
+                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                0,
+                0,
+                nullptr,
+                0,
+                nullptr,
+                1,
+                &barrier
+            );
+
+            vkCmdCopyBufferToImage(
+                command_buffer,
+                staging.buffer,
+                destination_image.handle(),
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                1,
+                &copy_region
+            );
+
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+            vkCmdPipelineBarrier(
+                command_buffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                0,
+                0,
+                nullptr,
+                0,
+                nullptr,
+                1,
+                &barrier
+            );
+        }
+    );
+
+    MIDNIGHT_LOG_DEBUG(
+        Renderer,
+        "Vulkan image region update queued: {}x{} texels",
+        region.extent.width,
+        region.extent.height
+    );
+
+    return ticket;
+}
+
+VulkanTransferContext::Ticket VulkanTransferContext::upload_to_buffer(
+    const VulkanBuffer& destination_buffer,
+    const void* source,
+    const VkDeviceSize byte_size,
+    const VkDeviceSize destination_offset
+)
+{
+    if (destination_offset > destination_buffer.byte_size() ||
+        byte_size > destination_buffer.byte_size() - destination_offset) {
+        throw std::runtime_error("Vulkan buffer transfer would write past the end of the buffer");
+    }
+
+    const StagingRange staging = stage(source, byte_size);
+
+    const Ticket ticket = record(
+        [&staging, &destination_buffer, byte_size, destination_offset](
+            const VkCommandBuffer command_buffer
+        ) {
+            const VkBufferCopy copy_region{
+                .srcOffset = staging.offset,
+                .dstOffset = destination_offset,
+                .size = byte_size
+            };
+
+            vkCmdCopyBuffer(
+                command_buffer,
+                staging.buffer,
+                destination_buffer.handle(),
+                1,
+                &copy_region
+            );
+
+            VkMemoryBarrier to_vertex_input{};
+            to_vertex_input.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            to_vertex_input.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            to_vertex_input.dstAccessMask =
+                VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |
+                VK_ACCESS_INDEX_READ_BIT;
+
+            vkCmdPipelineBarrier(
+                command_buffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                0,
+                1,
+                &to_vertex_input,
+                0,
+                nullptr,
+                0,
+                nullptr
+            );
+        }
+    );
+
+    MIDNIGHT_LOG_DEBUG(Renderer, "Vulkan buffer upload queued: {} bytes", byte_size);
+
+    return ticket;
+}
+
+VkSemaphore VulkanTransferContext::timeline_semaphore() const noexcept
+{
+    return timeline_semaphore_;
 }
 
 void VulkanTransferContext::create_command_pool()
@@ -228,52 +616,147 @@ void VulkanTransferContext::create_command_pool()
     );
 }
 
-void VulkanTransferContext::allocate_command_buffer()
+void VulkanTransferContext::allocate_command_buffers()
 {
+    std::array<VkCommandBuffer, kBatchCount> command_buffers{};
+
     VkCommandBufferAllocateInfo allocate_info{};
     allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     allocate_info.commandPool = command_pool_;
     allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocate_info.commandBufferCount = 1;
+    allocate_info.commandBufferCount =
+        static_cast<std::uint32_t>(command_buffers.size());
 
     throw_if_vk_failed(
         vkAllocateCommandBuffers(
             device_.handle(),
             &allocate_info,
-            &command_buffer_
+            command_buffers.data()
         ),
         "vkAllocateCommandBuffers"
     );
+
+    for (std::size_t index = 0; index < kBatchCount; ++index) {
+        batches_[index].command_buffer = command_buffers[index];
+    }
 }
 
-void VulkanTransferContext::create_completion_fence()
+void VulkanTransferContext::create_sync_objects()
 {
+    if (device_.timeline_semaphores()) {
+        VkSemaphoreTypeCreateInfo type_info{};
+        type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        type_info.initialValue = 0;
+
+        VkSemaphoreCreateInfo create_info{};
+        create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        create_info.pNext = &type_info;
+
+        throw_if_vk_failed(
+            vkCreateSemaphore(
+                device_.handle(),
+                &create_info,
+                nullptr,
+                &timeline_semaphore_
+            ),
+            "vkCreateSemaphore"
+        );
+
+        return;
+    }
+
     VkFenceCreateInfo create_info{};
     create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
 
-    throw_if_vk_failed(
-        vkCreateFence(
-            device_.handle(),
-            &create_info,
-            nullptr,
-            &completion_fence_
-        ),
-        "vkCreateFence"
-    );
+    for (Batch& batch : batches_) {
+        throw_if_vk_failed(
+            vkCreateFence(
+                device_.handle(),
+                &create_info,
+                nullptr,
+                &batch.fence
+            ),
+            "vkCreateFence"
+        );
+    }
 }
 
 void VulkanTransferContext::destroy() noexcept
 {
-    if (completion_fence_ != VK_NULL_HANDLE) {
-        vkDestroyFence(device_.handle(), completion_fence_, nullptr);
-        completion_fence_ = VK_NULL_HANDLE;
+    if (submitted_ticket_ > completed_ticket_) {
+        (void)vkQueueWaitIdle(device_.graphics_queue());
+        completed_ticket_ = submitted_ticket_;
+    }
+
+    for (Batch& batch : batches_) {
+        batch.staging_buffers.clear();
+
+        if (batch.fence != VK_NULL_HANDLE) {
+            vkDestroyFence(device_.handle(), batch.fence, nullptr);
+            batch.fence = VK_NULL_HANDLE;
+        }
+
+        batch.command_buffer = VK_NULL_HANDLE;
+    }
+
+    if (timeline_semaphore_ != VK_NULL_HANDLE) {
+        vkDestroySemaphore(device_.handle(), timeline_semaphore_, nullptr);
+        timeline_semaphore_ = VK_NULL_HANDLE;
     }
 
     if (command_pool_ != VK_NULL_HANDLE) {
         vkDestroyCommandPool(device_.handle(), command_pool_, nullptr);
         command_pool_ = VK_NULL_HANDLE;
-        command_buffer_ = VK_NULL_HANDLE;
     }
 }
 
+VulkanTransferContext::Batch& VulkanTransferContext::open_batch()
+{
+    Batch& batch = batches_[current_batch_];
+
+    if (batch.recording) {
+        return batch;
+    }
+
+    // The ring wrapped onto a batch that may still be executing; its staging
+    // memory and command buffer are reused below.
+    if (batch.ticket != 0) {
+        wait(batch.ticket);
+    }
+
+    if (batch.staging_buffers.size() > 1) {
+        VkDeviceSize total_size = 0;
+
+        for (const std::unique_ptr<VulkanBuffer>& buffer :
+             batch.staging_buffers) {
+            total_size += buffer->byte_size();
+        }
+
+        batch.staging_buffers.clear();
+        batch.staging_reserve = std::bit_ceil(total_size);
+    }
+
+    batch.staging_used = 0;
+
+    throw_if_vk_failed(
+        vkResetCommandBuffer(batch.command_buffer, 0),
+        "vkResetCommandBuffer"
+    );
+
+    VkCommandBufferBeginInfo begin_info{};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    throw_if_vk_failed(
+        vkBeginCommandBuffer(batch.command_buffer, &begin_info),
+        "vkBeginCommandBuffer"
+    );
+
+    batch.ticket = submitted_ticket_ + 1;
+    batch.recording = true;
+
+    return batch;
+}
+
 }
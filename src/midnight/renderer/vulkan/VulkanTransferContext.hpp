@@ -2,16 +2,32 @@
 
 #include <vulkan/vulkan.h>
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <vector>
 
 namespace midnight {
 
+class VulkanBuffer;
 class VulkanDevice;
 class VulkanImage;
 
+// Batches copies and layout transitions into one submission per frame.
+// Each batch completes with a ticket; with timeline semaphores the ticket is
+// the value the batch signals, so render submissions can wait on it GPU-side
+// instead of the CPU blocking on a fence.
 class VulkanTransferContext final {
 public:
     using CommandRecorder = std::function<void(VkCommandBuffer)>;
+    using Ticket = std::uint64_t;
+
+    struct StagingRange final {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+    };
 
     explicit VulkanTransferContext(const VulkanDevice& device);
     ~VulkanTransferContext();
@@ -22,25 +38,86 @@ public:
     VulkanTransferContext(VulkanTransferContext&&) = delete;
     VulkanTransferContext& operator=(VulkanTransferContext&&) = delete;
 
+    // Appends commands to the open batch and returns the ticket the batch
+    // will complete with. Nothing reaches the GPU until submit().
+    Ticket record(const CommandRecorder& record_commands);
+
+    // Copies `source` into staging memory owned by the open batch. The range
+    // stays valid until that batch completes.
+    [[nodiscard]] StagingRange stage(const void* source, VkDeviceSize byte_size);
+
+    // Submits the open batch, if any, and returns the newest submitted ticket.
+    Ticket submit();
+
+    [[nodiscard]] bool complete(Ticket ticket);
+    void wait(Ticket ticket);
+
+    // Records, submits and waits, for callers that need the result at once.
     void execute(const CommandRecorder& record_commands);
 
-    void upload_to_new_sampled_image(
+    // `source` holds every mip level of the image back to back, largest
+    // first, each tightly packed.
+    Ticket upload_to_new_sampled_image(
+        const VulkanImage& destination_image,
+        const void* source,
+        VkDeviceSize byte_size
+    );
+
+    // Rewrites `region` of the base level of an image that was already
+    // uploaded and is being sampled. `source` holds whole rows of
+    // `source_row_length` texels from the region's top row down, so a
+    // caller can pass rows of its full-size copy of the image. The copy
+    // waits for earlier frames' fragment shaders on the same queue.
+    Ticket update_sampled_image_region(
         const VulkanImage& destination_image,
+        const VkRect2D& region,
         const void* source,
+        std::uint32_t source_row_length,
         VkDeviceSize byte_size
     );
 
+    // Copies into a device-local vertex or index buffer that no submitted
+    // frame is reading. The destination needs TRANSFER_DST usage.
+    Ticket upload_to_buffer(
+        const VulkanBuffer& destination_buffer,
+        const void* source,
+        VkDeviceSize byte_size,
+        VkDeviceSize destination_offset = 0
+    );
+
+    // VK_NULL_HANDLE without timeline semaphore support. Batches then only
+    // rely on running earlier on the same queue, behind their own barriers.
+    [[nodiscard]] VkSemaphore timeline_semaphore() const noexcept;
+
 private:
+    static constexpr std::size_t kBatchCount = 3;
+
+    struct Batch final {
+        VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;
+        Ticket ticket = 0;
+        bool recording = false;
+        std::vector<std::unique_ptr<VulkanBuffer>> staging_buffers;
+        VkDeviceSize staging_used = 0;
+        VkDeviceSize staging_reserve = 0;
+    };
+
     void create_command_pool();
-    void allocate_command_buffer();
-    void create_completion_fence();
+    void allocate_command_buffers();
+    void create_sync_objects();
     void destroy() noexcept;
 
+    [[nodiscard]] Batch& open_batch();
+
     const VulkanDevice& device_;
 
     VkCommandPool command_pool_ = VK_NULL_HANDLE;
-    VkCommandBuffer command_buffer_ = VK_NULL_HANDLE;
-    VkFence completion_fence_ = VK_NULL_HANDLE;
+    VkSemaphore timeline_semaphore_ = VK_NULL_HANDLE;
+
+    std::array<Batch, kBatchCount> batches_{};
+    std::size_t current_batch_ = 0;
+    Ticket submitted_ticket_ = 0;
+    Ticket completed_ticket_ = 0;
 };
 
 }